@@ -0,0 +1,39 @@
+// Tests that serverStatus reports the number of log records dropped by the asynchronous log file
+// writer.
+(function() {
+"use strict";
+
+const logPath = MongoRunner.dataPath + "async_log_dropped_records.log";
+const conn = MongoRunner.runMongod({
+    logpath: logPath,
+    setParameter: {
+        asyncLogFileWrites: true,
+        asyncLogBufferRecords: 1,
+        asyncLogOverflowPolicy: "drop",
+        logComponentVerbosity: tojson({command: 2}),
+    }
+});
+const admin = conn.getDB("admin");
+
+function droppedRecords() {
+    return Number(admin.serverStatus().metrics.log.asyncDroppedRecords);
+}
+
+const before = droppedRecords();
+assert.gte(before, 0);
+
+// Every command logs at this verbosity, from several connections at once, so the single-record
+// buffers overflow. The count never goes down.
+const threads = [];
+for (let i = 0; i < 4; ++i) {
+    threads.push(startParallelShell(() => {
+        for (let j = 0; j < 1000; ++j) {
+            assert.commandWorked(db.adminCommand({ping: 1}));
+        }
+    }, conn.port));
+}
+threads.forEach(join => join());
+assert.gte(droppedRecords(), before);
+
+MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,46 @@
+/**
+ * Checks that the compact command with {online: true} reclaims the free space of a collection and
+ * its indexes, and does not block writes to the collection while it runs.
+ *
+ * @tags: [requires_wiredtiger, requires_persistence]
+ */
+(function() {
+"use strict";
+
+load("jstests/libs/parallel_shell_helpers.js");
+
+const conn = MongoRunner.runMongod({setParameter: {onlineCompactChunkSecs: 1}});
+const db = conn.getDB("test");
+const coll = db.getCollection(jsTest.name());
+
+assert.commandWorked(coll.createIndex({x: 1}));
+
+const padding = "x".repeat(1024);
+let bulk = coll.initializeUnorderedBulkOp();
+for (let i = 0; i < 50000; i++) {
+    bulk.insert({_id: i, x: i, padding: padding});
+}
+assert.commandWorked(bulk.execute());
+
+// Delete most documents to leave free space in the collection and index files.
+assert.commandWorked(coll.remove({_id: {$gte: 5000}}));
+assert.commandWorked(db.adminCommand({fsync: 1}));
+
+// Writes proceed while the online compact runs.
+function runOnlineCompact(collName) {
+    const res = assert.commandWorked(db.runCommand({compact: collName, online: true}));
+    assert.gte(res.bytesFreed, 0, tojson(res));
+}
+const awaitCompact =
+    startParallelShell(funWithArgs(runOnlineCompact, coll.getName()), conn.port);
+for (let i = 50000; i < 50100; i++) {
+    assert.commandWorked(coll.insert({_id: i, x: i}));
+}
+awaitCompact();
+
+assert.eq(5100, coll.find().itcount());
+assert.eq(5100, coll.find().hint({x: 1}).itcount());
+assert(coll.validate().valid);
+
+MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,21 @@
+/**
+ * Tests that the wiredTigerCache serverStatus section, read by high resolution FTDC, is only
+ * reported when requested and holds the same statistics as wiredTiger.cache.
+ *
+ * @tags: [requires_wiredtiger]
+ */
+(function() {
+"use strict";
+
+const conn = MongoRunner.runMongod();
+const admin = conn.getDB("admin");
+
+assert(!admin.serverStatus().hasOwnProperty("wiredTigerCache"));
+
+const status = assert.commandWorked(admin.runCommand({serverStatus: 1, wiredTigerCache: 1}));
+assert.eq(Object.keys(status.wiredTiger.cache).sort(),
+          Object.keys(status.wiredTigerCache).sort(),
+          tojson(status.wiredTigerCache));
+
+MongoRunner.stopMongod(conn);
+})();
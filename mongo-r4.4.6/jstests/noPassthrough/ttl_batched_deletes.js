@@ -0,0 +1,88 @@
+// Tests that the TTL monitor deletes from several TTL indexes at once, in batches, within the
+// deletes per second budget, and reports each index under serverStatus.metrics.ttl.indexes.
+(function() {
+"use strict";
+
+load("jstests/libs/fail_point_util.js");
+
+const conn = MongoRunner.runMongod({
+    setParameter: {
+        ttlMonitorSleepSecs: 1,
+        ttlMonitorEnabled: false,
+        ttlMonitorMaxConcurrency: 4,
+        ttlMonitorBatchSize: 20,
+    }
+});
+const db = conn.getDB("test");
+const collNames = ["a", "b", "c"];
+
+function insertExpired(numDocs) {
+    const expired = new Date(0);
+    for (let name of collNames) {
+        const docs = [];
+        for (let i = 0; i < numDocs; ++i) {
+            docs.push({x: expired});
+        }
+        assert.commandWorked(db[name].insert(docs));
+    }
+}
+
+function waitForExpiry() {
+    assert.soon(() => collNames.every(name => db[name].find().itcount() === 0),
+                "TTL monitor didn't delete the expired documents before timing out");
+}
+
+function setTTLMonitorEnabled(enabled) {
+    assert.commandWorked(db.adminCommand({setParameter: 1, ttlMonitorEnabled: enabled}));
+}
+
+for (let name of collNames) {
+    assert.commandWorked(db[name].createIndex({x: 1}, {expireAfterSeconds: 0}));
+}
+insertExpired(100);
+
+// Every TTL index gets a worker of its own.
+const hangFp = configureFailPoint(conn, "hangTTLMonitorWithLock");
+setTTLMonitorEnabled(true);
+assert.commandWorked(db.adminCommand({
+    waitForFailPoint: "hangTTLMonitorWithLock",
+    timesEntered: hangFp.timesEntered + collNames.length,
+    maxTimeMS: kDefaultWaitForFailPointTimeout
+}));
+hangFp.off();
+waitForExpiry();
+
+// Each index reports the documents deleted through it, and no backlog once it is caught up.
+assert.soon(() => {
+    const indexes = db.serverStatus().metrics.ttl.indexes;
+    return collNames.every(name => {
+        const index = indexes.find(index => index.ns === "test." + name);
+        return index && index.name === "x_1" && Number(index.deletedDocuments) === 100 &&
+            Number(index.backlogEstimate) === 0;
+    });
+}, () => tojson(db.serverStatus().metrics.ttl));
+
+// The deletes per second budget is shared by all of the workers, and holds even though a batch is
+// larger than it.
+setTTLMonitorEnabled(false);
+const maxDeletesPerSecond = 10;
+assert.commandWorked(
+    db.adminCommand({setParameter: 1, ttlMonitorMaxDeletesPerSecond: maxDeletesPerSecond}));
+const numDocs = 20;
+insertExpired(numDocs);
+
+const deletedBefore = db.serverStatus().metrics.ttl.deletedDocuments;
+const start = Date.now();
+setTTLMonitorEnabled(true);
+waitForExpiry();
+const elapsedMS = Date.now() - start;
+
+assert.eq(deletedBefore + numDocs * collNames.length,
+          db.serverStatus().metrics.ttl.deletedDocuments);
+// The deletes span at least this many one-second windows after the first, less a second of slack
+// for the clock the budget is kept by.
+const minWindows = numDocs * collNames.length / maxDeletesPerSecond - 1;
+assert.gte(elapsedMS, (minWindows - 1) * 1000, "TTL monitor deleted faster than its budget");
+
+MongoRunner.stopMongod(conn);
+})();
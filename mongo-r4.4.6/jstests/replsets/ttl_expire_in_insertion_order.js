@@ -0,0 +1,50 @@
+/**
+ * Tests that 'expireInInsertionOrder' is rejected for a collection whose writes are replicated,
+ * and that the TTL monitor removes the expired range of an unreplicated collection which has it.
+ *
+ * @tags: [requires_replication]
+ */
+(function() {
+"use strict";
+
+const rst = new ReplSetTest({nodes: 1, nodeOptions: {setParameter: "ttlMonitorSleepSecs=1"}});
+rst.startSet();
+rst.initiate();
+
+const primary = rst.getPrimary();
+
+// A range removal is written at a single timestamp, so it can't be replicated as separate deletes.
+const replicatedDB = primary.getDB("ttl_expire_in_insertion_order");
+assert.commandFailedWithCode(replicatedDB.createCollection("c", {expireInInsertionOrder: true}),
+                             ErrorCodes.InvalidOptions);
+
+const localDB = primary.getDB("local");
+const coll = localDB.getCollection("ttl_expire_in_insertion_order");
+assert.commandWorked(localDB.createCollection(coll.getName(), {expireInInsertionOrder: true}));
+assert.commandWorked(coll.createIndex({t: 1}, {expireAfterSeconds: 60}));
+assert.commandWorked(coll.createIndex({x: 1}));
+
+// The expired documents come first in insertion order, followed by documents that do not expire.
+const numExpired = 500;
+const numLive = 100;
+const past = new Date(new Date().getTime() - 3600 * 1000);
+const future = new Date(new Date().getTime() + 3600 * 1000);
+let bulk = coll.initializeUnorderedBulkOp();
+for (let i = 0; i < numExpired; ++i) {
+    bulk.insert({_id: i, t: past, x: i});
+}
+for (let i = numExpired; i < numExpired + numLive; ++i) {
+    bulk.insert({_id: i, t: future, x: i});
+}
+assert.commandWorked(bulk.execute());
+
+assert.soon(() => coll.count() == numLive, "expired documents were not deleted");
+
+// The secondary index no longer has keys for the removed documents.
+assert.eq(0, coll.find({t: past}).hint({x: 1}).itcount());
+assert.eq(numLive, coll.find({x: {$gte: 0}}).hint({x: 1}).itcount());
+const res = assert.commandWorked(coll.validate({full: true}));
+assert(res.valid, tojson(res));
+
+rst.stopSet();
+})();
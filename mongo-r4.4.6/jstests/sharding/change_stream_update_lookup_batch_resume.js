@@ -0,0 +1,108 @@
+// Tests that when mongos looks up the post-images of several change events together, the
+// postBatchResumeToken of each getMore does not run ahead of the events the lookup has read but not
+// yet returned, so that resuming from it does not skip them.
+// @tags: [uses_change_streams]
+(function() {
+"use strict";
+
+// For supportsMajorityReadConcern().
+load("jstests/multiVersion/libs/causal_consistency_helpers.js");
+
+if (!supportsMajorityReadConcern()) {
+    jsTestLog("Skipping test since storage engine doesn't support majority read concern.");
+    return;
+}
+
+const st = new ShardingTest({
+    shards: 2,
+    rs: {
+        nodes: 1,
+        enableMajorityReadConcern: '',
+        // Use a higher frequency for periodic noops to speed up the test.
+        setParameter: {writePeriodicNoops: true, periodicNoopIntervalSecs: 1}
+    },
+    other: {
+        mongosOptions: {
+            setParameter: {
+                internalChangeStreamUpdateLookupBatchSize: 10,
+                internalChangeStreamUpdateLookupBatchMaxWaitMS: 1000
+            }
+        }
+    }
+});
+
+const mongosDB = st.s0.getDB(jsTestName());
+const mongosColl = mongosDB['coll'];
+
+// Shard the test collection on _id with a chunk on each shard.
+assert.commandWorked(mongosDB.adminCommand({enableSharding: mongosDB.getName()}));
+st.ensurePrimaryShard(mongosDB.getName(), st.rs0.getURL());
+assert.commandWorked(
+    mongosDB.adminCommand({shardCollection: mongosColl.getFullName(), key: {_id: 1}}));
+assert.commandWorked(mongosDB.adminCommand({split: mongosColl.getFullName(), middle: {_id: 0}}));
+assert.commandWorked(mongosDB.adminCommand(
+    {moveChunk: mongosColl.getFullName(), find: {_id: 1}, to: st.rs1.getURL()}));
+
+const pipeline = [{$changeStream: {fullDocument: "updateLookup"}}];
+const startCursor = assert.commandWorked(mongosDB.runCommand(
+    {aggregate: mongosColl.getName(), pipeline: pipeline, cursor: {batchSize: 0}}));
+
+// Generate more events than mongos returns in one getMore, on both shards.
+const numDocs = 8;
+for (let i = 0; i < numDocs; ++i) {
+    const id = (i % 2 == 0) ? i + 1 : -(i + 1);
+    assert.commandWorked(mongosColl.insert({_id: id}));
+    assert.commandWorked(mongosColl.update({_id: id}, {$set: {updated: true}}));
+}
+const numEvents = 2 * numDocs;
+
+// Read the events one at a time, each time recording the postBatchResumeToken returned with it.
+// The remaining events of a lookup batch are buffered on mongos while this happens.
+function readEvents(cursorId) {
+    const events = [];
+    const tokens = [];
+    assert.soon(() => {
+        const res = assert.commandWorked(mongosDB.runCommand(
+            {getMore: cursorId, collection: mongosColl.getName(), batchSize: 1}));
+        for (let event of res.cursor.nextBatch) {
+            events.push(event);
+            tokens.push(res.cursor.postBatchResumeToken);
+        }
+        return events.length >= numEvents;
+    });
+    return {events: events, tokens: tokens};
+}
+
+const {events, tokens} = readEvents(startCursor.cursor.id);
+assert.eq(events.length, numEvents, events);
+for (let event of events) {
+    if (event.operationType == "update") {
+        assert.docEq(event.fullDocument, {_id: event.documentKey._id, updated: true});
+    }
+}
+
+// Resuming from the postBatchResumeToken that came with any event must return the next event.
+for (let i = 0; i < numEvents - 1; ++i) {
+    const resumed = assert.commandWorked(mongosDB.runCommand({
+        aggregate: mongosColl.getName(),
+        pipeline: [{$changeStream: {fullDocument: "updateLookup", resumeAfter: tokens[i]}}],
+        cursor: {}
+    }));
+    let next = resumed.cursor.firstBatch;
+    assert.soon(() => {
+        if (next.length > 0) {
+            return true;
+        }
+        next = assert
+                   .commandWorked(mongosDB.runCommand(
+                       {getMore: resumed.cursor.id, collection: mongosColl.getName()}))
+                   .cursor.nextBatch;
+        return next.length > 0;
+    });
+    assert.docEq(next[0]._id, events[i + 1]._id, {resumedFrom: tokens[i], got: next[0]});
+    assert.commandWorked(
+        mongosDB.runCommand({killCursors: mongosColl.getName(), cursors: [resumed.cursor.id]}));
+}
+
+st.stop();
+})();
@@ -297,6 +297,19 @@ public:
                                 const bool noWarn = false,
                                 StoreDeletedDoc storeDeletedDoc = StoreDeletedDoc::Off) = 0;
 
+    /**
+     * Deletes every document with a RecordId from 'first' through 'last', inclusive, removing
+     * them from the record store as a single range after each one is unindexed. A range removal is
+     * written at a single timestamp, so the deletes must not be written to the oplog, where each
+     * would take a timestamp of its own. The collection must not be capped.
+     *
+     * 'opDebug' Optional argument. When not null, will be used to record operation statistics.
+     */
+    virtual void deleteDocumentRange(OperationContext* const opCtx,
+                                     RecordId first,
+                                     RecordId last,
+                                     OpDebug* const opDebug) = 0;
+
     /*
      * Inserts all documents inside one WUOW.
      * Caller should ensure vector is appropriately sized for this.
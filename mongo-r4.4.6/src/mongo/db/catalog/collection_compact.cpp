@@ -32,9 +32,11 @@
 #include "mongo/db/catalog/collection_compact.h"
 
 #include "mongo/db/catalog/collection_catalog.h"
+#include "mongo/db/catalog/collection_compact_gen.h"
 #include "mongo/db/catalog/document_validation.h"
 #include "mongo/db/catalog/index_key_validate.h"
 #include "mongo/db/catalog/multi_index_block.h"
+#include "mongo/db/curop.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/index/index_access_method.h"
 #include "mongo/db/index/index_descriptor.h"
@@ -43,6 +45,7 @@
 #include "mongo/db/views/view_catalog.h"
 #include "mongo/logv2/log.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -50,6 +53,10 @@ using logv2::LogComponent;
 
 namespace {
 
+// Number of chunks in a row which may time out without reclaiming any space before the online
+// compaction gives up on a file. Concurrent writes can keep a file from shrinking indefinitely.
+const int kMaxChunksWithoutProgress = 3;
+
 Collection* getCollectionForCompact(OperationContext* opCtx,
                                     Database* database,
                                     const NamespaceString& collectionNss) {
@@ -68,6 +75,49 @@ Collection* getCollectionForCompact(OperationContext* opCtx,
     return collection;
 }
 
+/**
+ * Runs one chunk of the online compaction of the record store of the collection 'collectionUUID',
+ * or of its index 'indexName' if set, under an intent lock on the collection.
+ *
+ * Returns ErrorCodes::ExceededTimeLimit if the file was not fully compacted within the chunk.
+ * Adds the number of bytes the file shrank by to 'bytesReclaimed'.
+ */
+Status compactChunk(OperationContext* opCtx,
+                    const NamespaceString& collectionNss,
+                    const UUID& collectionUUID,
+                    const boost::optional<std::string>& indexName,
+                    int64_t* bytesReclaimed) {
+    AutoGetCollection autoColl(
+        opCtx, NamespaceStringOrUUID(collectionNss.db().toString(), collectionUUID), MODE_IX);
+    Collection* collection = autoColl.getCollection();
+    uassert(ErrorCodes::NamespaceNotFound,
+            str::stream() << "collection " << collectionNss
+                          << " was dropped during an online compact",
+            collection);
+
+    const Seconds timeout(gOnlineCompactChunkSecs.load());
+    if (!indexName) {
+        auto recordStore = collection->getRecordStore();
+        const auto sizeBefore = recordStore->storageSize(opCtx);
+        Status status = recordStore->compact(opCtx, timeout);
+        *bytesReclaimed += sizeBefore - recordStore->storageSize(opCtx);
+        return status;
+    }
+
+    // An index dropped during the compaction does not need to be compacted any more.
+    auto indexCatalog = collection->getIndexCatalog();
+    const IndexDescriptor* descriptor = indexCatalog->findIndexByName(opCtx, *indexName);
+    if (!descriptor) {
+        return Status::OK();
+    }
+
+    auto accessMethod = indexCatalog->getEntry(descriptor)->accessMethod();
+    const auto sizeBefore = accessMethod->getSpaceUsedBytes(opCtx);
+    Status status = accessMethod->compact(opCtx, timeout);
+    *bytesReclaimed += sizeBefore - accessMethod->getSpaceUsedBytes(opCtx);
+    return status;
+}
+
 }  // namespace
 
 StatusWith<int64_t> compactCollection(OperationContext* opCtx,
@@ -112,7 +162,7 @@ StatusWith<int64_t> compactCollection(OperationContext* opCtx,
     auto oldTotalSize = recordStore->storageSize(opCtx) + collection->getIndexSize(opCtx);
     auto indexCatalog = collection->getIndexCatalog();
 
-    Status status = recordStore->compact(opCtx);
+    Status status = recordStore->compact(opCtx, boost::none);
     if (!status.isOK())
         return status;
 
@@ -131,4 +181,95 @@ StatusWith<int64_t> compactCollection(OperationContext* opCtx,
     return totalSizeDiff;
 }
 
+StatusWith<int64_t> compactCollectionOnline(OperationContext* opCtx,
+                                            const NamespaceString& collectionNss) {
+    boost::optional<UUID> collectionUUID;
+    // The files to compact: the record store, then each ready index.
+    std::vector<boost::optional<std::string>> files{boost::none};
+    {
+        AutoGetDb autoDb(opCtx, collectionNss.db(), MODE_IX);
+        Database* database = autoDb.getDb();
+        uassert(ErrorCodes::NamespaceNotFound, "database does not exist", database);
+        Lock::CollectionLock collLk(opCtx, collectionNss, MODE_IX);
+
+        Collection* collection = getCollectionForCompact(opCtx, database, collectionNss);
+        auto recordStore = collection->getRecordStore();
+        if (!recordStore->compactSupported() || !recordStore->supportsOnlineCompaction()) {
+            return Status(ErrorCodes::CommandNotSupported,
+                          str::stream() << "cannot compact collection online with record store: "
+                                        << recordStore->name());
+        }
+
+        collectionUUID = collection->uuid();
+        auto it = collection->getIndexCatalog()->getIndexIterator(opCtx, false);
+        while (it->more()) {
+            files.push_back(it->next()->descriptor()->indexName());
+        }
+    }
+
+    LOGV2_OPTIONS(5600120,
+                  {LogComponent::kCommand},
+                  "Online compact begin",
+                  "namespace"_attr = collectionNss,
+                  "numFiles"_attr = files.size());
+
+    ProgressMeterHolder progress;
+    {
+        stdx::unique_lock<Client> lk(*opCtx->getClient());
+        progress.set(CurOp::get(opCtx)->setProgress_inlock("Online compact: compacting files",
+                                                           files.size()));
+    }
+
+    int64_t bytesReclaimed = 0;
+    for (const auto& indexName : files) {
+        int chunksWithoutProgress = 0;
+        while (true) {
+            opCtx->checkForInterrupt();
+
+            const int64_t bytesReclaimedBefore = bytesReclaimed;
+            Timer timer;
+            Status status =
+                compactChunk(opCtx, collectionNss, *collectionUUID, indexName, &bytesReclaimed);
+            CurOp::get(opCtx)->debug().bytesReclaimed = static_cast<long long>(bytesReclaimed);
+            if (status.isOK()) {
+                break;
+            }
+            if (status != ErrorCodes::ExceededTimeLimit) {
+                return status;
+            }
+
+            const int64_t chunkBytes = bytesReclaimed - bytesReclaimedBefore;
+            chunksWithoutProgress = chunkBytes > 0 ? 0 : chunksWithoutProgress + 1;
+            if (chunksWithoutProgress >= kMaxChunksWithoutProgress) {
+                LOGV2(5600155,
+                      "Online compact is not reclaiming any space, moving on to the next file",
+                      "namespace"_attr = collectionNss,
+                      "index"_attr = indexName,
+                      "numChunks"_attr = chunksWithoutProgress);
+                break;
+            }
+
+            // Throttle by sleeping for as long as reclaiming the chunk's bytes should have taken,
+            // beyond the time it did take. The locks are not held while sleeping.
+            const int64_t maxBytesPerSec =
+                static_cast<int64_t>(gMaxOnlineCompactMBperSec.load()) * 1024 * 1024;
+            if (maxBytesPerSec > 0 && chunkBytes > 0) {
+                const Microseconds expected(chunkBytes * 1000 * 1000 / maxBytesPerSec);
+                const Microseconds elapsed(timer.micros());
+                if (expected > elapsed) {
+                    opCtx->sleepFor(duration_cast<Milliseconds>(expected - elapsed));
+                }
+            }
+        }
+        progress.hit();
+    }
+    progress.finished();
+
+    LOGV2(5600121,
+          "Online compact end",
+          "namespace"_attr = collectionNss,
+          "freedBytes"_attr = bytesReclaimed);
+    return bytesReclaimed;
+}
+
 }  // namespace mongo
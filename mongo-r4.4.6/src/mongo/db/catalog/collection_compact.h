@@ -43,4 +43,16 @@ namespace mongo {
 StatusWith<int64_t> compactCollection(OperationContext* opCtx,
                                       const NamespaceString& collectionNss);
 
+/**
+ * Compacts collection and its indexes in chunks of 'onlineCompactChunkSecs' seconds, yielding its
+ * locks between chunks and throttling to 'maxOnlineCompactMBperSec', so that neither writes nor DDL
+ * operations on the collection are blocked for long. The bytes reclaimed so far are reported in
+ * currentOp.
+ *
+ * Returns the number of bytes of stable storage and index size that were freed, as
+ * compactCollection() does.
+ */
+StatusWith<int64_t> compactCollectionOnline(OperationContext* opCtx,
+                                            const NamespaceString& collectionNss);
+
 }  // namespace mongo
@@ -789,6 +789,46 @@ void CollectionImpl::deleteDocument(OperationContext* opCtx,
     }
 }
 
+void CollectionImpl::deleteDocumentRange(OperationContext* opCtx,
+                                         RecordId first,
+                                         RecordId last,
+                                         OpDebug* opDebug) {
+    uassert(5600150, "cannot remove from a capped collection", !isCapped());
+    // Every logged delete takes the timestamp of its own oplog entry, but a range removal is
+    // written at a single timestamp. A snapshot between those timestamps, or a recovery to one of
+    // them, would see index keys and oplog entries for documents missing from the record store.
+    uassert(5600156,
+            "cannot remove a range of documents whose deletes are replicated",
+            repl::ReplicationCoordinator::get(opCtx)->isOplogDisabledFor(opCtx, ns()));
+
+    auto opObserver = getGlobalServiceContext()->getOpObserver();
+    int64_t keysDeleted = 0;
+    auto cursor = _recordStore->getCursor(opCtx, true);
+    for (auto record = cursor->seekExact(first); record && record->id <= last;
+         record = cursor->next()) {
+        const BSONObj doc = record->data.toBson();
+        opObserver->aboutToDelete(opCtx, ns(), doc);
+
+        boost::optional<BSONObj> deletedDoc;
+        if (getRecordPreImages()) {
+            deletedDoc.emplace(doc.getOwned());
+        }
+
+        int64_t docKeysDeleted;
+        _indexCatalog->unindexRecord(opCtx, doc, record->id, false, &docKeysDeleted);
+        keysDeleted += docKeysDeleted;
+
+        opObserver->onDelete(opCtx, ns(), uuid(), kUninitializedStmtId, false, deletedDoc);
+    }
+    cursor.reset();
+
+    _recordStore->deleteRecordRange(opCtx, first, last);
+
+    if (opDebug) {
+        opDebug->additiveMetrics.incrementKeysDeleted(keysDeleted);
+    }
+}
+
 Counter64 moveCounter;
 ServerStatusMetricField<Counter64> moveCounterDisplay("record.moves", &moveCounter);
 
@@ -133,6 +133,11 @@ public:
         bool noWarn = false,
         Collection::StoreDeletedDoc storeDeletedDoc = Collection::StoreDeletedDoc::Off) final;
 
+    void deleteDocumentRange(OperationContext* opCtx,
+                             RecordId first,
+                             RecordId last,
+                             OpDebug* opDebug) final;
+
     /*
      * Inserts all documents inside one WUOW.
      * Caller should ensure vector is appropriately sized for this.
@@ -112,6 +112,13 @@ public:
         std::abort();
     }
 
+    void deleteDocumentRange(OperationContext* opCtx,
+                             RecordId first,
+                             RecordId last,
+                             OpDebug* opDebug) {
+        std::abort();
+    }
+
     Status insertDocuments(OperationContext* opCtx,
                            std::vector<InsertStatement>::const_iterator begin,
                            std::vector<InsertStatement>::const_iterator end,
@@ -170,6 +170,8 @@ StatusWith<CollectionOptions> CollectionOptions::parse(const BSONObj& options, P
             collectionOptions.temp = e.trueValue();
         } else if (fieldName == "recordPreImages") {
             collectionOptions.recordPreImages = e.trueValue();
+        } else if (fieldName == "expireInInsertionOrder") {
+            collectionOptions.expireInInsertionOrder = e.trueValue();
         } else if (fieldName == "storageEngine") {
             Status status = checkStorageEngineOptions(e);
             if (!status.isOK()) {
@@ -260,6 +262,13 @@ StatusWith<CollectionOptions> CollectionOptions::parse(const BSONObj& options, P
         return Status(ErrorCodes::BadValue, "'pipeline' cannot be specified without 'viewOn'");
     }
 
+    if (collectionOptions.expireInInsertionOrder &&
+        (collectionOptions.capped || !collectionOptions.viewOn.empty())) {
+        return Status(ErrorCodes::InvalidOptions,
+                      "'expireInInsertionOrder' cannot be specified for a capped collection or a "
+                      "view");
+    }
+
     return collectionOptions;
 }
 
@@ -292,6 +301,10 @@ void CollectionOptions::appendBSON(BSONObjBuilder* builder) const {
         builder->appendBool("recordPreImages", true);
     }
 
+    if (expireInInsertionOrder) {
+        builder->appendBool("expireInInsertionOrder", true);
+    }
+
     if (!storageEngine.isEmpty()) {
         builder->append("storageEngine", storageEngine);
     }
@@ -351,6 +364,10 @@ bool CollectionOptions::matchesStorageOptions(const CollectionOptions& other,
         return false;
     }
 
+    if (expireInInsertionOrder != other.expireInInsertionOrder) {
+        return false;
+    }
+
     if (temp != other.temp) {
         return false;
     }
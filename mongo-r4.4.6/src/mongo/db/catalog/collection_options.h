@@ -121,6 +121,11 @@ struct CollectionOptions {
     bool temp = false;
     bool recordPreImages = false;
 
+    // Whether the documents of the collection expire in the order they were inserted, which lets
+    // the TTL monitor remove expired documents by truncating a range of the record store. Only
+    // allowed for collections whose writes are not replicated.
+    bool expireInInsertionOrder = false;
+
     // Storage engine collection options. Always owned or empty.
     BSONObj storageEngine;
 
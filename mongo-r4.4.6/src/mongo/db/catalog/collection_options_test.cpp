@@ -349,6 +349,20 @@ TEST(CollectionOptions, MaxNumberLimits) {
     ASSERT_EQ(options.cappedMaxDocs, 0);
 }
 
+TEST(CollectionOptions, ExpireInInsertionOrderRoundTrip) {
+    CollectionOptions options =
+        assertGet(CollectionOptions::parse(fromjson("{expireInInsertionOrder: true}")));
+    ASSERT_TRUE(options.expireInInsertionOrder);
+    ASSERT_BSONOBJ_EQ(options.toBSON(), fromjson("{expireInInsertionOrder: true}"));
+}
+
+TEST(CollectionOptions, ExpireInInsertionOrderRejectedForCappedCollection) {
+    ASSERT_EQ(CollectionOptions::parse(
+                  fromjson("{capped: true, size: 4096, expireInInsertionOrder: true}"))
+                  .getStatus(),
+              ErrorCodes::InvalidOptions);
+}
+
 TEST(CollectionOptions, NExtentsNoError) {
     // Check that $nExtents does not cause an error for backwards compatability
     assertGet(CollectionOptions::parse(fromjson("{$nExtents: 'a'}")));
@@ -36,15 +36,24 @@
 #include <fmt/format.h>
 
 #include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/collection_validation_gen.h"
 #include "mongo/db/catalog/database_holder.h"
 #include "mongo/db/catalog/index_consistency.h"
+#include "mongo/db/catalog/throttle_cursor.h"
 #include "mongo/db/catalog/validate_adaptor.h"
+#include "mongo/db/client.h"
+#include "mongo/db/concurrency/d_concurrency.h"
+#include "mongo/db/concurrency/locker.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/index/index_access_method.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/storage/durable_catalog.h"
 #include "mongo/db/views/view_catalog.h"
 #include "mongo/logv2/log.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/fail_point.h"
 #include "mongo/util/scopeguard.h"
 
@@ -64,6 +73,13 @@ using ValidateResultsMap = std::map<string, ValidateResults>;
 // Indicates whether the failpoint turned on by testing has been reached.
 AtomicWord<bool> _validationIsPausedForTest{false};
 
+// The last record validated by the previous incremental validation of each collection, which the
+// next incremental validation resumes after. Collections are removed once fully validated. This is
+// not persisted, so incremental validations start over from the beginning after a restart.
+Mutex _incrementalCheckpointsMutex =
+    MONGO_MAKE_LATCH("CollectionValidation::_incrementalCheckpointsMutex");
+stdx::unordered_map<UUID, RecordId, UUID::Hash> _incrementalCheckpoints;
+
 /**
  * Validates the internal structure of each index in the Index Catalog 'indexCatalog', ensuring that
  * the index files have not been corrupted or compromised.
@@ -113,6 +129,53 @@ std::map<std::string, int64_t> _validateIndexesInternalStructure(
     return numIndexKeysPerIndex;
 }
 
+/**
+ * Reports the number of entries traversed in the index described by 'descriptor'. If we are
+ * performing a full index validation, we have information on the number of index keys validated in
+ * _validateIndexesInternalStructure (when we validated the internal structure of the index), so we
+ * also check that it is consistent with 'numTraversedKeys'.
+ */
+void _reportIndexTraversal(OperationContext* opCtx,
+                           ValidateState* validateState,
+                           const IndexDescriptor* descriptor,
+                           int64_t numTraversedKeys,
+                           const std::map<std::string, int64_t>& numIndexKeysPerIndex,
+                           BSONObjBuilder* keysPerIndex,
+                           ValidateResults* curIndexResults,
+                           ValidateResults* results) {
+    if (validateState->isFullIndexValidation()) {
+        invariant(opCtx->lockState()->isCollectionLockedForMode(validateState->nss(), MODE_X));
+
+        // Ensure that this index was validated in _validateIndexesInternalStructure.
+        const auto numIndexKeysIt = numIndexKeysPerIndex.find(descriptor->indexName());
+        invariant(numIndexKeysIt != numIndexKeysPerIndex.end());
+
+        // The number of keys counted in _validateIndexesInternalStructure, when checking the
+        // internal structure of the index.
+        const int64_t numIndexKeys = numIndexKeysIt->second;
+
+        // Check if currIndexResults is valid to ensure that this index is not corrupted or
+        // comprised (which was set in _validateIndexesInternalStructure). If the index is
+        // corrupted, there is no use in checking if the traversal yielded the same key count.
+        if (curIndexResults->valid) {
+            if (numIndexKeys != numTraversedKeys) {
+                curIndexResults->valid = false;
+                string msg = str::stream()
+                    << "number of traversed index entries (" << numTraversedKeys
+                    << ") does not match the number of expected index entries (" << numIndexKeys
+                    << ")";
+                results->errors.push_back(msg);
+                results->valid = false;
+            }
+        }
+    }
+
+    keysPerIndex->appendNumber(descriptor->indexName(), static_cast<long long>(numTraversedKeys));
+    if (!curIndexResults->valid) {
+        results->valid = false;
+    }
+}
+
 /**
  * Validates each index in the Index Catalog using the cursors in 'indexCursors'.
  *
@@ -142,42 +205,200 @@ void _validateIndexes(OperationContext* opCtx,
         int64_t numTraversedKeys;
         indexValidator->traverseIndex(opCtx, index.get(), &numTraversedKeys, &curIndexResults);
 
-        // If we are performing a full index validation, we have information on the number of index
-        // keys validated in _validateIndexesInternalStructure (when we validated the internal
-        // structure of the index). Check if this is consistent with 'numTraversedKeys' from
-        // traverseIndex above.
-        if (validateState->isFullIndexValidation()) {
-            invariant(opCtx->lockState()->isCollectionLockedForMode(validateState->nss(), MODE_X));
-
-            // Ensure that this index was validated in _validateIndexesInternalStructure.
-            const auto numIndexKeysIt = numIndexKeysPerIndex.find(descriptor->indexName());
-            invariant(numIndexKeysIt != numIndexKeysPerIndex.end());
-
-            // The number of keys counted in _validateIndexesInternalStructure, when checking the
-            // internal structure of the index.
-            const int64_t numIndexKeys = numIndexKeysIt->second;
-
-            // Check if currIndexResults is valid to ensure that this index is not corrupted or
-            // comprised (which was set in _validateIndexesInternalStructure). If the index is
-            // corrupted, there is no use in checking if the traversal yielded the same key count.
-            if (curIndexResults.valid) {
-                if (numIndexKeys != numTraversedKeys) {
-                    curIndexResults.valid = false;
-                    string msg = str::stream()
-                        << "number of traversed index entries (" << numTraversedKeys
-                        << ") does not match the number of expected index entries (" << numIndexKeys
-                        << ")";
-                    results->errors.push_back(msg);
-                    results->valid = false;
-                }
+        _reportIndexTraversal(opCtx,
+                              validateState,
+                              descriptor,
+                              numTraversedKeys,
+                              numIndexKeysPerIndex,
+                              keysPerIndex,
+                              &curIndexResults,
+                              results);
+    }
+}
+
+/**
+ * Traverses the record store and each index in the Index Catalog concurrently, on separate threads
+ * with their own cursors. This replaces the sequential traversals done by
+ * ValidateAdaptor::traverseRecordStore() and _validateIndexes() for foreground validation.
+ *
+ * Each worker takes the global lock in IS mode, under which the storage engine allows its cursors
+ * to be used, and otherwise relies on the exclusive collection lock held by 'opCtx' for the
+ * duration of the traversal. The workers are always joined before this returns. If 'opCtx' is
+ * interrupted, the worker operations are killed.
+ */
+void _traverseInParallel(OperationContext* opCtx,
+                         ValidateState* validateState,
+                         BSONObjBuilder* keysPerIndex,
+                         ValidateAdaptor* indexValidator,
+                         const std::map<std::string, int64_t>& numIndexKeysPerIndex,
+                         ValidateResultsMap* indexNsResultsMap,
+                         ValidateResults* results,
+                         BSONObjBuilder* output) {
+    invariant(opCtx->lockState()->isCollectionLockedForMode(validateState->nss(), MODE_X));
+
+    const auto& indexes = validateState->getIndexes();
+    const size_t numTasks = 1 + indexes.size();
+
+    // Each task only writes to its own slot, so that no synchronization is needed until the tasks
+    // are joined. The record store traversal also writes to 'indexNsResultsMap' through
+    // 'indexValidator', which is not otherwise accessed until then.
+    std::vector<Status> taskStatuses(numTasks, Status::OK());
+    ValidateResults recordStoreResults;
+    BSONObjBuilder recordStoreOutput;
+    std::vector<ValidateResults> indexResults(indexes.size());
+    std::vector<int64_t> numTraversedKeys(indexes.size(), 0);
+
+    auto mutex = MONGO_MAKE_LATCH("CollectionValidation::_traverseInParallel");
+    stdx::condition_variable tasksDone;
+    size_t numTasksDone = 0;
+    bool killed = false;
+    std::vector<OperationContext*> taskOpCtxs;
+
+    auto runTask = [&](size_t taskIndex,
+                       const std::function<void(OperationContext*, DataThrottle*)>& task) {
+        const ServiceContext::UniqueOperationContext taskOpCtx = cc().makeOperationContext();
+        if (opCtx->getDeadline() != Date_t::max()) {
+            taskOpCtx->setDeadlineByDate(opCtx->getDeadline(), opCtx->getTimeoutError());
+        }
+        // Like the validating operation, ignore prepare conflicts to avoid deadlocking.
+        taskOpCtx->recoveryUnit()->setPrepareConflictBehavior(
+            PrepareConflictBehavior::kIgnoreConflicts);
+
+        bool runnable;
+        {
+            stdx::lock_guard<Latch> lk(mutex);
+            runnable = !killed;
+            if (runnable) {
+                taskOpCtxs.push_back(taskOpCtx.get());
             }
         }
 
-        keysPerIndex->appendNumber(descriptor->indexName(),
-                                   static_cast<long long>(numTraversedKeys));
-        if (!curIndexResults.valid) {
-            results->valid = false;
+        if (runnable) {
+            try {
+                // A collection IS lock would conflict with the exclusive lock 'opCtx' holds, but
+                // the global IS lock is compatible with the intent locks it holds above the
+                // collection. Secondary batch application waits for 'opCtx' to finish, so it must
+                // not hold up the workers either.
+                ShouldNotConflictWithSecondaryBatchApplicationBlock noConflictBlock(
+                    taskOpCtx->lockState());
+                Lock::GlobalLock globalLock(taskOpCtx.get(), MODE_IS);
+
+                DataThrottle dataThrottle(taskOpCtx.get());
+                dataThrottle.turnThrottlingOff();
+                task(taskOpCtx.get(), &dataThrottle);
+            } catch (const DBException& ex) {
+                taskStatuses[taskIndex] = ex.toStatus();
+            }
+            taskOpCtx->recoveryUnit()->abandonSnapshot();
+        } else {
+            taskStatuses[taskIndex] =
+                Status(ErrorCodes::Interrupted, "Collection validation was interrupted");
         }
+
+        stdx::lock_guard<Latch> lk(mutex);
+        taskOpCtxs.erase(std::remove(taskOpCtxs.begin(), taskOpCtxs.end(), taskOpCtx.get()),
+                         taskOpCtxs.end());
+        ++numTasksDone;
+        tasksDone.notify_all();
+    };
+
+    ThreadPool::Options options;
+    options.poolName = "ParallelValidation";
+    options.threadNamePrefix = "ParallelValidation-";
+    options.minThreads = 0;
+    options.maxThreads = std::min<size_t>(numTasks, maxValidateParallelism.load());
+    options.onCreateThread = [](const std::string& threadName) {
+        Client::initThread(threadName.c_str());
+    };
+    ThreadPool pool(options);
+    pool.startup();
+
+    pool.schedule([&](Status status) {
+        runTask(0, [&](OperationContext* taskOpCtx, DataThrottle* dataThrottle) {
+            uassertStatusOK(status);
+            SeekableRecordThrottleCursor cursor(
+                taskOpCtx, validateState->getCollection()->getRecordStore(), dataThrottle);
+            indexValidator->traverseRecordStore(
+                taskOpCtx, &cursor, &recordStoreResults, &recordStoreOutput);
+        });
+    });
+    for (size_t i = 0; i < indexes.size(); ++i) {
+        pool.schedule([&, i](Status status) {
+            runTask(i + 1, [&](OperationContext* taskOpCtx, DataThrottle* dataThrottle) {
+                uassertStatusOK(status);
+                const IndexCatalogEntry* index = indexes[i].get();
+
+                LOGV2_OPTIONS(5600110,
+                              {LogComponent::kIndex},
+                              "Validating index consistency",
+                              "index"_attr = index->descriptor()->indexName(),
+                              "namespace"_attr = index->descriptor()->parentNS());
+
+                SortedDataInterfaceThrottleCursor cursor(
+                    taskOpCtx, index->accessMethod(), dataThrottle);
+                indexValidator->traverseIndex(
+                    taskOpCtx, index, &cursor, &numTraversedKeys[i], &indexResults[i]);
+            });
+        });
+    }
+
+    try {
+        stdx::unique_lock<Latch> lk(mutex);
+        opCtx->waitForConditionOrInterrupt(tasksDone, lk, [&] { return numTasksDone == numTasks; });
+    } catch (const DBException& ex) {
+        {
+            stdx::lock_guard<Latch> lk(mutex);
+            killed = true;
+            for (auto taskOpCtx : taskOpCtxs) {
+                stdx::lock_guard<Client> clientLock(*taskOpCtx->getClient());
+                taskOpCtx->getServiceContext()->killOperation(clientLock, taskOpCtx, ex.code());
+            }
+        }
+        pool.shutdown();
+        pool.join();
+        throw;
+    }
+    pool.shutdown();
+    pool.join();
+
+    for (const auto& status : taskStatuses) {
+        uassertStatusOK(status);
+    }
+
+    output->appendElements(recordStoreOutput.obj());
+    results->warnings.insert(results->warnings.end(),
+                             recordStoreResults.warnings.begin(),
+                             recordStoreResults.warnings.end());
+    results->errors.insert(
+        results->errors.end(), recordStoreResults.errors.begin(), recordStoreResults.errors.end());
+    if (!recordStoreResults.valid) {
+        results->valid = false;
+        return;
+    }
+
+    for (size_t i = 0; i < indexes.size(); ++i) {
+        const IndexDescriptor* descriptor = indexes[i]->descriptor();
+        ValidateResults& curIndexResults = (*indexNsResultsMap)[descriptor->indexName()];
+        curIndexResults.valid = curIndexResults.valid && indexResults[i].valid;
+        curIndexResults.warnings.insert(curIndexResults.warnings.end(),
+                                        indexResults[i].warnings.begin(),
+                                        indexResults[i].warnings.end());
+        curIndexResults.errors.insert(curIndexResults.errors.end(),
+                                      indexResults[i].errors.begin(),
+                                      indexResults[i].errors.end());
+
+        // The multikey metadata paths can only be compared once both the records and the index
+        // have been traversed.
+        indexValidator->validateMultikeyMetadataPaths(indexes[i].get(), &curIndexResults);
+
+        _reportIndexTraversal(opCtx,
+                              validateState,
+                              descriptor,
+                              numTraversedKeys[i],
+                              numIndexKeysPerIndex,
+                              keysPerIndex,
+                              &curIndexResults,
+                              results);
     }
 }
 
@@ -411,18 +632,25 @@ void _validateCatalogEntry(OperationContext* opCtx,
         }
     }
 }
-}  // namespace
 
-Status validate(OperationContext* opCtx,
-                const NamespaceString& nss,
-                ValidateOptions options,
-                bool background,
-                ValidateResults* results,
-                BSONObjBuilder* output,
-                bool turnOnExtraLoggingForTest) {
+/**
+ * Validates the collection 'nss'. If 'incrementalMaxRecords' is set, only validates that many
+ * records, and their index entries, after the checkpoint left by the previous incremental
+ * validation of the collection.
+ */
+Status _validate(OperationContext* opCtx,
+                 const NamespaceString& nss,
+                 ValidateOptions options,
+                 bool background,
+                 boost::optional<long long> incrementalMaxRecords,
+                 ValidateResults* results,
+                 BSONObjBuilder* output,
+                 bool turnOnExtraLoggingForTest) {
     invariant(!opCtx->lockState()->isLocked() || storageGlobalParams.repair);
-    // Background validation does not support any type of full validation.
+    // Background validation does not support any type of full validation, nor parallel traversal.
     invariant(!(background && (options != ValidateOptions::kNoFullValidation)));
+    // Incremental validation does not support any type of full validation, nor parallel traversal.
+    invariant(!(incrementalMaxRecords && (options != ValidateOptions::kNoFullValidation)));
 
     // This is deliberately outside of the try-catch block, so that any errors thrown in the
     // constructor fail the cmd, as opposed to returning OK with valid:false.
@@ -501,6 +729,18 @@ Status validate(OperationContext* opCtx,
         // Validate in-memory catalog information with persisted info.
         _validateCatalogEntry(opCtx, &validateState, results);
 
+        if (incrementalMaxRecords) {
+            RecordId resumeAfter;
+            {
+                stdx::lock_guard<Latch> lk(_incrementalCheckpointsMutex);
+                auto it = _incrementalCheckpoints.find(validateState.uuid());
+                if (it != _incrementalCheckpoints.end()) {
+                    resumeAfter = it->second;
+                }
+            }
+            validateState.setIncremental(resumeAfter, *incrementalMaxRecords);
+        }
+
         // Open all cursors at once before running non-full validation code so that all steps of
         // validation during background validation use the same view of the data.
         validateState.initializeCursors(opCtx);
@@ -515,10 +755,42 @@ Status validate(OperationContext* opCtx,
         IndexConsistency indexConsistency(opCtx, &validateState);
         ValidateAdaptor indexValidator(&indexConsistency, &validateState, &indexNsResultsMap);
 
-        // In traverseRecordStore(), the index validator keeps track the records in the record
-        // store so that _validateIndexes() can confirm that the index entries match the records in
-        // the collection.
-        indexValidator.traverseRecordStore(opCtx, results, output);
+        const bool parallel = (options & ValidateOptions::kParallel) &&
+            !validateState.isBackground() && !storageGlobalParams.repair;
+        if (parallel) {
+            _traverseInParallel(opCtx,
+                                &validateState,
+                                &keysPerIndex,
+                                &indexValidator,
+                                numIndexKeysPerIndex,
+                                &indexNsResultsMap,
+                                results,
+                                output);
+        } else {
+            // In traverseRecordStore(), the index validator keeps track the records in the record
+            // store so that _validateIndexes() can confirm that the index entries match the records
+            // in the collection.
+            indexValidator.traverseRecordStore(opCtx, results, output);
+        }
+
+        if (validateState.isIncremental()) {
+            {
+                stdx::lock_guard<Latch> lk(_incrementalCheckpointsMutex);
+                if (validateState.reachedEnd()) {
+                    _incrementalCheckpoints.erase(validateState.uuid());
+                } else {
+                    _incrementalCheckpoints[validateState.uuid()] =
+                        validateState.getLastRecordId();
+                }
+            }
+
+            BSONObjBuilder incremental(output->subobjStart("incremental"));
+            incremental.append("firstRecordId",
+                               static_cast<long long>(validateState.getFirstRecordId().repr()));
+            incremental.append("lastRecordId",
+                               static_cast<long long>(validateState.getLastRecordId().repr()));
+            incremental.append("complete", validateState.reachedEnd());
+        }
 
         // Pause collection validation while a lock is held and between collection and index data
         // validation.
@@ -550,13 +822,15 @@ Status validate(OperationContext* opCtx,
         }
 
         // Validate indexes and check for mismatches.
-        _validateIndexes(opCtx,
-                         &validateState,
-                         &keysPerIndex,
-                         &indexValidator,
-                         numIndexKeysPerIndex,
-                         &indexNsResultsMap,
-                         results);
+        if (!parallel) {
+            _validateIndexes(opCtx,
+                             &validateState,
+                             &keysPerIndex,
+                             &indexValidator,
+                             numIndexKeysPerIndex,
+                             &indexNsResultsMap,
+                             results);
+        }
 
         if (indexConsistency.haveEntryMismatch()) {
             LOGV2_OPTIONS(20305,
@@ -583,8 +857,11 @@ Status validate(OperationContext* opCtx,
             return Status::OK();
         }
 
-        // Validate index key count.
-        _validateIndexKeyCount(opCtx, &validateState, &indexValidator, &indexNsResultsMap);
+        // Validate index key count. The counts of an incremental validation only cover part of the
+        // collection.
+        if (!validateState.isIncremental()) {
+            _validateIndexKeyCount(opCtx, &validateState, &indexValidator, &indexNsResultsMap);
+        }
 
         if (!results->valid) {
             _reportInvalidResults(opCtx,
@@ -628,6 +905,42 @@ Status validate(OperationContext* opCtx,
 
     return Status::OK();
 }
+}  // namespace
+
+Status validate(OperationContext* opCtx,
+                const NamespaceString& nss,
+                ValidateOptions options,
+                bool background,
+                ValidateResults* results,
+                BSONObjBuilder* output,
+                bool turnOnExtraLoggingForTest) {
+    return _validate(opCtx,
+                     nss,
+                     options,
+                     background,
+                     boost::none,
+                     results,
+                     output,
+                     turnOnExtraLoggingForTest);
+}
+
+Status validateIncremental(OperationContext* opCtx,
+                           const NamespaceString& nss,
+                           long long maxRecords,
+                           bool background,
+                           ValidateResults* results,
+                           BSONObjBuilder* output,
+                           bool turnOnExtraLoggingForTest) {
+    invariant(maxRecords > 0);
+    return _validate(opCtx,
+                     nss,
+                     ValidateOptions::kNoFullValidation,
+                     background,
+                     maxRecords,
+                     results,
+                     output,
+                     turnOnExtraLoggingForTest);
+}
 
 bool getIsValidationPausedForTest() {
     return _validationIsPausedForTest.load();
@@ -53,12 +53,20 @@ enum class ValidateOptions {
     kFullIndexValidation = 1 << 1,
     // Includes all of the full validations above.
     kFullValidation = kFullRecordStoreValidation | kFullIndexValidation,
+
+    // If set, validate() traverses the record store and each index concurrently, on up to
+    // 'maxValidateParallelism' threads. Only supported for foreground validation.
+    kParallel = 1 << 2,
 };
 
 inline bool operator&(ValidateOptions lhs, ValidateOptions rhs) {
     return (static_cast<int>(lhs) & static_cast<int>(rhs)) != 0;
 }
 
+inline ValidateOptions operator|(ValidateOptions lhs, ValidateOptions rhs) {
+    return static_cast<ValidateOptions>(static_cast<int>(lhs) | static_cast<int>(rhs));
+}
+
 /**
  * Expects the caller to hold no locks.
  *
@@ -78,6 +86,23 @@ Status validate(OperationContext* opCtx,
                 BSONObjBuilder* output,
                 bool turnOnExtraLoggingForTest = false);
 
+/**
+ * Validates the next 'maxRecords' records of the collection, and the index entries which point at
+ * them, resuming after the last record validated by the previous incremental validation of the
+ * collection. Once the end of the collection is reached, the following incremental validation
+ * starts over from its beginning. The range validated is reported in 'output'.
+ *
+ * Checks which need the whole collection, such as comparing the number of index entries with the
+ * number of records, are not run. Expects the caller to hold no locks.
+ */
+Status validateIncremental(OperationContext* opCtx,
+                           const NamespaceString& nss,
+                           long long maxRecords,
+                           bool background,
+                           ValidateResults* results,
+                           BSONObjBuilder* output,
+                           bool turnOnExtraLoggingForTest = false);
+
 /**
  * Checks whether a failpoint has been hit in the above validate() code..
  */
@@ -33,7 +33,9 @@
 
 #include "mongo/db/catalog/catalog_test_fixture.h"
 #include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/db_raii.h"
+#include "mongo/db/index/index_descriptor.h"
 #include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/fail_point.h"
@@ -97,7 +99,10 @@ void foregroundValidate(
         CollectionValidation::ValidateOptions::kNoFullValidation,
         CollectionValidation::ValidateOptions::kFullRecordStoreValidation,
         CollectionValidation::ValidateOptions::kFullIndexValidation,
-        CollectionValidation::ValidateOptions::kFullValidation};
+        CollectionValidation::ValidateOptions::kFullValidation,
+        CollectionValidation::ValidateOptions::kParallel,
+        CollectionValidation::ValidateOptions::kFullValidation |
+            CollectionValidation::ValidateOptions::kParallel};
     for (auto options : optionsList) {
         ValidateResults validateResults;
         BSONObjBuilder output;
@@ -255,6 +260,78 @@ TEST_F(BackgroundCollectionValidationTest, BackgroundValidateError) {
                        /*runForegroundAsWell*/ true);
 }
 
+// Verify that successive incremental validations each validate the next range of records, and
+// start over from the beginning of the collection once it has been fully validated.
+TEST_F(CollectionValidationTest, ValidateIncremental) {
+    auto opCtx = operationContext();
+    insertDataRange(opCtx, 0, 10);
+
+    for (int pass = 0; pass < 2; ++pass) {
+        for (auto expected : std::vector<std::pair<int, bool>>{{4, false}, {4, false}, {2, true}}) {
+            ValidateResults validateResults;
+            BSONObjBuilder output;
+            ASSERT_OK(CollectionValidation::validateIncremental(opCtx,
+                                                                kNss,
+                                                                /*maxRecords*/ 4,
+                                                                /*background*/ false,
+                                                                &validateResults,
+                                                                &output));
+            ASSERT(validateResults.valid);
+            ASSERT_EQ(validateResults.errors.size(), 0U);
+
+            BSONObj obj = output.obj();
+            ASSERT_EQ(obj.getIntField("nrecords"), expected.first);
+            ASSERT_EQ(obj.getObjectField("incremental").getBoolField("complete"), expected.second);
+        }
+    }
+
+    // A full validation is unaffected by the incremental validations.
+    foregroundValidate(opCtx, /*valid*/ true, /*numRecords*/ 10, 0, 0);
+}
+
+// Verify that parallel validation traverses the record store and every index on the WT storage
+// engine, whose cursors may only be used under a read lock, and agrees with serial validation.
+TEST_F(BackgroundCollectionValidationTest, ValidateParallel) {
+    auto opCtx = operationContext();
+    {
+        AutoGetCollection autoColl(opCtx, kNss, MODE_X);
+        auto indexInfoObj = BSON("v" << int(IndexDescriptor::kLatestIndexVersion) << "key"
+                                     << BSON("a" << 1) << "name"
+                                     << "a_1");
+        WriteUnitOfWork wuow(opCtx);
+        ASSERT_OK(autoColl.getCollection()
+                      ->getIndexCatalog()
+                      ->createIndexOnEmptyCollection(opCtx, indexInfoObj)
+                      .getStatus());
+        wuow.commit();
+    }
+    int numRecords = insertDataRange(opCtx, 0, 100);
+
+    for (auto options : {CollectionValidation::ValidateOptions::kNoFullValidation,
+                         CollectionValidation::ValidateOptions::kFullValidation}) {
+        std::vector<BSONObj> keysPerIndex;
+        for (auto parallel : {CollectionValidation::ValidateOptions::kNoFullValidation,
+                              CollectionValidation::ValidateOptions::kParallel}) {
+            ValidateResults validateResults;
+            BSONObjBuilder output;
+            ASSERT_OK(CollectionValidation::validate(opCtx,
+                                                     kNss,
+                                                     options | parallel,
+                                                     /*background*/ false,
+                                                     &validateResults,
+                                                     &output));
+            ASSERT(validateResults.valid);
+            ASSERT_EQ(validateResults.errors.size(), 0U);
+
+            BSONObj obj = output.obj();
+            ASSERT_EQ(obj.getIntField("nrecords"), numRecords);
+            ASSERT_EQ(obj.getIntField("nIndexes"), 2);
+            keysPerIndex.push_back(obj.getObjectField("keysPerIndex").getOwned());
+        }
+        ASSERT_BSONOBJ_EQ(keysPerIndex[0], keysPerIndex[1]);
+    }
+}
+
 /**
  * Waits for a parallel running collection validation operation to start and then hang at a
  * failpoint.
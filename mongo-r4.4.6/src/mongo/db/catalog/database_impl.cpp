@@ -946,6 +946,16 @@ Status DatabaseImpl::userCreateNS(OperationContext* opCtx,
         }
     }
 
+    // The TTL monitor removes the expired documents of such a collection as a range, which is
+    // written at a single timestamp and so cannot be replicated as separate deletes.
+    if (collectionOptions.expireInInsertionOrder &&
+        !repl::ReplicationCoordinator::get(opCtx)->isOplogDisabledFor(opCtx, nss)) {
+        return Status(ErrorCodes::InvalidOptions,
+                      str::stream() << "'expireInInsertionOrder' can only be specified for a "
+                                       "collection whose writes are not replicated: "
+                                    << nss);
+    }
+
     Status status = validateStorageOptions(
         opCtx->getServiceContext(),
         collectionOptions.storageEngine,
@@ -76,8 +76,7 @@ IndexInfo::IndexInfo(const IndexDescriptor* descriptor)
 
 IndexConsistency::IndexConsistency(OperationContext* opCtx,
                                    CollectionValidation::ValidateState* validateState)
-    : _validateState(validateState), _firstPhase(true) {
-    _indexKeyCount.resize(kNumHashBuckets);
+    : _validateState(validateState), _indexKeyCount(kNumHashBuckets), _firstPhase(true) {
 
     for (const auto& index : _validateState->getIndexes()) {
         const IndexDescriptor* descriptor = index->descriptor();
@@ -91,16 +90,22 @@ void IndexConsistency::addMultikeyMetadataPath(const KeyString::Value& ks, Index
 
 void IndexConsistency::removeMultikeyMetadataPath(const KeyString::Value& ks,
                                                   IndexInfo* indexInfo) {
-    indexInfo->hashedMultikeyMetadataPaths.erase(_hashKeyString(ks, indexInfo->indexNameHash));
+    indexInfo->hashedIndexMultikeyMetadataPaths.emplace(
+        _hashKeyString(ks, indexInfo->indexNameHash));
 }
 
 size_t IndexConsistency::getMultikeyMetadataPathCount(IndexInfo* indexInfo) {
-    return indexInfo->hashedMultikeyMetadataPaths.size();
+    return std::count_if(indexInfo->hashedMultikeyMetadataPaths.begin(),
+                         indexInfo->hashedMultikeyMetadataPaths.end(),
+                         [&](uint32_t path) {
+                             return !indexInfo->hashedIndexMultikeyMetadataPaths.count(path);
+                         });
 }
 
 bool IndexConsistency::haveEntryMismatch() const {
-    return std::any_of(
-        _indexKeyCount.begin(), _indexKeyCount.end(), [](int count) -> bool { return count; });
+    return std::any_of(_indexKeyCount.begin(),
+                       _indexKeyCount.end(),
+                       [](const AtomicWord<uint32_t>& count) -> bool { return count.load(); });
 }
 
 void IndexConsistency::setSecondPhase() {
@@ -206,7 +211,7 @@ void IndexConsistency::addDocKey(OperationContext* opCtx,
     if (_firstPhase) {
         // During the first phase of validation we only keep track of the count for the document
         // keys encountered.
-        _indexKeyCount[hash]++;
+        _indexKeyCount[hash].fetchAndAdd(1);
         indexInfo->numRecords++;
 
         if (MONGO_unlikely(_validateState->extraLoggingForTest())) {
@@ -217,7 +222,7 @@ void IndexConsistency::addDocKey(OperationContext* opCtx,
             StorageDebugUtil::printKeyString(
                 recordId, ks, keyPatternBson, keyStringBson, "[validate](record)");
         }
-    } else if (_indexKeyCount[hash]) {
+    } else if (_indexKeyCount[hash].load()) {
         // Found a document key for a hash bucket that had mismatches.
 
         // Get the documents _id index key.
@@ -249,7 +254,7 @@ void IndexConsistency::addIndexKey(const KeyString::Value& ks,
     if (_firstPhase) {
         // During the first phase of validation we only keep track of the count for the index entry
         // keys encountered.
-        _indexKeyCount[hash]--;
+        _indexKeyCount[hash].fetchAndSubtract(1);
         indexInfo->numKeys++;
 
         if (MONGO_unlikely(_validateState->extraLoggingForTest())) {
@@ -260,7 +265,7 @@ void IndexConsistency::addIndexKey(const KeyString::Value& ks,
             StorageDebugUtil::printKeyString(
                 recordId, ks, keyPatternBson, keyStringBson, "[validate](index)");
         }
-    } else if (_indexKeyCount[hash]) {
+    } else if (_indexKeyCount[hash].load()) {
         // Found an index key for a bucket that has inconsistencies.
         // If there is a corresponding document key for the index entry key, we remove the key from
         // the '_missingIndexEntries' map. However if there was no document key for the index entry
@@ -32,6 +32,7 @@
 #include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/db/catalog/validate_state.h"
 #include "mongo/db/storage/key_string.h"
+#include "mongo/platform/atomic_word.h"
 
 namespace mongo {
 
@@ -57,6 +58,10 @@ struct IndexInfo {
     int64_t numRecords = 0;
     // A hashed set of indexed multikey paths (applies to $** indexes only).
     std::set<uint32_t> hashedMultikeyMetadataPaths;
+    // A hashed set of the multikey paths found in the index's multikey metadata entries (applies to
+    // $** indexes only). Kept apart from 'hashedMultikeyMetadataPaths' so that the records and the
+    // index can be traversed concurrently.
+    std::set<uint32_t> hashedIndexMultikeyMetadataPaths;
 };
 
 /**
@@ -65,6 +70,10 @@ struct IndexInfo {
  * document to ensure there is a one-to-one mapping for each key.
  * In addition, an IndexObserver class can be hooked into the IndexAccessMethod to inform
  * this class about changes to the indexes during a validation and compensate for them.
+ *
+ * During the first phase of validation, the record store and each index may be traversed on
+ * separate threads: the hash buckets are updated atomically, and each IndexInfo field is only
+ * updated by one traversal.
  */
 class IndexConsistency final {
     using IndexInfoMap = std::map<std::string, IndexInfo>;
@@ -94,10 +103,11 @@ public:
     void addIndexKey(const KeyString::Value& ks, IndexInfo* indexInfo, RecordId recordId);
 
     /**
-     * To validate $** multikey metadata paths, we first scan the collection and add a hash of all
-     * multikey paths encountered to a set. We then scan the index for multikey metadata path
-     * entries and remove any path encountered. As we expect the index to contain a super-set of
-     * the collection paths, a non-empty set represents an invalid index.
+     * To validate $** multikey metadata paths, we scan the collection and add a hash of all
+     * multikey paths encountered to a set. We also scan the index for multikey metadata path
+     * entries and add any path encountered to a second set. As we expect the index to contain a
+     * super-set of the collection paths, a collection path missing from the index's set represents
+     * an invalid index.
      */
     void addMultikeyMetadataPath(const KeyString::Value& ks, IndexInfo* indexInfo);
     void removeMultikeyMetadataPath(const KeyString::Value& ks, IndexInfo* indexInfo);
@@ -147,7 +157,7 @@ private:
     //       than zero, there are too few index entries.
     //     - Similarly, if that count ends up less than zero, there are too many index entries.
 
-    std::vector<uint32_t> _indexKeyCount;
+    std::vector<AtomicWord<uint32_t>> _indexKeyCount;
 
     // A vector of IndexInfo indexes by index number
     IndexInfoMap _indexesInfo;
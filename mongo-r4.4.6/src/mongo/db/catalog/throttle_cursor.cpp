@@ -60,6 +60,17 @@ boost::optional<Record> SeekableRecordThrottleCursor::seekExact(OperationContext
     return record;
 }
 
+boost::optional<Record> SeekableRecordThrottleCursor::seekAfter(OperationContext* opCtx,
+                                                                const RecordId& id) {
+    boost::optional<Record> record = _cursor->seekAfter(id);
+    if (record) {
+        const int64_t dataSize = record->data.size() + sizeof(record->id.repr());
+        _dataThrottle->awaitIfNeeded(opCtx, dataSize);
+    }
+
+    return record;
+}
+
 boost::optional<Record> SeekableRecordThrottleCursor::next(OperationContext* opCtx) {
     boost::optional<Record> record = _cursor->next();
     if (record) {
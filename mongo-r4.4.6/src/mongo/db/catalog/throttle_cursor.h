@@ -55,6 +55,8 @@ public:
 
     boost::optional<Record> seekExact(OperationContext* opCtx, const RecordId& id);
 
+    boost::optional<Record> seekAfter(OperationContext* opCtx, const RecordId& id);
+
     boost::optional<Record> next(OperationContext* opCtx);
 
     void save() {
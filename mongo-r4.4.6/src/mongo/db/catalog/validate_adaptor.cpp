@@ -213,13 +213,6 @@ void ValidateAdaptor::traverseIndex(OperationContext* opCtx,
                                     const IndexCatalogEntry* index,
                                     int64_t* numTraversedKeys,
                                     ValidateResults* results) {
-    const IndexDescriptor* descriptor = index->descriptor();
-    auto indexName = descriptor->indexName();
-    IndexInfo& indexInfo = _indexConsistency->getIndexInfo(indexName);
-    int64_t numKeys = 0;
-
-    bool isFirstEntry = true;
-
     // The progress meter will be inactive after traversing the record store to allow the message
     // and the total to be set to different values.
     if (!_progress->isActive()) {
@@ -228,6 +221,68 @@ void ValidateAdaptor::traverseIndex(OperationContext* opCtx,
         _progress.set(CurOp::get(opCtx)->setProgress_inlock(curopMessage, _totalIndexKeys));
     }
 
+    // Ensure that this index has an open index cursor.
+    const auto indexCursorIt =
+        _validateState->getIndexCursors().find(index->descriptor()->indexName());
+    invariant(indexCursorIt != _validateState->getIndexCursors().end());
+
+    _traverseIndex(opCtx,
+                   index,
+                   indexCursorIt->second.get(),
+                   [&] { _validateState->yield(opCtx); },
+                   /*reportProgress=*/true,
+                   numTraversedKeys,
+                   results);
+
+    if (results) {
+        validateMultikeyMetadataPaths(index, results);
+    }
+}
+
+void ValidateAdaptor::traverseIndex(OperationContext* opCtx,
+                                    const IndexCatalogEntry* index,
+                                    SortedDataInterfaceThrottleCursor* cursor,
+                                    int64_t* numTraversedKeys,
+                                    ValidateResults* results) {
+    _traverseIndex(opCtx,
+                   index,
+                   cursor,
+                   [&] {
+                       cursor->save();
+                       cursor->restore();
+                   },
+                   /*reportProgress=*/false,
+                   numTraversedKeys,
+                   results);
+}
+
+void ValidateAdaptor::validateMultikeyMetadataPaths(const IndexCatalogEntry* index,
+                                                    ValidateResults* results) {
+    const IndexDescriptor* descriptor = index->descriptor();
+    IndexInfo& indexInfo = _indexConsistency->getIndexInfo(descriptor->indexName());
+    if (_indexConsistency->getMultikeyMetadataPathCount(&indexInfo) > 0) {
+        results->errors.push_back(str::stream()
+                                  << "Index '" << descriptor->indexName()
+                                  << "' has one or more missing multikey metadata index keys");
+        results->valid = false;
+    }
+}
+
+void ValidateAdaptor::_traverseIndex(OperationContext* opCtx,
+                                     const IndexCatalogEntry* index,
+                                     SortedDataInterfaceThrottleCursor* indexCursor,
+                                     const std::function<void()>& yield,
+                                     bool reportProgress,
+                                     int64_t* numTraversedKeys,
+                                     ValidateResults* results) {
+    const IndexDescriptor* descriptor = index->descriptor();
+    auto indexName = descriptor->indexName();
+    IndexInfo& indexInfo = _indexConsistency->getIndexInfo(indexName);
+    int64_t numKeys = 0;
+    int64_t numKeysSinceYield = 0;
+
+    bool isFirstEntry = true;
+
     const KeyString::Version version =
         index->accessMethod()->getSortedDataInterface()->getKeyStringVersion();
     KeyString::Builder firstKeyString(
@@ -235,11 +290,6 @@ void ValidateAdaptor::traverseIndex(OperationContext* opCtx,
 
     KeyString::Value prevIndexKeyStringValue;
 
-    // Ensure that this index has an open index cursor.
-    const auto indexCursorIt = _validateState->getIndexCursors().find(indexName);
-    invariant(indexCursorIt != _validateState->getIndexCursors().end());
-
-    const std::unique_ptr<SortedDataInterfaceThrottleCursor>& indexCursor = indexCursorIt->second;
     for (auto indexEntry = indexCursor->seekForKeyString(opCtx, firstKeyString.getValueCopy());
          indexEntry;
          indexEntry = indexCursor->nextKeyString(opCtx)) {
@@ -254,10 +304,25 @@ void ValidateAdaptor::traverseIndex(OperationContext* opCtx,
         if (descriptor->getIndexType() == IndexType::INDEX_WILDCARD &&
             indexEntry->loc == kWildcardMultikeyMetadataRecordId) {
             _indexConsistency->removeMultikeyMetadataPath(indexEntry->keyString, &indexInfo);
-            _progress->hit();
+            if (reportProgress) {
+                _progress->hit();
+            }
             numKeys++;
             continue;
         }
+
+        // An incremental validation only checks the index entries of the records it validates,
+        // but still checks the order of every entry.
+        if (!_validateState->isInRecordIdRange(indexEntry->loc)) {
+            isFirstEntry = false;
+            prevIndexKeyStringValue = indexEntry->keyString;
+            if (++numKeysSinceYield % kInterruptIntervalNumRecords == 0) {
+                opCtx->checkForInterrupt();
+                yield();
+            }
+            continue;
+        }
+
         try {
             _indexConsistency->addIndexKey(indexEntry->keyString, &indexInfo, indexEntry->loc);
         } catch (const DBException& e) {
@@ -269,25 +334,20 @@ void ValidateAdaptor::traverseIndex(OperationContext* opCtx,
             continue;
         }
 
-        _progress->hit();
+        if (reportProgress) {
+            _progress->hit();
+        }
         numKeys++;
         isFirstEntry = false;
         prevIndexKeyStringValue = indexEntry->keyString;
 
-        if (numKeys % kInterruptIntervalNumRecords == 0) {
+        if (++numKeysSinceYield % kInterruptIntervalNumRecords == 0) {
             // Periodically checks for interrupts and yields.
             opCtx->checkForInterrupt();
-            _validateState->yield(opCtx);
+            yield();
         }
     }
 
-    if (results && _indexConsistency->getMultikeyMetadataPathCount(&indexInfo) > 0) {
-        results->errors.push_back(str::stream()
-                                  << "Index '" << descriptor->indexName()
-                                  << "' has one or more missing multikey metadata index keys");
-        results->valid = false;
-    }
-
     if (numTraversedKeys) {
         *numTraversedKeys = numKeys;
     }
@@ -296,14 +356,6 @@ void ValidateAdaptor::traverseIndex(OperationContext* opCtx,
 void ValidateAdaptor::traverseRecordStore(OperationContext* opCtx,
                                           ValidateResults* results,
                                           BSONObjBuilder* output) {
-    _numRecords = 0;  // need to reset it because this function can be called more than once.
-    long long dataSizeTotal = 0;
-    long long interruptIntervalNumBytes = 0;
-    long long nInvalid = 0;
-
-    results->valid = true;
-    RecordId prevRecordId;
-
     // In case validation occurs twice and the progress meter persists after index traversal
     if (_progress.get() && _progress->isActive()) {
         _progress->finished();
@@ -312,19 +364,68 @@ void ValidateAdaptor::traverseRecordStore(OperationContext* opCtx,
     // Because the progress meter is intended as an approximation, it's sufficient to get the number
     // of records when we begin traversing, even if this number may deviate from the final number.
     const char* curopMessage = "Validate: scanning documents";
-    const auto totalRecords = _validateState->getCollection()->getRecordStore()->numRecords(opCtx);
+    const auto totalRecords = _validateState->isIncremental()
+        ? _validateState->getIncrementalMaxRecords()
+        : _validateState->getCollection()->getRecordStore()->numRecords(opCtx);
     {
         stdx::unique_lock<Client> lk(*opCtx->getClient());
         _progress.set(CurOp::get(opCtx)->setProgress_inlock(curopMessage, totalRecords));
     }
 
-    const std::unique_ptr<SeekableRecordThrottleCursor>& traverseRecordStoreCursor =
-        _validateState->getTraverseRecordStoreCursor();
+    _traverseRecordStore(opCtx,
+                         _validateState->getTraverseRecordStoreCursor().get(),
+                         [&] { _validateState->yield(opCtx); },
+                         /*reportProgress=*/true,
+                         results,
+                         output);
+}
+
+void ValidateAdaptor::traverseRecordStore(OperationContext* opCtx,
+                                          SeekableRecordThrottleCursor* cursor,
+                                          ValidateResults* results,
+                                          BSONObjBuilder* output) {
+    _traverseRecordStore(opCtx,
+                         cursor,
+                         [&] {
+                             cursor->save();
+                             uassert(ErrorCodes::Interrupted,
+                                     "Interrupted due to: failure to restore yielded traverse "
+                                     "cursor",
+                                     cursor->restore());
+                         },
+                         /*reportProgress=*/false,
+                         results,
+                         output);
+}
+
+void ValidateAdaptor::_traverseRecordStore(OperationContext* opCtx,
+                                           SeekableRecordThrottleCursor* traverseRecordStoreCursor,
+                                           const std::function<void()>& yield,
+                                           bool reportProgress,
+                                           ValidateResults* results,
+                                           BSONObjBuilder* output) {
+    _numRecords = 0;  // need to reset it because this function can be called more than once.
+    long long dataSizeTotal = 0;
+    long long interruptIntervalNumBytes = 0;
+    long long nInvalid = 0;
+
+    results->valid = true;
+    RecordId prevRecordId;
+    bool reachedEnd = true;
+
     for (auto record =
              traverseRecordStoreCursor->seekExact(opCtx, _validateState->getFirstRecordId());
          record;
          record = traverseRecordStoreCursor->next(opCtx)) {
-        _progress->hit();
+        if (_validateState->isIncremental() &&
+            _numRecords == _validateState->getIncrementalMaxRecords()) {
+            reachedEnd = false;
+            break;
+        }
+
+        if (reportProgress) {
+            _progress->hit();
+        }
         ++_numRecords;
         auto dataSize = record->data.size();
         interruptIntervalNumBytes += dataSize;
@@ -375,7 +476,7 @@ void ValidateAdaptor::traverseRecordStore(OperationContext* opCtx,
             interruptIntervalNumBytes >= kInterruptIntervalNumBytes) {
             // Periodically checks for interrupts and yields.
             opCtx->checkForInterrupt();
-            _validateState->yield(opCtx);
+            yield();
 
             if (interruptIntervalNumBytes >= kInterruptIntervalNumBytes) {
                 interruptIntervalNumBytes = 0;
@@ -383,14 +484,21 @@ void ValidateAdaptor::traverseRecordStore(OperationContext* opCtx,
         }
     }
 
+    if (_validateState->isIncremental()) {
+        _validateState->setLastRecordId(prevRecordId, reachedEnd);
+    }
+
     // Do not update the record store stats if we're in the background as we've validated a
-    // checkpoint and it may not have the most up-to-date changes.
-    if (results->valid && !_validateState->isBackground()) {
+    // checkpoint and it may not have the most up-to-date changes, or if we've only validated part
+    // of the collection.
+    if (results->valid && !_validateState->isBackground() && !_validateState->isIncremental()) {
         _validateState->getCollection()->getRecordStore()->updateStatsAfterRepair(
             opCtx, _numRecords, dataSizeTotal);
     }
 
-    _progress->finished();
+    if (reportProgress) {
+        _progress->finished();
+    }
 
     output->appendNumber("nInvalidDocuments", nInvalid);
     output->appendNumber("nrecords", _numRecords);
@@ -29,6 +29,8 @@
 
 #pragma once
 
+#include <functional>
+
 #include "mongo/db/catalog/validate_state.h"
 #include "mongo/util/progress_meter.h"
 
@@ -80,6 +82,30 @@ public:
                              ValidateResults* results,
                              BSONObjBuilder* output);
 
+    /**
+     * Variants of traverseIndex() and traverseRecordStore() for parallel validation, where the
+     * record store and each index are traversed concurrently on separate threads. Each reads
+     * through 'cursor', opened on the calling thread's 'opCtx', yields only that cursor, and does
+     * not report progress. The record store traversal is the only one which may modify the
+     * ValidateResultsMap, so each index traversal must be given its own 'results'.
+     */
+    void traverseIndex(OperationContext* opCtx,
+                       const IndexCatalogEntry* index,
+                       SortedDataInterfaceThrottleCursor* cursor,
+                       int64_t* numTraversedKeys,
+                       ValidateResults* results);
+    void traverseRecordStore(OperationContext* opCtx,
+                             SeekableRecordThrottleCursor* cursor,
+                             ValidateResults* results,
+                             BSONObjBuilder* output);
+
+    /**
+     * Validates that a $** index has a multikey metadata entry for every multikey path of the
+     * documents traversed. Must be called after both the record store and the index have been
+     * traversed.
+     */
+    void validateMultikeyMetadataPaths(const IndexCatalogEntry* index, ValidateResults* results);
+
     /**
      * Validates that the number of document keys matches the number of index keys previously
      * traversed in traverseIndex().
@@ -87,6 +113,21 @@ public:
     void validateIndexKeyCount(const IndexDescriptor* idx, ValidateResults& results);
 
 private:
+    void _traverseIndex(OperationContext* opCtx,
+                        const IndexCatalogEntry* index,
+                        SortedDataInterfaceThrottleCursor* cursor,
+                        const std::function<void()>& yield,
+                        bool reportProgress,
+                        int64_t* numTraversedKeys,
+                        ValidateResults* results);
+
+    void _traverseRecordStore(OperationContext* opCtx,
+                              SeekableRecordThrottleCursor* cursor,
+                              const std::function<void()>& yield,
+                              bool reportProgress,
+                              ValidateResults* results,
+                              BSONObjBuilder* output);
+
     IndexConsistency* _indexConsistency;
     CollectionValidation::ValidateState* _validateState;
     ValidateResultsMap* _indexNsResultsMap;
@@ -236,7 +236,12 @@ void ValidateState::initializeCursors(OperationContext* opCtx) {
     // use cursor->next() to get subsequent Records. However, if the Record Store is empty,
     // there is no first record. In this case, we set the first Record Id to an invalid RecordId
     // (RecordId()), which will halt iteration at the initialization step.
-    const boost::optional<Record> record = _traverseRecordStoreCursor->next(opCtx);
+    //
+    // An incremental validation instead starts at the first record after the one at which the
+    // previous incremental validation stopped.
+    const boost::optional<Record> record = _incrementalResumeAfter.isNull()
+        ? _traverseRecordStoreCursor->next(opCtx)
+        : _traverseRecordStoreCursor->seekAfter(opCtx, _incrementalResumeAfter);
     _firstRecordId = record ? record->id : RecordId();
 }
 
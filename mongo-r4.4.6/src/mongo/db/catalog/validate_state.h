@@ -120,6 +120,49 @@ public:
         return _firstRecordId;
     }
 
+    /**
+     * Limits the validation to the first 'maxRecords' records after 'resumeAfter', or after the
+     * start of the collection if 'resumeAfter' is null. Must be called before initializeCursors().
+     */
+    void setIncremental(RecordId resumeAfter, long long maxRecords) {
+        invariant(!_traverseRecordStoreCursor);
+        invariant(maxRecords > 0);
+        _incrementalResumeAfter = resumeAfter;
+        _incrementalMaxRecords = maxRecords;
+    }
+
+    bool isIncremental() const {
+        return _incrementalMaxRecords > 0;
+    }
+
+    long long getIncrementalMaxRecords() const {
+        return _incrementalMaxRecords;
+    }
+
+    /**
+     * The last record of an incremental validation, set by the record store traversal, and whether
+     * it is the last record of the collection.
+     */
+    void setLastRecordId(RecordId lastRecordId, bool reachedEnd) {
+        _lastRecordId = lastRecordId;
+        _reachedEnd = reachedEnd;
+    }
+
+    RecordId getLastRecordId() const {
+        return _lastRecordId;
+    }
+
+    bool reachedEnd() const {
+        return _reachedEnd;
+    }
+
+    /**
+     * Whether the record 'id' is one of the records being validated.
+     */
+    bool isInRecordIdRange(const RecordId& id) const {
+        return !isIncremental() || (id >= _firstRecordId && id <= _lastRecordId);
+    }
+
     /**
      * Yields locks for background validation; or cursors for foreground validation. Locks are
      * yielded to allow DDL ops to run concurrently with background validation. Cursors are yielded
@@ -210,6 +253,13 @@ private:
 
     RecordId _firstRecordId;
 
+    // The range of records to validate for an incremental validation. '_incrementalMaxRecords' is
+    // 0 for a validation of the whole collection.
+    RecordId _incrementalResumeAfter;
+    long long _incrementalMaxRecords = 0;
+    RecordId _lastRecordId;
+    bool _reachedEnd = false;
+
     DataThrottle _dataThrottle;
 
     // Used to detect when the catalog is re-opened while yielding locks.
@@ -0,0 +1,82 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/commands/server_status.h"
+#include "mongo/db/pipeline/change_stream_shared_reader.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/service_context.h"
+
+namespace mongo {
+namespace {
+
+class ChangeStreamSharedReadersServerStatus final : public ServerStatusSection {
+public:
+    ChangeStreamSharedReadersServerStatus() : ServerStatusSection("changeStreamSharedReaders") {}
+
+    bool includeByDefault() const override {
+        return internalChangeStreamUseSharedReaders.load();
+    }
+
+    BSONObj generateSection(OperationContext* opCtx,
+                            const BSONElement& configElement) const override {
+        auto stats = SharedChangeStreamReaderRegistry::get(opCtx->getServiceContext()).getStats();
+
+        long long subscribers = 0;
+        BSONObjBuilder section;
+        BSONArrayBuilder readers(section.subarrayStart("readers"));
+        for (const auto& reader : stats) {
+            subscribers += reader.subscribers;
+
+            BSONObjBuilder readerBob(readers.subobjStart());
+            readerBob.append("ns", reader.nss.ns());
+            readerBob.append("startedAt", reader.startedAt);
+            readerBob.append("latestOplogTimestamp", reader.latestOplogTimestamp);
+            readerBob.appendNumber("subscribers", static_cast<long long>(reader.subscribers));
+            readerBob.appendNumber("bufferedEvents", static_cast<long long>(reader.bufferedEvents));
+            readerBob.appendNumber("bufferedBytes", static_cast<long long>(reader.bufferedBytes));
+            readerBob.appendNumber("maxLagEvents", static_cast<long long>(reader.maxLagEvents));
+            readerBob.appendNumber("maxLagSecs", reader.maxLagSecs);
+            readerBob.appendNumber("eventsRead", reader.eventsRead);
+            readerBob.appendNumber("eventsDelivered", reader.eventsDelivered);
+            readerBob.appendNumber("subscribersFellBehind", reader.subscribersFellBehind);
+        }
+        readers.doneFast();
+
+        section.appendNumber("numReaders", static_cast<long long>(stats.size()));
+        section.appendNumber("numSubscribers", subscribers);
+        return section.obj();
+    }
+
+} changeStreamSharedReadersServerStatus;
+
+}  // namespace
+}  // namespace mongo
@@ -74,10 +74,13 @@ public:
         return "compact collection\n"
                "warning: this operation locks the database and is slow. you can cancel with "
                "killOp()\n"
-               "{ compact : <collection_name>, [force:<bool>], [validate:<bool>] }\n"
+               "{ compact : <collection_name>, [force:<bool>], [validate:<bool>], "
+               "[online:<bool>] }\n"
                "  force - allows to run on a replica set primary\n"
                "  validate - check records are noncorrupt before adding to newly compacting "
-               "extents. slower but safer (defaults to true in this version)\n";
+               "extents. slower but safer (defaults to true in this version)\n"
+               "  online - compact in throttled chunks, yielding locks between chunks, so that "
+               "writes are not blocked. allowed on a replica set primary without force\n";
     }
     CompactCmd() : ErrmsgCommandDeprecated("compact") {}
 
@@ -88,8 +91,10 @@ public:
                            BSONObjBuilder& result) {
         NamespaceString nss = CommandHelpers::parseNsCollectionRequired(db, cmdObj);
 
+        const bool online = cmdObj["online"].trueValue();
+
         repl::ReplicationCoordinator* replCoord = repl::ReplicationCoordinator::get(opCtx);
-        if (replCoord->getMemberState().primary() && !cmdObj["force"].trueValue()) {
+        if (replCoord->getMemberState().primary() && !cmdObj["force"].trueValue() && !online) {
             errmsg =
                 "will not run compact on an active replica set primary as this is a slow blocking "
                 "operation. use force:true to force";
@@ -102,7 +107,8 @@ public:
             return false;
         }
 
-        StatusWith<int64_t> status = compactCollection(opCtx, nss);
+        StatusWith<int64_t> status =
+            online ? compactCollectionOnline(opCtx, nss) : compactCollection(opCtx, nss);
         uassertStatusOK(status.getStatus());
         result.appendNumber("bytesFreed", static_cast<long long>(status.getValue()));
 
@@ -47,11 +47,13 @@
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/pipeline/accumulator.h"
+#include "mongo/db/pipeline/change_stream_shared_reader.h"
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_exchange.h"
 #include "mongo/db/pipeline/document_source_geo_near.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/pipeline/parallel_aggregation.h"
 #include "mongo/db/pipeline/pipeline.h"
 #include "mongo/db/pipeline/pipeline_d.h"
 #include "mongo/db/pipeline/process_interface/mongo_process_interface.h"
@@ -715,8 +717,13 @@ Status runAggregate(OperationContext* opCtx,
             // regardless of what the user's collation was.
             std::unique_ptr<CollatorInterface> collatorForCursor = nullptr;
             auto collatorStash = expCtx->temporarilyChangeCollator(std::move(collatorForCursor));
-            attachExecutorCallback =
-                PipelineD::buildInnerQueryExecutor(collection, nss, &request, pipeline.get());
+            // A change stream which shares its oplog reader with others on the same namespace
+            // takes its input from that reader, and needs no $cursor stage of its own.
+            if (!change_stream_shared_reader::attachIfEligible(
+                    collection, request, pipeline.get())) {
+                attachExecutorCallback =
+                    PipelineD::buildInnerQueryExecutor(collection, nss, &request, pipeline.get());
+            }
         } else {
             attachExecutorCallback =
                 PipelineD::buildInnerQueryExecutor(collection, nss, &request, pipeline.get());
@@ -740,6 +747,11 @@ Status runAggregate(OperationContext* opCtx,
                                                           std::move(attachExecutorCallback.second),
                                                           pipeline.get());
 
+            // Spread the stages up to and including a partial $group over several threads, if the
+            // pipeline is eligible.
+            pipeline = parallel_aggregation::parallelizeIfEligible(
+                collection, request, std::move(pipeline));
+
             auto pipelines =
                 createExchangePipelinesIfNeeded(opCtx, expCtx, request, std::move(pipeline), uuid);
             for (auto&& pipelineIt : pipelines) {
@@ -38,6 +38,8 @@
 #include "mongo/db/service_context.h"
 #include "mongo/db/stats/counters.h"
 #include "mongo/logv2/log.h"
+#include "mongo/logv2/log_domain_global.h"
+#include "mongo/logv2/log_manager.h"
 #include "mongo/util/net/http_client.h"
 #include "mongo/util/net/socket_utils.h"
 #include "mongo/util/version.h"
@@ -176,6 +178,21 @@ public:
         _sections[section->getSectionName()] = section;
     }
 
+    void appendSections(OperationContext* opCtx,
+                        const std::vector<std::string>& sectionNames,
+                        BSONObjBuilder* result) {
+        _runCalled = true;
+
+        for (const auto& sectionName : sectionNames) {
+            auto it = _sections.find(sectionName);
+            if (it == _sections.end()) {
+                continue;
+            }
+
+            it->second->appendSection(opCtx, BSONElement(), result);
+        }
+    }
+
 private:
     const Date_t _started;
     bool _runCalled;
@@ -206,6 +223,12 @@ ServerStatusSection::ServerStatusSection(const string& sectionName) : _sectionNa
     CmdServerStatusInstantiator::getInstance().addSection(this);
 }
 
+void appendServerStatusSections(OperationContext* opCtx,
+                                const std::vector<std::string>& sectionNames,
+                                BSONObjBuilder* result) {
+    CmdServerStatusInstantiator::getInstance().appendSections(opCtx, sectionNames, result);
+}
+
 OpCounterServerStatusSection::OpCounterServerStatusSection(const string& sectionName,
                                                            OpCounters* counters)
     : ServerStatusSection(sectionName), _counters(counters) {}
@@ -284,6 +307,16 @@ public:
     }
 } memBase;
 
+class AsyncLogDroppedRecords : public ServerStatusMetric {
+public:
+    AsyncLogDroppedRecords() : ServerStatusMetric("log.asyncDroppedRecords") {}
+    void appendAtLeaf(BSONObjBuilder& b) const override {
+        b.appendNumber(
+            _leafName,
+            logv2::LogManager::global().getGlobalDomainInternal().droppedAsyncRecords());
+    }
+} asyncLogDroppedRecords;
+
 class HttpClientServerStatus : public ServerStatusSection {
 public:
     HttpClientServerStatus() : ServerStatusSection("http_client") {}
@@ -34,6 +34,7 @@
 #include "mongo/db/stats/counters.h"
 #include "mongo/platform/atomic_word.h"
 #include <string>
+#include <vector>
 
 namespace mongo {
 
@@ -121,4 +122,15 @@ public:
 private:
     const OpCounters* _counters;
 };
+
+/**
+ * Appends only the named serverStatus sections to 'result' as if they had been requested with
+ * default options, skipping the common fields and the metrics tree. Unknown section names are
+ * ignored. Used by internal samplers, such as high resolution FTDC, that read a few sections far
+ * more often than the full serverStatus command is run.
+ */
+void appendServerStatusSections(OperationContext* opCtx,
+                                const std::vector<std::string>& sectionNames,
+                                BSONObjBuilder* result);
+
 }  // namespace mongo
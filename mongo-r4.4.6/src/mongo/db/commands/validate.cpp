@@ -70,6 +70,9 @@ stdx::condition_variable _validationNotifier;
  *       validate: "collectionNameWithoutTheDBPart",
  *       full: <bool>  // If true, a more thorough (and slower) collection validation is performed.
  *       background: <bool>  // If true, performs validation on the checkpoint of the collection.
+ *       parallel: <bool>  // If true, traverses the collection and its indexes concurrently.
+ *       incremental: <bool>  // If true, only validates the next 'maxRecords' records.
+ *       maxRecords: <number>  // Required with 'incremental'.
  *   }
  */
 class ValidateCmd : public BasicCommand {
@@ -85,7 +88,14 @@ public:
                              << "for correctness.\nThis is a slow operation.\n"
                              << "\tAdd {full: true} option to do a more thorough check.\n"
                              << "\tAdd {background: true} to validate in the background.\n"
-                             << "Cannot specify both {full: true, background: true}.";
+                             << "\tAdd {parallel: true} to traverse the collection and its "
+                             << "indexes concurrently.\n"
+                             << "\tAdd {incremental: true, maxRecords: <n>} to validate the next "
+                             << "n records, resuming where the previous incremental validation "
+                             << "stopped.\n"
+                             << "Cannot specify both {full: true, background: true}.\n"
+                             << "Cannot specify {parallel: true} with {background: true} or "
+                             << "{incremental: true}, nor {incremental: true} with {full: true}.";
     }
 
     virtual bool supportsWriteConcern(const BSONObj& cmd) const override {
@@ -140,12 +150,45 @@ public:
                                     << " and { full: true } is not supported.");
         }
 
+        const bool parallel = cmdObj["parallel"].trueValue();
+        if (background && parallel) {
+            uasserted(ErrorCodes::CommandNotSupported,
+                      str::stream() << "Running the validate command with both { background: true }"
+                                    << " and { parallel: true } is not supported.");
+        }
+
+        const bool incremental = cmdObj["incremental"].trueValue();
+        long long maxRecords = 0;
+        if (incremental) {
+            uassert(ErrorCodes::CommandNotSupported,
+                    "Running the validate command with both { incremental: true } and "
+                    "{ full: true } is not supported.",
+                    !fullValidate);
+            uassert(ErrorCodes::CommandNotSupported,
+                    "Running the validate command with both { incremental: true } and "
+                    "{ parallel: true } is not supported.",
+                    !parallel);
+
+            const auto maxRecordsElem = cmdObj["maxRecords"];
+            uassert(ErrorCodes::InvalidOptions,
+                    "The validate command requires a positive 'maxRecords' number with "
+                    "{ incremental: true }",
+                    maxRecordsElem.isNumber() && maxRecordsElem.safeNumberLong() > 0);
+            maxRecords = maxRecordsElem.safeNumberLong();
+        } else {
+            uassert(ErrorCodes::InvalidOptions,
+                    "The validate command only accepts 'maxRecords' with { incremental: true }",
+                    !cmdObj.hasField("maxRecords"));
+        }
+
         if (!serverGlobalParams.quiet.load()) {
             LOGV2(20514,
                   "CMD: validate",
                   "namespace"_attr = nss,
                   "background"_attr = background,
-                  "full"_attr = fullValidate);
+                  "full"_attr = fullValidate,
+                  "parallel"_attr = parallel,
+                  "incremental"_attr = incremental);
         }
 
         // Only one validation per collection can be in progress, the rest wait.
@@ -174,10 +217,16 @@ public:
 
         auto options = (fullValidate) ? CollectionValidation::ValidateOptions::kFullValidation
                                       : CollectionValidation::ValidateOptions::kNoFullValidation;
+        if (parallel) {
+            options = options | CollectionValidation::ValidateOptions::kParallel;
+        }
 
         ValidateResults validateResults;
-        Status status = CollectionValidation::validate(
-            opCtx, nss, options, background, &validateResults, &result);
+        Status status = incremental
+            ? CollectionValidation::validateIncremental(
+                  opCtx, nss, maxRecords, background, &validateResults, &result)
+            : CollectionValidation::validate(
+                  opCtx, nss, options, background, &validateResults, &result);
         if (!status.isOK()) {
             return CommandHelpers::appendCommandStatusNoThrow(result, status);
         }
@@ -50,6 +50,7 @@
 #include "mongo/db/profile_filter.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/query/query_stats_store.h"
 #include "mongo/logv2/log.h"
 #include "mongo/rpc/metadata/client_metadata.h"
 #include "mongo/rpc/metadata/client_metadata_ismaster.h"
@@ -450,6 +451,19 @@ bool CurOp::completeAndLogOperation(OperationContext* opCtx,
         oplogGetMoreStats.recordMillis(executionTimeMillis);
     }
 
+    if (_debug.queryHash) {
+        QueryStatsMetrics metrics;
+        metrics.readWriteType = getReadWriteType();
+        metrics.execMicros = _debug.executionTimeMicros;
+        metrics.docsExamined = _debug.additiveMetrics.docsExamined.value_or(0);
+        metrics.keysExamined = _debug.additiveMetrics.keysExamined.value_or(0);
+        metrics.nreturned = std::max(_debug.nreturned, 0LL);
+        metrics.bytesReturned = std::max(_debug.responseLength, 0);
+        metrics.now = opCtx->getServiceContext()->getFastClockSource()->now();
+        QueryStatsStore::get(opCtx->getServiceContext())
+            .record(getNSS(), *_debug.queryHash, metrics);
+    }
+
     bool shouldLogSlowOp, shouldProfileAtLevel1;
 
     if (auto filter =
@@ -684,6 +698,10 @@ void CurOp::reportState(OperationContext* opCtx, BSONObjBuilder* builder, bool t
     if (_debug.dataThroughputAverage) {
         builder->append("dataThroughputAverage", *_debug.dataThroughputAverage);
     }
+
+    if (_debug.bytesReclaimed) {
+        builder->append("bytesReclaimed", *_debug.bytesReclaimed);
+    }
 }
 
 namespace {
@@ -254,6 +254,9 @@ public:
     boost::optional<float> dataThroughputLastSecond;
     boost::optional<float> dataThroughputAverage;
 
+    // Stores the number of bytes of storage reclaimed so far by an online compact.
+    boost::optional<long long> bytesReclaimed;
+
     // Used to track the amount of time spent waiting for a response from remote operations.
     boost::optional<Microseconds> remoteOpWaitTime;
 
@@ -41,6 +41,7 @@
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/repl/optime.h"
 #include "mongo/db/storage/oplog_hack.h"
 #include "mongo/logv2/log.h"
@@ -70,6 +71,9 @@ CollectionScan::CollectionScan(ExpressionContext* expCtx,
     _specificStats.minTs = params.minTs;
     _specificStats.maxTs = params.maxTs;
     _specificStats.tailable = params.tailable;
+    if (_filter && internalQueryCompileMatchFilters.load()) {
+        _compiledFilter = CompiledFilter::compile(_filter);
+    }
     if (params.minTs || params.maxTs) {
         // The 'minTs' and 'maxTs' parameters are used for a special optimization that
         // applies only to forwards scans of the oplog.
@@ -262,9 +266,10 @@ PlanStage::StageState CollectionScan::returnIfMatches(WorkingSetMember* member,
                                                       WorkingSetID memberID,
                                                       WorkingSetID* out) {
     ++_specificStats.docsTested;
-    if (Filter::passes(member, _filter)) {
+    if (Filter::passes(member, _filter, _compiledFilter.get())) {
         if (_params.stopApplyingFilterAfterFirstMatch) {
             _filter = nullptr;
+            _compiledFilter.reset();
         }
         *out = memberID;
         return PlanStage::ADVANCED;
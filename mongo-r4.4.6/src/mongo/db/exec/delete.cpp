@@ -88,6 +88,10 @@ bool DeleteStage::isEOF() {
     if (!_params->isMulti && _specificStats.docsDeleted > 0) {
         return true;
     }
+    if (_params->limit > 0 &&
+        _specificStats.docsDeleted >= static_cast<size_t>(_params->limit)) {
+        return true;
+    }
     return _idRetrying == WorkingSet::INVALID_ID && _idReturning == WorkingSet::INVALID_ID &&
         child()->isEOF();
 }
@@ -54,6 +54,10 @@ struct DeleteStageParams {
     // (a "single delete")?
     bool isMulti;
 
+    // For a multi delete, the most documents to delete, or 0 to delete every document returned
+    // from the child.
+    long long limit = 0;
+
     // Is this delete part of a migrate operation that is essentially like a no-op
     // when the cluster is observed by an external client.
     bool fromMigrate;
@@ -32,6 +32,7 @@
 #include <memory>
 
 #include "mongo/db/exec/requires_collection_stage.h"
+#include "mongo/db/matcher/compiled_filter.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/record_id.h"
@@ -95,6 +96,9 @@ private:
     // The filter is not owned by us.
     const MatchExpression* _filter;
 
+    // Compiled form of '_filter', or null if '_filter' has nothing to compile.
+    std::unique_ptr<CompiledFilter> _compiledFilter;
+
     // If not Null, we use this rather than asking our child what to do next.
     WorkingSetID _idRetrying;
 
@@ -30,6 +30,7 @@
 #pragma once
 
 #include "mongo/db/exec/working_set.h"
+#include "mongo/db/matcher/compiled_filter.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/matcher/matchable.h"
 
@@ -159,6 +160,20 @@ public:
         return filter->matches(&doc, nullptr);
     }
 
+    /**
+     * As above, but evaluates 'compiled', the compiled form of 'filter', when 'wsm' holds a full
+     * document. 'compiled' may be null.
+     */
+    static bool passes(WorkingSetMember* wsm,
+                       const MatchExpression* filter,
+                       const CompiledFilter* compiled) {
+        if (compiled && wsm->hasObj()) {
+            dassert(compiled->source() == filter);
+            return compiled->matches(wsm->doc.value().toBson());
+        }
+        return passes(wsm, filter);
+    }
+
     static bool passes(const BSONObj& keyData,
                        const BSONObj& keyPattern,
                        const MatchExpression* filter) {
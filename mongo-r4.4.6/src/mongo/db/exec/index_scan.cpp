@@ -210,6 +210,25 @@ PlanStage::StageState IndexScan::doWork(WorkingSetID* out) {
 
     _scanState = GETTING_NEXT;
 
+    if (_sortKeyThreshold) {
+        BSONObjIterator keyIt(kv->key);
+        for (size_t i = 0; i < _sortKeyThresholdPos; ++i) {
+            keyIt.next();
+        }
+
+        if (_sortKeyThreshold->excludes(Value(keyIt.next()))) {
+            if (_stopAtSortKeyThreshold) {
+                _scanState = HIT_END;
+                _commonStats.isEOF = true;
+                _indexCursor.reset();
+                return PlanStage::IS_EOF;
+            }
+
+            ++_specificStats.keysDroppedBySortThreshold;
+            return PlanStage::NEED_TIME;
+        }
+    }
+
     if (_shouldDedup) {
         ++_specificStats.dupsTested;
         if (!_returned.insert(kv->loc).second) {
@@ -242,6 +261,51 @@ PlanStage::StageState IndexScan::doWork(WorkingSetID* out) {
     return PlanStage::ADVANCED;
 }
 
+bool IndexScan::setSortKeyThreshold(std::shared_ptr<const SortKeyThreshold> threshold) {
+    invariant(_scanState == INITIALIZING);
+
+    // Only btree indexes hold the field's values themselves, and only without a collation are they
+    // comparable with sort keys generated without one.
+    if (!IndexNames::findPluginName(_keyPattern).empty() || !_specificStats.collation.isEmpty()) {
+        return false;
+    }
+
+    boost::optional<size_t> pos;
+    int keyPatternDirection = 1;
+    size_t i = 0;
+    for (auto&& elt : _keyPattern) {
+        if (elt.fieldNameStringData() == threshold->path().fullPath()) {
+            pos = i;
+            keyPatternDirection = sgn(elt.number());
+            break;
+        }
+        ++i;
+    }
+    if (!pos) {
+        return false;
+    }
+
+    // A document's sort key only matches its index key if the field holds no arrays.
+    const auto& multikeyPaths = _specificStats.multiKeyPaths;
+    if (multikeyPaths.empty() ? _specificStats.isMultiKey : !multikeyPaths[*pos].empty()) {
+        return false;
+    }
+
+    // The values of the threshold's field are visited in order when all fields before it are
+    // constrained to a single point each.
+    bool prefixIsPoint = !_bounds.isSimpleRange && *pos < _bounds.fields.size();
+    for (size_t j = 0; prefixIsPoint && j < *pos; ++j) {
+        prefixIsPoint =
+            _bounds.fields[j].intervals.size() == 1 && _bounds.fields[j].intervals[0].isPoint();
+    }
+    const bool scansAscending = keyPatternDirection * _direction > 0;
+
+    _sortKeyThreshold = std::move(threshold);
+    _sortKeyThresholdPos = *pos;
+    _stopAtSortKeyThreshold = prefixIsPoint && scansAscending == _sortKeyThreshold->isAscending();
+    return true;
+}
+
 bool IndexScan::isEOF() {
     return _commonStats.isEOF;
 }
@@ -30,6 +30,7 @@
 #pragma once
 
 #include "mongo/db/exec/requires_index_stage.h"
+#include "mongo/db/exec/sort_key_threshold.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/expression.h"
@@ -126,6 +127,14 @@ public:
 
     const SpecificStats* getSpecificStats() const final;
 
+    /**
+     * Makes this scan drop keys which sort after 'threshold', the threshold of a top-k sort above
+     * it, so that their documents are never fetched. If the scan visits the threshold's field in
+     * sort order, it also stops at the first key past the threshold. Returns false, leaving the
+     * scan unchanged, if this index can not be used to evaluate the threshold.
+     */
+    bool setSortKeyThreshold(std::shared_ptr<const SortKeyThreshold> threshold);
+
     static const char* kStageType;
 
 protected:
@@ -166,6 +175,13 @@ private:
     // Keeps track of what work we need to do next.
     ScanState _scanState = ScanState::INITIALIZING;
 
+    // Set by setSortKeyThreshold(). '_sortKeyThresholdPos' is the position of the threshold's
+    // field in the key pattern. If '_stopAtSortKeyThreshold' is true, the keys are visited in sort
+    // order for that field, so the first key past the threshold ends the scan.
+    std::shared_ptr<const SortKeyThreshold> _sortKeyThreshold;
+    size_t _sortKeyThresholdPos = 0;
+    bool _stopAtSortKeyThreshold = false;
+
     // Could our index have duplicates?  If so, we use _returned to dedup.
     stdx::unordered_set<RecordId, RecordId::Hasher> _returned;
 
@@ -466,7 +466,8 @@ struct IndexScanStats : public SpecificStats {
           dupsTested(0),
           dupsDropped(0),
           keysExamined(0),
-          seeks(0) {}
+          seeks(0),
+          keysDroppedBySortThreshold(0) {}
 
     SpecificStats* clone() const final {
         IndexScanStats* specific = new IndexScanStats(*this);
@@ -528,6 +529,9 @@ struct IndexScanStats : public SpecificStats {
 
     // Number of times the index cursor is re-positioned during the execution of the scan.
     size_t seeks;
+
+    // Number of keys dropped because they sort after the threshold of a top-k sort above the scan.
+    size_t keysDroppedBySortThreshold;
 };
 
 struct LimitStats : public SpecificStats {
@@ -0,0 +1,129 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/bson/json.h"
+#include "mongo/db/exec/add_fields_projection_executor.h"
+#include "mongo/db/exec/document_value/document.h"
+#include "mongo/db/exec/projection_executor_builder.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/db/query/projection_parser.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/platform/random.h"
+
+namespace mongo {
+namespace {
+
+std::vector<Document> makeInput(int nDocs) {
+    PseudoRandom random(1);
+    std::vector<Document> input;
+    input.reserve(nDocs);
+    for (int i = 0; i < nDocs; ++i) {
+        MutableDocument doc;
+        doc.addField("_id", Value(i));
+        doc.addField("a", Value(random.nextInt32(1000)));
+        doc.addField("b", Value(random.nextInt32(1000) - 500));
+        doc.addField("price", Value(random.nextCanonicalDouble() * 100));
+        const std::string first = str::stream() << "first" << random.nextInt32(100);
+        const std::string last = str::stream() << "Last" << random.nextInt32(100);
+        doc.addField("first", Value(first));
+        doc.addField("last", Value(last));
+        doc.addField("ts", Value(Date_t::fromMillisSinceEpoch(random.nextInt64(1LL << 41))));
+        if (i % 4) {
+            doc.addField("score", Value(random.nextInt32(100)));
+        }
+        input.push_back(doc.freeze());
+    }
+    return input;
+}
+
+void runProjection(benchmark::State& state,
+                   const std::function<std::unique_ptr<projection_executor::ProjectionExecutor>(
+                       const boost::intrusive_ptr<ExpressionContext>&)>& makeExecutor) {
+    const bool compileExpressions = state.range(0);
+    const bool oldCompileExpressions = internalQueryCompileExpressions.load();
+    internalQueryCompileExpressions.store(compileExpressions);
+
+    const auto input = makeInput(1000);
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+
+    // Expressions are compiled when the executor is optimized.
+    auto executor = makeExecutor(expCtx);
+    executor->optimize();
+
+    for (auto keepRunning : state) {
+        for (auto&& doc : input) {
+            benchmark::DoNotOptimize(executor->applyTransformation(doc));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * input.size());
+
+    internalQueryCompileExpressions.store(oldCompileExpressions);
+}
+
+// An $addFields stage mixing arithmetic, conditionals, string and date operators.
+void BM_AddFields(benchmark::State& state) {
+    const BSONObj spec = fromjson(
+        "{total: {$add: ['$a', '$b', 1]},"
+        " size: {$cond: [{$gt: ['$a', '$b']}, 'big', 'small']},"
+        " name: {$toUpper: {$concat: ['$first', ' ', '$last']}},"
+        " year: {$year: '$ts'},"
+        " month: {$month: '$ts'},"
+        " score: {$ifNull: ['$score', 0]}}");
+    runProjection(state, [&](const auto& expCtx) {
+        return projection_executor::AddFieldsProjectionExecutor::create(expCtx, spec);
+    });
+}
+
+// A $project stage computing arithmetic and comparisons over numeric fields.
+void BM_ProjectArithmetic(benchmark::State& state) {
+    const BSONObj spec = fromjson(
+        "{_id: 0,"
+        " a: 1,"
+        " clamped: {$add: ['$a', {$cond: [{$lt: ['$b', 0]}, 0, '$b']}]},"
+        " withTax: {$add: ['$price', 1.5, '$a']},"
+        " inRange: {$cond: [{$gte: ['$b', -100]}, {$lte: ['$b', 100]}, false]},"
+        " order: {$cmp: ['$a', '$b']},"
+        " hasScore: {$ne: [{$ifNull: ['$score', null]}, null]}}");
+    runProjection(state, [&](const auto& expCtx) {
+        auto policies = ProjectionPolicies::aggregateProjectionPolicies();
+        auto projection = projection_ast::parse(expCtx, spec, policies);
+        return projection_executor::buildProjectionExecutor(
+            expCtx, &projection, policies, projection_executor::kDefaultBuilderParams);
+    });
+}
+
+BENCHMARK(BM_AddFields)->Arg(false)->Arg(true);
+BENCHMARK(BM_ProjectArithmetic)->Arg(false)->Arg(true);
+
+}  // namespace
+}  // namespace mongo
@@ -30,6 +30,7 @@
 #pragma once
 
 #include "mongo/db/exec/projection_executor.h"
+#include "mongo/db/pipeline/expression_compiler.h"
 
 #include "mongo/db/query/projection_policies.h"
 
@@ -162,6 +163,8 @@ protected:
 
     stdx::unordered_map<std::string, std::unique_ptr<ProjectionNode>> _children;
     stdx::unordered_map<std::string, boost::intrusive_ptr<Expression>> _expressions;
+    // The expressions in '_expressions' which could be compiled, computed by optimize().
+    stdx::unordered_map<std::string, std::unique_ptr<CompiledExpression>> _compiledExpressions;
     stdx::unordered_set<std::string> _projectedFields;
     ProjectionPolicies _policies;
     std::string _pathToNode;
@@ -200,6 +203,7 @@ private:
      */
     void makeOptimizationsStale() {
         _maxFieldsToProject = boost::none;
+        _compiledExpressions.clear();
     }
 
     /**
@@ -30,14 +30,17 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/db/exec/document_value/document.h"
+#include "mongo/db/exec/index_scan.h"
 #include "mongo/db/exec/sort.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/query/query_knobs_gen.h"
 
 namespace mongo {
 
 SortStage::SortStage(boost::intrusive_ptr<ExpressionContext> expCtx,
                      WorkingSet* ws,
                      SortPattern sortPattern,
+                     uint64_t limit,
                      bool addSortKeyMetadata,
                      std::unique_ptr<PlanStage> child)
     : PlanStage(kStageType.rawData(), expCtx.get()),
@@ -45,6 +48,41 @@ SortStage::SortStage(boost::intrusive_ptr<ExpressionContext> expCtx,
       _sortKeyGen(sortPattern, expCtx->getCollator()),
       _addSortKeyMetadata(addSortKeyMetadata) {
     _children.emplace_back(std::move(child));
+
+    // With a collation, the sort keys hold comparison keys which index keys can't be checked
+    // against.
+    if (limit > 0 && internalQueryPushDownTopKSortThreshold.load() && !expCtx->getCollator() &&
+        sortPattern.size() > 0 && sortPattern[0].fieldPath) {
+        auto threshold = std::make_shared<SortKeyThreshold>(*sortPattern[0].fieldPath,
+                                                            sortPattern[0].isAscending);
+        if (pushDownSortKeyThreshold(_children.front().get(), threshold)) {
+            _sortKeyThreshold = std::move(threshold);
+        }
+    }
+}
+
+bool SortStage::pushDownSortKeyThreshold(PlanStage* stage,
+                                         const std::shared_ptr<SortKeyThreshold>& threshold) {
+    switch (stage->stageType()) {
+        case STAGE_IXSCAN:
+            return static_cast<IndexScan*>(stage)->setSortKeyThreshold(threshold);
+        case STAGE_FETCH:
+        case STAGE_SHARDING_FILTER:
+        case STAGE_OR:
+        case STAGE_SORT_MERGE:
+        case STAGE_AND_HASH:
+        case STAGE_AND_SORTED: {
+            // Each of these returns a subset of its children's documents, so no document they
+            // return can make the top k unless it also could as one of their children's.
+            bool pushedDown = false;
+            for (auto&& child : stage->getChildren()) {
+                pushedDown = pushDownSortKeyThreshold(child.get(), threshold) || pushedDown;
+            }
+            return pushedDown;
+        }
+        default:
+            return false;
+    }
 }
 
 PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
@@ -108,7 +146,7 @@ SortStageDefault::SortStageDefault(boost::intrusive_ptr<ExpressionContext> expCt
                                    uint64_t maxMemoryUsageBytes,
                                    bool addSortKeyMetadata,
                                    std::unique_ptr<PlanStage> child)
-    : SortStage(expCtx, ws, sortPattern, addSortKeyMetadata, std::move(child)),
+    : SortStage(expCtx, ws, sortPattern, limit, addSortKeyMetadata, std::move(child)),
       _sortExecutor(std::move(sortPattern),
                     limit,
                     maxMemoryUsageBytes,
@@ -119,6 +157,10 @@ void SortStageDefault::spool(WorkingSetID wsid) {
     SortableWorkingSetMember extractedMember{_ws->extract(wsid)};
     auto sortKey = _sortKeyGen.computeSortKey(*extractedMember);
     _sortExecutor.add(sortKey, extractedMember);
+
+    if (_sortKeyThreshold) {
+        updateSortKeyThreshold(_sortExecutor.getThreshold());
+    }
 }
 
 PlanStage::StageState SortStageDefault::unspool(WorkingSetID* out) {
@@ -126,13 +168,16 @@ PlanStage::StageState SortStageDefault::unspool(WorkingSetID* out) {
         return PlanStage::IS_EOF;
     }
 
+    if (!_addSortKeyMetadata) {
+        *out = _ws->emplace(_sortExecutor.getNextData().extract());
+        return PlanStage::ADVANCED;
+    }
+
     auto&& [key, nextWsm] = _sortExecutor.getNext();
     *out = _ws->emplace(nextWsm.extract());
 
-    if (_addSortKeyMetadata) {
-        auto member = _ws->get(*out);
-        member->metadata().setSortKey(std::move(key), _sortKeyGen.isSingleElementKey());
-    }
+    auto member = _ws->get(*out);
+    member->metadata().setSortKey(std::move(key), _sortKeyGen.isSingleElementKey());
 
     return PlanStage::ADVANCED;
 }
@@ -144,7 +189,7 @@ SortStageSimple::SortStageSimple(boost::intrusive_ptr<ExpressionContext> expCtx,
                                  uint64_t maxMemoryUsageBytes,
                                  bool addSortKeyMetadata,
                                  std::unique_ptr<PlanStage> child)
-    : SortStage(expCtx, ws, sortPattern, addSortKeyMetadata, std::move(child)),
+    : SortStage(expCtx, ws, sortPattern, limit, addSortKeyMetadata, std::move(child)),
       _sortExecutor(std::move(sortPattern),
                     limit,
                     maxMemoryUsageBytes,
@@ -161,6 +206,10 @@ void SortStageSimple::spool(WorkingSetID wsid) {
 
     _sortExecutor.add(std::move(sortKey), member->doc.value().toBson());
     _ws->free(wsid);
+
+    if (_sortKeyThreshold) {
+        updateSortKeyThreshold(_sortExecutor.getThreshold());
+    }
 }
 
 PlanStage::StageState SortStageSimple::unspool(WorkingSetID* out) {
@@ -168,7 +217,13 @@ PlanStage::StageState SortStageSimple::unspool(WorkingSetID* out) {
         return PlanStage::IS_EOF;
     }
 
-    auto&& [key, nextObj] = _sortExecutor.getNext();
+    Value key;
+    BSONObj nextObj;
+    if (_addSortKeyMetadata) {
+        std::tie(key, nextObj) = _sortExecutor.getNext();
+    } else {
+        nextObj = _sortExecutor.getNextData();
+    }
 
     *out = _ws->allocate();
     auto member = _ws->get(*out);
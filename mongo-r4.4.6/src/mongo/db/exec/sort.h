@@ -36,6 +36,7 @@
 #include "mongo/db/exec/sort_executor.h"
 #include "mongo/db/exec/sort_key_comparator.h"
 #include "mongo/db/exec/sort_key_generator.h"
+#include "mongo/db/exec/sort_key_threshold.h"
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/record_id.h"
 
@@ -48,6 +49,10 @@ namespace mongo {
  *
  * Concrete implementations derive from this abstract base class by implementing methods for
  * spooling and unspooling.
+ *
+ * When there is a limit and the sort pattern leads with a field path, the sort shares the leading
+ * component of its k-th best sort key with the index scans beneath it as a SortKeyThreshold, so
+ * that they can drop keys which can no longer make it into the output.
  */
 class SortStage : public PlanStage {
 public:
@@ -56,6 +61,7 @@ public:
     SortStage(boost::intrusive_ptr<ExpressionContext> expCtx,
               WorkingSet* ws,
               SortPattern sortPattern,
+              uint64_t limit,
               bool addSortKeyMetadata,
               std::unique_ptr<PlanStage> child);
 
@@ -95,7 +101,28 @@ protected:
 
     const bool _addSortKeyMetadata;
 
+    /**
+     * Tightens '_sortKeyThreshold' given 'threshold', the sort executor's current threshold. Should
+     * be called after each document is spooled.
+     */
+    void updateSortKeyThreshold(boost::optional<Value> threshold) {
+        if (threshold) {
+            _sortKeyThreshold->set(_sortKeyGen.isSingleElementKey() ? std::move(*threshold)
+                                                                    : (*threshold)[0]);
+        }
+    }
+
+    // Shared with the index scans beneath this stage. Null if no scan can make use of it.
+    std::shared_ptr<SortKeyThreshold> _sortKeyThreshold;
+
 private:
+    /**
+     * Hands 'threshold' to every index scan reachable from 'stage' through stages which pass their
+     * children's documents through unchanged. Returns true if any scan accepted it.
+     */
+    static bool pushDownSortKeyThreshold(PlanStage* stage,
+                                         const std::shared_ptr<SortKeyThreshold>& threshold);
+
     // Whether or not we have finished loading data into '_sortExecutor'.
     bool _populated = false;
 };
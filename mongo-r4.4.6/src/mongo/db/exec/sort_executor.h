@@ -29,13 +29,19 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
+
+#include "mongo/bson/ordering.h"
 #include "mongo/db/exec/document_value/document.h"
 #include "mongo/db/exec/plan_stats.h"
 #include "mongo/db/exec/sort_key_comparator.h"
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/pipeline/expression.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/sort_pattern.h"
+#include "mongo/db/sorter/radix_sort.h"
 #include "mongo/db/sorter/sorter.h"
+#include "mongo/db/storage/key_string.h"
 
 namespace mongo {
 /**
@@ -47,6 +53,12 @@ namespace mongo {
  * The template parameter is the type of data being sorted. In DocumentSource execution, we sort
  * Document objects directly, but in the PlanStage layer we may sort WorkingSetMembers. The type of
  * the sort key, on the other hand, is always Value.
+ *
+ * Unless disabled by 'internalQuerySortKeysAsKeyStrings', each sort key is encoded once into a
+ * KeyString whose bytes compare in the order of the sort pattern. The in-memory phase then sorts
+ * the KeyStrings with a radix sort, and merging spilled runs only needs byte comparisons. Sort
+ * keys already hold collation comparison keys rather than the original strings, so the encoding
+ * needs no collator.
  */
 template <typename T>
 class SortExecutor {
@@ -64,6 +76,22 @@ public:
         SortKeyComparator _sortKeyComparator;
     };
 
+    using KeyStringSorter = Sorter<KeyString::Value, T>;
+    class KeyStringComparator {
+    public:
+        int operator()(const typename KeyStringSorter::Data& lhs,
+                       const typename KeyStringSorter::Data& rhs) const {
+            return lhs.first.compare(rhs.first);
+        }
+
+        template <typename RandomIt>
+        void sort(RandomIt begin, RandomIt end) const {
+            msdRadixSort(begin, end, [](const typename KeyStringSorter::Data& data) {
+                return StringData(data.first.getBuffer(), data.first.getSize());
+            });
+        }
+    };
+
     /**
      * If the passed in limit is 0, this is treated as no limit.
      */
@@ -73,6 +101,7 @@ public:
                  std::string tempDir,
                  bool allowDiskUse)
         : _sortPattern(std::move(sortPattern)),
+          _sortKeyOrdering(makeSortKeyOrdering(_sortPattern)),
           _tempDir(std::move(tempDir)),
           _diskUseAllowed(allowDiskUse) {
         _stats.sortPattern =
@@ -123,6 +152,16 @@ public:
      * Should only be called before 'loadingDone()' is called.
      */
     void add(const Value& sortKey, const T& data) {
+        if (_sortKeyOrdering) {
+            if (!_keyStringSorter) {
+                _keyStringSorter.reset(makeKeyStringSorter());
+            }
+            _keyStringSorter->add(encodeSortKey(sortKey), data);
+
+            _stats.totalDataSizeBytes += data.memUsageForSorter();
+            return;
+        }
+
         if (!_sorter) {
             _sorter.reset(DocumentSorter::make(makeSortOptions(), Comparator(_sortPattern)));
         }
@@ -135,6 +174,17 @@ public:
      * Signals to the sort executor that there will be no more input documents.
      */
     void loadingDone() {
+        if (_sortKeyOrdering) {
+            // This conditional should only pass if no documents were added to the sorter.
+            if (!_keyStringSorter) {
+                _keyStringSorter.reset(makeKeyStringSorter());
+            }
+            _keyStringOutput.reset(_keyStringSorter->done());
+            _stats.wasDiskUsed = _stats.wasDiskUsed || _keyStringSorter->usedDisk();
+            _keyStringSorter.reset();
+            return;
+        }
+
         // This conditional should only pass if no documents were added to the sorter.
         if (!_sorter) {
             _sorter.reset(DocumentSorter::make(makeSortOptions(), Comparator(_sortPattern)));
@@ -153,8 +203,9 @@ public:
             return false;
         }
 
-        if (!_output->more()) {
+        if (_sortKeyOrdering ? !_keyStringOutput->more() : !_output->more()) {
             _output.reset();
+            _keyStringOutput.reset();
             _isEOF = true;
             return false;
         }
@@ -168,9 +219,52 @@ public:
      * end-of-stream must be detected with 'hasNext()'.
      */
     std::pair<Value, T> getNext() {
+        if (_sortKeyOrdering) {
+            auto next = _keyStringOutput->next();
+            return {decodeSortKey(next.first), std::move(next.second)};
+        }
         return _output->next();
     }
 
+    /**
+     * Like 'getNext()', but only returns the data item. Prefer this when the sort key is not
+     * needed, since it saves decoding the sort key from its KeyString.
+     */
+    T getNextData() {
+        if (_sortKeyOrdering) {
+            return _keyStringOutput->next().second;
+        }
+        return _output->next().second;
+    }
+
+    /**
+     * Returns a sort key such that documents whose sort keys compare greater than or equal to it
+     * can no longer make it into the output, or boost::none if there is no such key yet. Only a
+     * top-k sort which has buffered at least 'limit' documents has one. Should only be called
+     * before 'loadingDone()' is called.
+     */
+    boost::optional<Value> getThreshold() {
+        if (_sortKeyOrdering) {
+            auto threshold = _keyStringSorter ? _keyStringSorter->getThreshold() : nullptr;
+            if (!threshold) {
+                return boost::none;
+            }
+
+            // The threshold changes far less often than it is asked for, so only decode it when
+            // it moves.
+            if (!_decodedThreshold || _decodedThreshold->first.compare(*threshold) != 0) {
+                _decodedThreshold = std::make_pair(*threshold, decodeSortKey(*threshold));
+            }
+            return _decodedThreshold->second;
+        }
+
+        auto threshold = _sorter ? _sorter->getThreshold() : nullptr;
+        if (!threshold) {
+            return boost::none;
+        }
+        return *threshold;
+    }
+
 private:
     SortOptions makeSortOptions() const {
         SortOptions opts;
@@ -187,13 +281,89 @@ private:
         return opts;
     }
 
+    /**
+     * Returns the Ordering with which sort keys are encoded into KeyStrings, or boost::none if the
+     * sort keys should be compared as Values instead.
+     */
+    static boost::optional<Ordering> makeSortKeyOrdering(const SortPattern& sortPattern) {
+        if (!internalQuerySortKeysAsKeyStrings.load() || sortPattern.size() == 0 ||
+            sortPattern.size() > Ordering::kMaxCompoundIndexKeys) {
+            return boost::none;
+        }
+
+        BSONObjBuilder directions;
+        for (auto&& part : sortPattern) {
+            directions.append("", part.isAscending ? 1 : -1);
+        }
+        return Ordering::make(directions.obj());
+    }
+
+    KeyStringSorter* makeKeyStringSorter() const {
+        return KeyStringSorter::make(
+            makeSortOptions(),
+            KeyStringComparator(),
+            {KeyString::Value::SorterDeserializeSettings(KeyString::Version::kLatestVersion),
+             typename T::SorterDeserializeSettings()});
+    }
+
+    /**
+     * Encodes 'sortKey' into a KeyString which compares like the sort key does under
+     * SortKeyComparator.
+     */
+    KeyString::Value encodeSortKey(const Value& sortKey) const {
+        BSONObjBuilder components;
+        auto appendComponent = [&](const Value& component) {
+            // A missing component compares equal to undefined, and unlike missing, undefined can
+            // be encoded.
+            if (component.missing()) {
+                components.appendUndefined("");
+            } else {
+                component.addToBsonObj(&components, ""_sd);
+            }
+        };
+
+        if (_sortPattern.size() == 1) {
+            appendComponent(sortKey);
+        } else {
+            for (size_t i = 0; i < _sortPattern.size(); ++i) {
+                appendComponent(sortKey[i]);
+            }
+        }
+
+        KeyString::HeapBuilder builder(
+            KeyString::Version::kLatestVersion, components.done(), *_sortKeyOrdering);
+        return builder.release();
+    }
+
+    Value decodeSortKey(const KeyString::Value& keyString) const {
+        BSONObj components = KeyString::toBson(keyString, *_sortKeyOrdering);
+        if (_sortPattern.size() == 1) {
+            return Value(components.firstElement());
+        }
+
+        std::vector<Value> sortKey;
+        sortKey.reserve(_sortPattern.size());
+        for (auto&& component : components) {
+            sortKey.emplace_back(component);
+        }
+        return Value(std::move(sortKey));
+    }
+
     const SortPattern _sortPattern;
+    const boost::optional<Ordering> _sortKeyOrdering;
     const std::string _tempDir;
     const bool _diskUseAllowed;
 
     std::unique_ptr<DocumentSorter> _sorter;
     std::unique_ptr<typename DocumentSorter::Iterator> _output;
 
+    // Used instead of '_sorter' and '_output' when '_sortKeyOrdering' is set.
+    std::unique_ptr<KeyStringSorter> _keyStringSorter;
+    std::unique_ptr<typename KeyStringSorter::Iterator> _keyStringOutput;
+
+    // The last threshold returned by 'getThreshold()' in KeyString form, and its decoding.
+    boost::optional<std::pair<KeyString::Value, Value>> _decodedThreshold;
+
     SortStats _stats;
 
     bool _isEOF = false;
@@ -0,0 +1,106 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+#include <limits>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/exec/sort_executor.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/platform/random.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+namespace {
+
+// Sort on a low-cardinality string followed by a descending number, so that many comparisons
+// have to look at both components of the sort key.
+const BSONObj kSortPattern = BSON("a" << 1 << "b" << -1);
+
+std::vector<std::pair<Value, BSONObj>> makeInput(int nDocs) {
+    PseudoRandom random(1);
+    std::vector<std::pair<Value, BSONObj>> input;
+    input.reserve(nDocs);
+    for (int i = 0; i < nDocs; ++i) {
+        const std::string a = str::stream() << "category" << random.nextInt32(100);
+        const long long b = random.nextInt64();
+        input.emplace_back(Value(std::vector<Value>{Value(a), Value(b)}),
+                           BSON("_id" << i << "a" << a << "b" << b));
+    }
+    return input;
+}
+
+void BM_SortExecutor(benchmark::State& state) {
+    const int nDocs = state.range(0);
+    const bool sortKeysAsKeyStrings = state.range(1);
+
+    const bool oldSortKeysAsKeyStrings = internalQuerySortKeysAsKeyStrings.load();
+    internalQuerySortKeysAsKeyStrings.store(sortKeysAsKeyStrings);
+
+    const auto input = makeInput(nDocs);
+
+    for (auto keepRunning : state) {
+        // The ExpressionContext is only needed to parse $meta sorts.
+        SortExecutor<BSONObj> executor(SortPattern(kSortPattern, nullptr),
+                                       0 /* limit */,
+                                       std::numeric_limits<uint64_t>::max(),
+                                       "" /* tempDir */,
+                                       false /* allowDiskUse */);
+        for (auto&& [sortKey, doc] : input) {
+            executor.add(sortKey, doc);
+        }
+        executor.loadingDone();
+
+        size_t nReturned = 0;
+        while (executor.hasNext()) {
+            benchmark::DoNotOptimize(executor.getNextData());
+            ++nReturned;
+        }
+        invariant(nReturned == input.size());
+    }
+
+    state.SetItemsProcessed(state.iterations() * nDocs);
+    internalQuerySortKeysAsKeyStrings.store(oldSortKeysAsKeyStrings);
+}
+
+BENCHMARK(BM_SortExecutor)
+    ->ArgNames({"docs", "keyString"})
+    ->Args({1000, 0})
+    ->Args({1000, 1})
+    ->Args({100000, 0})
+    ->Args({100000, 1})
+    ->Args({1000000, 0})
+    ->Args({1000000, 1})
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace mongo
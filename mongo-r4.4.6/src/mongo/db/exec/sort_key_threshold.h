@@ -0,0 +1,91 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+
+#include "mongo/db/exec/document_value/value.h"
+#include "mongo/db/exec/document_value/value_comparator.h"
+#include "mongo/db/pipeline/field_path.h"
+
+namespace mongo {
+
+/**
+ * The bound a top-k SortStage shares with the index scans beneath it. Once the sort has buffered
+ * k results, every further document whose sort key does not sort strictly before the k-th best
+ * key is discarded. The threshold tracks the leading component of that k-th best key, which lets
+ * an index scan over the leading sort field drop keys that sort strictly after it before their
+ * documents are fetched, and stop early when it scans that field in sort order.
+ *
+ * The threshold only ever describes sort keys for which k results at least as good have already
+ * been seen, so it is safe to apply even while it is being tightened.
+ */
+class SortKeyThreshold {
+public:
+    SortKeyThreshold(FieldPath path, bool isAscending)
+        : _path(std::move(path)), _isAscending(isAscending) {}
+
+    /**
+     * The field path of the leading component of the sort pattern.
+     */
+    const FieldPath& path() const {
+        return _path;
+    }
+
+    bool isAscending() const {
+        return _isAscending;
+    }
+
+    void set(Value leadingComponent) {
+        _leadingComponent = std::move(leadingComponent);
+    }
+
+    /**
+     * Returns true if a document whose leading sort key component is 'value' sorts strictly after
+     * the current threshold, and so can not be part of the sort's output.
+     */
+    bool excludes(const Value& value) const {
+        if (!_leadingComponent) {
+            return false;
+        }
+
+        // Sort keys hold collation comparison keys, so they are compared binary.
+        const int cmp = ValueComparator().compare(value, *_leadingComponent);
+        return _isAscending ? cmp > 0 : cmp < 0;
+    }
+
+private:
+    const FieldPath _path;
+    const bool _isAscending;
+
+    boost::optional<Value> _leadingComponent;
+};
+
+}  // namespace mongo
@@ -32,12 +32,27 @@
 #include "mongo/db/ftdc/block_compressor.h"
 
 #include <zlib.h>
+#include <zstd.h>
 
 #include "mongo/util/str.h"
 
 namespace mongo {
 //FTDCCompressor::getCompressedSamples()  ѹ
-StatusWith<ConstDataRange> BlockCompressor::compress(ConstDataRange source) {
+StatusWith<ConstDataRange> BlockCompressor::compress(ConstDataRange source,
+                                                     FTDCBlockCodec codec) {
+    if (codec == FTDCBlockCodec::kZstd) {
+        _buffer.resize(ZSTD_compressBound(source.length()));
+
+        size_t ret = ZSTD_compress(
+            _buffer.data(), _buffer.size(), source.data(), source.length(), ZSTD_CLEVEL_DEFAULT);
+        if (ZSTD_isError(ret)) {
+            return {ErrorCodes::BadValue,
+                    str::stream() << "ZSTD_compress failed with " << ZSTD_getErrorName(ret)};
+        }
+
+        return ConstDataRange(_buffer.data(), ret);
+    }
+
     z_stream stream;
     int level = Z_DEFAULT_COMPRESSION;
 
@@ -79,7 +94,21 @@ StatusWith<ConstDataRange> BlockCompressor::compress(ConstDataRange source) {
 
 //FTDCDecompressor::uncompress 
 StatusWith<ConstDataRange> BlockCompressor::uncompress(ConstDataRange source,
-                                                       size_t uncompressedLength) {
+                                                       size_t uncompressedLength,
+                                                       FTDCBlockCodec codec) {
+    if (codec == FTDCBlockCodec::kZstd) {
+        _buffer.resize(uncompressedLength);
+
+        size_t ret =
+            ZSTD_decompress(_buffer.data(), _buffer.size(), source.data(), source.length());
+        if (ZSTD_isError(ret)) {
+            return {ErrorCodes::BadValue,
+                    str::stream() << "ZSTD_decompress failed with " << ZSTD_getErrorName(ret)};
+        }
+
+        return ConstDataRange(_buffer.data(), ret);
+    }
+
     z_stream stream;
 
     stream.next_in = reinterpret_cast<unsigned char*>(const_cast<char*>(source.data()));
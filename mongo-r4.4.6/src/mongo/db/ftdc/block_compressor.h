@@ -34,11 +34,12 @@
 
 #include "mongo/base/data_range.h"
 #include "mongo/base/status_with.h"
+#include "mongo/db/ftdc/config.h"
 
 namespace mongo {
 
 /**
- * Compesses and uncompresses a block of buffer using zlib.
+ * Compesses and uncompresses a block of buffer using zlib or zstd.
  */
 class BlockCompressor {
     BlockCompressor(const BlockCompressor&) = delete;
@@ -53,7 +54,8 @@ public:
      * Returns a pointer to a buffer that BlockCompressor owns.
      * The returned buffer is valid until the next call to compress or uncompress.
      */
-    StatusWith<ConstDataRange> compress(ConstDataRange source);
+    StatusWith<ConstDataRange> compress(ConstDataRange source,
+                                        FTDCBlockCodec codec = FTDCBlockCodec::kZlib);
 
     /**
      * Uncompress a buffer of data.
@@ -64,7 +66,9 @@ public:
      * Returns a pointer to a buffer that BlockCompressor owns.
      * The returned buffer is valid until the next call to compress or uncompress.
      */
-    StatusWith<ConstDataRange> uncompress(ConstDataRange source, size_t maxUncompressedLength);
+    StatusWith<ConstDataRange> uncompress(ConstDataRange source,
+                                          size_t maxUncompressedLength,
+                                          FTDCBlockCodec codec = FTDCBlockCodec::kZlib);
 
 private:
     std::vector<std::uint8_t> _buffer;
@@ -104,9 +104,13 @@ FTDCCompressor::addSample(const BSONObj& sample, Date_t date) {
 
 
     // Add another sample   _deltasеȡֵֻisFTDCTypeοdb.runCommand({getDiagnosticData:1})
+    // NOTE: The deltas of a sample are stored contiguously so this loop vectorizes, the
+    // compression code transposes them instead.
+    std::uint64_t* deltas = _deltas.data() + _deltaCount * _metricsCount;
+    const std::uint64_t* metrics = _metrics.data();
+    const std::uint64_t* prevMetrics = _prevmetrics.data();
     for (std::size_t i = 0; i < _metrics.size(); ++i) {
-        // NOTE: This touches a lot of cache lines so that compression code can be more effcient.
-        _deltas[getArrayOffset(_maxDeltas, _deltaCount, i)] = _metrics[i] - _prevmetrics[i];
+        deltas[i] = metrics[i] - prevMetrics[i];
     }
 
     ++_deltaCount;
@@ -152,7 +156,8 @@ StatusWith<std::tuple<ConstDataRange, Date_t>> FTDCCompressor::getCompressedSamp
     // Append count of samples - uint32 little endian
     _uncompressedChunkBuffer.appendNum(static_cast<std::uint32_t>(_deltaCount));
 
-    if (_metricsCount != 0 && _deltaCount != 0) {
+    if (_metricsCount != 0 && _deltaCount != 0 &&
+        _config->chunkFormat == FTDCChunkFormat::kVersion1) {
         // On average, we do not need all 10 bytes for every sample, worst case, we grow the buffer
         DataBuilder db(_metricsCount * _deltaCount * FTDCVarInt::kMaxSizeBytes64 / 2);
 
@@ -173,7 +178,7 @@ StatusWith<std::tuple<ConstDataRange, Date_t>> FTDCCompressor::getCompressedSamp
         // compressed with ZLIB.
         for (std::uint32_t i = 0; i < _metricsCount; i++) {
             for (std::uint32_t j = 0; j < _deltaCount; j++) {
-                std::uint64_t delta = _deltas[getArrayOffset(_maxDeltas, j, i)];
+                std::uint64_t delta = _deltas[j * _metricsCount + i];
 
                 if (delta == 0) {
                     ++zeroesCount;
@@ -224,11 +229,16 @@ StatusWith<std::tuple<ConstDataRange, Date_t>> FTDCCompressor::getCompressedSamp
         // Append the entire compacted metric chunk into the uncompressed buffer
         ConstDataRange cdr = db.getCursor();
         _uncompressedChunkBuffer.appendBuf(cdr.data(), cdr.length());
+    } else if (_metricsCount != 0 && _deltaCount != 0) {
+        _encodeVersion2Deltas();
     }
 
+    const auto codec = _config->chunkFormat == FTDCChunkFormat::kVersion1 ? FTDCBlockCodec::kZlib
+                                                                          : _config->blockCodec;
+
 	//ѹ
     auto swDest = _compressor.compress(
-        ConstDataRange(_uncompressedChunkBuffer.buf(), _uncompressedChunkBuffer.len()));
+        ConstDataRange(_uncompressedChunkBuffer.buf(), _uncompressedChunkBuffer.len()), codec);
 
     // The only way for compression to fail is if the buffer size calculations are wrong
     if (!swDest.isOK()) {
@@ -237,6 +247,12 @@ StatusWith<std::tuple<ConstDataRange, Date_t>> FTDCCompressor::getCompressedSamp
 
     _compressedChunkBuffer.setlen(0);
 
+    if (_config->chunkFormat != FTDCChunkFormat::kVersion1) {
+        _compressedChunkBuffer.appendNum(static_cast<std::uint32_t>(
+            kVersionedChunkMarker | static_cast<std::uint8_t>(_config->chunkFormat)));
+        _compressedChunkBuffer.appendUChar(static_cast<std::uint8_t>(codec));
+    }
+
     _compressedChunkBuffer.appendNum(static_cast<std::uint32_t>(_uncompressedChunkBuffer.len()));
 
     _compressedChunkBuffer.appendBuf(swDest.getValue().data(), swDest.getValue().length());
@@ -247,6 +263,25 @@ StatusWith<std::tuple<ConstDataRange, Date_t>> FTDCCompressor::getCompressedSamp
         _referenceDocDate);
 }
 
+void FTDCCompressor::_encodeVersion2Deltas() {
+    const std::size_t count = _metricsCount * _deltaCount;
+
+    // Transpose to group the deltas of each metric together. Most metrics rarely change, so this
+    // produces long runs of zero byte counts which the block codec compresses well.
+    _encodedDeltas.resize(count);
+    for (std::uint32_t i = 0; i < _metricsCount; i++) {
+        std::uint64_t* encoded = &_encodedDeltas[getArrayOffset(_deltaCount, 0, i)];
+        for (std::uint32_t j = 0; j < _deltaCount; j++) {
+            encoded[j] = FTDCGroupVarInt::zigZagEncode(_deltas[j * _metricsCount + i]);
+        }
+    }
+
+    const int start = _uncompressedChunkBuffer.len();
+    char* out = _uncompressedChunkBuffer.skip(FTDCGroupVarInt::maxEncodedSize(count));
+    const std::size_t length = FTDCGroupVarInt::encode(_encodedDeltas.data(), count, out);
+    _uncompressedChunkBuffer.setlen(start + length);
+}
+
 void FTDCCompressor::reset() {
     _metrics.clear();
     _reset(BSONObj(), Date_t());
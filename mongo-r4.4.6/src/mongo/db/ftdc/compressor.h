@@ -56,6 +56,11 @@ namespace mongo {
  * 4. Encodes zeros in Run Length Encoded pairs of <Count, Zero>
  * 5. ZLIB compresses the final processed array
  *
+ * Version 2 chunks (FTDCConfig::chunkFormat) replace steps 3 and 4 with zig-zag encoding the
+ * deltas and packing them with FTDCGroupVarInt, and may use zstd instead of zlib in step 5. They
+ * are prefixed with kVersionedChunkMarker | version and the block codec so that they are self
+ * describing, and so that older readers reject them as too long instead of misreading them.
+ *
  * NOTE: This compression ignores non-number data, and assumes the non-number data is constant
  * across all documents in the series of documents.
  */
@@ -137,6 +142,12 @@ public:
      */
     void reset();
 
+    /**
+     * Marker in the high bits of the leading 32-bit word of a versioned metric chunk. Version 1
+     * chunks start with their uncompressed length instead, which is always much smaller.
+     */
+    static constexpr std::uint32_t kVersionedChunkMarker = 0xFFFFFF00;
+
     /**
      * Compute the offset into an array for given (sample, metric) pair
      */
@@ -152,6 +163,11 @@ private:
      */
     void _reset(const BSONObj& referenceDoc, Date_t date);
 
+    /**
+     * Append the deltas to the uncompressed chunk buffer in the version 2 encoding.
+     */
+    void _encodeVersion2Deltas();
+
 private:
     // Block Compressor
     BlockCompressor _compressor;
@@ -178,11 +194,13 @@ private:
     //maxSamplesPerArchiveMetricChunk-1
     std::size_t _maxDeltas{0};
 
-    // Array of deltas - M x S
-    // _deltas[Metrics][Metrics]
+    // Array of deltas - S x M, the deltas of a sample are contiguous
     //ĶMetricsϢռ䣬οFTDCCompressor::addSample->FTDCCompressor::_reset
     std::vector<std::uint64_t> _deltas;
 
+    // Scratch array of zig-zag encoded deltas - M x S, for version 2 chunks
+    std::vector<std::uint64_t> _encodedDeltas;
+
     // Buffer for metric chunk compressed = uncompressed length + compressed data
     BufBuilder _compressedChunkBuffer;
 
@@ -0,0 +1,203 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/db/ftdc/compressor.h"
+#include "mongo/db/ftdc/config.h"
+#include "mongo/db/ftdc/decompressor.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Builds a sample shaped like the high resolution serverStatus sections: a globalLock section and
+ * a wiredTiger.cache section with 'numFields' counters, a few of which move on every sample.
+ */
+BSONObj makeSample(int numFields, long long tick) {
+    BSONObjBuilder builder;
+    {
+        BSONObjBuilder globalLock(builder.subobjStart("globalLock"));
+        globalLock.append("totalTime", tick * 100000);
+        BSONObjBuilder currentQueue(globalLock.subobjStart("currentQueue"));
+        currentQueue.append("total", tick % 7);
+        currentQueue.append("readers", tick % 3);
+        currentQueue.append("writers", tick % 5);
+    }
+    {
+        BSONObjBuilder wiredTiger(builder.subobjStart("wiredTiger"));
+        BSONObjBuilder cache(wiredTiger.subobjStart("cache"));
+        for (int i = 0; i < numFields; i++) {
+            // Every eighth counter changes between samples, the rest stay constant.
+            cache.append(std::to_string(i), i % 8 == 0 ? tick * i : static_cast<long long>(i));
+        }
+    }
+    return builder.obj();
+}
+
+/**
+ * Cost of adding one sample to the compressor, including the amortized cost of compressing a full
+ * metric chunk. At 10 Hz the CPU overhead per second is ten times the reported time.
+ */
+void BM_FTDCCompressorAddSample(benchmark::State& state) {
+    const int numFields = state.range(0);
+    FTDCConfig config;
+    FTDCCompressor compressor(&config);
+
+    std::vector<BSONObj> samples;
+    for (long long tick = 0; tick < 64; tick++) {
+        samples.push_back(makeSample(numFields, tick));
+    }
+
+    size_t i = 0;
+    for (auto _ : state) {
+        auto swResult = compressor.addSample(samples[i++ % samples.size()], Date_t());
+        invariant(swResult.isOK());
+        benchmark::DoNotOptimize(swResult.getValue());
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * Same as above but also compresses the pending samples every
+ * maxSamplesPerInterimMetricChunk samples, as FTDCFileWriter does for the interim file.
+ */
+void BM_FTDCCompressorAddSampleWithInterim(benchmark::State& state) {
+    const int numFields = state.range(0);
+    FTDCConfig config;
+    FTDCCompressor compressor(&config);
+
+    std::vector<BSONObj> samples;
+    for (long long tick = 0; tick < 64; tick++) {
+        samples.push_back(makeSample(numFields, tick));
+    }
+
+    size_t i = 0;
+    for (auto _ : state) {
+        auto swResult = compressor.addSample(samples[i++ % samples.size()], Date_t());
+        invariant(swResult.isOK());
+
+        if (compressor.getSampleCount() != 0 &&
+            compressor.getSampleCount() % config.maxSamplesPerInterimMetricChunk == 0) {
+            auto swBuf = compressor.getCompressedSamples();
+            invariant(swBuf.isOK());
+            benchmark::DoNotOptimize(swBuf.getValue());
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * Fills a compressor with one chunk less one sample of 'numFields' counters using the chunk format
+ * and block codec in the benchmark arguments.
+ */
+void fillCompressor(benchmark::State& state, FTDCConfig* config, FTDCCompressor* compressor) {
+    config->chunkFormat = static_cast<FTDCChunkFormat>(state.range(1));
+    config->blockCodec = static_cast<FTDCBlockCodec>(state.range(2));
+
+    for (long long tick = 0; tick < config->maxSamplesPerArchiveMetricChunk - 1; tick++) {
+        auto swResult = compressor->addSample(makeSample(state.range(0), tick), Date_t());
+        invariant(swResult.isOK());
+    }
+}
+
+/**
+ * Cost of encoding and compressing the pending samples of a nearly full metric chunk. Reports the
+ * encoded chunk size so that the chunk formats and codecs can be compared on both axes.
+ */
+void BM_FTDCCompressorEncodeChunk(benchmark::State& state) {
+    FTDCConfig config;
+    FTDCCompressor compressor(&config);
+    fillCompressor(state, &config, &compressor);
+
+    size_t chunkSize = 0;
+    for (auto _ : state) {
+        auto swBuf = compressor.getCompressedSamples();
+        invariant(swBuf.isOK());
+        chunkSize = std::get<0>(swBuf.getValue()).length();
+        benchmark::DoNotOptimize(swBuf.getValue());
+    }
+
+    state.counters["chunkBytes"] = chunkSize;
+    state.SetItemsProcessed(state.iterations() * compressor.getSampleCount());
+}
+
+/**
+ * Cost of decompressing and decoding a nearly full metric chunk back into BSON samples.
+ */
+void BM_FTDCDecompressorDecodeChunk(benchmark::State& state) {
+    FTDCConfig config;
+    FTDCCompressor compressor(&config);
+    fillCompressor(state, &config, &compressor);
+
+    auto swBuf = compressor.getCompressedSamples();
+    invariant(swBuf.isOK());
+    auto cdr = std::get<0>(swBuf.getValue());
+    std::vector<char> chunk(cdr.data(), cdr.data() + cdr.length());
+
+    FTDCDecompressor decompressor;
+    for (auto _ : state) {
+        auto swSamples = decompressor.uncompress(ConstDataRange(chunk.data(), chunk.size()));
+        invariant(swSamples.isOK());
+        benchmark::DoNotOptimize(swSamples.getValue());
+    }
+
+    state.SetItemsProcessed(state.iterations() * compressor.getSampleCount());
+}
+
+/**
+ * Arguments are {numFields, chunk format, block codec}. Version 1 chunks are always zlib.
+ */
+void chunkFormatArgs(benchmark::internal::Benchmark* b) {
+    for (int numFields : {128, 1024}) {
+        b->Args({numFields,
+                 static_cast<int>(FTDCChunkFormat::kVersion1),
+                 static_cast<int>(FTDCBlockCodec::kZlib)});
+        b->Args({numFields,
+                 static_cast<int>(FTDCChunkFormat::kVersion2),
+                 static_cast<int>(FTDCBlockCodec::kZlib)});
+        b->Args({numFields,
+                 static_cast<int>(FTDCChunkFormat::kVersion2),
+                 static_cast<int>(FTDCBlockCodec::kZstd)});
+    }
+}
+
+BENCHMARK(BM_FTDCCompressorAddSample)->Arg(32)->Arg(128)->Arg(1024);
+BENCHMARK(BM_FTDCCompressorAddSampleWithInterim)->Arg(32)->Arg(128)->Arg(1024);
+BENCHMARK(BM_FTDCCompressorEncodeChunk)->Apply(chunkFormatArgs);
+BENCHMARK(BM_FTDCDecompressorDecodeChunk)->Apply(chunkFormatArgs);
+
+}  // namespace
+}  // namespace mongo
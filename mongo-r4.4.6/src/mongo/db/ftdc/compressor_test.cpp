@@ -125,6 +125,12 @@ public:
     TestTie(FTDCValidationMode mode = FTDCValidationMode::kStrict)
         : _compressor(&_config), _mode(mode) {}
 
+    TestTie(FTDCChunkFormat format, FTDCBlockCodec codec)
+        : _compressor(&_config), _mode(FTDCValidationMode::kStrict) {
+        _config.chunkFormat = format;
+        _config.blockCodec = codec;
+    }
+
     ~TestTie() {
         validate(boost::none);
     }
@@ -537,4 +543,55 @@ TEST_F(FTDCCompressorTest, TestManyMetrics) {
     }
 }
 
+// Test the group varint chunk format round trips with each block codec
+TEST_F(FTDCCompressorTest, TestVersion2) {
+    for (auto codec : {FTDCBlockCodec::kZlib, FTDCBlockCodec::kZstd}) {
+        TestTie c(FTDCChunkFormat::kVersion2, codec);
+
+        auto st = c.addSample(BSON("name"
+                                   << "joe"
+                                   << "key1" << 33 << "key2" << 42));
+        ASSERT_HAS_SPACE(st);
+
+        // Alternate increasing and decreasing values so the deltas are negative half the time
+        for (size_t i = 0; i != FTDCConfig::kMaxSamplesPerArchiveMetricChunkDefault - 2; i++) {
+            st = c.addSample(BSON("name"
+                                  << "joe"
+                                  << "key1" << static_cast<long long int>(i) * (i % 2 ? 1 : -1)
+                                  << "key2" << 42 << "key3" << std::numeric_limits<long long>::min()
+                                  << "key4" << std::numeric_limits<long long>::max()));
+            if (i == 0) {
+                ASSERT_SCHEMA_CHANGED(st);
+            } else {
+                ASSERT_HAS_SPACE(st);
+            }
+        }
+    }
+}
+
+// Test the group varint chunk format with a full buffer of many random metrics
+TEST_F(FTDCCompressorTest, TestVersion2ManyMetrics) {
+    std::random_device rd;
+    std::mt19937 gen(rd());
+
+    std::uniform_int_distribution<long long> genValues(std::numeric_limits<long long>::min(),
+                                                       std::numeric_limits<long long>::max());
+    const size_t metrics = 1000;
+
+    for (auto codec : {FTDCBlockCodec::kZlib, FTDCBlockCodec::kZstd}) {
+        TestTie c(FTDCChunkFormat::kVersion2, codec);
+
+        auto st = c.addSample(generateSample(rd, genValues, metrics));
+        ASSERT_HAS_SPACE(st);
+
+        for (size_t i = 0; i != FTDCConfig::kMaxSamplesPerArchiveMetricChunkDefault - 2; i++) {
+            st = c.addSample(generateSample(rd, genValues, metrics));
+            ASSERT_HAS_SPACE(st);
+        }
+
+        st = c.addSample(generateSample(rd, genValues, metrics));
+        ASSERT_FULL(st);
+    }
+}
+
 }  // namespace mongo
@@ -35,6 +35,34 @@
 
 namespace mongo {
 
+/**
+ * Encoding of the deltas in a metric chunk. See FTDCCompressor.
+ *
+ * NOTE: Persisted to disk in metric chunks.
+ */
+enum class FTDCChunkFormat : std::uint8_t {
+    /**
+     * Varint encoded deltas with run length encoded zeros, compressed with zlib. Readable by all
+     * versions of mongod and the FTDC tools.
+     */
+    kVersion1 = 1,
+
+    /**
+     * Zig-zag and group varint encoded deltas, compressed with the chunk's block codec.
+     */
+    kVersion2 = 2,
+};
+
+/**
+ * Block compression codec for version 2 metric chunks.
+ *
+ * NOTE: Persisted to disk in metric chunks.
+ */
+enum class FTDCBlockCodec : std::uint8_t {
+    kZlib = 0,
+    kZstd = 1,
+};
+
 /**
  * Configuration settings for full-time diagnostic data capture (FTDC).
  *
@@ -47,7 +75,9 @@ struct FTDCConfig {
           maxFileSizeBytes(kMaxFileSizeBytesDefault),
           period(kPeriodMillisDefault),
           maxSamplesPerArchiveMetricChunk(kMaxSamplesPerArchiveMetricChunkDefault),
-          maxSamplesPerInterimMetricChunk(kMaxSamplesPerInterimMetricChunkDefault) {}
+          maxSamplesPerInterimMetricChunk(kMaxSamplesPerInterimMetricChunkDefault),
+          chunkFormat(kChunkFormatDefault),
+          blockCodec(kBlockCodecDefault) {}
 
     /**
      * True if FTDC is collecting data. False otherwise
@@ -88,6 +118,16 @@ struct FTDCConfig {
      */ ////diagnosticDataCollectionSamplesPerInterimUpdateãmetrics.interimļµʱ
     std::uint32_t maxSamplesPerInterimMetricChunk;
 
+    /**
+     * Encoding of the metric chunks written to disk.
+     */
+    FTDCChunkFormat chunkFormat;
+
+    /**
+     * Block codec for version 2 metric chunks. Version 1 metric chunks always use zlib.
+     */
+    FTDCBlockCodec blockCodec;
+
     static const bool kEnabledDefault = true;
 
     static const std::int64_t kPeriodMillisDefault;
@@ -98,6 +138,9 @@ struct FTDCConfig {
 
     static const std::uint32_t kMaxSamplesPerArchiveMetricChunkDefault = 300;
     static const std::uint32_t kMaxSamplesPerInterimMetricChunkDefault = 10;
+
+    static constexpr FTDCChunkFormat kChunkFormatDefault = FTDCChunkFormat::kVersion1;
+    static constexpr FTDCBlockCodec kBlockCodecDefault = FTDCBlockCodec::kZlib;
 };
 
 }  // namespace mongo
@@ -244,6 +244,17 @@ void FTDCController::addPeriodicCollector(std::unique_ptr<FTDCCollectorInterface
     }
 }
 
+void FTDCController::addPeriodicCollector(std::unique_ptr<FTDCCollectorInterface> collector,
+                                          Milliseconds period) {
+    {
+        stdx::lock_guard<Latch> lock(_mutex);
+        invariant(_state == State::kNotStarted);
+        invariant(period > Milliseconds(0));
+
+        _customPeriodCollectors[period].add(std::move(collector));
+    }
+}
+
 //startFTDC
 //ЧݣҪؿ
 void FTDCController::addOnRotateCollector(std::unique_ptr<FTDCCollectorInterface> collector) {
@@ -329,14 +340,31 @@ void FTDCController::doLoop() noexcept {
         _config = _configTemp;
     }
 
+    // Next time to collect the FTDC period collectors, and each set of custom period collectors
+    Date_t nextDefaultTime;
+    std::map<Milliseconds, Date_t> nextCustomTimes;
+    bool reschedule = true;
+
     while (true) {
         // Compute the next interval to run regardless of how we were woken up
         // Skipping an interval due to a race condition with a config signal is harmless.
         auto now = getGlobalServiceContext()->getPreciseClockSource()->now();
 
+        if (reschedule) {
+            nextDefaultTime = FTDCUtil::roundTime(now, _config.period);
+            for (auto& customCollectors : _customPeriodCollectors) {
+                nextCustomTimes[customCollectors.first] =
+                    FTDCUtil::roundTime(now, customCollectors.first);
+            }
+            reschedule = false;
+        }
+
         // Get next time to run at
         //diagnosticDataCollectionPeriodMillisãĬһӣftdc߳ѭʱ
-        auto next_time = FTDCUtil::roundTime(now, _config.period);
+        auto next_time = nextDefaultTime;
+        for (auto& nextCustomTime : nextCustomTimes) {
+            next_time = std::min(next_time, nextCustomTime.second);
+        }
 
         // Wait for the next run or signal to shutdown
         {
@@ -363,6 +391,7 @@ void FTDCController::doLoop() noexcept {
             // if we were signalled, then we have a config update only or were asked to stop
             //޸ò¼ʱԣͨ_condvar.wait_untilȴʱ¼
             if (status == stdx::cv_status::no_timeout) {
+                reschedule = true;
                 continue;
             }
         }
@@ -378,22 +407,49 @@ void FTDCController::doLoop() noexcept {
 
                 _mgr = uassertStatusOK(std::move(swMgr));
             }
-			LOGV2(210627,
-                  "FTDCController::doLoop() yang test ...");
-			//FTDCCollectorCollection::collect        std::tuple<BSONObj, Date_t>ΪcollectSample
-            auto collectSample = _periodicCollectors.collect(client);
+            if (nextDefaultTime <= next_time) {
+				LOGV2(210627,
+                      "FTDCController::doLoop() yang test ...");
+				//FTDCCollectorCollection::collect        std::tuple<BSONObj, Date_t>ΪcollectSample
+                auto collectSample = _periodicCollectors.collect(client);
+
+                Status s = _mgr->writeSampleAndRotateIfNeeded(
+                    client, std::get<0>(collectSample), std::get<1>(collectSample));
 
-            Status s = _mgr->writeSampleAndRotateIfNeeded(
-                client, std::get<0>(collectSample), std::get<1>(collectSample));
+                uassertStatusOK(s);
 
-            uassertStatusOK(s);
+                nextDefaultTime = FTDCUtil::roundTime(
+                    getGlobalServiceContext()->getPreciseClockSource()->now(), _config.period);
 
-            // Store a reference to the most recent document from the periodic collectors
-            {
+                // Store a reference to the most recent document from the periodic collectors
                 stdx::lock_guard<Latch> lock(_mutex);
 				//ҲһλȡȫϢ
                 _mostRecentPeriodicDocument = std::get<0>(collectSample);
             }
+
+            // Collectors with their own period are compressed separately from the FTDC period
+            // samples so that sampling them more often does not break up the main metric chunks.
+            for (auto& customCollectors : _customPeriodCollectors) {
+                auto& nextCustomTime = nextCustomTimes[customCollectors.first];
+                if (nextCustomTime > next_time) {
+                    continue;
+                }
+
+                auto collectSample = customCollectors.second.collect(client);
+
+                Status s = _mgr->writeSampleAndRotateIfNeeded(client,
+                                                              std::get<0>(collectSample),
+                                                              std::get<1>(collectSample),
+                                                              customCollectors.first);
+
+                uassertStatusOK(s);
+
+                nextCustomTime = FTDCUtil::roundTime(
+                    getGlobalServiceContext()->getPreciseClockSource()->now(),
+                    customCollectors.first);
+            }
+        } else {
+            reschedule = true;
         }
     }
 }
@@ -31,6 +31,7 @@
 
 #include <boost/filesystem/path.hpp>
 #include <cstdint>
+#include <map>
 #include <memory>
 
 #include "mongo/db/ftdc/collector.h"
@@ -111,6 +112,16 @@ public:
      */
     void addPeriodicCollector(std::unique_ptr<FTDCCollectorInterface> collector);
 
+    /**
+     * Add a metric collector to collect at its own period instead of the FTDC period, i.e. a few
+     * serverStatus sections sampled at 10 Hz.
+     *
+     * Collectors with the same period are sampled together into one document, and each period is
+     * written to its own metric chunks with an independent reference document.
+     */
+    void addPeriodicCollector(std::unique_ptr<FTDCCollectorInterface> collector,
+                              Milliseconds period);
+
     /**
      * Add a collector to collect on server start, and file rotation. i.e. hostInfo
      *
@@ -201,6 +212,8 @@ private:
     //עFTDCController::addPeriodicCollector   ռFTDCController::doLoop()
     FTDCCollectorCollection _periodicCollectors;
 
+    std::map<Milliseconds, FTDCCollectorCollection> _customPeriodCollectors;
+
     // Last seen sample document from periodic collectors
     // Owned
     BSONObj _mostRecentPeriodicDocument;
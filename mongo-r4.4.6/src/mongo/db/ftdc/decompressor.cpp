@@ -57,11 +57,46 @@ StatusWith<std::vector<BSONObj>> FTDCDecompressor::uncompress(ConstDataRange buf
     // Limit size of the buffer we need zlib
     auto uncompressedLength = swUncompressedLength.getValue();
 
+    // Versioned chunks replace the uncompressed length with a marker, followed by the block codec
+    // and the real uncompressed length.
+    auto format = FTDCChunkFormat::kVersion1;
+    auto codec = FTDCBlockCodec::kZlib;
+    if ((uncompressedLength & FTDCCompressor::kVersionedChunkMarker) ==
+        FTDCCompressor::kVersionedChunkMarker) {
+        format = static_cast<FTDCChunkFormat>(uncompressedLength &
+                                              ~FTDCCompressor::kVersionedChunkMarker);
+        if (format != FTDCChunkFormat::kVersion2) {
+            return Status(ErrorCodes::BadValue,
+                          str::stream() << "Unsupported metrics chunk format version "
+                                        << static_cast<int>(format));
+        }
+
+        auto swCodec = compressedDataRange.readAndAdvanceNoThrow<std::uint8_t>();
+        if (!swCodec.isOK()) {
+            return {swCodec.getStatus()};
+        }
+
+        codec = static_cast<FTDCBlockCodec>(swCodec.getValue());
+        if (codec != FTDCBlockCodec::kZlib && codec != FTDCBlockCodec::kZstd) {
+            return Status(ErrorCodes::BadValue,
+                          str::stream() << "Unsupported metrics chunk block codec "
+                                        << static_cast<int>(codec));
+        }
+
+        swUncompressedLength =
+            compressedDataRange.readAndAdvanceNoThrow<LittleEndian<std::uint32_t>>();
+        if (!swUncompressedLength.isOK()) {
+            return {swUncompressedLength.getStatus()};
+        }
+
+        uncompressedLength = swUncompressedLength.getValue();
+    }
+
     if (uncompressedLength > 10000000) {
         return Status(ErrorCodes::InvalidLength, "Metrics chunk has exceeded the allowable size.");
     }
 
-    auto statusUncompress = _compressor.uncompress(compressedDataRange, uncompressedLength);
+    auto statusUncompress = _compressor.uncompress(compressedDataRange, uncompressedLength, codec);
 
     if (!statusUncompress.isOK()) {
         return {statusUncompress.getStatus()};
@@ -127,36 +162,47 @@ StatusWith<std::vector<BSONObj>> FTDCDecompressor::uncompress(ConstDataRange buf
     // Read the samples
     std::vector<std::uint64_t> deltas(metricsCount * sampleCount);
 
-    // decompress the deltas
-    std::uint64_t zeroesCount = 0;
+    if (format == FTDCChunkFormat::kVersion1) {
+        // decompress the deltas
+        std::uint64_t zeroesCount = 0;
 
-    auto cdrc = ConstDataRangeCursor(cdc);
+        auto cdrc = ConstDataRangeCursor(cdc);
 
-    for (std::uint32_t i = 0; i < metricsCount; i++) {
-        for (std::uint32_t j = 0; j < sampleCount; j++) {
-            if (zeroesCount) {
-                deltas[FTDCCompressor::getArrayOffset(sampleCount, j, i)] = 0;
-                zeroesCount--;
-                continue;
-            }
+        for (std::uint32_t i = 0; i < metricsCount; i++) {
+            for (std::uint32_t j = 0; j < sampleCount; j++) {
+                if (zeroesCount) {
+                    deltas[FTDCCompressor::getArrayOffset(sampleCount, j, i)] = 0;
+                    zeroesCount--;
+                    continue;
+                }
 
-            auto swDelta = cdrc.readAndAdvanceNoThrow<FTDCVarInt>();
+                auto swDelta = cdrc.readAndAdvanceNoThrow<FTDCVarInt>();
 
-            if (!swDelta.isOK()) {
-                return swDelta.getStatus();
-            }
+                if (!swDelta.isOK()) {
+                    return swDelta.getStatus();
+                }
+
+                if (swDelta.getValue() == 0) {
+                    auto swZero = cdrc.readAndAdvanceNoThrow<FTDCVarInt>();
 
-            if (swDelta.getValue() == 0) {
-                auto swZero = cdrc.readAndAdvanceNoThrow<FTDCVarInt>();
+                    if (!swZero.isOK()) {
+                        return swZero.getStatus();
+                    }
 
-                if (!swZero.isOK()) {
-                    return swZero.getStatus();
+                    zeroesCount = swZero.getValue();
                 }
 
-                zeroesCount = swZero.getValue();
+                deltas[FTDCCompressor::getArrayOffset(sampleCount, j, i)] = swDelta.getValue();
             }
+        }
+    } else {
+        auto swLength = FTDCGroupVarInt::decode(cdc, deltas.size(), deltas.data());
+        if (!swLength.isOK()) {
+            return swLength.getStatus();
+        }
 
-            deltas[FTDCCompressor::getArrayOffset(sampleCount, j, i)] = swDelta.getValue();
+        for (auto& delta : deltas) {
+            delta = FTDCGroupVarInt::zigZagDecode(delta);
         }
     }
 
@@ -170,25 +170,25 @@ StatusWith<boost::filesystem::path> FTDCFileManager::generateArchiveFileName(
 
 //ļ򿪻иʱҪЩԪ
 //FTDCFileManager::rotate  FTDCFileManager::create
-Status FTDCFileManager::openArchiveFile(
-    Client* client,
-    const boost::filesystem::path& path,
-    const std::vector<std::tuple<FTDCBSONUtil::FTDCType, BSONObj, Date_t>>& docs) {
+Status FTDCFileManager::openArchiveFile(Client* client,
+                                        const boost::filesystem::path& path,
+                                        const std::vector<RecoveredDocument>& docs) {
     auto sOpen = _writer.open(path);
     if (!sOpen.isOK()) {
         return sOpen;
     }
 
     // Append any old interim records
-    for (auto& triplet : docs) {
-        if (std::get<0>(triplet) == FTDCBSONUtil::FTDCType::kMetadata) {
-            Status s = _writer.writeMetadata(std::get<1>(triplet), std::get<2>(triplet));
+    for (auto& recovered : docs) {
+        if (std::get<0>(recovered) == FTDCBSONUtil::FTDCType::kMetadata) {
+            Status s = _writer.writeMetadata(std::get<1>(recovered), std::get<2>(recovered));
 
             if (!s.isOK()) {
                 return s;
             }
         } else {
-            Status s = _writer.writeSample(std::get<1>(triplet), std::get<2>(triplet));
+            Status s = _writer.writeSample(
+                std::get<1>(recovered), std::get<2>(recovered), std::get<3>(recovered));
 
             if (!s.isOK()) {
                 return s;
@@ -251,8 +251,7 @@ Status FTDCFileManager::trimDirectory(std::vector<boost::filesystem::path>& file
 
 //ʱļлȡ
 //ȡ"metrics.interim"ļ
-std::vector<std::tuple<FTDCBSONUtil::FTDCType, BSONObj, Date_t>>
-FTDCFileManager::recoverInterimFile() {
+std::vector<FTDCFileManager::RecoveredDocument> FTDCFileManager::recoverInterimFile() {
     decltype(recoverInterimFile()) docs;
 
 	//"metrics.interim"
@@ -291,8 +290,10 @@ FTDCFileManager::recoverInterimFile() {
     StatusWith<bool> m = read.hasNext();
     for (; m.isOK() && m.getValue(); m = read.hasNext()) {
         auto triplet = read.next();
-        docs.emplace_back(std::tuple<FTDCBSONUtil::FTDCType, BSONObj, Date_t>(
-            std::get<0>(triplet), std::get<1>(triplet).getOwned(), std::get<2>(triplet)));
+        docs.emplace_back(RecoveredDocument(std::get<0>(triplet),
+                                            std::get<1>(triplet).getOwned(),
+                                            std::get<2>(triplet),
+                                            read.getPeriod()));
     }
 
     // Warn if the interim file was corrupt or we had an unclean shutdown
@@ -343,8 +344,9 @@ Status FTDCFileManager::rotate(Client* client) {
 //FTDCController::doLoop() 
 Status FTDCFileManager::writeSampleAndRotateIfNeeded(Client* client,
                                                      const BSONObj& sample,
-                                                     Date_t date) {
-    Status s = _writer.writeSample(sample, date);
+                                                     Date_t date,
+                                                     boost::optional<Milliseconds> period) {
+    Status s = _writer.writeSample(sample, date, period);
 
     if (!s.isOK()) {
         return s;
@@ -79,11 +79,15 @@ public:
     Status rotate(Client* client);
 
     /**
-     * Writes a sample to disk via FTDCFileWriter.
+     * Writes a sample to disk via FTDCFileWriter. Samples collected at a period other than the
+     * default FTDC period pass that period.
      *
      * Rotates files as needed.
      */
-    Status writeSampleAndRotateIfNeeded(Client* client, const BSONObj& sample, Date_t date);
+    Status writeSampleAndRotateIfNeeded(Client* client,
+                                        const BSONObj& sample,
+                                        Date_t date,
+                                        boost::optional<Milliseconds> period = boost::none);
 
     /**
      * Closes the current file manager down.
@@ -99,6 +103,13 @@ public:
                                                                 StringData suffix);
 
 private:
+    /**
+     * A document recovered from the interim file: its type, the document, the _id of the chunk it
+     * came from, and the collection period for periodic metric chunks.
+     */
+    using RecoveredDocument =
+        std::tuple<FTDCBSONUtil::FTDCType, BSONObj, Date_t, boost::optional<Milliseconds>>;
+
     FTDCFileManager(const FTDCConfig* config,
                     const boost::filesystem::path& path,
                     FTDCCollectorCollection* collection);
@@ -114,7 +125,7 @@ private:
      * Checks if the file is non-empty, and if gets a list of documents with the original times they
      * were written disk based on the _id fields.
      */
-    std::vector<std::tuple<FTDCBSONUtil::FTDCType, BSONObj, Date_t>> recoverInterimFile();
+    std::vector<RecoveredDocument> recoverInterimFile();
 
     /**
      * Removes the oldest files if the directory is over quota
@@ -130,10 +141,9 @@ private:
      *    recovery is written.
      * 2. Appends file rotation collectors upon opening the file.
      */
-    Status openArchiveFile(
-        Client* client,
-        const boost::filesystem::path& path,
-        const std::vector<std::tuple<FTDCBSONUtil::FTDCType, BSONObj, Date_t>>& docs);
+    Status openArchiveFile(Client* client,
+                           const boost::filesystem::path& path,
+                           const std::vector<RecoveredDocument>& docs);
 
 private:
     // config to use
@@ -92,8 +92,24 @@ StatusWith<bool> FTDCFileReader::hasNext() {
                 }
 
                 _metadata = swMetadata.getValue();
-            } else if (type == FTDCBSONUtil::FTDCType::kMetricChunk) {
+                _period = boost::none;
+            } else if (type == FTDCBSONUtil::FTDCType::kMetricChunk ||
+                       type == FTDCBSONUtil::FTDCType::kPeriodicMetricChunk) {
                 _state = State::kMetricChunk;
+                _chunkType = type;
+                _period = boost::none;
+
+                if (type == FTDCBSONUtil::FTDCType::kPeriodicMetricChunk) {
+                    auto swPeriod = FTDCBSONUtil::getBSONDocumentPeriod(_parent);
+                    if (!swPeriod.isOK()) {
+                        return swPeriod.getStatus();
+                    }
+
+                    _period = swPeriod.getValue();
+                }
+
+                // Chunks of different periods are interleaved in the file, but each one carries
+                // its own reference document so they decompress independently.
 
                 auto swDocs = FTDCBSONUtil::getMetricsFromMetricDoc(_parent, &_decompressor);
                 if (!swDocs.isOK()) {
@@ -140,7 +156,7 @@ std::tuple<FTDCBSONUtil::FTDCType, const BSONObj&, Date_t> FTDCFileReader::next(
 
     if (_state == State::kMetricChunk) {
         return std::tuple<FTDCBSONUtil::FTDCType, const BSONObj&, Date_t>(
-            FTDCBSONUtil::FTDCType::kMetricChunk, _docs[_pos], _dateId);
+            _chunkType, _docs[_pos], _dateId);
     }
 
     MONGO_UNREACHABLE;
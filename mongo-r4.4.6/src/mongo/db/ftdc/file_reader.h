@@ -75,6 +75,14 @@ public:
      */
     std::tuple<FTDCBSONUtil::FTDCType, const BSONObj&, Date_t> next();
 
+    /**
+     * Returns the collection period of the document last returned by next() if it came from a
+     * periodic metric chunk, and boost::none for metadata and default period metric chunks.
+     */
+    boost::optional<Milliseconds> getPeriod() const {
+        return _period;
+    }
+
 private:
     /**
      * Read a document from the file. If the file is corrupt, returns an appropriate status.
@@ -126,6 +134,12 @@ private:
     // _id of current metadata or metric chunk
     Date_t _dateId;
 
+    // Type of the current metric chunk, either kMetricChunk or kPeriodicMetricChunk
+    FTDCBSONUtil::FTDCType _chunkType{FTDCBSONUtil::FTDCType::kMetricChunk};
+
+    // Collection period of the current periodic metric chunk
+    boost::optional<Milliseconds> _period;
+
     // Current metadata document - unowned
     BSONObj _metadata;
 
@@ -76,10 +76,38 @@ Status FTDCFileWriter::open(const boost::filesystem::path& file) {
     _interimTempFile = FTDCUtil::getInterimTempFile(file);
 
     _compressor.reset();
+    _periodicCompressors.clear();
 
     return Status::OK();
 }
 
+FTDCCompressor* FTDCFileWriter::getCompressor(boost::optional<Milliseconds> period) {
+    if (!period) {
+        return &_compressor;
+    }
+
+    auto& compressor = _periodicCompressors[*period];
+    if (!compressor) {
+        compressor = std::make_unique<FTDCCompressor>(_config);
+    }
+
+    return compressor.get();
+}
+
+namespace {
+
+BSONObj createMetricChunkDocument(ConstDataRange buf,
+                                  Date_t date,
+                                  boost::optional<Milliseconds> period) {
+    if (period) {
+        return FTDCBSONUtil::createBSONPeriodicMetricChunkDocument(buf, date, *period);
+    }
+
+    return FTDCBSONUtil::createBSONMetricChunkDocument(buf, date);
+}
+
+}  // namespace
+
 //bufд"metrics.interim"ļ  FTDCFileWriter::writeSample
 //diagnosticDataCollectionSamplesPerChunkڵȫ+Ϣ¼"metrics.interim"
 Status FTDCFileWriter::writeInterimFileBuffer(ConstDataRange buf) {
@@ -160,8 +188,11 @@ Status FTDCFileWriter::writeMetadata(const BSONObj& metadata, Date_t date) {
 }
 
 //writeSampleAndRotateIfNeeded
-Status FTDCFileWriter::writeSample(const BSONObj& sample, Date_t date) {
-    auto ret = _compressor.addSample(sample, date);
+Status FTDCFileWriter::writeSample(const BSONObj& sample,
+                                   Date_t date,
+                                   boost::optional<Milliseconds> period) {
+    auto compressor = getCompressor(period);
+    auto ret = compressor->addSample(sample, date);
 
     if (!ret.isOK()) {
         return ret.getStatus();
@@ -170,58 +201,115 @@ Status FTDCFileWriter::writeSample(const BSONObj& sample, Date_t date) {
     if (ret.getValue().is_initialized()) {
 		//diagnosticDataCollectionSamplesPerChunk,ʱֱӰѱdiagnosticDataCollectionSamplesPerChunk
 		//ڵȫ+׷ӵmetrics.2021-11-09T08-10-30Z-00000ļ
-        return flush(std::get<0>(ret.getValue().get()), std::get<2>(ret.getValue().get()));
+        return flushChunk(
+            std::get<0>(ret.getValue().get()), std::get<2>(ret.getValue().get()), period);
     }
 
 	//diagnosticDataCollectionSamplesPerInterimUpdateһmetrics.interimдȫ+
-    if (_compressor.getSampleCount() != 0 &&
-        (_compressor.getSampleCount() % _config->maxSamplesPerInterimMetricChunk) == 0) {
+    if (compressor->getSampleCount() != 0 &&
+        (compressor->getSampleCount() % _config->maxSamplesPerInterimMetricChunk) == 0) {
         // Check if we want to do a partial write to the interim buffer
-        auto swBuf = _compressor.getCompressedSamples();
+        return writeInterimFile();
+    }
+
+    return Status::OK();
+}
+
+//FTDCFileWriter::writeSample
+Status FTDCFileWriter::flushChunk(ConstDataRange range,
+                                  Date_t date,
+                                  boost::optional<Milliseconds> period) {
+    BSONObj o = createMetricChunkDocument(range, date, period);
+    Status s = writeArchiveFileBuffer({o.objdata(), static_cast<size_t>(o.objsize())});
+
+    if (!s.isOK()) {
+        return s;
+    }
+
+    // Samples of the other periods are still only in the interim file, so rewrite it instead of
+    // removing it.
+    if (!_periodicCompressors.empty()) {
+        return writeInterimFile();
+    }
+
+    return removeInterimFile();
+}
+
+Status FTDCFileWriter::flush() {
+    auto flushCompressor = [this](FTDCCompressor* compressor,
+                                  boost::optional<Milliseconds> period) -> Status {
+        if (!compressor->hasDataToFlush()) {
+            return Status::OK();
+        }
+
+        auto swBuf = compressor->getCompressedSamples();
+
         if (!swBuf.isOK()) {
             return swBuf.getStatus();
         }
 
-		//swbufеbsonʽ
-        BSONObj o = FTDCBSONUtil::createBSONMetricChunkDocument(std::get<0>(swBuf.getValue()),
-                                                                std::get<1>(swBuf.getValue()));
+        BSONObj o = createMetricChunkDocument(
+            std::get<0>(swBuf.getValue()), std::get<1>(swBuf.getValue()), period);
+        return writeArchiveFileBuffer({o.objdata(), static_cast<size_t>(o.objsize())});
+    };
 
-		//ӡĶͨecho "xx" |  ruby -rzlib -rbase64 -e 'd = STDIN.read; print Zlib::Inflate.new.inflate(Base64.decode64(d)[4..-1])' | ./bsondump --quiet
-		//XXΪݣݾdiagnose
-		LOGV2_DEBUG(220327, 2, "FTDCFileWriter::writeSample","writeSample x: "_attr = o);
-        return writeInterimFileBuffer({o.objdata(), static_cast<size_t>(o.objsize())});
+    Status s = flushCompressor(&_compressor, boost::none);
+    if (!s.isOK()) {
+        return s;
     }
 
-    return Status::OK();
+    for (auto& periodicCompressor : _periodicCompressors) {
+        s = flushCompressor(periodicCompressor.second.get(), periodicCompressor.first);
+        if (!s.isOK()) {
+            return s;
+        }
+    }
+
+    return removeInterimFile();
 }
 
-//FTDCFileWriter::writeSample
-Status FTDCFileWriter::flush(const boost::optional<ConstDataRange>& range, Date_t date) {
-    if (!range.is_initialized()) {
-        if (_compressor.hasDataToFlush()) {
-            auto swBuf = _compressor.getCompressedSamples();
-
-            if (!swBuf.isOK()) {
-                return swBuf.getStatus();
-            }
-
-            BSONObj o = FTDCBSONUtil::createBSONMetricChunkDocument(std::get<0>(swBuf.getValue()),
-                                                                    std::get<1>(swBuf.getValue()));
-            Status s = writeArchiveFileBuffer({o.objdata(), static_cast<size_t>(o.objsize())});
-
-            if (!s.isOK()) {
-                return s;
-            }
+Status FTDCFileWriter::writeInterimFile() {
+    BufBuilder buf;
+
+    auto appendCompressor = [&buf](FTDCCompressor* compressor,
+                                   boost::optional<Milliseconds> period) -> Status {
+        if (!compressor->hasDataToFlush()) {
+            return Status::OK();
         }
-    } else {
-        BSONObj o = FTDCBSONUtil::createBSONMetricChunkDocument(range.get(), date);
-        Status s = writeArchiveFileBuffer({o.objdata(), static_cast<size_t>(o.objsize())});
 
+        auto swBuf = compressor->getCompressedSamples();
+        if (!swBuf.isOK()) {
+            return swBuf.getStatus();
+        }
+
+        BSONObj o = createMetricChunkDocument(
+            std::get<0>(swBuf.getValue()), std::get<1>(swBuf.getValue()), period);
+
+        LOGV2_DEBUG(220327, 2, "FTDCFileWriter::writeSample", "writeSample x: "_attr = o);
+        buf.appendBuf(o.objdata(), o.objsize());
+        return Status::OK();
+    };
+
+    Status s = appendCompressor(&_compressor, boost::none);
+    if (!s.isOK()) {
+        return s;
+    }
+
+    for (auto& periodicCompressor : _periodicCompressors) {
+        s = appendCompressor(periodicCompressor.second.get(), periodicCompressor.first);
         if (!s.isOK()) {
             return s;
         }
     }
 
+    if (buf.len() == 0) {
+        return removeInterimFile();
+    }
+
+    return writeInterimFileBuffer({buf.buf(), static_cast<size_t>(buf.len())});
+}
+
+Status FTDCFileWriter::removeInterimFile() {
     boost::system::error_code ec;
     boost::filesystem::remove(_interimFile, ec);
     if (ec) {
@@ -235,7 +323,7 @@ Status FTDCFileWriter::flush(const boost::optional<ConstDataRange>& range, Date_
 
 Status FTDCFileWriter::close() {
     if (_archiveStream.is_open()) {
-        Status s = flush(boost::none, Date_t());
+        Status s = flush();
 
         _archiveStream.close();
 
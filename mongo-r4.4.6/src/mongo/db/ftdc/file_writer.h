@@ -33,6 +33,8 @@
 #include <cstddef>
 #include <cstdint>
 #include <fstream>
+#include <map>
+#include <memory>
 #include <vector>
 
 #include "mongo/base/status.h"
@@ -78,8 +80,14 @@ public:
 
     /**
      * Write a sample to interim and/or archive log as needed.
+     *
+     * Samples collected at a period other than the default FTDC period pass that period. Each
+     * period is compressed into its own metric chunks with their own reference document so that
+     * a schema change or chunk boundary on one cadence does not affect the others.
      */
-    Status writeSample(const BSONObj& sample, Date_t date);
+    Status writeSample(const BSONObj& sample,
+                       Date_t date,
+                       boost::optional<Milliseconds> period = boost::none);
 
     /**
      * Close all the files and shutdown cleanly by zeroing the beginning of the interim file.
@@ -102,10 +110,31 @@ public:
     void closeWithoutFlushForTest();
 
 private:
+    /**
+     * Get the compressor for the specified period, creating it on first use.
+     */
+    FTDCCompressor* getCompressor(boost::optional<Milliseconds> period);
+
     /**
      * Flush all changes to disk.
      */
-    Status flush(const boost::optional<ConstDataRange>&, Date_t date);
+    Status flush();
+
+    /**
+     * Append a full metric chunk of the specified period to the archive file.
+     */
+    Status flushChunk(ConstDataRange range, Date_t date, boost::optional<Milliseconds> period);
+
+    /**
+     * Write the samples from every compressor that are not yet in the archive file to the interim
+     * file, or remove the interim file if there are none.
+     */
+    Status writeInterimFile();
+
+    /**
+     * Remove the interim file.
+     */
+    Status removeInterimFile();
 
     /**
      * Write a buffer to the beginning of the interim file.
@@ -142,6 +171,9 @@ private:
     // FTDC compressor
     FTDCCompressor _compressor;
 
+    // FTDC compressors for samples collected at a period other than the default period
+    std::map<Milliseconds, std::unique_ptr<FTDCCompressor>> _periodicCompressors;
+
     // Size of archive file
     std::size_t _size{0};
 
@@ -287,6 +287,75 @@ TEST_F(FTDCFileTest, TestLargeDocuments) {
     }
 }
 
+// Test samples of different periods are compressed and read back independently
+TEST_F(FTDCFileTest, TestPeriodicSamples) {
+    unittest::TempDir tempdir("metrics_testpath");
+    boost::filesystem::path p(tempdir.path());
+    p /= kTestFile;
+
+    deleteFileIfNeeded(p);
+
+    const Milliseconds kPeriod(100);
+
+    FTDCConfig config;
+    FTDCFileWriter writer(&config);
+
+    ASSERT_OK(writer.open(p));
+
+    std::vector<BSONObj> defaultDocs;
+    std::vector<BSONObj> periodicDocs;
+
+    // Interleave the two cadences, with the periodic one filling several metric chunks and
+    // changing schema in the middle of the default period chunk.
+    for (size_t i = 0; i < FTDCConfig::kMaxSamplesPerArchiveMetricChunkDefault * 2 + 5; i++) {
+        BSONObj periodic = BSON("cache" << BSON("bytes" << static_cast<long long>(i * 7)));
+        ASSERT_OK(writer.writeSample(periodic, Date_t(), kPeriod));
+        periodicDocs.emplace_back(periodic);
+
+        if (i % 10 == 0) {
+            BSONObj sample = i < 300 ? BSON("name"
+                                            << "joe"
+                                            << "key1" << static_cast<long long>(i))
+                                     : BSON("key1" << static_cast<long long>(i) << "key2" << 3);
+            ASSERT_OK(writer.writeSample(sample, Date_t()));
+            defaultDocs.emplace_back(sample);
+        }
+    }
+
+    ASSERT_OK(writer.close());
+
+    FTDCFileReader reader;
+    ASSERT_OK(reader.open(p));
+
+    std::vector<BSONObj> defaultDocsRead;
+    std::vector<BSONObj> periodicDocsRead;
+
+    auto sw = reader.hasNext();
+    for (; sw.isOK() && sw.getValue(); sw = reader.hasNext()) {
+        auto triplet = reader.next();
+        if (std::get<0>(triplet) == FTDCBSONUtil::FTDCType::kPeriodicMetricChunk) {
+            ASSERT_TRUE(reader.getPeriod());
+            ASSERT_EQUALS(*reader.getPeriod(), kPeriod);
+            periodicDocsRead.emplace_back(std::get<1>(triplet).getOwned());
+        } else {
+            ASSERT_TRUE(std::get<0>(triplet) == FTDCBSONUtil::FTDCType::kMetricChunk);
+            ASSERT_FALSE(reader.getPeriod());
+            defaultDocsRead.emplace_back(std::get<1>(triplet).getOwned());
+        }
+    }
+    ASSERT_OK(sw);
+
+    ASSERT_EQUALS(defaultDocs.size(), defaultDocsRead.size());
+    for (size_t i = 0; i < defaultDocs.size(); i++) {
+        ASSERT_BSONOBJ_EQ(defaultDocs[i], defaultDocsRead[i]);
+    }
+
+    ASSERT_EQUALS(periodicDocs.size(), periodicDocsRead.size());
+    for (size_t i = 0; i < periodicDocs.size(); i++) {
+        ASSERT_BSONOBJ_EQ(periodicDocs[i], periodicDocsRead[i]);
+    }
+}
+
 // Test a bad file
 TEST_F(FTDCFileTest, TestBadFile) {
     unittest::TempDir tempdir("metrics_testpath");
@@ -33,17 +33,58 @@
 
 #include <boost/filesystem.hpp>
 
+#include "mongo/db/commands/server_status.h"
 #include "mongo/db/ftdc/constants.h"
 #include "mongo/db/ftdc/controller.h"
 #include "mongo/db/ftdc/ftdc_server.h"
+#include "mongo/db/ftdc/ftdc_server_gen.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/storage/storage_options.h"
 
 namespace mongo {
 
 namespace {
+
+/**
+ * A FTDC Collector for the serverStatus sections that are worth sampling at a higher resolution
+ * than the rest of serverStatus: globalLock queueing and the WiredTiger cache, whose eviction
+ * stalls are usually over well within a regular one second sample.
+ */
+class FTDCHighResolutionServerStatusCollector : public FTDCCollectorInterface {
+public:
+    void collect(OperationContext* opCtx, BSONObjBuilder& builder) final {
+        BSONObjBuilder sectionsBuilder;
+        appendServerStatusSections(opCtx, {"globalLock", "wiredTigerCache"}, &sectionsBuilder);
+        auto sections = sectionsBuilder.done();
+
+        auto globalLock = sections["globalLock"];
+        if (!globalLock.eoo()) {
+            builder.append(globalLock);
+        }
+
+        // The cache statistics are read on their own rather than through the whole wiredTiger
+        // section, but are stored where they are in serverStatus so tools find them in one place.
+        auto cache = sections["wiredTigerCache"];
+        if (cache.isABSONObj()) {
+            BSONObjBuilder wiredTigerBuilder(builder.subobjStart("wiredTiger"));
+            wiredTigerBuilder.appendAs(cache, "cache");
+        }
+    }
+
+    std::string name() const final {
+        return "serverStatusHighResolution";
+    }
+};
+
 //mongodӹstartFTDC
 void registerMongoDCollectors(FTDCController* controller) {
+    auto highResolutionPeriodMillis = gDiagnosticDataCollectionHighResolutionPeriodMillis.load();
+    if (highResolutionPeriodMillis > 0) {
+        controller->addPeriodicCollector(
+            std::make_unique<FTDCHighResolutionServerStatusCollector>(),
+            Milliseconds(highResolutionPeriodMillis));
+    }
+
     // These metrics are only collected if replication is enabled
     if (repl::ReplicationCoordinator::get(getGlobalServiceContext())->getReplicationMode() !=
         repl::ReplicationCoordinator::modeNone) {
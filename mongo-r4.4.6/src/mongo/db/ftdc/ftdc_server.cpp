@@ -68,6 +68,9 @@ FTDCController* getGlobalFTDCController() {
  */
 synchronized_value<boost::filesystem::path> ftdcDirectoryPathParameter;
 
+// Sampling faster than this costs more in collection than it gains in resolution
+constexpr int kMinHighResolutionPeriodMillis = 10;
+
 }  // namespace
 
 FTDCStartupParams ftdcStartupParams;
@@ -176,6 +179,28 @@ Status onUpdateFTDCPerInterimUpdate(const std::int32_t potentialNewValue) {
     return Status::OK();
 }
 
+Status validateFTDCHighResolutionPeriod(const int& value) {
+    if (value != 0 && value < kMinHighResolutionPeriodMillis) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "diagnosticDataCollectionHighResolutionPeriodMillis must be 0 or "
+                                 "greater than or equal to "
+                              << kMinHighResolutionPeriodMillis};
+    }
+
+    return Status::OK();
+}
+
+Status validateFTDCBlockCompressor(const std::string& value) {
+    if (value != "zlib" && value != "zstd") {
+        return {ErrorCodes::BadValue,
+                str::stream() << "diagnosticDataCollectionBlockCompressor must be 'zlib' or "
+                                 "'zstd', found '"
+                              << value << "'"};
+    }
+
+    return Status::OK();
+}
+
 FTDCSimpleInternalCommandCollector::FTDCSimpleInternalCommandCollector(StringData command,
                                                                        StringData name,
                                                                        StringData ns,
@@ -272,6 +297,10 @@ void startFTDC(boost::filesystem::path& path,
         ftdcStartupParams.maxSamplesPerArchiveMetricChunk.load();
     config.maxSamplesPerInterimMetricChunk =
         ftdcStartupParams.maxSamplesPerInterimMetricChunk.load();
+    config.chunkFormat =
+        static_cast<FTDCChunkFormat>(gDiagnosticDataCollectionChunkFormatVersion.load());
+    config.blockCodec = gDiagnosticDataCollectionBlockCompressor == "zstd" ? FTDCBlockCodec::kZstd
+                                                                           : FTDCBlockCodec::kZlib;
 
     ftdcDirectoryPathParameter = path;
 
@@ -134,6 +134,12 @@ Status onUpdateFTDCFileSize(const std::int32_t value);
 Status onUpdateFTDCSamplesPerChunk(const std::int32_t value);
 Status onUpdateFTDCPerInterimUpdate(const std::int32_t value);
 
+/**
+ * Server Parameter validators
+ */
+Status validateFTDCHighResolutionPeriod(const int& value);
+Status validateFTDCBlockCompressor(const std::string& value);
+
 /**
  * Server Parameter accessors
  */
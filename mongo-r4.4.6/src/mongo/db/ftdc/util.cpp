@@ -59,6 +59,7 @@ const char kFTDCArchiveFile[] = "metrics";
 
 const char kFTDCIdField[] = "_id";
 const char kFTDCTypeField[] = "type";
+const char kFTDCPeriodField[] = "period";
 
 const char kFTDCDataField[] = "data";
 const char kFTDCDocField[] = "doc";
@@ -443,6 +444,19 @@ BSONObj createBSONMetricChunkDocument(ConstDataRange buf, Date_t date) {
     return builder.obj();
 }
 
+BSONObj createBSONPeriodicMetricChunkDocument(ConstDataRange buf,
+                                              Date_t date,
+                                              Milliseconds period) {
+    BSONObjBuilder builder;
+
+    builder.appendDate(kFTDCIdField, date);
+    builder.appendNumber(kFTDCTypeField, static_cast<int>(FTDCType::kPeriodicMetricChunk));
+    builder.appendNumber(kFTDCPeriodField, durationCount<Milliseconds>(period));
+    builder.appendBinData(kFTDCDataField, buf.length(), BinDataType::BinDataGeneral, buf.data());
+
+    return builder.obj();
+}
+
 StatusWith<Date_t> getBSONDocumentId(const BSONObj& obj) {
     BSONElement element;
 
@@ -463,6 +477,7 @@ StatusWith<FTDCType> getBSONDocumentType(const BSONObj& obj) {
     }
 
     if (static_cast<FTDCType>(value) != FTDCType::kMetricChunk &&
+        static_cast<FTDCType>(value) != FTDCType::kPeriodicMetricChunk &&
         static_cast<FTDCType>(value) != FTDCType::kMetadata) {
         return {ErrorCodes::BadValue,
                 str::stream() << "Field '" << std::string(kFTDCTypeField)
@@ -472,6 +487,23 @@ StatusWith<FTDCType> getBSONDocumentType(const BSONObj& obj) {
     return {static_cast<FTDCType>(value)};
 }
 
+StatusWith<Milliseconds> getBSONDocumentPeriod(const BSONObj& obj) {
+    long long value;
+
+    Status status = bsonExtractIntegerField(obj, kFTDCPeriodField, &value);
+    if (!status.isOK()) {
+        return {status};
+    }
+
+    if (value <= 0) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "Field '" << std::string(kFTDCPeriodField)
+                              << "' must be positive, found '" << value << "'"};
+    }
+
+    return {Milliseconds(value)};
+}
+
 StatusWith<BSONObj> getBSONDocumentFromMetadataDoc(const BSONObj& obj) {
     if (kDebugBuild) {
         auto swType = getBSONDocumentType(obj);
@@ -493,7 +525,9 @@ StatusWith<std::vector<BSONObj>> getMetricsFromMetricDoc(const BSONObj& obj,
                                                          FTDCDecompressor* decompressor) {
     if (kDebugBuild) {
         auto swType = getBSONDocumentType(obj);
-        dassert(swType.isOK() && swType.getValue() == FTDCType::kMetricChunk);
+        dassert(swType.isOK() &&
+                (swType.getValue() == FTDCType::kMetricChunk ||
+                 swType.getValue() == FTDCType::kPeriodicMetricChunk));
     }
 
     BSONElement element;
@@ -65,6 +65,15 @@ enum class FTDCType : std::int32_t {
      * See createBSONMetricChunkDocument
      */
     kMetricChunk = 1, //Ϣ
+
+    /**
+     * A metrics chunk for collectors sampled at a period other than the default FTDC period. It is
+     * a metric chunk header + the collection period in milliseconds + a compressed metric chunk.
+     * Each period is compressed against its own reference document.
+     *
+     * See createBSONPeriodicMetricChunkDocument
+     */
+    kPeriodicMetricChunk = 2,
 };
 
 
@@ -151,6 +160,20 @@ BSONObj createBSONMetadataDocument(const BSONObj& metadata, Date_t date);
  */
 BSONObj createBSONMetricChunkDocument(ConstDataRange buf, Date_t now);
 
+/**
+ * Create a BSON metric chunk document for samples collected at a period other than the default
+ * FTDC period. Identical to createBSONMetricChunkDocument except for the type and the period field.
+ *
+ * Example:
+ * {
+ *  "_id" : Date_t
+ *  "type" : 2
+ *  "period" : NumberLong(milliseconds)
+ *  "data" : BinData(...)
+ * }
+ */
+BSONObj createBSONPeriodicMetricChunkDocument(ConstDataRange buf, Date_t now, Milliseconds period);
+
 /**
  * Get the _id field of a BSON document
  */
@@ -161,6 +184,11 @@ StatusWith<Date_t> getBSONDocumentId(const BSONObj& obj);
  */
 StatusWith<FTDCType> getBSONDocumentType(const BSONObj& obj);
 
+/**
+ * Get the collection period of a periodic metric chunk document
+ */
+StatusWith<Milliseconds> getBSONDocumentPeriod(const BSONObj& obj);
+
 /**
  * Extract the metadata field from a BSON document
  */
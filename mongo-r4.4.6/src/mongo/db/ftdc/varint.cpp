@@ -29,9 +29,13 @@
 
 #include "mongo/db/ftdc/varint.h"
 
+#include <cstring>
 #include <third_party/s2/util/coding/varint.h>
 
+#include "mongo/platform/bits.h"
+#include "mongo/platform/endian.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/str.h"
 
 namespace mongo {
 
@@ -82,4 +86,79 @@ Status DataType::Handler<FTDCVarInt>::store(
     return Status::OK();
 }
 
+namespace {
+
+// Mask of the low n bytes of a 64-bit integer, indexed by n.
+const std::uint64_t kGroupVarIntMasks[] = {0x0ULL,
+                                           0xFFULL,
+                                           0xFFFFULL,
+                                           0xFFFFFFULL,
+                                           0xFFFFFFFFULL,
+                                           0xFFFFFFFFFFULL,
+                                           0xFFFFFFFFFFFFULL,
+                                           0xFFFFFFFFFFFFFFULL,
+                                           0xFFFFFFFFFFFFFFFFULL};
+
+}  // namespace
+
+std::size_t FTDCGroupVarInt::encode(const std::uint64_t* values, std::size_t count, char* out) {
+    const std::size_t controlLength = (count + 1) / 2;
+    auto control = reinterpret_cast<std::uint8_t*>(out);
+    char* data = out + controlLength;
+
+    std::memset(control, 0, controlLength);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        const std::uint64_t value = values[i];
+
+        // Number of significant bytes, 0 for a zero value.
+        const std::uint8_t length = (71 - countLeadingZeros64(value)) / 8;
+        control[i / 2] |= length << ((i & 1) * 4);
+
+        const std::uint64_t littleEndian = endian::nativeToLittle(value);
+        std::memcpy(data, &littleEndian, sizeof(littleEndian));
+        data += length;
+    }
+
+    return data - out;
+}
+
+StatusWith<std::size_t> FTDCGroupVarInt::decode(ConstDataRange buf,
+                                                std::size_t count,
+                                                std::uint64_t* values) {
+    const std::size_t controlLength = (count + 1) / 2;
+    if (buf.length() < controlLength) {
+        return Status(ErrorCodes::InvalidLength,
+                      str::stream() << "Group varint buffer of " << buf.length()
+                                    << " bytes is too short for " << count << " values");
+    }
+
+    auto control = reinterpret_cast<const std::uint8_t*>(buf.data());
+    const char* data = buf.data() + controlLength;
+    const char* const end = buf.data() + buf.length();
+
+    for (std::size_t i = 0; i < count; ++i) {
+        const std::size_t length = (control[i / 2] >> ((i & 1) * 4)) & 0xF;
+
+        if (length > sizeof(std::uint64_t) || length > static_cast<std::size_t>(end - data)) {
+            return Status(ErrorCodes::InvalidLength,
+                          str::stream() << "Group varint value " << i << " of " << count
+                                        << " is corrupt or truncated");
+        }
+
+        std::uint64_t littleEndian = 0;
+        if (static_cast<std::size_t>(end - data) >= sizeof(littleEndian)) {
+            std::memcpy(&littleEndian, data, sizeof(littleEndian));
+            values[i] = endian::littleToNative(littleEndian) & kGroupVarIntMasks[length];
+        } else {
+            std::memcpy(&littleEndian, data, length);
+            values[i] = endian::littleToNative(littleEndian);
+        }
+
+        data += length;
+    }
+
+    return static_cast<std::size_t>(data - buf.data());
+}
+
 }  // namespace mongo
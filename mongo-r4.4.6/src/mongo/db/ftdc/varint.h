@@ -32,8 +32,10 @@
 #include <cstddef>
 #include <cstdint>
 
+#include "mongo/base/data_range.h"
 #include "mongo/base/data_type.h"
 #include "mongo/base/status.h"
+#include "mongo/base/status_with.h"
 
 namespace mongo {
 /**
@@ -61,6 +63,54 @@ private:
     std::uint64_t _value{0};
 };
 
+/**
+ * Methods to compress and decompress arrays of 64-bit integers with a group varint layout similar
+ * to stream-vbyte:
+ *  - a stream of 4-bit byte counts, two per byte, the first value in the low nibble, followed by
+ *  - a stream of the little-endian bytes of each value with the leading zero bytes dropped.
+ * Zero is encoded as a zero byte count and no value bytes.
+ *
+ * Unlike FTDCVarInt, decoding does not branch on every byte: each value is an unaligned 8-byte
+ * load and a mask, so the loops are short and predictable.
+ */
+struct FTDCGroupVarInt {
+    /**
+     * Upper bound on the size of count encoded values, including the slack encode() needs to
+     * always store 8 bytes at a time.
+     */
+    static std::size_t maxEncodedSize(std::size_t count) {
+        return (count + 1) / 2 + (count + 1) * sizeof(std::uint64_t);
+    }
+
+    /**
+     * Map signed deltas stored in an unsigned integer to small unsigned integers so that small
+     * negative deltas also encode to few bytes.
+     */
+    static std::uint64_t zigZagEncode(std::uint64_t value) {
+        return (value << 1) ^ static_cast<std::uint64_t>(static_cast<std::int64_t>(value) >> 63);
+    }
+
+    static std::uint64_t zigZagDecode(std::uint64_t value) {
+        return (value >> 1) ^ (~(value & 1) + 1);
+    }
+
+    /**
+     * Encode count values into out, which must have room for maxEncodedSize(count) bytes.
+     *
+     * Returns the number of bytes used.
+     */
+    static std::size_t encode(const std::uint64_t* values, std::size_t count, char* out);
+
+    /**
+     * Decode count values from buf into values.
+     *
+     * Returns the number of bytes consumed, or an error if buf is too short or corrupt.
+     */
+    static StatusWith<std::size_t> decode(ConstDataRange buf,
+                                          std::size_t count,
+                                          std::uint64_t* values);
+};
+
 template <>
 struct DataType::Handler<FTDCVarInt> {
     /**
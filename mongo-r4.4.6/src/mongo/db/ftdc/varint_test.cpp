@@ -29,6 +29,9 @@
 
 #include "mongo/platform/basic.h"
 
+#include <limits>
+#include <vector>
+
 #include "mongo/base/data_builder.h"
 #include "mongo/base/data_type_validated.h"
 #include "mongo/base/init.h"
@@ -86,4 +89,57 @@ TEST(FTDCVarIntTest, TestDataBuilder) {
     };
 }
 
+// Test group varint arrays round trip, including zeros and every value width
+TEST(FTDCVarIntTest, TestGroupVarIntRoundTrip) {
+    std::vector<std::uint64_t> values;
+    for (int i = 0; i < 64; i++) {
+        values.push_back(0);
+        values.push_back(1ULL << i);
+        values.push_back((1ULL << i) - 1);
+        values.push_back(~0ULL >> i);
+    }
+
+    // Odd counts leave the last byte count nibble unused.
+    for (size_t count : {size_t(0), size_t(1), size_t(7), values.size()}) {
+        std::vector<char> buf(FTDCGroupVarInt::maxEncodedSize(count));
+        auto length = FTDCGroupVarInt::encode(values.data(), count, buf.data());
+        ASSERT_LTE(length, buf.size());
+
+        std::vector<std::uint64_t> decoded(count);
+        auto swLength =
+            FTDCGroupVarInt::decode(ConstDataRange(buf.data(), length), count, decoded.data());
+        ASSERT_OK(swLength);
+        ASSERT_EQUALS(length, swLength.getValue());
+
+        for (size_t i = 0; i < count; i++) {
+            ASSERT_EQUALS(values[i], decoded[i]);
+        }
+    }
+}
+
+// Test truncated group varint arrays are rejected
+TEST(FTDCVarIntTest, TestGroupVarIntTruncated) {
+    std::vector<std::uint64_t> values(5, ~0ULL);
+    std::vector<char> buf(FTDCGroupVarInt::maxEncodedSize(values.size()));
+    auto length = FTDCGroupVarInt::encode(values.data(), values.size(), buf.data());
+
+    std::vector<std::uint64_t> decoded(values.size());
+    ASSERT_NOT_OK(FTDCGroupVarInt::decode(
+        ConstDataRange(buf.data(), length - 1), values.size(), decoded.data()));
+    ASSERT_NOT_OK(
+        FTDCGroupVarInt::decode(ConstDataRange(buf.data(), 1), values.size(), decoded.data()));
+}
+
+// Test zig-zag encoding maps small negative deltas to small integers
+TEST(FTDCVarIntTest, TestZigZag) {
+    for (std::int64_t i : {0LL, 1LL, -1LL, 63LL, -64LL, std::numeric_limits<long long>::max(),
+                           std::numeric_limits<long long>::min()}) {
+        auto value = static_cast<std::uint64_t>(i);
+        ASSERT_EQUALS(value, FTDCGroupVarInt::zigZagDecode(FTDCGroupVarInt::zigZagEncode(value)));
+    }
+
+    ASSERT_EQUALS(1ULL, FTDCGroupVarInt::zigZagEncode(static_cast<std::uint64_t>(-1LL)));
+    ASSERT_EQUALS(2ULL, FTDCGroupVarInt::zigZagEncode(1ULL));
+}
+
 }  // namespace mongo
@@ -460,8 +460,9 @@ Status AbstractIndexAccessMethod::update(OperationContext* opCtx,
     return Status::OK();
 }
 
-Status AbstractIndexAccessMethod::compact(OperationContext* opCtx) {
-    return this->_newInterface->compact(opCtx);
+Status AbstractIndexAccessMethod::compact(OperationContext* opCtx,
+                                          boost::optional<Seconds> timeout) const {
+    return this->_newInterface->compact(opCtx, timeout);
 }
 
 class AbstractIndexAccessMethod::BulkBuilderImpl : public IndexAccessMethod::BulkBuilder {
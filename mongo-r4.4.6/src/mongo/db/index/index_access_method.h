@@ -205,9 +205,10 @@ public:
 
     /**
      * Attempt compaction to regain disk space if the indexed record store supports
-     * compaction-in-place.
+     * compaction-in-place. If 'timeout' is set, gives up with ErrorCodes::ExceededTimeLimit once
+     * compaction has run for that long.
      */
-    virtual Status compact(OperationContext* opCtx) = 0;
+    virtual Status compact(OperationContext* opCtx, boost::optional<Seconds> timeout) const = 0;
 
     /**
      * Sets this index as multikey with the provided paths.
@@ -518,7 +519,7 @@ public:
 
     RecordId findSingle(OperationContext* opCtx, const BSONObj& key) const final;
 
-    Status compact(OperationContext* opCtx) final;
+    Status compact(OperationContext* opCtx, boost::optional<Seconds> timeout) const final;
 
     void setIndexIsMultikey(OperationContext* opCtx,
                             KeyStringSet multikeyMetadataKeys,
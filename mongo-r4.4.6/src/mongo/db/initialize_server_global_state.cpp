@@ -295,6 +295,15 @@ void forkServerOrDie() {
         quickExit(EXIT_FAILURE);
 }
 
+Status validateAsyncLogOverflowPolicy(const std::string& value) {
+    if (value != "block" && value != "drop") {
+        return Status(ErrorCodes::BadValue,
+                      str::stream() << "asyncLogOverflowPolicy must be 'block' or 'drop', not '"
+                                    << value << "'");
+    }
+    return Status::OK();
+}
+
 MONGO_INITIALIZER_GENERAL(ServerLogRedirection,
                           ("GlobalLogManager", "EndStartupOptionHandling", "ForkServer"),
                           ("default"))
@@ -382,6 +391,12 @@ MONGO_INITIALIZER_GENERAL(ServerLogRedirection,
         }
     }
 
+    lv2Config.fileAsync = gAsyncLogFileWrites;
+    lv2Config.fileAsyncBufferRecords = gAsyncLogBufferRecords;
+    lv2Config.fileAsyncOverflowPolicy = gAsyncLogOverflowPolicy == "drop"
+        ? logv2::AsyncFileRotateSink::OverflowPolicy::kDrop
+        : logv2::AsyncFileRotateSink::OverflowPolicy::kBlock;
+
     lv2Config.timestampFormat = serverGlobalParams.logTimestampFormat;
     Status result = lv2Manager.getGlobalDomainInternal().configure(lv2Config);
     if (result.isOK() && writeServerRestartedAfterLogConfig) {
@@ -29,6 +29,10 @@
 
 #pragma once
 
+#include <string>
+
+#include "mongo/base/status.h"
+
 namespace mongo {
 
 class ServiceContext;
@@ -66,4 +70,9 @@ void forkServerOrDie();
  */
 void signalForkSuccess();
 
+/**
+ * Validates the asyncLogOverflowPolicy server parameter, which is either "block" or "drop".
+ */
+Status validateAsyncLogOverflowPolicy(const std::string& value);
+
 }  // namespace mongo
@@ -0,0 +1,362 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/matcher/compiled_filter.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+
+#include "mongo/bson/oid.h"
+#include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/db/matcher/expression_tree.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+namespace {
+
+bool isIntegral(BSONType type) {
+    return type == NumberInt || type == NumberLong;
+}
+
+bool isNonNaNDouble(const BSONElement& elem) {
+    return elem.type() == NumberDouble && !std::isnan(elem._numberDouble());
+}
+
+template <typename T>
+int compareValues(const T& lhs, const T& rhs) {
+    if (lhs < rhs)
+        return -1;
+    return lhs == rhs ? 0 : 1;
+}
+
+bool applyComparison(MatchExpression::MatchType op, int cmp) {
+    switch (op) {
+        case MatchExpression::EQ:
+            return cmp == 0;
+        case MatchExpression::LT:
+            return cmp < 0;
+        case MatchExpression::LTE:
+            return cmp <= 0;
+        case MatchExpression::GT:
+            return cmp > 0;
+        case MatchExpression::GTE:
+            return cmp >= 0;
+        default:
+            MONGO_UNREACHABLE;
+    }
+}
+
+/**
+ * Compares 'elem' against 'rhs' when both are of a type pair the kernels evaluate directly, storing
+ * the three-way result in 'cmp'. Returns false if the pair must be compared by the tree instead.
+ * The results agree with BSONElement::compareElements() for every pair accepted here.
+ */
+bool compareFast(const BSONElement& elem, const BSONElement& rhs, int* cmp) {
+    switch (rhs.type()) {
+        case NumberInt:
+        case NumberLong:
+            if (isIntegral(elem.type())) {
+                *cmp = compareValues(elem.numberLong(), rhs.numberLong());
+                return true;
+            }
+            // Every NumberInt is exactly representable as a double.
+            if (rhs.type() == NumberInt && isNonNaNDouble(elem)) {
+                *cmp = compareValues(elem._numberDouble(), double(rhs._numberInt()));
+                return true;
+            }
+            return false;
+        case NumberDouble:
+            if (isNonNaNDouble(elem)) {
+                *cmp = compareValues(elem._numberDouble(), rhs._numberDouble());
+                return true;
+            }
+            if (elem.type() == NumberInt) {
+                *cmp = compareValues(double(elem._numberInt()), rhs._numberDouble());
+                return true;
+            }
+            return false;
+        case String:
+            if (elem.type() == String) {
+                *cmp = elem.valueStringData().compare(rhs.valueStringData());
+                return true;
+            }
+            return false;
+        case Date:
+            if (elem.type() == Date) {
+                *cmp = compareValues(elem.date(), rhs.date());
+                return true;
+            }
+            return false;
+        case Bool:
+            if (elem.type() == Bool) {
+                *cmp = compareValues(elem.boolean(), rhs.boolean());
+                return true;
+            }
+            return false;
+        case jstOID:
+            if (elem.type() == jstOID) {
+                *cmp = std::memcmp(elem.value(), rhs.value(), OID::kOIDSize);
+                return true;
+            }
+            return false;
+        default:
+            return false;
+    }
+}
+
+bool isCompilableRhs(const BSONElement& rhs, const CollatorInterface* collator) {
+    switch (rhs.type()) {
+        case NumberInt:
+        case NumberLong:
+        case Date:
+        case Bool:
+        case jstOID:
+            return true;
+        case NumberDouble:
+            return !std::isnan(rhs._numberDouble());
+        case String:
+            return !collator;
+        default:
+            return false;
+    }
+}
+
+}  // namespace
+
+std::unique_ptr<CompiledFilter> CompiledFilter::compile(const MatchExpression* root) {
+    if (!root) {
+        return nullptr;
+    }
+
+    std::unique_ptr<CompiledFilter> compiled(new CompiledFilter(root));
+
+    std::vector<const MatchExpression*> conjuncts;
+    if (root->matchType() == MatchExpression::AND) {
+        for (size_t i = 0; i < root->numChildren(); ++i) {
+            conjuncts.push_back(root->getChild(i));
+        }
+    } else {
+        conjuncts.push_back(root);
+    }
+
+    for (auto&& expr : conjuncts) {
+        Step step;
+        step.expr = expr;
+        if (!compiled->_compileLeaf(expr, &step)) {
+            step = Step();
+            step.expr = expr;
+        }
+        compiled->_steps.push_back(std::move(step));
+    }
+
+    if (compiled->numKernels() == 0) {
+        return nullptr;
+    }
+    return compiled;
+}
+
+bool CompiledFilter::_compileLeaf(const MatchExpression* expr, Step* step) {
+    switch (expr->matchType()) {
+        case MatchExpression::EQ:
+        case MatchExpression::LT:
+        case MatchExpression::LTE:
+        case MatchExpression::GT:
+        case MatchExpression::GTE: {
+            auto cmp = static_cast<const ComparisonMatchExpressionBase*>(expr);
+            if (!isCompilableRhs(cmp->getData(), cmp->getCollator())) {
+                return false;
+            }
+            step->kind = StepKind::kCompare;
+            step->rhs = cmp->getData();
+            break;
+        }
+        case MatchExpression::MATCH_IN: {
+            auto in = static_cast<const InMatchExpression*>(expr);
+            const auto& equalities = in->getEqualities();
+            if (in->hasNull() || !in->getRegexes().empty() || equalities.empty()) {
+                return false;
+            }
+            if (std::all_of(equalities.begin(), equalities.end(), [](const BSONElement& e) {
+                    return isIntegral(e.type());
+                })) {
+                step->kind = StepKind::kInIntegral;
+                for (auto&& e : equalities) {
+                    step->integralSet.push_back(e.numberLong());
+                }
+                std::sort(step->integralSet.begin(), step->integralSet.end());
+            } else if (!in->getCollator() &&
+                       std::all_of(equalities.begin(),
+                                   equalities.end(),
+                                   [](const BSONElement& e) { return e.type() == String; })) {
+                step->kind = StepKind::kInString;
+                for (auto&& e : equalities) {
+                    step->stringSet.push_back(e.valueStringData());
+                }
+                std::sort(step->stringSet.begin(), step->stringSet.end());
+            } else {
+                return false;
+            }
+            break;
+        }
+        default:
+            return false;
+    }
+
+    return _compilePath(expr->path(), step);
+}
+
+bool CompiledFilter::_compilePath(StringData path, Step* step) {
+    if (path.empty()) {
+        return false;
+    }
+
+    std::vector<std::string> components;
+    size_t start = 0;
+    while (true) {
+        size_t dot = path.find('.', start);
+        auto component =
+            dot == std::string::npos ? path.substr(start) : path.substr(start, dot - start);
+        if (component.empty()) {
+            return false;
+        }
+        components.push_back(component.toString());
+        if (dot == std::string::npos) {
+            break;
+        }
+        start = dot + 1;
+    }
+
+    auto it = std::find(_topLevelFields.begin(), _topLevelFields.end(), components.front());
+    if (it == _topLevelFields.end()) {
+        if (_topLevelFields.size() == kMaxTopLevelFields) {
+            return false;
+        }
+        it = _topLevelFields.insert(_topLevelFields.end(), components.front());
+    }
+
+    step->fieldIndex = it - _topLevelFields.begin();
+    step->suffix.assign(std::make_move_iterator(components.begin() + 1),
+                        std::make_move_iterator(components.end()));
+    return true;
+}
+
+size_t CompiledFilter::numKernels() const {
+    return std::count_if(_steps.begin(), _steps.end(), [](const Step& step) {
+        return step.kind != StepKind::kResidual;
+    });
+}
+
+bool CompiledFilter::_evaluate(const Step& step, const BSONElement& elem) const {
+    switch (step.kind) {
+        case StepKind::kCompare: {
+            int cmp;
+            if (!compareFast(elem, step.rhs, &cmp)) {
+                break;
+            }
+            return applyComparison(step.expr->matchType(), cmp);
+        }
+        case StepKind::kInIntegral:
+            if (!isIntegral(elem.type())) {
+                break;
+            }
+            return std::binary_search(
+                step.integralSet.begin(), step.integralSet.end(), elem.numberLong());
+        case StepKind::kInString:
+            if (elem.type() != String) {
+                break;
+            }
+            return std::binary_search(
+                step.stringSet.begin(), step.stringSet.end(), elem.valueStringData());
+        case StepKind::kResidual:
+            MONGO_UNREACHABLE;
+    }
+
+    // The kernel does not handle this type pair; the leaf's own element matcher does.
+    return step.expr->matchesSingleElement(elem);
+}
+
+bool CompiledFilter::matches(const BSONObj& doc) const {
+    // Locate the first occurrence of every top-level field in a single pass over the document,
+    // which is the element ElementPath traversal would find.
+    std::array<BSONElement, kMaxTopLevelFields> fields;
+    std::array<bool, kMaxTopLevelFields> found{};
+    size_t remaining = _topLevelFields.size();
+
+    BSONObjIterator it(doc);
+    while (remaining > 0 && it.more()) {
+        BSONElement elem = it.next();
+        StringData fieldName = elem.fieldNameStringData();
+        for (size_t i = 0; i < _topLevelFields.size(); ++i) {
+            if (!found[i] && _topLevelFields[i] == fieldName) {
+                fields[i] = elem;
+                found[i] = true;
+                --remaining;
+                break;
+            }
+        }
+    }
+
+    for (auto&& step : _steps) {
+        if (step.kind == StepKind::kResidual) {
+            if (!step.expr->matchesBSON(doc)) {
+                return false;
+            }
+            continue;
+        }
+
+        BSONElement elem = fields[step.fieldIndex];
+        bool sawArray = elem.type() == Array;
+        for (auto&& component : step.suffix) {
+            if (sawArray) {
+                break;
+            }
+            if (elem.type() != Object) {
+                // A missing or scalar intermediate yields a single missing element.
+                elem = BSONElement();
+                break;
+            }
+            elem = elem.embeddedObject().getField(component);
+            sawArray = elem.type() == Array;
+        }
+
+        bool matched = sawArray ? step.expr->matchesBSON(doc) : _evaluate(step, elem);
+        if (!matched) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+}  // namespace mongo
@@ -0,0 +1,132 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonelement.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/matcher/expression.h"
+
+namespace mongo {
+
+/**
+ * A flattened, allocation-free evaluator for the common shape of query filters: a conjunction of
+ * comparisons and $in predicates against scalar fields.
+ *
+ * Compilation walks the top-level children of an $and (or a single leaf) and turns each $eq, $lt,
+ * $lte, $gt, $gte and $in leaf over a plain field path into a typed kernel. Matching then makes a
+ * single pass over the top-level fields of the document to locate every field the kernels need,
+ * resolves dotted paths through embedded objects, and runs the kernels without going through
+ * ElementPath iterators or virtual dispatch. Any child that cannot be compiled is kept as a
+ * residual and evaluated by the tree in its original position, so the compiled filter always
+ * returns exactly what 'source()->matchesBSON()' would.
+ *
+ * Array-valued fields are never handled by the kernels: whenever path resolution encounters an
+ * array, the leaf is evaluated through the tree, which implements the implicit array traversal
+ * rules.
+ *
+ * The compiled filter holds pointers into the source tree, which must outlive it and must not be
+ * modified (renamed, re-collated, or optimized) after compilation. Matching is const and keeps its
+ * scratch state on the stack, so a single CompiledFilter may be shared across threads.
+ */
+class CompiledFilter {
+    CompiledFilter(const CompiledFilter&) = delete;
+    CompiledFilter& operator=(const CompiledFilter&) = delete;
+
+public:
+    // Maximum number of distinct top-level fields a compiled filter looks up. Leaves over further
+    // fields are evaluated as residuals.
+    static constexpr size_t kMaxTopLevelFields = 32;
+
+    /**
+     * Returns a compiled form of 'root', or nullptr if no part of 'root' benefits from compilation.
+     */
+    static std::unique_ptr<CompiledFilter> compile(const MatchExpression* root);
+
+    /**
+     * Returns true if 'doc' satisfies the source expression.
+     */
+    bool matches(const BSONObj& doc) const;
+
+    const MatchExpression* source() const {
+        return _source;
+    }
+
+    /**
+     * Returns the number of leaves evaluated by specialized kernels rather than the tree.
+     */
+    size_t numKernels() const;
+
+private:
+    enum class StepKind {
+        // A comparison against a single scalar right-hand side.
+        kCompare,
+        // An $in whose equalities are all NumberInt or NumberLong.
+        kInIntegral,
+        // An $in whose equalities are all strings and which has no collator.
+        kInString,
+        // Anything else; evaluated with MatchExpression::matchesBSON().
+        kResidual,
+    };
+
+    struct Step {
+        StepKind kind = StepKind::kResidual;
+        const MatchExpression* expr = nullptr;
+
+        // Index into '_topLevelFields' of the first path component.
+        size_t fieldIndex = 0;
+        // The remaining path components, if the path is dotted.
+        std::vector<std::string> suffix;
+
+        // kCompare only. Points into the BSON owned by 'expr'.
+        BSONElement rhs;
+
+        // kInIntegral and kInString only. Sorted for binary search.
+        std::vector<long long> integralSet;
+        std::vector<StringData> stringSet;
+    };
+
+    explicit CompiledFilter(const MatchExpression* source) : _source(source) {}
+
+    bool _compileLeaf(const MatchExpression* expr, Step* step);
+    bool _compilePath(StringData path, Step* step);
+
+    bool _evaluate(const Step& step, const BSONElement& elem) const;
+
+    const MatchExpression* _source;
+    std::vector<Step> _steps;
+    std::vector<std::string> _topLevelFields;
+};
+
+}  // namespace mongo
@@ -0,0 +1,232 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <limits>
+
+#include "mongo/bson/json.h"
+#include "mongo/db/matcher/compiled_filter.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Documents covering the type pairs the kernels handle, the pairs they hand back to the tree, and
+ * the path shapes (missing, scalar intermediate, array) that force tree evaluation.
+ */
+std::vector<BSONObj> makeCorpus() {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const OID oid1 = OID("5f0000000000000000000001");
+    const OID oid2 = OID("5f0000000000000000000002");
+    const BSONObj literals[] = {
+        BSON("a" << 1),
+        BSON("a" << 5),
+        BSON("a" << 10),
+        BSON("a" << -3),
+        BSON("a" << 5LL),
+        BSON("a" << (1LL << 40)),
+        BSON("a" << 5.0),
+        BSON("a" << 5.5),
+        BSON("a" << -0.0),
+        BSON("a" << nan),
+        BSON("a" << Decimal128("5")),
+        BSON("a" << Decimal128("5.1")),
+        BSON("a"
+             << "abc"),
+        BSON("a"
+             << "abd"),
+        BSON("a"
+             << "ab"),
+        BSON("a"
+             << ""),
+        BSON("a" << true),
+        BSON("a" << false),
+        BSON("a" << Date_t::fromMillisSinceEpoch(-1000)),
+        BSON("a" << Date_t::fromMillisSinceEpoch(1000)),
+        BSON("a" << oid1),
+        BSON("a" << oid2),
+        BSON("a" << BSONNULL),
+        BSON("a" << BSONUndefined),
+        BSON("a" << MINKEY),
+        BSON("a" << MAXKEY),
+        BSON("a" << BSONSymbol("abc")),
+        BSON("a" << BSON_ARRAY(1 << 5 << 10)),
+        BSON("a" << BSON_ARRAY("abc" << 7)),
+        BSON("a" << BSONArray()),
+        BSON("a" << BSON("b" << 5)),
+        BSON("a" << BSON("b"
+                         << "abc")),
+        BSON("a" << BSON("b" << BSON("c" << 5))),
+        BSON("a" << BSON("b" << BSON_ARRAY(5 << 6))),
+        BSON("a" << BSON_ARRAY(BSON("b" << 5) << BSON("b" << 7))),
+        BSON("a" << BSON("c" << 5)),
+        BSON("a" << 5 << "a" << 7),
+        BSON("a" << 7 << "a" << 5),
+        BSON("a" << 5 << "b" << 10 << "c"
+                 << "abc"),
+        BSON("a" << 5 << "b" << BSON_ARRAY(10) << "c"
+                 << "abd"),
+        BSON("b" << 10),
+        BSONObj(),
+    };
+    return std::vector<BSONObj>(std::begin(literals), std::end(literals));
+}
+
+class CompiledFilterTest : public unittest::Test {
+protected:
+    std::unique_ptr<MatchExpression> parse(const BSONObj& query) {
+        return uassertStatusOK(MatchExpressionParser::parse(query, _expCtx));
+    }
+
+    std::unique_ptr<MatchExpression> parse(const std::string& query) {
+        return parse(fromjson(query));
+    }
+
+    void setCollator(std::unique_ptr<CollatorInterface> collator) {
+        _expCtx->setCollator(std::move(collator));
+    }
+
+    /**
+     * Asserts that 'query' compiles to at least one kernel and that the compiled filter agrees with
+     * the tree on every document in the corpus.
+     */
+    void assertAgreesWithTree(const std::string& query) {
+        auto expr = parse(query);
+        auto compiled = CompiledFilter::compile(expr.get());
+        ASSERT(compiled) << query;
+        ASSERT_GT(compiled->numKernels(), 0u);
+        for (auto&& doc : makeCorpus()) {
+            ASSERT_EQ(compiled->matches(doc), expr->matchesBSON(doc))
+                << "query: " << query << ", doc: " << doc;
+        }
+    }
+
+    bool compiles(const std::string& query) {
+        auto expr = parse(query);
+        return CompiledFilter::compile(expr.get()) != nullptr;
+    }
+
+private:
+    boost::intrusive_ptr<ExpressionContextForTest> _expCtx{new ExpressionContextForTest()};
+};
+
+TEST_F(CompiledFilterTest, NumericComparisonsAgreeWithTree) {
+    for (auto op : {"$eq", "$lt", "$lte", "$gt", "$gte"}) {
+        for (auto rhs : {"5", "NumberLong(5)", "5.0", "5.5", "-0.0", "NumberLong(1099511627776)"}) {
+            assertAgreesWithTree(std::string("{a: {") + op + ": " + rhs + "}}");
+        }
+    }
+}
+
+TEST_F(CompiledFilterTest, StringDateBoolAndOIDComparisonsAgreeWithTree) {
+    for (auto op : {"$eq", "$lt", "$lte", "$gt", "$gte"}) {
+        for (auto rhs : {"'abc'",
+                         "''",
+                         "{$date: 0}",
+                         "{$date: -500}",
+                         "true",
+                         "false",
+                         "{$oid: '5f0000000000000000000001'}"}) {
+            assertAgreesWithTree(std::string("{a: {") + op + ": " + rhs + "}}");
+        }
+    }
+}
+
+TEST_F(CompiledFilterTest, InAgreesWithTree) {
+    assertAgreesWithTree("{a: {$in: [1, 5, NumberLong(10)]}}");
+    assertAgreesWithTree("{a: {$in: [NumberLong(1099511627776), -3]}}");
+    assertAgreesWithTree("{a: {$in: ['abc', 'ab', '']}}");
+}
+
+TEST_F(CompiledFilterTest, DottedPathsAgreeWithTree) {
+    assertAgreesWithTree("{'a.b': 5}");
+    assertAgreesWithTree("{'a.b': {$gte: 'abc'}}");
+    assertAgreesWithTree("{'a.b.c': {$lt: 6}}");
+    assertAgreesWithTree("{'a.b': {$in: [5, 7]}}");
+}
+
+TEST_F(CompiledFilterTest, ConjunctionsWithResidualsAgreeWithTree) {
+    assertAgreesWithTree("{a: {$gt: 1, $lt: 10}}");
+    assertAgreesWithTree("{a: 5, b: 10, c: 'abc'}");
+    assertAgreesWithTree("{a: 5, b: {$exists: true}}");
+    assertAgreesWithTree("{a: {$type: 'number', $lte: 5}}");
+    assertAgreesWithTree("{c: /^ab/, a: {$in: [5, 7]}}");
+    assertAgreesWithTree("{$or: [{a: 1}, {b: 10}], a: {$gte: 1}}");
+    assertAgreesWithTree("{a: 5, 'a.b': 5}");
+}
+
+TEST_F(CompiledFilterTest, DoesNotCompileWithoutKernels) {
+    ASSERT_FALSE(compiles("{}"));
+    ASSERT_FALSE(compiles("{a: null}"));
+    ASSERT_FALSE(compiles("{a: {$exists: true}}"));
+    ASSERT_FALSE(compiles("{a: {$in: [1, null]}}"));
+    ASSERT_FALSE(compiles("{a: {$in: [1, /x/]}}"));
+    ASSERT_FALSE(compiles("{a: {$in: [1, 'abc']}}"));
+    ASSERT_FALSE(compiles("{a: {$eq: NaN}}"));
+    ASSERT_FALSE(compiles("{a: {$eq: {$minKey: 1}}}"));
+    ASSERT_FALSE(compiles("{$or: [{a: 1}, {b: 1}]}"));
+}
+
+TEST_F(CompiledFilterTest, StringKernelsAreNotUsedWithCollator) {
+    setCollator(
+        std::make_unique<CollatorInterfaceMock>(CollatorInterfaceMock::MockType::kToLowerString));
+    ASSERT_FALSE(compiles("{a: 'ABC'}"));
+    ASSERT_FALSE(compiles("{a: {$in: ['ABC']}}"));
+
+    // Numeric predicates are unaffected by the collation.
+    assertAgreesWithTree("{a: {$in: [1, 5]}}");
+    assertAgreesWithTree("{a: {$gt: 1}, c: 'ABC'}");
+}
+
+TEST_F(CompiledFilterTest, LeavesBeyondFieldLimitAreEvaluatedByTree) {
+    BSONObjBuilder query;
+    BSONObjBuilder doc;
+    for (size_t i = 0; i < CompiledFilter::kMaxTopLevelFields + 4; ++i) {
+        const std::string field = str::stream() << "f" << i;
+        query.append(field, static_cast<int>(i));
+        doc.append(field, static_cast<int>(i));
+    }
+    auto expr = parse(query.obj());
+    auto compiled = CompiledFilter::compile(expr.get());
+    ASSERT(compiled);
+    ASSERT_EQ(compiled->numKernels(), CompiledFilter::kMaxTopLevelFields);
+
+    const BSONObj matching = doc.obj();
+    ASSERT_TRUE(compiled->matches(matching));
+    ASSERT_FALSE(compiled->matches(matching.removeField("f35")));
+    ASSERT_FALSE(compiled->matches(matching.removeField("f0")));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -35,6 +35,7 @@
 #include "mongo/db/matcher/expression_parser.h"
 #include "mongo/db/matcher/matcher.h"
 #include "mongo/db/matcher/path.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/util/stacktrace.h"
 #include "mongo/util/str.h"
 
@@ -47,12 +48,18 @@ Matcher::Matcher(const BSONObj& pattern,
     : _pattern(pattern) {
     _expression = uassertStatusOK(
         MatchExpressionParser::parse(pattern, expCtx, extensionsCallback, allowedFeatures));
+    if (internalQueryCompileMatchFilters.load()) {
+        _compiledFilter = CompiledFilter::compile(_expression.get());
+    }
 }
 
 bool Matcher::matches(const BSONObj& doc, MatchDetails* details) const {
     if (!_expression)
         return true;
 
+    if (_compiledFilter && !details)
+        return _compiledFilter->matches(doc);
+
     return _expression->matchesBSON(doc, details);
 }
 
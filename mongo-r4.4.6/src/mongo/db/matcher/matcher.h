@@ -32,6 +32,7 @@
 
 #include "mongo/base/status.h"
 #include "mongo/bson/bsonobj.h"
+#include "mongo/db/matcher/compiled_filter.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/matcher/expression_parser.h"
 #include "mongo/db/matcher/extensions_callback_noop.h"
@@ -81,6 +82,10 @@ private:
     BSONObj _pattern;
 
     std::unique_ptr<MatchExpression> _expression;
+
+    // Compiled form of '_expression', used when no MatchDetails are requested. Null if the
+    // expression has no compilable predicates.
+    std::unique_ptr<CompiledFilter> _compiledFilter;
 };
 
 }  // namespace mongo
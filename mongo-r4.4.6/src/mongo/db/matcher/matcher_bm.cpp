@@ -0,0 +1,115 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/bson/json.h"
+#include "mongo/db/matcher/matcher.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/platform/random.h"
+
+namespace mongo {
+namespace {
+
+std::vector<BSONObj> makeInput(int nDocs) {
+    PseudoRandom random(1);
+    std::vector<BSONObj> input;
+    input.reserve(nDocs);
+    for (int i = 0; i < nDocs; ++i) {
+        BSONObjBuilder doc;
+        doc.append("_id", OID::gen());
+        doc.append("status", (random.nextInt32(4) == 0) ? "closed" : "open");
+        doc.append("qty", random.nextInt32(1000));
+        doc.append("price", random.nextCanonicalDouble() * 100);
+        doc.append("category", static_cast<long long>(random.nextInt32(20)));
+        doc.append("created", Date_t::fromMillisSinceEpoch(random.nextInt64(1LL << 41)));
+        {
+            BSONObjBuilder customer(doc.subobjStart("customer"));
+            customer.append("name", str::stream() << "name" << random.nextInt32(1000));
+            customer.append("tier", random.nextInt32(3));
+        }
+        doc.append("tags", BSON_ARRAY("a" << "b"));
+        doc.append("notes", "the quick brown fox jumps over the lazy dog");
+        input.push_back(doc.obj());
+    }
+    return input;
+}
+
+void runMatcher(benchmark::State& state, const std::string& query) {
+    const bool compileFilters = state.range(0);
+    const bool oldCompileFilters = internalQueryCompileMatchFilters.load();
+    internalQueryCompileMatchFilters.store(compileFilters);
+
+    const auto input = makeInput(1000);
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    Matcher matcher(fromjson(query), expCtx);
+
+    for (auto keepRunning : state) {
+        for (auto&& doc : input) {
+            benchmark::DoNotOptimize(matcher.matches(doc));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * input.size());
+
+    internalQueryCompileMatchFilters.store(oldCompileFilters);
+}
+
+// A single equality on a string field.
+void BM_MatchEquality(benchmark::State& state) {
+    runMatcher(state, "{status: 'open'}");
+}
+
+// A range over one field combined with equalities over others, including a field late in the
+// document.
+void BM_MatchConjunction(benchmark::State& state) {
+    runMatcher(state,
+               "{qty: {$gte: 100, $lt: 900}, price: {$lt: 75.5}, status: 'open',"
+               " created: {$gt: {$date: 1000000000000}}}");
+}
+
+// An $in over integers and an equality on a dotted path.
+void BM_MatchInAndDottedPath(benchmark::State& state) {
+    runMatcher(state, "{category: {$in: [1, 3, 5, 7, 11, 13, 17, 19]}, 'customer.tier': 2}");
+}
+
+// A conjunction which mixes compilable predicates with ones evaluated by the tree.
+void BM_MatchWithResiduals(benchmark::State& state) {
+    runMatcher(state, "{qty: {$gt: 10}, tags: 'b', notes: {$exists: true}, status: 'open'}");
+}
+
+BENCHMARK(BM_MatchEquality)->Arg(false)->Arg(true);
+BENCHMARK(BM_MatchConjunction)->Arg(false)->Arg(true);
+BENCHMARK(BM_MatchInAndDottedPath)->Arg(false)->Arg(true);
+BENCHMARK(BM_MatchWithResiduals)->Arg(false)->Arg(true);
+
+}  // namespace
+}  // namespace mongo
@@ -81,6 +81,14 @@ public:
         processInternal(input, merging);
     }
 
+    /** Process 'count' inputs, in order, with the same effect as calling process() on each.
+     *  Accumulators with a type-specialized kernel for common inputs override
+     *  processBatchInternal().
+     */
+    void processBatch(const Value* inputs, size_t count, bool merging) {
+        processBatchInternal(inputs, count, merging);
+    }
+
     /**
      * Finish processing all the pending operations, and clean up memory. Some accumulators
      * ($accumulator for example) might do a batch processing in order to improve performace. In
@@ -145,6 +153,13 @@ protected:
     /// Update subclass's internal state based on input
     virtual void processInternal(const Value& input, bool merging) = 0;
 
+    /// Update subclass's internal state based on a run of inputs
+    virtual void processBatchInternal(const Value* inputs, size_t count, bool merging) {
+        for (size_t i = 0; i < count; ++i) {
+            processInternal(inputs[i], merging);
+        }
+    }
+
     const boost::intrusive_ptr<ExpressionContext>& getExpressionContext() const {
         return _expCtx;
     }
@@ -247,6 +262,9 @@ public:
         return true;
     }
 
+protected:
+    void processBatchInternal(const Value* inputs, size_t count, bool merging) final;
+
 private:
     BSONType totalType = NumberInt;
     DoubleDoubleSummation nonDecimalTotal;
@@ -275,6 +293,9 @@ public:
         return true;
     }
 
+protected:
+    void processBatchInternal(const Value* inputs, size_t count, bool merging) final;
+
 private:
     Value _val;
     const Sense _sense;
@@ -330,6 +351,9 @@ public:
     static boost::intrusive_ptr<AccumulatorState> create(
         const boost::intrusive_ptr<ExpressionContext>& expCtx);
 
+protected:
+    void processBatchInternal(const Value* inputs, size_t count, bool merging) final;
+
 private:
     /**
      * The total of all values is partitioned between those that are decimals, and those that are
@@ -338,6 +362,8 @@ private:
     Decimal128 _getDecimalTotal() const;
 
     bool _isDecimal;
+    // True while only integers have been added to '_nonDecimalTotal'.
+    bool _nonDecimalTotalIsIntegral = true;
     DoubleDoubleSummation _nonDecimalTotal;
     Decimal128 _decimalTotal;
     long long _count;
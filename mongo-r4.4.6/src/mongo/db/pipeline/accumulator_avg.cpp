@@ -37,6 +37,7 @@
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/platform/decimal128.h"
+#include "mongo/platform/overflow_arithmetic.h"
 
 namespace mongo {
 
@@ -83,8 +84,11 @@ void AccumulatorAvg::processInternal(const Value& input, bool merging) {
             _nonDecimalTotal.addLong(input.getLong());
             break;
         case NumberInt:
+            _nonDecimalTotal.addDouble(input.getDouble());
+            break;
         case NumberDouble:
             _nonDecimalTotal.addDouble(input.getDouble());
+            _nonDecimalTotalIsIntegral = false;
             break;
         default:
             dassert(!input.numeric());
@@ -93,6 +97,40 @@ void AccumulatorAvg::processInternal(const Value& input, bool merging) {
     _count++;
 }
 
+void AccumulatorAvg::processBatchInternal(const Value* inputs, size_t count, bool merging) {
+    size_t i = 0;
+
+    // As for $sum, a leading run of integers added to an exact integer total can be summed in a
+    // 64-bit integer and folded in at once without changing the result.
+    if (!merging && _nonDecimalTotalIsIntegral) {
+        long long partial = 0;
+        long long numAdded = 0;
+        for (; i < count; ++i) {
+            const Value& input = inputs[i];
+            const BSONType type = input.getType();
+            if (type != NumberInt && type != NumberLong) {
+                if (input.numeric()) {
+                    break;
+                }
+                continue;
+            }
+
+            long long newPartial;
+            if (overflow::add(partial, input.coerceToLong(), &newPartial)) {
+                break;
+            }
+            partial = newPartial;
+            ++numAdded;
+        }
+        _nonDecimalTotal.addLong(partial);
+        _count += numAdded;
+    }
+
+    for (; i < count; ++i) {
+        processInternal(inputs[i], merging);
+    }
+}
+
 intrusive_ptr<AccumulatorState> AccumulatorAvg::create(
     const boost::intrusive_ptr<ExpressionContext>& expCtx) {
     return new AccumulatorAvg(expCtx);
@@ -130,6 +168,7 @@ AccumulatorAvg::AccumulatorAvg(const boost::intrusive_ptr<ExpressionContext>& ex
 
 void AccumulatorAvg::reset() {
     _isDecimal = false;
+    _nonDecimalTotalIsIntegral = true;
     _nonDecimalTotal = {};
     _decimalTotal = {};
     _count = 0;
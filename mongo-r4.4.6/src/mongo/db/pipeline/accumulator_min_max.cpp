@@ -31,6 +31,8 @@
 
 #include "mongo/db/pipeline/accumulator.h"
 
+#include <cmath>
+
 #include "mongo/db/exec/document_value/value.h"
 #include "mongo/db/pipeline/accumulation_statement.h"
 #include "mongo/db/pipeline/expression.h"
@@ -62,6 +64,55 @@ void AccumulatorMinMax::processInternal(const Value& input, bool merging) {
     }
 }
 
+void AccumulatorMinMax::processBatchInternal(const Value* inputs, size_t count, bool merging) {
+    // When every non-nullish input in the run is a number of one type (and not NaN), find the
+    // extreme of the run natively and offer only that to processInternal(). Ties keep the earliest
+    // input, as comparing the inputs one at a time would.
+    BSONType runType = EOO;
+    size_t best = count;
+    for (size_t i = 0; i < count; ++i) {
+        const Value& input = inputs[i];
+        if (input.nullish()) {
+            continue;
+        }
+
+        const BSONType type = input.getType();
+        const bool supported = (best == count)
+            ? (type == NumberInt || type == NumberLong || type == NumberDouble)
+            : type == runType;
+        if (!supported || (type == NumberDouble && std::isnan(input.getDouble()))) {
+            for (size_t j = 0; j < count; ++j) {
+                processInternal(inputs[j], merging);
+            }
+            return;
+        }
+
+        if (best == count) {
+            runType = type;
+            best = i;
+            continue;
+        }
+
+        int cmp;
+        if (type == NumberDouble) {
+            const double lhs = inputs[best].getDouble();
+            const double rhs = input.getDouble();
+            cmp = lhs < rhs ? -1 : (lhs > rhs ? 1 : 0);
+        } else {
+            const long long lhs = inputs[best].coerceToLong();
+            const long long rhs = input.coerceToLong();
+            cmp = lhs < rhs ? -1 : (lhs > rhs ? 1 : 0);
+        }
+        if (cmp * _sense > 0) {
+            best = i;
+        }
+    }
+
+    if (best != count) {
+        processInternal(inputs[best], merging);
+    }
+}
+
 Value AccumulatorMinMax::getValue(bool toBeMerged) {
     if (_val.missing()) {
         return Value(BSONNULL);
@@ -37,6 +37,7 @@
 #include "mongo/db/exec/document_value/value.h"
 #include "mongo/db/pipeline/accumulation_statement.h"
 #include "mongo/db/pipeline/expression.h"
+#include "mongo/platform/overflow_arithmetic.h"
 #include "mongo/util/summation.h"
 
 namespace mongo {
@@ -85,6 +86,42 @@ void AccumulatorSum::processInternal(const Value& input, bool merging) {
     }
 }
 
+void AccumulatorSum::processBatchInternal(const Value* inputs, size_t count, bool merging) {
+    size_t i = 0;
+
+    // While only integers have been summed, 'nonDecimalTotal' holds an exact integer. A leading run
+    // of NumberInt and NumberLong inputs can then be added up in a 64-bit integer and folded in
+    // with a single addLong(), which yields the same exact total as adding them one at a time.
+    // Non-numeric inputs are skipped, as in processInternal().
+    if (!merging && (totalType == NumberInt || totalType == NumberLong)) {
+        long long partial = 0;
+        for (; i < count; ++i) {
+            const Value& input = inputs[i];
+            const BSONType type = input.getType();
+            if (type != NumberInt && type != NumberLong) {
+                if (input.numeric()) {
+                    break;
+                }
+                continue;
+            }
+
+            long long newPartial;
+            if (overflow::add(partial, input.coerceToLong(), &newPartial)) {
+                break;
+            }
+            partial = newPartial;
+            if (type == NumberLong) {
+                totalType = NumberLong;
+            }
+        }
+        nonDecimalTotal.addLong(partial);
+    }
+
+    for (; i < count; ++i) {
+        processInternal(inputs[i], merging);
+    }
+}
+
 intrusive_ptr<AccumulatorState> AccumulatorSum::create(
     const boost::intrusive_ptr<ExpressionContext>& expCtx) {
     return new AccumulatorSum(expCtx);
@@ -70,6 +70,17 @@ static void assertExpectedResults(
                 ASSERT_EQUALS(op.second.getType(), result.getType());
             }
 
+            // Asserts that result equals expected result when the input is processed as a batch,
+            // both whole and split into a prefix and a suffix.
+            for (size_t split = 0; split <= op.first.size(); ++split) {
+                auto accum = AccName::create(expCtx);
+                accum->processBatch(op.first.data(), split, false);
+                accum->processBatch(op.first.data() + split, op.first.size() - split, false);
+                Value result = accum->getValue(false);
+                ASSERT_VALUE_EQ(op.second, result);
+                ASSERT_EQUALS(op.second.getType(), result.getType());
+            }
+
             // Asserts that result equals expected result when all input is on one shard.
             {
                 auto accum = AccName::create(expCtx);
@@ -132,6 +143,9 @@ TEST(Accumulators, Avg) {
             {{Value(5), Value(3LL)}, Value(4.0)},
             // Averaging an int, long, and double.
             {{Value(1), Value(2LL), Value(6.0)}, Value(3.0)},
+            // Non-numeric values between numbers are ignored.
+            {{Value(1), Value(), Value(2LL), Value(BSONNULL), Value(2.5), Value(3)},
+             Value(2.125)},
 
             // Unlike $sum, two ints do not overflow in the 'total' portion of the average.
             {{Value(numeric_limits<int>::max()), Value(numeric_limits<int>::max())},
@@ -208,7 +222,18 @@ TEST(Accumulators, Min) {
          // The accumulator evaluates two documents and retains the minimum value.
          {{Value(5), Value(7)}, Value(5)},
          // The accumulator evaluates two documents and ignores the missing value.
-         {{Value(7), Value()}, Value(7)}});
+         {{Value(7), Value()}, Value(7)},
+
+         // Equal numbers of different types retain the first one seen.
+         {{Value(5), Value(5LL)}, Value(5)},
+         {{Value(5LL), Value(5), Value(6.0)}, Value(5LL)},
+         // Doubles, with null and missing values in between.
+         {{Value(2.5), Value(BSONNULL), Value(-1.5), Value(), Value(0.5)}, Value(-1.5)},
+         // NaN is lower than all other numbers.
+         {{Value(1.0), Value(numeric_limits<double>::quiet_NaN()), Value(-1.0)},
+          Value(numeric_limits<double>::quiet_NaN())},
+         // Numbers are lower than strings.
+         {{Value("a"_sd), Value(3), Value(2)}, Value(2)}});
 }
 
 TEST(Accumulators, MinRespectsCollation) {
@@ -235,7 +260,17 @@ TEST(Accumulators, Max) {
          // The accumulator evaluates two documents and retains the maximum value.
          {{Value(5), Value(7)}, Value(7)},
          // The accumulator evaluates two documents and ignores the missing value.
-         {{Value(7), Value()}, Value(7)}});
+         {{Value(7), Value()}, Value(7)},
+
+         // Equal numbers of different types retain the first one seen.
+         {{Value(7LL), Value(7)}, Value(7LL)},
+         // Longs, with null and missing values in between.
+         {{Value(3LL), Value(BSONNULL), Value(60000000000LL), Value(), Value(-4LL)},
+          Value(60000000000LL)},
+         // NaN is lower than all other numbers.
+         {{Value(numeric_limits<double>::quiet_NaN()), Value(-1.0)}, Value(-1.0)},
+         // Strings are greater than numbers.
+         {{Value(3), Value("a"_sd), Value(2)}, Value("a"_sd)}});
 }
 
 TEST(Accumulators, MaxRespectsCollation) {
@@ -0,0 +1,427 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/change_stream_shared_reader.h"
+
+#include <algorithm>
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/client.h"
+#include "mongo/db/pipeline/aggregation_request.h"
+#include "mongo/db/pipeline/document_source_change_stream.h"
+#include "mongo/db/pipeline/document_source_change_stream_gen.h"
+#include "mongo/db/pipeline/document_source_change_stream_shared_reader.h"
+#include "mongo/db/pipeline/document_source_change_stream_transform.h"
+#include "mongo/db/pipeline/pipeline_d.h"
+#include "mongo/db/pipeline/resume_token.h"
+#include "mongo/db/query/find_common.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/service_context.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+
+namespace {
+const auto getRegistry = ServiceContext::declareDecoration<SharedChangeStreamReaderRegistry>();
+}  // namespace
+
+SharedChangeStreamReader::SharedChangeStreamReader(
+    NamespaceString nss, Timestamp startFrom, std::unique_ptr<Pipeline, PipelineDeleter> pipeline)
+    : _nss(std::move(nss)),
+      _startedAt(startFrom),
+      _pipeline(std::move(pipeline)),
+      _retainedFrom(startFrom) {}
+
+SharedChangeStreamReader::~SharedChangeStreamReader() {
+    _disposePipeline(nullptr);
+}
+
+boost::optional<SharedChangeStreamReader::SubscriberId> SharedChangeStreamReader::subscribe(
+    Timestamp startFrom) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (_closed || _abandoned || !_failure.isOK() || startFrom < _retainedFrom) {
+        return boost::none;
+    }
+
+    // Events are buffered in oplog order, so the subscriber can skip straight to the first event
+    // at or after its starting point.
+    auto firstWanted = std::partition_point(_buffer.begin(), _buffer.end(), [&](const Event& e) {
+        return e.clusterTime < startFrom;
+    });
+    const auto id = _nextSubscriberId++;
+    _subscribers.emplace(id, _firstSequence + (firstWanted - _buffer.begin()));
+    return id;
+}
+
+void SharedChangeStreamReader::unsubscribe(OperationContext* opCtx, SubscriberId id) {
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _subscribers.erase(id);
+        if (!_subscribers.empty()) {
+            return;
+        }
+
+        // Each subscriber reads from the oplog only from within fetch(), so once the last one has
+        // left nobody can be using the pipeline.
+        invariant(!_reading);
+        _closed = true;
+        _buffer.clear();
+        _bufferedBytes = 0;
+    }
+    _disposePipeline(opCtx);
+}
+
+SharedChangeStreamReader::FetchResult SharedChangeStreamReader::fetch(OperationContext* opCtx,
+                                                                      SubscriberId id,
+                                                                      size_t maxEvents) {
+    stdx::unique_lock<Latch> lk(_mutex);
+    while (true) {
+        uassertStatusOK(_failure);
+
+        auto subscriber = _subscribers.find(id);
+        invariant(subscriber != _subscribers.end());
+        auto& next = subscriber->second;
+
+        FetchResult result;
+        if (_abandoned || next < _firstSequence) {
+            ++_subscribersFellBehind;
+            result.fellBehind = true;
+            return result;
+        }
+
+        const uint64_t end = _firstSequence + _buffer.size();
+        if (next < end) {
+            const auto count = std::min<uint64_t>(end - next, maxEvents);
+            auto first = _buffer.begin() + (next - _firstSequence);
+            result.events.assign(first, first + count);
+            result.latestOplogTimestamp = _latestOplogTimestamp;
+            next += count;
+            _eventsDelivered += count;
+            _trim(lk);
+            return result;
+        }
+
+        // This subscriber has consumed every buffered event. Read more from the oplog, unless
+        // another subscriber is already doing so.
+        if (!_reading) {
+            _reading = true;
+            lk.unlock();
+
+            std::pair<std::vector<Event>, Timestamp> read;
+            try {
+                read = _readFromOplog(opCtx, maxEvents);
+            } catch (const DBException& ex) {
+                lk.lock();
+                _reading = false;
+                if (ErrorCodes::isInterruption(ex.code())) {
+                    // Only this subscriber's operation failed, but the pipeline may have been
+                    // stopped part way through an event.
+                    _abandoned = true;
+                } else {
+                    _failure = ex.toStatus();
+                }
+                _readCompleted.notify_all();
+                throw;
+            }
+
+            lk.lock();
+            _reading = false;
+            _readCompleted.notify_all();
+
+            // Hand this subscriber the events it read before trimming the buffer, so that the
+            // memory limit only ever forces the other, slower subscribers to fall behind.
+            _eventsRead += read.first.size();
+            _eventsDelivered += read.first.size();
+            for (auto&& event : read.first) {
+                _bufferedBytes += event.event.objsize();
+                _buffer.push_back(event);
+            }
+            next = _firstSequence + _buffer.size();
+            _latestOplogTimestamp = std::max(_latestOplogTimestamp, read.second);
+            _trim(lk);
+
+            result.events = std::move(read.first);
+            result.latestOplogTimestamp = _latestOplogTimestamp;
+            return result;
+        }
+
+        // Wait for the subscriber which is reading, but for no longer than this operation would
+        // have waited for new oplog entries itself.
+        const auto& awaitData = awaitDataState(opCtx);
+        if (!awaitData.shouldWaitForInserts ||
+            !opCtx->waitForConditionOrInterruptUntil(
+                _readCompleted, lk, awaitData.waitForInsertsDeadline, [&] { return !_reading; })) {
+            // Everything up to '_latestOplogTimestamp' has been consumed, though the reader may be
+            // about to move past it.
+            result.latestOplogTimestamp = _latestOplogTimestamp;
+            return result;
+        }
+    }
+}
+
+std::pair<std::vector<SharedChangeStreamReader::Event>, Timestamp>
+SharedChangeStreamReader::_readFromOplog(OperationContext* opCtx, size_t maxEvents) {
+    _pipeline->reattachToOperationContext(opCtx);
+    ON_BLOCK_EXIT([&] { _pipeline->detachFromOperationContext(); });
+
+    // Once some events have been read, return them to the other subscribers straight away rather
+    // than waiting for more, just as a getMore stops waiting once it has results.
+    auto& awaitData = awaitDataState(opCtx);
+    const bool shouldWaitForInserts = awaitData.shouldWaitForInserts;
+    ON_BLOCK_EXIT([&] { awaitData.shouldWaitForInserts = shouldWaitForInserts; });
+
+    std::vector<Event> events;
+    while (events.size() < maxEvents) {
+        auto next = _pipeline->getNext();
+        if (!next) {
+            break;
+        }
+        awaitData.shouldWaitForInserts = false;
+
+        Event event;
+        event.event = next->toBsonWithMetaData(SortKeyFormat::k44SortKey);
+        auto clusterTime = event.event[DocumentSourceChangeStream::kClusterTimeField];
+        event.clusterTime = clusterTime.type() == BSONType::bsonTimestamp
+            ? clusterTime.timestamp()
+            : PipelineD::getLatestOplogTimestamp(_pipeline.get());
+        events.push_back(std::move(event));
+    }
+    return {std::move(events), PipelineD::getLatestOplogTimestamp(_pipeline.get())};
+}
+
+void SharedChangeStreamReader::_trim(WithLock) {
+    uint64_t minNext = _firstSequence + _buffer.size();
+    for (auto&& subscriber : _subscribers) {
+        minNext = std::min(minNext, subscriber.second);
+    }
+
+    const auto maxBytes =
+        static_cast<size_t>(internalChangeStreamSharedReaderMaxBufferBytes.load());
+    while (!_buffer.empty() && (_firstSequence < minNext || _bufferedBytes > maxBytes)) {
+        const auto& front = _buffer.front();
+        _bufferedBytes -= front.event.objsize();
+        _retainedFrom = std::max(_retainedFrom, Timestamp(front.clusterTime.asULL() + 1));
+        _buffer.pop_front();
+        ++_firstSequence;
+    }
+}
+
+void SharedChangeStreamReader::_disposePipeline(OperationContext* opCtx) {
+    if (!_pipeline) {
+        return;
+    }
+
+    if (opCtx) {
+        _pipeline->dispose(opCtx);
+    } else {
+        // The last subscriber went away without an OperationContext, so use one of our own to
+        // release the oplog cursor.
+        auto client = getGlobalServiceContext()->makeClient("SharedChangeStreamReaderCleanup");
+        AlternativeClientRegion acr(client);
+        auto cleanupOpCtx = cc().makeOperationContext();
+        _pipeline->dispose(cleanupOpCtx.get());
+    }
+    _pipeline.get_deleter().dismissDisposal();
+    _pipeline.reset();
+}
+
+SharedChangeStreamReader::Stats SharedChangeStreamReader::getStats() const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    Stats stats;
+    stats.nss = _nss;
+    stats.startedAt = _startedAt;
+    stats.latestOplogTimestamp = _latestOplogTimestamp;
+    stats.subscribers = _subscribers.size();
+    stats.bufferedEvents = _buffer.size();
+    stats.bufferedBytes = _bufferedBytes;
+    stats.eventsRead = _eventsRead;
+    stats.eventsDelivered = _eventsDelivered;
+    stats.subscribersFellBehind = _subscribersFellBehind;
+
+    const uint64_t end = _firstSequence + _buffer.size();
+    uint64_t minNext = end;
+    for (auto&& subscriber : _subscribers) {
+        minNext = std::min(minNext, subscriber.second);
+    }
+    stats.maxLagEvents = end - minNext;
+    if (minNext >= _firstSequence && minNext < end) {
+        stats.maxLagSecs = static_cast<long long>(_latestOplogTimestamp.getSecs()) -
+            static_cast<long long>(_buffer[minNext - _firstSequence].clusterTime.getSecs());
+    }
+    return stats;
+}
+
+SharedChangeStreamReaderRegistry& SharedChangeStreamReaderRegistry::get(
+    ServiceContext* serviceContext) {
+    return getRegistry(serviceContext);
+}
+
+std::pair<std::shared_ptr<SharedChangeStreamReader>, SharedChangeStreamReader::SubscriberId>
+SharedChangeStreamReaderRegistry::subscribe(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                            Collection* oplog,
+                                            const std::string& key,
+                                            Timestamp startFrom,
+                                            const PipelineFactory& makePipeline) {
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        auto& readers = _readers[key];
+        readers.erase(std::remove_if(readers.begin(),
+                                     readers.end(),
+                                     [](const auto& reader) { return reader.expired(); }),
+                      readers.end());
+        for (auto&& weakReader : readers) {
+            if (auto reader = weakReader.lock()) {
+                if (auto id = reader->subscribe(startFrom)) {
+                    return {std::move(reader), *id};
+                }
+            }
+        }
+    }
+
+    // No reader can serve this subscriber. Build a new one outside the mutex, since doing so scans
+    // the oplog.
+    auto reader = std::make_shared<SharedChangeStreamReader>(
+        expCtx->ns, startFrom, makePipeline(expCtx, oplog, startFrom));
+    auto id = reader->subscribe(startFrom);
+    invariant(id);
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    _readers[key].push_back(reader);
+    return {std::move(reader), *id};
+}
+
+std::vector<SharedChangeStreamReader::Stats> SharedChangeStreamReaderRegistry::getStats() {
+    std::vector<std::shared_ptr<SharedChangeStreamReader>> readers;
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        for (auto it = _readers.begin(); it != _readers.end();) {
+            bool anyAlive = false;
+            for (auto&& weakReader : it->second) {
+                if (auto reader = weakReader.lock()) {
+                    readers.push_back(std::move(reader));
+                    anyAlive = true;
+                }
+            }
+            if (anyAlive) {
+                ++it;
+            } else {
+                _readers.erase(it++);
+            }
+        }
+    }
+
+    std::vector<SharedChangeStreamReader::Stats> stats;
+    for (auto&& reader : readers) {
+        stats.push_back(reader->getStats());
+    }
+    return stats;
+}
+
+namespace change_stream_shared_reader {
+
+bool attachIfEligible(Collection* oplog, const AggregationRequest& request, Pipeline* pipeline) {
+    const auto& expCtx = pipeline->getContext();
+    if (!internalChangeStreamUseSharedReaders.load() || !oplog || expCtx->explain ||
+        expCtx->inMongos || expCtx->fromMongos || expCtx->needsMerge) {
+        return false;
+    }
+
+    // The oplog match and the transformation are the only stages which are shared. Everything
+    // after them, including the resume token checks, stays with each subscriber.
+    const auto& sources = pipeline->getSources();
+    if (sources.size() < 2 || !dynamic_cast<DocumentSourceOplogMatch*>(sources.front().get()) ||
+        !dynamic_cast<DocumentSourceChangeStreamTransform*>(std::next(sources.begin())->get())) {
+        return false;
+    }
+
+    const auto& userPipeline = request.getPipeline();
+    if (userPipeline.empty() ||
+        userPipeline.front().firstElementFieldNameStringData() !=
+            DocumentSourceChangeStream::kStageName) {
+        return false;
+    }
+
+    // Streams which differ only in where they start can share a reader.
+    BSONObjBuilder sharedSpecBuilder;
+    for (auto&& elem : userPipeline.front().firstElement().Obj()) {
+        const auto fieldName = elem.fieldNameStringData();
+        if (fieldName != DocumentSourceChangeStreamSpec::kResumeAfterFieldName &&
+            fieldName != DocumentSourceChangeStreamSpec::kStartAfterFieldName &&
+            fieldName != DocumentSourceChangeStreamSpec::kStartAtOperationTimeFieldName) {
+            sharedSpecBuilder.append(elem);
+        }
+    }
+    const auto sharedSpec = sharedSpecBuilder.obj();
+    const bool showMigrationEvents =
+        DocumentSourceChangeStreamSpec::parse(IDLParserErrorContext("$changeStream"), sharedSpec)
+            .getShowMigrationEvents();
+    const auto fcv = serverGlobalParams.featureCompatibility.getVersion();
+
+    std::string key = str::stream() << expCtx->ns.ns() << '|' << static_cast<int>(fcv) << '|'
+                                    << sharedSpec.toString();
+    const auto startFrom =
+        ResumeToken::parse(expCtx->initialPostBatchResumeToken).getData().clusterTime;
+
+    auto makePipeline = [sharedSpec, showMigrationEvents, fcv](
+                            const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                            Collection* oplog,
+                            Timestamp startFrom) {
+        // The shared stages get an ExpressionContext of their own, since each subscriber attaches
+        // them to its own OperationContext in turn.
+        auto readerExpCtx =
+            expCtx->copyWith(expCtx->ns, expCtx->uuid, std::unique_ptr<CollatorInterface>{});
+        readerExpCtx->tailableMode = TailableModeEnum::kTailableAndAwaitData;
+        readerExpCtx->initialPostBatchResumeToken =
+            ResumeToken::makeHighWaterMarkToken(startFrom).toDocument().toBson();
+
+        auto readerPipeline = Pipeline::create(
+            {DocumentSourceOplogMatch::create(DocumentSourceChangeStream::buildMatchFilter(
+                                                  readerExpCtx, startFrom, showMigrationEvents),
+                                              readerExpCtx),
+             DocumentSourceChangeStreamTransform::create(readerExpCtx, fcv, sharedSpec)},
+            readerExpCtx);
+        PipelineD::buildAndAttachInnerQueryExecutorToPipeline(
+            oplog, NamespaceString::kRsOplogNamespace, nullptr, readerPipeline.get());
+        readerPipeline->detachFromOperationContext();
+        return readerPipeline;
+    };
+
+    auto sharedReaderStage = DocumentSourceChangeStreamSharedReader::create(
+        expCtx, oplog, std::move(key), startFrom, std::move(makePipeline));
+    pipeline->popFront();
+    pipeline->popFront();
+    pipeline->addInitialSource(std::move(sharedReaderStage));
+    return true;
+}
+
+}  // namespace change_stream_shared_reader
+}  // namespace mongo
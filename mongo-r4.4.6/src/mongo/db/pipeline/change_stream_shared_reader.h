@@ -0,0 +1,244 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/timestamp.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/pipeline/pipeline.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/concurrency/with_lock.h"
+
+namespace mongo {
+
+class AggregationRequest;
+class Collection;
+class OperationContext;
+class ServiceContext;
+
+/**
+ * Tails the oplog on behalf of every change stream which watches the same namespace with the same
+ * options, so that each oplog entry is scanned and transformed into a change event only once. The
+ * transformed events are buffered until every subscriber has consumed them. Each subscriber runs
+ * its own resume checks and filters over the shared events.
+ *
+ * The reader has no thread of its own. Whichever subscriber first runs out of buffered events
+ * attaches the shared pipeline to its OperationContext and reads the next batch from the oplog,
+ * while the other subscribers which have caught up wait for it to finish.
+ */
+class SharedChangeStreamReader {
+    SharedChangeStreamReader(const SharedChangeStreamReader&) = delete;
+    SharedChangeStreamReader& operator=(const SharedChangeStreamReader&) = delete;
+
+public:
+    using SubscriberId = uint64_t;
+
+    /**
+     * A transformed change event. Events are kept as BSON, which unlike a Document can be read by
+     * several threads at once; each subscriber builds its own Document from it.
+     */
+    struct Event {
+        BSONObj event;
+        Timestamp clusterTime;
+    };
+
+    struct FetchResult {
+        std::vector<Event> events;
+
+        // The latest oplog timestamp the reader had scanned when the events were fetched. Once a
+        // subscriber has consumed every event up to this point it may report it as its own.
+        Timestamp latestOplogTimestamp;
+
+        // Set if events this subscriber had yet to consume were discarded because the buffer grew
+        // beyond 'internalChangeStreamSharedReaderMaxBufferBytes'. The subscriber must move to a
+        // different reader.
+        bool fellBehind = false;
+    };
+
+    struct Stats {
+        NamespaceString nss;
+        Timestamp startedAt;
+        Timestamp latestOplogTimestamp;
+        size_t subscribers = 0;
+        size_t bufferedEvents = 0;
+        size_t bufferedBytes = 0;
+
+        // How far the slowest subscriber is behind the newest buffered event.
+        size_t maxLagEvents = 0;
+        long long maxLagSecs = 0;
+
+        long long eventsRead = 0;
+        long long eventsDelivered = 0;
+        long long subscribersFellBehind = 0;
+    };
+
+    /**
+     * Creates a reader over 'pipeline', which must produce transformed change events for 'nss'
+     * starting from the oplog timestamp 'startFrom'. The pipeline must be detached from any
+     * OperationContext.
+     */
+    SharedChangeStreamReader(NamespaceString nss,
+                             Timestamp startFrom,
+                             std::unique_ptr<Pipeline, PipelineDeleter> pipeline);
+
+    ~SharedChangeStreamReader();
+
+    /**
+     * Registers a subscriber which wants every event at or after 'startFrom'. Returns boost::none
+     * if some of those events have already been discarded, or if the reader has been closed.
+     */
+    boost::optional<SubscriberId> subscribe(Timestamp startFrom);
+
+    /**
+     * Removes a subscriber. When the last subscriber leaves, the reader is closed and its pipeline
+     * disposed of using 'opCtx', which may be null if none is available.
+     */
+    void unsubscribe(OperationContext* opCtx, SubscriberId id);
+
+    /**
+     * Returns up to 'maxEvents' events which subscriber 'id' has not yet consumed, reading more
+     * from the oplog if the subscriber has consumed everything that was buffered. Returns no events
+     * if there are none available before the operation's awaitData deadline.
+     */
+    FetchResult fetch(OperationContext* opCtx, SubscriberId id, size_t maxEvents);
+
+    Stats getStats() const;
+
+private:
+    /**
+     * Reads up to 'maxEvents' events from the shared pipeline using 'opCtx'. Must be called without
+     * holding '_mutex', by the single thread which set '_reading'.
+     */
+    std::pair<std::vector<Event>, Timestamp> _readFromOplog(OperationContext* opCtx,
+                                                            size_t maxEvents);
+
+    /**
+     * Discards the events every subscriber has consumed, then the oldest events until the buffer
+     * is within its memory limit.
+     */
+    void _trim(WithLock);
+
+    void _disposePipeline(OperationContext* opCtx);
+
+    const NamespaceString _nss;
+    const Timestamp _startedAt;
+
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("SharedChangeStreamReader::_mutex");
+    stdx::condition_variable _readCompleted;
+
+    // Only touched by the thread which set '_reading', or after the reader has been closed.
+    std::unique_ptr<Pipeline, PipelineDeleter> _pipeline;
+
+    // Whether some subscriber is currently reading from the oplog.
+    bool _reading = false;
+
+    // Set once the last subscriber leaves; a closed reader accepts no new subscribers.
+    bool _closed = false;
+
+    // Set if the subscriber reading from the oplog was interrupted part way through, which leaves
+    // the shared pipeline in an unknown state. Every subscriber then moves to a different reader.
+    bool _abandoned = false;
+
+    // A failure of the shared pipeline, which is reported to every subscriber.
+    Status _failure = Status::OK();
+
+    // Buffered events, numbered consecutively from '_firstSequence'.
+    std::deque<Event> _buffer;
+    uint64_t _firstSequence = 0;
+    size_t _bufferedBytes = 0;
+
+    // Every event at or after this timestamp is either buffered or not yet read.
+    Timestamp _retainedFrom;
+    Timestamp _latestOplogTimestamp;
+
+    // Maps each subscriber to the sequence number of the next event it will consume.
+    stdx::unordered_map<SubscriberId, uint64_t> _subscribers;
+    SubscriberId _nextSubscriberId = 0;
+
+    long long _eventsRead = 0;
+    long long _eventsDelivered = 0;
+    long long _subscribersFellBehind = 0;
+};
+
+/**
+ * Tracks the shared readers of a ServiceContext, keyed by namespace and change stream options.
+ */
+class SharedChangeStreamReaderRegistry {
+public:
+    /**
+     * Builds the pipeline for a new reader which starts at the given timestamp, using the given
+     * ExpressionContext as a template and the oplog collection, which the caller has locked.
+     */
+    using PipelineFactory = std::function<std::unique_ptr<Pipeline, PipelineDeleter>(
+        const boost::intrusive_ptr<ExpressionContext>&, Collection*, Timestamp)>;
+
+    static SharedChangeStreamReaderRegistry& get(ServiceContext* serviceContext);
+
+    /**
+     * Subscribes to a reader registered under 'key' which can still serve every event from
+     * 'startFrom' onwards, creating and registering a new reader if there is none.
+     */
+    std::pair<std::shared_ptr<SharedChangeStreamReader>, SharedChangeStreamReader::SubscriberId>
+    subscribe(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+              Collection* oplog,
+              const std::string& key,
+              Timestamp startFrom,
+              const PipelineFactory& makePipeline);
+
+    std::vector<SharedChangeStreamReader::Stats> getStats();
+
+private:
+    Mutex _mutex = MONGO_MAKE_LATCH("SharedChangeStreamReaderRegistry::_mutex");
+    stdx::unordered_map<std::string, std::vector<std::weak_ptr<SharedChangeStreamReader>>>
+        _readers;
+};
+
+namespace change_stream_shared_reader {
+
+/**
+ * If shared change stream readers are enabled and 'pipeline' is a change stream which may use one,
+ * replaces its oplog match and transformation stages with a subscription to the shared reader for
+ * its namespace and options, and returns true. The pipeline then needs no $cursor stage. The
+ * caller must hold a lock on 'oplog'.
+ */
+bool attachIfEligible(Collection* oplog, const AggregationRequest& request, Pipeline* pipeline);
+
+}  // namespace change_stream_shared_reader
+}  // namespace mongo
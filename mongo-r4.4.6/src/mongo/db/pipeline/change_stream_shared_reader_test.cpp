@@ -0,0 +1,205 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <deque>
+
+#include "mongo/db/exec/document_value/document.h"
+#include "mongo/db/exec/document_value/document_value_test_util.h"
+#include "mongo/db/pipeline/aggregation_context_fixture.h"
+#include "mongo/db/pipeline/change_stream_shared_reader.h"
+#include "mongo/db/pipeline/document_source_mock.h"
+#include "mongo/db/pipeline/pipeline.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+using SharedChangeStreamReaderTest = AggregationContextFixture;
+
+/**
+ * Returns a change event at the given cluster time, in the shape the shared pipeline produces.
+ */
+Document makeEvent(unsigned int inc) {
+    return Document{{"_id", Document{{"_data", std::to_string(inc)}}},
+                    {"clusterTime", Timestamp(1, inc)}};
+}
+
+/**
+ * Returns a detached pipeline which produces events at cluster times Timestamp(1, first) to
+ * Timestamp(1, last) inclusive, standing in for the shared oplog scan and transformation.
+ */
+std::unique_ptr<Pipeline, PipelineDeleter> makeEventPipeline(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx, unsigned int first, unsigned int last) {
+    auto pipelineExpCtx = expCtx->copyWith(expCtx->ns);
+    std::deque<DocumentSource::GetNextResult> events;
+    for (auto inc = first; inc <= last; ++inc) {
+        events.emplace_back(makeEvent(inc));
+    }
+    auto pipeline = Pipeline::create(
+        {boost::intrusive_ptr<DocumentSource>(new DocumentSourceMock(events, pipelineExpCtx))},
+        pipelineExpCtx);
+    pipeline->detachFromOperationContext();
+    return pipeline;
+}
+
+TEST_F(SharedChangeStreamReaderTest, SubscribersShareOneReadOfTheOplog) {
+    auto opCtx = getExpCtx()->opCtx;
+    SharedChangeStreamReader reader(
+        getExpCtx()->ns, Timestamp(1, 1), makeEventPipeline(getExpCtx(), 1, 3));
+    auto first = reader.subscribe(Timestamp(1, 1));
+    auto second = reader.subscribe(Timestamp(1, 2));
+    ASSERT(first);
+    ASSERT(second);
+
+    auto firstResult = reader.fetch(opCtx, *first, 10);
+    ASSERT_FALSE(firstResult.fellBehind);
+    ASSERT_EQ(firstResult.events.size(), 3UL);
+    for (unsigned int i = 0; i < 3; ++i) {
+        ASSERT_EQ(firstResult.events[i].clusterTime, Timestamp(1, i + 1));
+        ASSERT_DOCUMENT_EQ(Document::fromBsonWithMetaData(firstResult.events[i].event),
+                           makeEvent(i + 1));
+    }
+
+    // The second subscriber is served from the buffer, skipping the event before its starting
+    // point, without reading from the pipeline again.
+    auto secondResult = reader.fetch(opCtx, *second, 10);
+    ASSERT_FALSE(secondResult.fellBehind);
+    ASSERT_EQ(secondResult.events.size(), 2UL);
+    ASSERT_EQ(secondResult.events[0].clusterTime, Timestamp(1, 2));
+    ASSERT_EQ(secondResult.events[1].clusterTime, Timestamp(1, 3));
+
+    auto stats = reader.getStats();
+    ASSERT_EQ(stats.subscribers, 2UL);
+    ASSERT_EQ(stats.eventsRead, 3);
+    ASSERT_EQ(stats.eventsDelivered, 5);
+    ASSERT_EQ(stats.bufferedEvents, 0UL);
+    ASSERT_EQ(stats.maxLagEvents, 0UL);
+
+    // Both subscribers have caught up, and the pipeline is exhausted.
+    ASSERT(reader.fetch(opCtx, *first, 10).events.empty());
+
+    reader.unsubscribe(opCtx, *first);
+    reader.unsubscribe(opCtx, *second);
+    ASSERT_FALSE(reader.subscribe(Timestamp(1, 1)));
+}
+
+TEST_F(SharedChangeStreamReaderTest, FetchReturnsAtMostTheRequestedNumberOfEvents) {
+    auto opCtx = getExpCtx()->opCtx;
+    SharedChangeStreamReader reader(
+        getExpCtx()->ns, Timestamp(1, 1), makeEventPipeline(getExpCtx(), 1, 5));
+    auto id = reader.subscribe(Timestamp(1, 1));
+    ASSERT(id);
+
+    ASSERT_EQ(reader.fetch(opCtx, *id, 2).events.size(), 2UL);
+    ASSERT_EQ(reader.fetch(opCtx, *id, 2).events.size(), 2UL);
+    ASSERT_EQ(reader.fetch(opCtx, *id, 2).events.size(), 1UL);
+    ASSERT_EQ(reader.getStats().eventsRead, 5);
+    reader.unsubscribe(opCtx, *id);
+}
+
+TEST_F(SharedChangeStreamReaderTest, SlowSubscriberFallsBehindWhenBufferIsFull) {
+    internalChangeStreamSharedReaderMaxBufferBytes.store(1);
+    ON_BLOCK_EXIT(
+        [] { internalChangeStreamSharedReaderMaxBufferBytes.store(64 * 1024 * 1024); });
+
+    auto opCtx = getExpCtx()->opCtx;
+    SharedChangeStreamReader reader(
+        getExpCtx()->ns, Timestamp(1, 1), makeEventPipeline(getExpCtx(), 1, 3));
+    auto fast = reader.subscribe(Timestamp(1, 1));
+    auto slow = reader.subscribe(Timestamp(1, 1));
+    ASSERT(fast);
+    ASSERT(slow);
+
+    // The subscriber which reads from the oplog always receives what it read, even though the
+    // buffer cannot hold it.
+    auto fastResult = reader.fetch(opCtx, *fast, 10);
+    ASSERT_FALSE(fastResult.fellBehind);
+    ASSERT_EQ(fastResult.events.size(), 3UL);
+    ASSERT_EQ(reader.getStats().bufferedEvents, 0UL);
+
+    auto slowResult = reader.fetch(opCtx, *slow, 10);
+    ASSERT_TRUE(slowResult.fellBehind);
+    ASSERT(slowResult.events.empty());
+    ASSERT_EQ(reader.getStats().subscribersFellBehind, 1);
+
+    // Nor can the reader serve a new subscriber which wants the discarded events.
+    ASSERT_FALSE(reader.subscribe(Timestamp(1, 3)));
+    auto late = reader.subscribe(Timestamp(1, 4));
+    ASSERT(late);
+
+    reader.unsubscribe(opCtx, *late);
+    reader.unsubscribe(opCtx, *slow);
+    reader.unsubscribe(opCtx, *fast);
+}
+
+TEST_F(SharedChangeStreamReaderTest, RegistryReusesReadersWhichCanServeTheStartingPoint) {
+    internalChangeStreamSharedReaderMaxBufferBytes.store(1);
+    ON_BLOCK_EXIT(
+        [] { internalChangeStreamSharedReaderMaxBufferBytes.store(64 * 1024 * 1024); });
+
+    auto opCtx = getExpCtx()->opCtx;
+    auto& registry = SharedChangeStreamReaderRegistry::get(opCtx->getServiceContext());
+    int pipelinesCreated = 0;
+    auto makePipeline = [&](const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                            Collection*,
+                            Timestamp startFrom) {
+        ++pipelinesCreated;
+        return makeEventPipeline(expCtx, startFrom.getInc(), 3);
+    };
+
+    auto first = registry.subscribe(getExpCtx(), nullptr, "key", Timestamp(1, 1), makePipeline);
+    auto second = registry.subscribe(getExpCtx(), nullptr, "key", Timestamp(1, 1), makePipeline);
+    ASSERT_EQ(first.first, second.first);
+    ASSERT_EQ(pipelinesCreated, 1);
+
+    // Streams with different options never share a reader.
+    auto other = registry.subscribe(getExpCtx(), nullptr, "other", Timestamp(1, 1), makePipeline);
+    ASSERT_NE(first.first, other.first);
+    ASSERT_EQ(pipelinesCreated, 2);
+
+    // Once the events from the start of the oplog have been discarded, a stream which needs them
+    // gets a reader of its own.
+    ASSERT_EQ(first.first->fetch(opCtx, first.second, 10).events.size(), 3UL);
+    auto third = registry.subscribe(getExpCtx(), nullptr, "key", Timestamp(1, 1), makePipeline);
+    ASSERT_NE(first.first, third.first);
+    ASSERT_EQ(pipelinesCreated, 3);
+    ASSERT_EQ(registry.getStats().size(), 3UL);
+
+    first.first->unsubscribe(opCtx, first.second);
+    second.first->unsubscribe(opCtx, second.second);
+    other.first->unsubscribe(opCtx, other.second);
+    third.first->unsubscribe(opCtx, third.second);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,192 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/document_source_change_stream_shared_reader.h"
+
+#include <algorithm>
+
+#include "mongo/db/db_raii.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/service_context.h"
+
+namespace mongo {
+
+boost::intrusive_ptr<DocumentSourceChangeStreamSharedReader>
+DocumentSourceChangeStreamSharedReader::create(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    Collection* oplog,
+    std::string key,
+    Timestamp startFrom,
+    SharedChangeStreamReaderRegistry::PipelineFactory makePipeline) {
+    boost::intrusive_ptr<DocumentSourceChangeStreamSharedReader> stage(
+        new DocumentSourceChangeStreamSharedReader(
+            expCtx, std::move(key), startFrom, std::move(makePipeline)));
+    stage->subscribe(oplog, startFrom);
+    return stage;
+}
+
+DocumentSourceChangeStreamSharedReader::DocumentSourceChangeStreamSharedReader(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    std::string key,
+    Timestamp startFrom,
+    SharedChangeStreamReaderRegistry::PipelineFactory makePipeline)
+    : DocumentSource(kStageName, expCtx),
+      _key(std::move(key)),
+      _makePipeline(std::move(makePipeline)),
+      _startFrom(startFrom) {}
+
+DocumentSourceChangeStreamSharedReader::~DocumentSourceChangeStreamSharedReader() {
+    if (_reader) {
+        _reader->unsubscribe(nullptr, _subscriberId);
+    }
+}
+
+StageConstraints DocumentSourceChangeStreamSharedReader::constraints(
+    Pipeline::SplitState pipeState) const {
+    StageConstraints constraints(StreamType::kStreaming,
+                                 PositionRequirement::kFirst,
+                                 HostTypeRequirement::kAnyShard,
+                                 DiskUseRequirement::kNoDiskUse,
+                                 FacetRequirement::kNotAllowed,
+                                 TransactionRequirement::kNotAllowed,
+                                 LookupRequirement::kNotAllowed,
+                                 UnionRequirement::kNotAllowed,
+                                 ChangeStreamRequirement::kChangeStreamStage);
+    constraints.requiresInputDocSource = false;
+    constraints.isIndependentOfAnyCollection = pExpCtx->ns.isCollectionlessAggregateNS();
+    return constraints;
+}
+
+Value DocumentSourceChangeStreamSharedReader::serialize(
+    boost::optional<ExplainOptions::Verbosity> explain) const {
+    // Like the $cursor stage this stage replaces, it is only visible in explain output.
+    if (!explain) {
+        return Value();
+    }
+    return Value(
+        Document{{kStageName,
+                  Document{{"startFrom"_sd, _startFrom}, {"readersJoined"_sd, _readersJoined}}}});
+}
+
+DocumentSource::GetNextResult DocumentSourceChangeStreamSharedReader::doGetNext() {
+    while (true) {
+        if (_batch.empty()) {
+            fetchBatch();
+            if (_batch.empty()) {
+                return GetNextResult::makeEOF();
+            }
+        }
+
+        auto event = std::move(_batch.front());
+        _batch.pop_front();
+
+        if (event.clusterTime < _startFrom) {
+            continue;
+        }
+        if (!_skipThrough.isEmpty()) {
+            if (event.event.getObjectField("_id").woCompare(_skipThrough) <= 0) {
+                continue;
+            }
+            _skipThrough = BSONObj();
+        }
+
+        _lastResumeToken = event.event.getObjectField("_id").getOwned();
+        _latestOplogTimestamp = std::max(_latestOplogTimestamp, event.clusterTime);
+        return Document::fromBsonWithMetaData(event.event);
+    }
+}
+
+void DocumentSourceChangeStreamSharedReader::fetchBatch() {
+    const auto batchSize =
+        static_cast<size_t>(internalChangeStreamSharedReaderBatchSize.load());
+    while (true) {
+        auto result = [&] {
+            try {
+                return _reader->fetch(pExpCtx->opCtx, _subscriberId, batchSize);
+            } catch (const ExceptionFor<ErrorCodes::OplogQueryMinTsMissing>&) {
+                // A reader which this stream moved to after falling behind starts from the last
+                // event the stream returned. Report that point falling off the oplog as a resume
+                // would.
+                uassert(ErrorCodes::ChangeStreamHistoryLost,
+                        "Change stream fell behind the shared oplog reader, and its position is "
+                        "no longer in the oplog.",
+                        _readersJoined <= 1);
+                throw;
+            }
+        }();
+
+        if (!result.fellBehind) {
+            if (result.events.empty()) {
+                _latestOplogTimestamp =
+                    std::max(_latestOplogTimestamp, result.latestOplogTimestamp);
+            }
+            _batch.insert(_batch.end(),
+                          std::make_move_iterator(result.events.begin()),
+                          std::make_move_iterator(result.events.end()));
+            return;
+        }
+
+        // The events this stream had yet to see are gone from the shared buffer. Move to a reader
+        // which starts at the point this stream has seen every event up to, skipping any events at
+        // that time which were already returned.
+        const auto restartFrom = std::max(_startFrom, _latestOplogTimestamp);
+        if (!_lastResumeToken.isEmpty()) {
+            _skipThrough = _lastResumeToken;
+        }
+        unsubscribe();
+
+        AutoGetCollectionForRead oplogRead(pExpCtx->opCtx, NamespaceString::kRsOplogNamespace);
+        subscribe(oplogRead.getCollection(), restartFrom);
+    }
+}
+
+void DocumentSourceChangeStreamSharedReader::subscribe(Collection* oplog, Timestamp startFrom) {
+    auto subscription =
+        SharedChangeStreamReaderRegistry::get(pExpCtx->opCtx->getServiceContext())
+            .subscribe(pExpCtx, oplog, _key, startFrom, _makePipeline);
+    _reader = std::move(subscription.first);
+    _subscriberId = subscription.second;
+    ++_readersJoined;
+}
+
+void DocumentSourceChangeStreamSharedReader::unsubscribe() {
+    if (_reader) {
+        _reader->unsubscribe(pExpCtx->opCtx, _subscriberId);
+        _reader.reset();
+    }
+}
+
+void DocumentSourceChangeStreamSharedReader::doDispose() {
+    _batch.clear();
+    unsubscribe();
+}
+
+}  // namespace mongo
@@ -0,0 +1,125 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <memory>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/timestamp.h"
+#include "mongo/db/pipeline/change_stream_shared_reader.h"
+#include "mongo/db/pipeline/document_source.h"
+
+namespace mongo {
+
+/**
+ * The first stage of a change stream which shares its oplog scan and transformation with other
+ * change streams on the same namespace. Produces the transformed events of a
+ * SharedChangeStreamReader, beginning at this stream's own starting point; the rest of the change
+ * stream pipeline, including the resume checks, runs unchanged after it.
+ */
+class DocumentSourceChangeStreamSharedReader final : public DocumentSource {
+public:
+    static constexpr StringData kStageName = "$_internalChangeStreamSharedReader"_sd;
+
+    /**
+     * Subscribes to a shared reader registered under 'key' which can serve every event from
+     * 'startFrom' onwards, using 'makePipeline' to create one if necessary. The caller must hold a
+     * lock on 'oplog'.
+     */
+    static boost::intrusive_ptr<DocumentSourceChangeStreamSharedReader> create(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx,
+        Collection* oplog,
+        std::string key,
+        Timestamp startFrom,
+        SharedChangeStreamReaderRegistry::PipelineFactory makePipeline);
+
+    ~DocumentSourceChangeStreamSharedReader();
+
+    const char* getSourceName() const final {
+        return kStageName.rawData();
+    }
+
+    StageConstraints constraints(Pipeline::SplitState pipeState) const final;
+
+    boost::optional<DistributedPlanLogic> distributedPlanLogic() final {
+        return boost::none;
+    }
+
+    Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
+
+    /**
+     * Returns the oplog timestamp up to which this stream has seen every event, in the same way as
+     * the $cursor stage of an unshared change stream.
+     */
+    Timestamp getLatestOplogTimestamp() const {
+        return _latestOplogTimestamp;
+    }
+
+protected:
+    GetNextResult doGetNext() final;
+    void doDispose() final;
+
+private:
+    DocumentSourceChangeStreamSharedReader(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                           std::string key,
+                                           Timestamp startFrom,
+                                           SharedChangeStreamReaderRegistry::PipelineFactory);
+
+    void subscribe(Collection* oplog, Timestamp startFrom);
+    void unsubscribe();
+
+    /**
+     * Fetches the next batch of events from the shared reader into '_batch', moving to a different
+     * reader if this stream fell behind.
+     */
+    void fetchBatch();
+
+    const std::string _key;
+    const SharedChangeStreamReaderRegistry::PipelineFactory _makePipeline;
+
+    // Events from before this timestamp precede the stream's starting point and are skipped.
+    const Timestamp _startFrom;
+
+    std::shared_ptr<SharedChangeStreamReader> _reader;
+    SharedChangeStreamReader::SubscriberId _subscriberId = 0;
+
+    std::deque<SharedChangeStreamReader::Event> _batch;
+
+    // The resume token of the last event returned. After moving to a different reader, which
+    // starts again from this event's cluster time, events up to and including it are skipped.
+    BSONObj _lastResumeToken;
+    BSONObj _skipThrough;
+
+    Timestamp _latestOplogTimestamp;
+    long long _readersJoined = 0;
+};
+
+}  // namespace mongo
@@ -31,6 +31,7 @@
 
 #include "mongo/db/pipeline/document_source_facet.h"
 
+#include <algorithm>
 #include <memory>
 #include <vector>
 
@@ -40,7 +41,10 @@
 #include "mongo/bson/bsontypes.h"
 #include "mongo/db/exec/document_value/document.h"
 #include "mongo/db/exec/document_value/value.h"
+#include "mongo/db/pipeline/document_source_match.h"
+#include "mongo/db/pipeline/document_source_single_document_transformation.h"
 #include "mongo/db/pipeline/document_source_tee_consumer.h"
+#include "mongo/db/pipeline/document_source_unwind.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/field_path.h"
 #include "mongo/db/pipeline/pipeline.h"
@@ -134,6 +138,115 @@ intrusive_ptr<DocumentSourceFacet> DocumentSourceFacet::create(
         std::move(facetPipelines), expCtx, bufferSizeBytes, maxOutputDocBytes);
 }
 
+namespace {
+/**
+ * Returns true if 'value' contains an expression which may evaluate differently each time it is
+ * evaluated on the same document, that is $rand or the $sampleRate match expression.
+ */
+bool containsNondeterministicExpression(const Value& value) {
+    switch (value.getType()) {
+        case BSONType::Object: {
+            FieldIterator it(value.getDocument());
+            while (it.more()) {
+                auto field = it.next();
+                if (field.first == "$rand"_sd || field.first == "$sampleRate"_sd ||
+                    containsNondeterministicExpression(field.second)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+        case BSONType::Array:
+            return std::any_of(value.getArray().begin(),
+                               value.getArray().end(),
+                               containsNondeterministicExpression);
+        default:
+            return false;
+    }
+}
+
+/**
+ * Returns true if 'stage' transforms each document independently of the others, so that
+ * evaluating it once before the $facet is equivalent to evaluating it in each facet.
+ */
+bool isHoistableStage(const DocumentSource& stage) {
+    StringData name = stage.getSourceName();
+    return name == DocumentSourceMatch::kStageName || name == DocumentSourceUnwind::kStageName ||
+        dynamic_cast<const DocumentSourceSingleDocumentTransformation*>(&stage);
+}
+}  // namespace
+
+boost::intrusive_ptr<DocumentSource> DocumentSourceFacet::popCommonPrefixStage() {
+    // The stages are compared by their serialized BSON, byte for byte. Comparing them as Values
+    // would treat e.g. {$match: {a: 1}} and {$match: {a: 1.0}} as equal, although the stages may
+    // produce differently typed results.
+    boost::optional<BSONObj> serializedPrefix;
+    for (auto&& facet : _facets) {
+        // Every facet pipeline begins with the $teeConsumer reading from '_teeBuffer'.
+        const auto& sources = facet.pipeline->getSources();
+        if (sources.size() < 2) {
+            return nullptr;
+        }
+
+        const auto& stage = *std::next(sources.begin());
+        if (!isHoistableStage(*stage)) {
+            return nullptr;
+        }
+
+        std::vector<Value> serializedStage;
+        stage->serializeToArray(serializedStage);
+        BSONArrayBuilder serialized;
+        for (auto&& value : serializedStage) {
+            value.addToBsonArray(&serialized);
+        }
+        if (!serializedPrefix) {
+            if (std::any_of(serializedStage.begin(),
+                            serializedStage.end(),
+                            [](const Value& value) {
+                                return containsNondeterministicExpression(value);
+                            })) {
+                return nullptr;
+            }
+            serializedPrefix = serialized.arr();
+        } else if (!serializedPrefix->binaryEqual(serialized.arr())) {
+            return nullptr;
+        }
+    }
+
+    boost::intrusive_ptr<DocumentSource> hoisted;
+    for (auto&& facet : _facets) {
+        auto teeConsumer = facet.pipeline->popFront();
+        hoisted = facet.pipeline->popFront();
+        facet.pipeline->addInitialSource(std::move(teeConsumer));
+    }
+    return hoisted;
+}
+
+Pipeline::SourceContainer::iterator DocumentSourceFacet::doOptimizeAt(
+    Pipeline::SourceContainer::iterator itr, Pipeline::SourceContainer* container) {
+    invariant(*itr == this);
+
+    // Equivalent prefixes are only recognizable once each facet has been optimized.
+    for (auto&& facet : _facets) {
+        facet.pipeline->optimizePipeline();
+    }
+
+    auto firstHoisted = itr;
+    while (auto stage = popCommonPrefixStage()) {
+        auto inserted = container->insert(itr, std::move(stage));
+        if (firstHoisted == itr) {
+            firstHoisted = inserted;
+        }
+    }
+
+    if (firstHoisted == itr) {
+        return std::next(itr);
+    }
+
+    // The hoisted stages, and the stage preceding them, may be able to optimize further.
+    return firstHoisted == container->begin() ? firstHoisted : std::prev(firstHoisted);
+}
+
 void DocumentSourceFacet::setSource(DocumentSource* source) {
     _teeBuffer->setSource(source);
 }
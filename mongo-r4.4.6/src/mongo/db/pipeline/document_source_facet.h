@@ -149,6 +149,14 @@ protected:
     GetNextResult doGetNext() final;
     void doDispose() final;
 
+    /**
+     * Moves the stages which every facet begins with, such as a $match or $unwind shared by all
+     * facets, in front of this stage, so that they are evaluated once per input document rather
+     * than once per facet and become subject to the optimizations of the enclosing pipeline.
+     */
+    Pipeline::SourceContainer::iterator doOptimizeAt(Pipeline::SourceContainer::iterator itr,
+                                                     Pipeline::SourceContainer* container) final;
+
 private:
     DocumentSourceFacet(std::vector<FacetPipeline> facetPipelines,
                         const boost::intrusive_ptr<ExpressionContext>& expCtx,
@@ -157,6 +165,13 @@ private:
 
     Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
 
+    /**
+     * If the first stage after the tee consumer is the same in every facet and may be evaluated
+     * once on behalf of all of them, removes it from each facet and returns it. Otherwise returns
+     * nullptr.
+     */
+    boost::intrusive_ptr<DocumentSource> popCommonPrefixStage();
+
     boost::intrusive_ptr<TeeBuffer> _teeBuffer;
     std::vector<FacetPipeline> _facets;
 
@@ -558,6 +558,65 @@ TEST_F(DocumentSourceFacetTest, ShouldOptimizeInnerPipelines) {
     ASSERT_TRUE(dummy->isOptimized);
 }
 
+TEST_F(DocumentSourceFacetTest, ShouldHoistStagesCommonToAllFacets) {
+    auto pipeline = Pipeline::parse({fromjson("{$facet: {"
+                                              "  a: [{$match: {x: 1}}, {$unwind: '$y'}, "
+                                              "      {$group: {_id: '$y'}}],"
+                                              "  b: [{$match: {x: 1}}, {$unwind: '$y'}, "
+                                              "      {$match: {z: 2}}]"
+                                              "}}")},
+                                    getExpCtx());
+    pipeline->optimizePipeline();
+
+    auto serialized = pipeline->serializeToBson();
+    ASSERT_EQ(serialized.size(), 3UL);
+    ASSERT_BSONOBJ_EQ(serialized[0], fromjson("{$match: {x: 1}}"));
+    ASSERT_BSONOBJ_EQ(serialized[1], fromjson("{$unwind: {path: '$y'}}"));
+    ASSERT_BSONOBJ_EQ(serialized[2],
+                      fromjson("{$facet: {a: [{$group: {_id: '$y'}}],"
+                               "          b: [{$match: {z: 2}}]}}"));
+}
+
+TEST_F(DocumentSourceFacetTest, ShouldNotHoistStagesWhichDifferAcrossFacets) {
+    auto pipeline = Pipeline::parse({fromjson("{$facet: {"
+                                              "  a: [{$match: {x: 1}}, {$group: {_id: '$y'}}],"
+                                              "  b: [{$match: {x: 2}}, {$group: {_id: '$y'}}]"
+                                              "}}")},
+                                    getExpCtx());
+    pipeline->optimizePipeline();
+
+    auto serialized = pipeline->serializeToBson();
+    ASSERT_EQ(serialized.size(), 1UL);
+    ASSERT_EQ(serialized[0].firstElementFieldNameStringData(), "$facet"_sd);
+}
+
+TEST_F(DocumentSourceFacetTest, ShouldNotHoistStagesWhichOnlyDifferInNumericType) {
+    // The stages compare equal as Values, but produce differently typed fields.
+    auto pipeline = Pipeline::parse({fromjson("{$facet: {"
+                                              "  a: [{$addFields: {v: 1}}, {$count: 'n'}],"
+                                              "  b: [{$addFields: {v: 1.0}}, {$count: 'n'}]"
+                                              "}}")},
+                                    getExpCtx());
+    pipeline->optimizePipeline();
+
+    auto serialized = pipeline->serializeToBson();
+    ASSERT_EQ(serialized.size(), 1UL);
+    ASSERT_EQ(serialized[0].firstElementFieldNameStringData(), "$facet"_sd);
+}
+
+TEST_F(DocumentSourceFacetTest, ShouldNotHoistNondeterministicStages) {
+    auto pipeline = Pipeline::parse({fromjson("{$facet: {"
+                                              "  a: [{$match: {$sampleRate: 0.5}}, {$count: 'n'}],"
+                                              "  b: [{$match: {$sampleRate: 0.5}}, {$count: 'n'}]"
+                                              "}}")},
+                                    getExpCtx());
+    pipeline->optimizePipeline();
+
+    auto serialized = pipeline->serializeToBson();
+    ASSERT_EQ(serialized.size(), 1UL);
+    ASSERT_EQ(serialized[0].firstElementFieldNameStringData(), "$facet"_sd);
+}
+
 TEST_F(DocumentSourceFacetTest, ShouldPropagateDetachingAndReattachingOfOpCtx) {
     auto ctx = getExpCtx();
     // We're going to be changing the OperationContext, so we need to use a MongoProcessInterface
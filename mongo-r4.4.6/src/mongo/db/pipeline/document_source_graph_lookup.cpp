@@ -31,6 +31,7 @@
 
 #include "mongo/db/pipeline/document_source_graph_lookup.h"
 
+#include <boost/filesystem/operations.hpp>
 #include <memory>
 
 #include "mongo/base/init.h"
@@ -44,6 +45,7 @@
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_planner_common.h"
+#include "mongo/util/destructor_guard.h"
 
 namespace mongo {
 
@@ -57,6 +59,16 @@ void assertIsValidCollectionState(const boost::intrusive_ptr<ExpressionContext>&
         }
     }
 }
+
+/**
+ * Generates a new file name on each call using a static, atomic and monotonically increasing
+ * number. See the comment on the equivalent function in document_source_group.cpp.
+ */
+std::string nextFileName() {
+    static AtomicWord<unsigned> documentSourceGraphLookupFileCounter;
+    return "extsort-doc-graphlookup." +
+        std::to_string(documentSourceGraphLookupFileCounter.fetchAndAdd(1));
+}
 }  // namespace
 
 using boost::intrusive_ptr;
@@ -112,11 +124,9 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::doGetNext() {
     performSearch();
 
     std::vector<Value> results;
-    while (!_visited.empty()) {
+    while (hasVisitedResults()) {
         // Remove elements one at a time to avoid consuming more memory.
-        auto it = _visited.begin();
-        results.push_back(Value(it->second));
-        _visited.erase(it);
+        results.push_back(Value(popVisitedResult()));
     }
 
     MutableDocument output(*_input);
@@ -135,7 +145,7 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::getNextUnwound() {
     // If the unwind is not preserving empty arrays, we might have to process multiple inputs before
     // we get one that will produce an output.
     while (true) {
-        if (_visited.empty()) {
+        if (!hasVisitedResults()) {
             // No results are left for the current input, so we should move on to the next one and
             // perform a new search.
 
@@ -151,7 +161,7 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::getNextUnwound() {
         }
         MutableDocument unwound(*_input);
 
-        if (_visited.empty()) {
+        if (!hasVisitedResults()) {
             if ((*_unwind)->preserveNullAndEmptyArrays()) {
                 // Since "preserveNullAndEmptyArrays" was specified, output a document even though
                 // we had no result.
@@ -165,13 +175,11 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::getNextUnwound() {
                 continue;
             }
         } else {
-            auto it = _visited.begin();
-            unwound.setNestedField(_as, Value(it->second));
+            unwound.setNestedField(_as, Value(popVisitedResult()));
             if (indexPath) {
                 unwound.setNestedField(*indexPath, Value(_outputIndex));
                 ++_outputIndex;
             }
-            _visited.erase(it);
         }
 
         return unwound.freeze();
@@ -180,8 +188,73 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::getNextUnwound() {
 
 void DocumentSourceGraphLookUp::doDispose() {
     _cache.clear();
+    _traversalCache.clear();
     _frontier.clear();
     _visited.clear();
+    resetSpilledResults();
+}
+
+bool DocumentSourceGraphLookUp::hasVisitedResults() {
+    while (!_spilledVisited.empty()) {
+        auto& iterator = _spilledVisited.front();
+        if (!_spillIteratorOpen) {
+            iterator->openSource();
+            _spillIteratorOpen = true;
+        }
+        if (iterator->more()) {
+            return true;
+        }
+        iterator->closeSource();
+        _spillIteratorOpen = false;
+        _spilledVisited.pop_front();
+    }
+    return !_visited.empty();
+}
+
+Document DocumentSourceGraphLookUp::popVisitedResult() {
+    if (!_spilledVisited.empty()) {
+        invariant(_spillIteratorOpen);
+        return _spilledVisited.front()->next().second;
+    }
+
+    invariant(!_visited.empty());
+    auto it = _visited.begin();
+    Document result = std::move(it->second);
+    _visited.erase(it);
+    return result;
+}
+
+void DocumentSourceGraphLookUp::spillVisited() {
+    invariant(!_fileName.empty());
+    _usedDisk = true;
+
+    SortedFileWriter<Value, Document> writer(
+        SortOptions().TempDir(pExpCtx->tempDir), _fileName, _nextSpillFileOffset);
+    for (auto&& [id, doc] : _visited) {
+        // Only the '_id' stays in memory, so stop accounting for the size of the document.
+        const size_t docSize = doc.getApproximateSize();
+        _visitedUsageBytes -= std::min(docSize, _visitedUsageBytes);
+        writer.addAlreadySorted(id, doc);
+        _spilledIds.insert(id);
+    }
+    _visited.clear();
+
+    _spilledVisited.emplace_back(writer.done());
+    _nextSpillFileOffset = writer.getFileEndOffset();
+}
+
+void DocumentSourceGraphLookUp::resetSpilledResults() {
+    if (_spillIteratorOpen) {
+        _spilledVisited.front()->closeSource();
+        _spillIteratorOpen = false;
+    }
+    _spilledVisited.clear();
+    _spilledIds.clear();
+
+    if (_nextSpillFileOffset != 0) {
+        boost::filesystem::remove(_fileName);
+        _nextSpillFileOffset = 0;
+    }
 }
 
 void DocumentSourceGraphLookUp::doBreadthFirstSearch() {
@@ -245,7 +318,7 @@ void DocumentSourceGraphLookUp::doBreadthFirstSearch() {
 bool DocumentSourceGraphLookUp::addToVisitedAndFrontier(Document result, long long depth) {
     auto id = result.getField("_id");
 
-    if (_visited.find(id) != _visited.end()) {
+    if (_visited.find(id) != _visited.end() || _spilledIds.find(id) != _spilledIds.end()) {
         // We've already seen this object, don't repeat any work.
         return false;
     }
@@ -347,6 +420,18 @@ void DocumentSourceGraphLookUp::performSearch() {
 
     Value startingValue = _startWith->evaluate(*_input, &pExpCtx->variables);
 
+    // The results of the previous search have all been returned by now.
+    resetSpilledResults();
+
+    if (auto cachedResults = _traversalCache[startingValue]) {
+        for (auto&& result : *cachedResults) {
+            auto id = result.getField("_id");
+            _visitedUsageBytes += id.getApproximateSize() + result.getApproximateSize();
+            _visited[id] = result;
+        }
+        return;
+    }
+
     // If _startWith evaluates to an array, treat each value as a separate starting point.
     if (startingValue.isArray()) {
         for (auto value : startingValue.getArray()) {
@@ -359,6 +444,18 @@ void DocumentSourceGraphLookUp::performSearch() {
     }
 
     doBreadthFirstSearch();
+
+    // Remember the result for later input documents which start from the same value, provided the
+    // search stayed in memory and fits in the traversal cache on its own. A search which found
+    // nothing has no documents to cache, and is cheap to repeat.
+    const auto traversalCacheMaxBytes =
+        static_cast<size_t>(internalDocumentSourceGraphLookupTraversalCacheMaxMemoryBytes.load());
+    if (_spilledIds.empty() && _visitedUsageBytes <= traversalCacheMaxBytes) {
+        for (auto&& entry : _visited) {
+            _traversalCache.insert(startingValue, entry.second);
+        }
+        _traversalCache.evictDownTo(traversalCacheMaxBytes);
+    }
 }
 
 DocumentSource::GetModPathsReturn DocumentSourceGraphLookUp::getModifiedPaths() const {
@@ -392,7 +489,11 @@ Pipeline::SourceContainer::iterator DocumentSourceGraphLookUp::doOptimizeAt(
 }
 
 void DocumentSourceGraphLookUp::checkMemoryUsage() {
-    // TODO SERVER-23980: Implement spilling to disk if allowDiskUse is specified.
+    if ((_visitedUsageBytes + _frontierUsageBytes) >= _maxMemoryUsageBytes && !_fileName.empty() &&
+        !_visited.empty()) {
+        spillVisited();
+    }
+
     uassert(40099,
             "$graphLookup reached maximum memory consumption",
             (_visitedUsageBytes + _frontierUsageBytes) < _maxMemoryUsageBytes);
@@ -438,6 +539,13 @@ void DocumentSourceGraphLookUp::serializeToArray(
     }
 }
 
+DocumentSourceGraphLookUp::~DocumentSourceGraphLookUp() {
+    if (_nextSpillFileOffset != 0) {
+        _spilledVisited.clear();
+        DESTRUCTOR_GUARD(boost::filesystem::remove(_fileName));
+    }
+}
+
 void DocumentSourceGraphLookUp::detachFromOperationContext() {
     _fromExpCtx->opCtx = nullptr;
 }
@@ -466,10 +574,18 @@ DocumentSourceGraphLookUp::DocumentSourceGraphLookUp(
       _additionalFilter(additionalFilter),
       _depthField(depthField),
       _maxDepth(maxDepth),
+      _maxMemoryUsageBytes(
+          static_cast<size_t>(internalDocumentSourceGraphLookupMaxMemoryBytes.load())),
       _frontier(pExpCtx->getValueComparator().makeUnorderedValueSet()),
       _visited(ValueComparator::kInstance.makeUnorderedValueMap<Document>()),
       _cache(pExpCtx->getValueComparator()),
+      _traversalCache(pExpCtx->getValueComparator()),
+      _spilledIds(ValueComparator::kInstance.makeUnorderedValueSet()),
       _unwind(unwindSrc) {
+    if (pExpCtx->allowDiskUse && !pExpCtx->inMongos) {
+        _fileName = pExpCtx->tempDir + "/" + nextFileName();
+    }
+
     const auto& resolvedNamespace = pExpCtx->getResolvedNamespace(_from);
     _fromExpCtx = pExpCtx->copyWith(resolvedNamespace.ns);
 
@@ -613,3 +729,6 @@ void DocumentSourceGraphLookUp::addInvolvedCollections(
     }
 }
 }  // namespace mongo
+
+#include "mongo/db/sorter/sorter.cpp"
+// Explicit instantiation unneeded since we aren't exposing Sorter outside of this file.
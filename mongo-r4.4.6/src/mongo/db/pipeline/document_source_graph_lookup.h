@@ -29,11 +29,15 @@
 
 #pragma once
 
+#include <deque>
+#include <memory>
+
 #include "mongo/db/exec/document_value/value_comparator.h"
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_unwind.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/lookup_set_cache.h"
+#include "mongo/db/sorter/sorter.h"
 
 namespace mongo {
 
@@ -95,7 +99,7 @@ public:
         StageConstraints constraints(StreamType::kStreaming,
                                      PositionRequirement::kNone,
                                      HostTypeRequirement::kPrimaryShard,
-                                     DiskUseRequirement::kNoDiskUse,
+                                     DiskUseRequirement::kWritesTmpData,
                                      FacetRequirement::kAllowed,
                                      TransactionRequirement::kAllowed,
                                      LookupRequirement::kAllowed,
@@ -121,6 +125,10 @@ public:
 
     void reattachToOperationContext(OperationContext* opCtx) final;
 
+    bool usedDisk() final {
+        return _usedDisk;
+    }
+
     static boost::intrusive_ptr<DocumentSourceGraphLookUp> create(
         const boost::intrusive_ptr<ExpressionContext>& expCtx,
         NamespaceString fromNs,
@@ -136,6 +144,8 @@ public:
     static boost::intrusive_ptr<DocumentSource> createFromBson(
         BSONElement elem, const boost::intrusive_ptr<ExpressionContext>& pExpCtx);
 
+    ~DocumentSourceGraphLookUp();
+
 protected:
     GetNextResult doGetNext() final;
     void doDispose() final;
@@ -201,10 +211,34 @@ private:
 
     /**
      * Assert that '_visited' and '_frontier' have not exceeded the maximum meory usage, and then
-     * evict from '_cache' until this source is using less than '_maxMemoryUsageBytes'.
+     * evict from '_cache' until this source is using less than '_maxMemoryUsageBytes'. If
+     * 'allowDiskUse' is set, the documents in '_visited' are first spilled to disk.
      */
     void checkMemoryUsage();
 
+    /**
+     * Writes the documents in '_visited' to '_fileName', keeping only their '_id' values in memory
+     * so that later levels of the search can still be de-duplicated against them.
+     */
+    void spillVisited();
+
+    /**
+     * Returns whether any results of the current search have yet to be returned, either from disk
+     * or from '_visited'.
+     */
+    bool hasVisitedResults();
+
+    /**
+     * Removes and returns the next result of the current search. Documents which were spilled to
+     * disk are returned first. Must only be called after hasVisitedResults() returned true.
+     */
+    Document popVisitedResult();
+
+    /**
+     * Discards any spilled results of the previous search and removes the spill file.
+     */
+    void resetSpilledResults();
+
     /**
      * Process 'result', adding it to '_visited' with the given 'depth', and updating '_frontier'
      * with the object's 'connectTo' values.
@@ -230,7 +264,7 @@ private:
     // The aggregation pipeline to perform against the '_from' namespace.
     std::vector<BSONObj> _fromPipeline;
 
-    size_t _maxMemoryUsageBytes = 100 * 1024 * 1024;
+    size_t _maxMemoryUsageBytes;
 
     // Track memory usage to ensure we don't exceed '_maxMemoryUsageBytes'.
     size_t _visitedUsageBytes = 0;
@@ -248,6 +282,28 @@ private:
     // to getNext().
     LookupSetCache _cache;
 
+    // Caches the complete result of a search, keyed by the value that '_startWith' evaluated to,
+    // so that input documents which start from the same value do not repeat the search. Bounded by
+    // 'internalDocumentSourceGraphLookupTraversalCacheMaxMemoryBytes' rather than by
+    // '_maxMemoryUsageBytes'. Searches which spilled to disk are never cached.
+    LookupSetCache _traversalCache;
+
+    // The '_id' values of documents from the current search which were spilled to disk, compared
+    // using the simple collation like the keys of '_visited'.
+    ValueUnorderedSet _spilledIds;
+
+    // Iterators over the documents of the current search which were spilled to disk, one per spill,
+    // in the order they were written. Only the front iterator is ever open.
+    std::deque<std::shared_ptr<Sorter<Value, Document>::Iterator>> _spilledVisited;
+    bool _spillIteratorOpen = false;
+
+    // The file which documents from '_visited' are spilled to. Empty unless 'allowDiskUse' is set.
+    std::string _fileName;
+    std::streampos _nextSpillFileOffset = 0;
+
+    // Whether this stage has spilled to disk at any point.
+    bool _usedDisk = false;
+
     // When we have internalized a $unwind, we must keep track of the input document, since we will
     // need it for multiple "getNext()" calls.
     boost::optional<Document> _input;
@@ -38,8 +38,11 @@
 #include "mongo/db/pipeline/document_source_graph_lookup.h"
 #include "mongo/db/pipeline/document_source_mock.h"
 #include "mongo/db/pipeline/process_interface/stub_mongo_process_interface.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/str.h"
 
 namespace mongo {
@@ -67,11 +70,17 @@ public:
         std::unique_ptr<Pipeline, PipelineDeleter> pipeline(
             ownedPipeline, PipelineDeleter(ownedPipeline->getContext()->opCtx));
         pipeline->addInitialSource(DocumentSourceMock::createForTest(_results));
+        ++_numPipelinesAttached;
         return pipeline;
     }
 
+    int getNumPipelinesAttached() const {
+        return _numPipelinesAttached;
+    }
+
 private:
     std::deque<DocumentSource::GetNextResult> _results;
+    int _numPipelinesAttached = 0;
 };
 
 TEST_F(DocumentSourceGraphLookUpTest,
@@ -609,5 +618,178 @@ TEST_F(DocumentSourceGraphLookUpTest, ShouldNotExpandArraysWithinArraysAtEndOfCo
     ASSERT(graphLookupStage->getNext().isEOF());
 }
 
+TEST_F(DocumentSourceGraphLookUpTest, ShouldReuseSearchForInputsWithTheSameStartValue) {
+    auto expCtx = getExpCtx();
+
+    std::deque<DocumentSource::GetNextResult> inputs{Document{{"_id", 0}, {"start", 0}},
+                                                     Document{{"_id", 1}, {"start", 0}}};
+    auto inputMock = DocumentSourceMock::createForTest(std::move(inputs));
+
+    // The 'to' value of this document was not queried for, so the per-value cache cannot answer
+    // the second search. Only the traversal cache can.
+    Document target{{"_id", "a"_sd}, {"to", 7}};
+    std::deque<DocumentSource::GetNextResult> fromContents{Document(target)};
+
+    NamespaceString fromNs("test", "graph_lookup");
+    expCtx->setResolvedNamespaces(StringMap<ExpressionContext::ResolvedNamespace>{
+        {fromNs.coll().toString(), {fromNs, std::vector<BSONObj>()}}});
+    auto mongoInterface = std::make_shared<MockMongoInterface>(std::move(fromContents));
+    expCtx->mongoProcessInterface = mongoInterface;
+    auto graphLookupStage =
+        DocumentSourceGraphLookUp::create(expCtx,
+                                          fromNs,
+                                          "results",
+                                          "from",
+                                          "to",
+                                          ExpressionFieldPath::create(expCtx, "start"),
+                                          boost::none,
+                                          boost::none,
+                                          boost::none,
+                                          boost::none);
+    graphLookupStage->setSource(inputMock.get());
+
+    for (int i = 0; i < 2; ++i) {
+        auto next = graphLookupStage->getNext();
+        ASSERT(next.isAdvanced());
+        ASSERT_VALUE_EQ(Value(i), next.getDocument().getField("_id"));
+        ASSERT_VALUE_EQ(Value(std::vector<Value>{Value(target)}),
+                        next.getDocument().getField("results"));
+    }
+    ASSERT(graphLookupStage->getNext().isEOF());
+    ASSERT_EQ(mongoInterface->getNumPipelinesAttached(), 1);
+}
+
+TEST_F(DocumentSourceGraphLookUpTest, ShouldNotReuseSearchWhenTraversalCacheIsDisabled) {
+    internalDocumentSourceGraphLookupTraversalCacheMaxMemoryBytes.store(0);
+    ON_BLOCK_EXIT([] {
+        internalDocumentSourceGraphLookupTraversalCacheMaxMemoryBytes.store(32 * 1024 * 1024);
+    });
+    auto expCtx = getExpCtx();
+
+    std::deque<DocumentSource::GetNextResult> inputs{Document{{"_id", 0}, {"start", 0}},
+                                                     Document{{"_id", 1}, {"start", 0}}};
+    auto inputMock = DocumentSourceMock::createForTest(std::move(inputs));
+
+    std::deque<DocumentSource::GetNextResult> fromContents{Document{{"_id", "a"_sd}, {"to", 7}}};
+
+    NamespaceString fromNs("test", "graph_lookup");
+    expCtx->setResolvedNamespaces(StringMap<ExpressionContext::ResolvedNamespace>{
+        {fromNs.coll().toString(), {fromNs, std::vector<BSONObj>()}}});
+    auto mongoInterface = std::make_shared<MockMongoInterface>(std::move(fromContents));
+    expCtx->mongoProcessInterface = mongoInterface;
+    auto graphLookupStage =
+        DocumentSourceGraphLookUp::create(expCtx,
+                                          fromNs,
+                                          "results",
+                                          "from",
+                                          "to",
+                                          ExpressionFieldPath::create(expCtx, "start"),
+                                          boost::none,
+                                          boost::none,
+                                          boost::none,
+                                          boost::none);
+    graphLookupStage->setSource(inputMock.get());
+
+    ASSERT(graphLookupStage->getNext().isAdvanced());
+    ASSERT(graphLookupStage->getNext().isAdvanced());
+    ASSERT(graphLookupStage->getNext().isEOF());
+    ASSERT_EQ(mongoInterface->getNumPipelinesAttached(), 2);
+}
+
+/**
+ * Builds a foreign collection of 'numDocs' documents which are all connected to the value 0 and
+ * connect from the value 1, each padded so that together they exceed a small memory limit.
+ */
+std::deque<DocumentSource::GetNextResult> makeLargeFromContents(int numDocs) {
+    std::deque<DocumentSource::GetNextResult> fromContents;
+    for (int i = 0; i < numDocs; ++i) {
+        fromContents.push_back(Document{
+            {"_id", i}, {"to", 0}, {"from", 1}, {"padding", std::string(100, 'x')}});
+    }
+    return fromContents;
+}
+
+TEST_F(DocumentSourceGraphLookUpTest, ShouldSpillVisitedDocumentsToDiskWhenAllowDiskUseIsSet) {
+    internalDocumentSourceGraphLookupMaxMemoryBytes.store(1024);
+    ON_BLOCK_EXIT(
+        [] { internalDocumentSourceGraphLookupMaxMemoryBytes.store(100 * 1024 * 1024); });
+    auto expCtx = getExpCtx();
+    unittest::TempDir tempDir("DocumentSourceGraphLookUpTest");
+    expCtx->tempDir = tempDir.path();
+    expCtx->allowDiskUse = true;
+
+    std::deque<DocumentSource::GetNextResult> inputs{Document{{"_id", 0}}};
+    auto inputMock = DocumentSourceMock::createForTest(std::move(inputs));
+
+    const int numDocs = 20;
+    NamespaceString fromNs("test", "graph_lookup");
+    expCtx->setResolvedNamespaces(StringMap<ExpressionContext::ResolvedNamespace>{
+        {fromNs.coll().toString(), {fromNs, std::vector<BSONObj>()}}});
+    expCtx->mongoProcessInterface =
+        std::make_shared<MockMongoInterface>(makeLargeFromContents(numDocs));
+    auto graphLookupStage =
+        DocumentSourceGraphLookUp::create(expCtx,
+                                          fromNs,
+                                          "results",
+                                          "from",
+                                          "to",
+                                          ExpressionFieldPath::create(expCtx, "_id"),
+                                          boost::none,
+                                          boost::none,
+                                          boost::none,
+                                          boost::none);
+    graphLookupStage->setSource(inputMock.get());
+
+    auto next = graphLookupStage->getNext();
+    ASSERT(next.isAdvanced());
+    ASSERT(graphLookupStage->usedDisk());
+
+    // The second level of the search returns the same documents again, which must be recognized as
+    // already visited even though they now live on disk.
+    auto resultsValue = next.getDocument().getField("results");
+    ASSERT(resultsValue.isArray());
+    auto resultsArray = resultsValue.getArray();
+    ASSERT_EQ(resultsArray.size(), static_cast<size_t>(numDocs));
+    std::vector<int> ids;
+    for (auto&& result : resultsArray) {
+        ids.push_back(result.getDocument().getField("_id").getInt());
+    }
+    std::sort(ids.begin(), ids.end());
+    for (int i = 0; i < numDocs; ++i) {
+        ASSERT_EQ(ids[i], i);
+    }
+    ASSERT(graphLookupStage->getNext().isEOF());
+}
+
+TEST_F(DocumentSourceGraphLookUpTest, ShouldFailToExceedMemoryLimitWithoutAllowDiskUse) {
+    internalDocumentSourceGraphLookupMaxMemoryBytes.store(1024);
+    ON_BLOCK_EXIT(
+        [] { internalDocumentSourceGraphLookupMaxMemoryBytes.store(100 * 1024 * 1024); });
+    auto expCtx = getExpCtx();
+
+    std::deque<DocumentSource::GetNextResult> inputs{Document{{"_id", 0}}};
+    auto inputMock = DocumentSourceMock::createForTest(std::move(inputs));
+
+    NamespaceString fromNs("test", "graph_lookup");
+    expCtx->setResolvedNamespaces(StringMap<ExpressionContext::ResolvedNamespace>{
+        {fromNs.coll().toString(), {fromNs, std::vector<BSONObj>()}}});
+    expCtx->mongoProcessInterface = std::make_shared<MockMongoInterface>(makeLargeFromContents(20));
+    auto graphLookupStage =
+        DocumentSourceGraphLookUp::create(expCtx,
+                                          fromNs,
+                                          "results",
+                                          "from",
+                                          "to",
+                                          ExpressionFieldPath::create(expCtx, "_id"),
+                                          boost::none,
+                                          boost::none,
+                                          boost::none,
+                                          boost::none);
+    graphLookupStage->setSource(inputMock.get());
+
+    ASSERT_THROWS_CODE(graphLookupStage->getNext(), AssertionException, 40099);
+    ASSERT_FALSE(graphLookupStage->usedDisk());
+}
+
 }  // namespace
 }  // namespace mongo
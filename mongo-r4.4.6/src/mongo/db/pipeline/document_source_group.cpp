@@ -41,6 +41,7 @@
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/util/destructor_guard.h"
 
 namespace mongo {
@@ -508,13 +509,98 @@ private:
 };
 }  // namespace
 
+void DocumentSourceGroup::addToAccumulatorBatch(const Accumulators& group, const Document& root) {
+    auto& batch = _accumulatorBatch;
+    auto [position, inserted] =
+        batch.groupPositions.emplace(group.front().get(), batch.groupPositions.size());
+    if (inserted) {
+        for (auto&& accum : group) {
+            batch.groupAccumulators.push_back(accum.get());
+        }
+    }
+
+    batch.documentGroups.push_back(position->second);
+    for (auto&& accumulatedField : _accumulatedFields) {
+        batch.arguments.push_back(
+            accumulatedField.expr.argument->evaluate(root, &pExpCtx->variables));
+
+        // Buffered arguments count against the memory limit until they are processed.
+        const size_t argumentBytes = batch.arguments.back().getApproximateSize();
+        batch.argumentBytes += argumentBytes;
+        _memoryTracker.memoryUsageBytes += argumentBytes;
+    }
+
+    if (batch.documentGroups.size() >= _accumulatorBatchSize) {
+        flushAccumulatorBatch();
+    }
+}
+
+void DocumentSourceGroup::flushAccumulatorBatch() {
+    auto& batch = _accumulatorBatch;
+    const size_t numDocuments = batch.documentGroups.size();
+    if (numDocuments == 0) {
+        return;
+    }
+
+    const size_t numGroups = batch.groupPositions.size();
+    const size_t numAccumulators = _accumulatedFields.size();
+    _memoryTracker.memoryUsageBytes -= batch.argumentBytes;
+    batch.argumentBytes = 0;
+
+    // Order the documents by group with a counting sort, which keeps the documents of each group
+    // in input order.
+    batch.groupOffsets.assign(numGroups + 1, 0);
+    for (auto group : batch.documentGroups) {
+        ++batch.groupOffsets[group + 1];
+    }
+    for (size_t group = 0; group < numGroups; ++group) {
+        batch.groupOffsets[group + 1] += batch.groupOffsets[group];
+    }
+    batch.runs.resize(numDocuments);
+
+    for (size_t i = 0; i < numAccumulators; ++i) {
+        batch.groupCursors.assign(batch.groupOffsets.begin(), batch.groupOffsets.end() - 1);
+        for (size_t doc = 0; doc < numDocuments; ++doc) {
+            batch.runs[batch.groupCursors[batch.documentGroups[doc]]++] =
+                std::move(batch.arguments[doc * numAccumulators + i]);
+        }
+
+        for (size_t group = 0; group < numGroups; ++group) {
+            AccumulatorState* accum = batch.groupAccumulators[group * numAccumulators + i];
+            const size_t begin = batch.groupOffsets[group];
+            const size_t end = batch.groupOffsets[group + 1];
+
+            // Subtract old mem usage. New usage added back after processing.
+            _memoryTracker.memoryUsageBytes -= accum->memUsageForSorter();
+            accum->processBatch(batch.runs.data() + begin, end - begin, _doingMerge);
+            _memoryTracker.memoryUsageBytes += accum->memUsageForSorter();
+        }
+    }
+
+    batch.groupAccumulators.clear();
+    batch.groupPositions.clear();
+    batch.documentGroups.clear();
+    batch.arguments.clear();
+    batch.runs.clear();
+}
+
 DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
     const size_t numAccumulators = _accumulatedFields.size();
 
+    // Accumulator arguments are buffered and processed in batches unless batching is disabled or
+    // there is nothing to accumulate.
+    _accumulatorBatchSize = numAccumulators > 0
+        ? static_cast<size_t>(internalDocumentSourceGroupAccumulatorBatchSize.load())
+        : 0;
+
     // Barring any pausing, this loop exhausts 'pSource' and populates '_groups'.
     GetNextResult input = pSource->getNext();
 
     for (; input.isAdvanced(); input = pSource->getNext()) {
+        if (_memoryTracker.memoryUsageBytes > _memoryTracker.maxMemoryUsageBytes) {
+            // Account for the buffered arguments before deciding whether to spill.
+            flushAccumulatorBatch();
+        }
         if (_memoryTracker.shouldSpillWithAttemptToSaveMemory([this]() { return freeMemory(); })) {
             _sortedFiles.push_back(spill());
         }
@@ -544,9 +630,13 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
                 Value initializerValue =
                     accumulatedField.expr.initializer->evaluate(idDoc, &pExpCtx->variables);
                 accum->startNewGroup(initializerValue);
+                if (_accumulatorBatchSize > 0) {
+                    // Batch processing replaces this usage rather than adding to it.
+                    _memoryTracker.memoryUsageBytes += accum->memUsageForSorter();
+                }
                 group.push_back(accum);
             }
-        } else {
+        } else if (_accumulatorBatchSize == 0) {
             for (auto&& groupObj : group) {
                 // subtract old mem usage. New usage added back after processing.
                 _memoryTracker.memoryUsageBytes -= groupObj->memUsageForSorter();
@@ -556,12 +646,17 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
         /* tickle all the accumulators for the group we found */
         dassert(numAccumulators == group.size());
 
-        for (size_t i = 0; i < numAccumulators; i++) {
-            group[i]->process(
-                _accumulatedFields[i].expr.argument->evaluate(rootDocument, &pExpCtx->variables),
-                _doingMerge);
+        if (_accumulatorBatchSize > 0) {
+            // The accumulators' memory usage is updated when the batch is processed.
+            addToAccumulatorBatch(group, rootDocument);
+        } else {
+            for (size_t i = 0; i < numAccumulators; i++) {
+                group[i]->process(_accumulatedFields[i].expr.argument->evaluate(
+                                      rootDocument, &pExpCtx->variables),
+                                  _doingMerge);
 
-            _memoryTracker.memoryUsageBytes += group[i]->memUsageForSorter();
+                _memoryTracker.memoryUsageBytes += group[i]->memUsageForSorter();
+            }
         }
 
         if (kDebugBuild && !storageGlobalParams.readOnly) {
@@ -571,11 +666,14 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
                 !_memoryTracker.allowDiskUse &&  // don't change behavior when testing external sort
                 _sortedFiles.size() < 20) {      // don't open too many FDs
 
+                flushAccumulatorBatch();
                 _sortedFiles.push_back(spill());
             }
         }
     }
 
+    flushAccumulatorBatch();
+
     switch (input.getStatus()) {
         case DocumentSource::GetNextResult::ReturnStatus::kAdvanced: {
             MONGO_UNREACHABLE;  // We consumed all advances above.
@@ -628,6 +726,7 @@ bool DocumentSourceGroup::usedDisk() {
 }
 
 shared_ptr<Sorter<Value, Value>::Iterator> DocumentSourceGroup::spill() {
+    invariant(_accumulatorBatch.documentGroups.empty());
     _usedDisk = true;
     vector<const GroupsMap::value_type*> ptrs;  // using pointers to speed sorting
     ptrs.reserve(_groups->size());
@@ -37,6 +37,7 @@
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/transformer_interface.h"
 #include "mongo/db/sorter/sorter.h"
+#include "mongo/stdx/unordered_map.h"
 
 namespace mongo {
 
@@ -156,6 +157,14 @@ public:
         _doingMerge = doingMerge;
     }
 
+    /**
+     * Sets the amount of memory this stage may use before it spills to disk or fails. Must be
+     * called before the stage is executed.
+     */
+    void setMaxMemoryUsageBytes(size_t maxMemoryUsageBytes) {
+        _memoryTracker.maxMemoryUsageBytes = maxMemoryUsageBytes;
+    }
+
     /**
      * Returns true if this $group stage used disk during execution and false otherwise.
      */
@@ -193,7 +202,7 @@ private:
         bool shouldSpillWithAttemptToSaveMemory(std::function<int()> saveMemory);
 
         const bool allowDiskUse;
-        const size_t maxMemoryUsageBytes;
+        size_t maxMemoryUsageBytes;
         size_t memoryUsageBytes = 0;
     };
 
@@ -235,6 +244,18 @@ private:
      */
     int freeMemory();
 
+    /**
+     * Evaluates the accumulator arguments for 'root' and buffers them for the accumulators of
+     * 'group', processing the buffered batch once it holds '_accumulatorBatchSize' documents.
+     */
+    void addToAccumulatorBatch(const Accumulators& group, const Document& root);
+
+    /**
+     * Feeds the buffered arguments to their accumulators, as one run per group and accumulator in
+     * input order, and accounts for the resulting change in memory usage.
+     */
+    void flushAccumulatorBatch();
+
     Document makeDocument(const Value& id, const Accumulators& accums, bool mergeableOutput);
 
     /**
@@ -260,6 +281,27 @@ private:
 
     MemoryUsageTracker _memoryTracker;
 
+    // Accumulator arguments buffered by addToAccumulatorBatch(). Empty outside of initialize().
+    struct AccumulatorBatch {
+        // The accumulators of each group with buffered documents, one group after another.
+        std::vector<AccumulatorState*> groupAccumulators;
+        // Maps a group, identified by its first accumulator, to its position in the batch.
+        stdx::unordered_map<AccumulatorState*, size_t> groupPositions;
+        // The position of the group of each buffered document.
+        std::vector<size_t> documentGroups;
+        // The arguments evaluated for each buffered document, one document after another.
+        std::vector<Value> arguments;
+        // The approximate size of 'arguments', included in the tracked memory usage.
+        size_t argumentBytes = 0;
+
+        // Scratch space used to lay out the arguments of each accumulator by group.
+        std::vector<size_t> groupOffsets;
+        std::vector<size_t> groupCursors;
+        std::vector<Value> runs;
+    };
+    AccumulatorBatch _accumulatorBatch;
+    size_t _accumulatorBatchSize = 0;
+
     std::string _fileName;
     std::streampos _nextSortedFileWriterOffset = 0;
     bool _ownsFileDeletion = true;  // unless a MergeIterator is made that takes over.
@@ -0,0 +1,146 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/bson/json.h"
+#include "mongo/db/exec/document_value/document.h"
+#include "mongo/db/pipeline/document_source_group.h"
+#include "mongo/db/pipeline/document_source_mock.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/platform/random.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Produces 'numRows' documents by cycling through a fixed set, so that very large inputs can be
+ * generated without holding them in memory.
+ */
+class RepeatingSource final : public DocumentSourceMock {
+public:
+    RepeatingSource(std::vector<Document> docs,
+                    long long numRows,
+                    const boost::intrusive_ptr<ExpressionContext>& expCtx)
+        : DocumentSourceMock(std::deque<GetNextResult>{}, expCtx),
+          _docs(std::move(docs)),
+          _remaining(numRows) {}
+
+protected:
+    GetNextResult doGetNext() final {
+        if (_remaining == 0) {
+            return GetNextResult::makeEOF();
+        }
+        --_remaining;
+        if (_next == _docs.size()) {
+            _next = 0;
+        }
+        return Document(_docs[_next++]);
+    }
+
+private:
+    const std::vector<Document> _docs;
+    long long _remaining;
+    size_t _next = 0;
+};
+
+std::vector<Document> makeSales(int nDocs) {
+    PseudoRandom random(1);
+    std::vector<Document> docs;
+    docs.reserve(nDocs);
+    for (int i = 0; i < nDocs; ++i) {
+        docs.push_back(Document{{"region", random.nextInt32(16)},
+                                {"store", random.nextInt32(1000)},
+                                {"units", random.nextInt32(100)},
+                                {"revenue", static_cast<long long>(random.nextInt32(1000000))},
+                                {"price", random.nextCanonicalDouble() * 100}});
+    }
+    return docs;
+}
+
+void runGroup(benchmark::State& state, const char* groupSpec) {
+    const int batchSize = state.range(0);
+    const long long numRows = state.range(1);
+    const int oldBatchSize = internalDocumentSourceGroupAccumulatorBatchSize.load();
+    internalDocumentSourceGroupAccumulatorBatchSize.store(batchSize);
+
+    const auto docs = makeSales(10000);
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    const BSONObj spec = fromjson(groupSpec);
+
+    for (auto keepRunning : state) {
+        auto group = DocumentSourceGroup::createFromBson(spec.firstElement(), expCtx);
+        auto source = make_intrusive<RepeatingSource>(docs, numRows, expCtx);
+        group->setSource(source.get());
+        for (auto next = group->getNext(); next.isAdvanced(); next = group->getNext()) {
+            benchmark::DoNotOptimize(next.releaseDocument());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * numRows);
+
+    internalDocumentSourceGroupAccumulatorBatchSize.store(oldBatchSize);
+}
+
+// A rollup of integer and long measures into a few groups.
+void BM_GroupIntegralRollup(benchmark::State& state) {
+    runGroup(state,
+             "{$group: {_id: '$region', units: {$sum: '$units'}, revenue: {$sum: '$revenue'},"
+             " count: {$sum: 1}, minUnits: {$min: '$units'}, maxRevenue: {$max: '$revenue'}}}");
+}
+
+// A rollup of double measures into a few groups.
+void BM_GroupDoubleRollup(benchmark::State& state) {
+    runGroup(state,
+             "{$group: {_id: '$region', avgPrice: {$avg: '$price'}, totalPrice: {$sum: '$price'},"
+             " minPrice: {$min: '$price'}, maxPrice: {$max: '$price'}}}");
+}
+
+// A rollup into many groups, where each batch holds only a few documents per group.
+void BM_GroupManyGroups(benchmark::State& state) {
+    runGroup(state, "{$group: {_id: '$store', units: {$sum: '$units'}, count: {$sum: 1}}}");
+}
+
+// Arguments are the accumulator batch size (0 disables batching) and the number of input rows.
+#define GROUP_BENCHMARK(name)            \
+    BENCHMARK(name)                      \
+        ->Args({0, 1000000})             \
+        ->Args({512, 1000000})           \
+        ->Args({0, 100000000})           \
+        ->Args({512, 100000000})         \
+        ->Unit(benchmark::kMillisecond)
+
+GROUP_BENCHMARK(BM_GroupIntegralRollup);
+GROUP_BENCHMARK(BM_GroupDoubleRollup);
+GROUP_BENCHMARK(BM_GroupManyGroups);
+
+}  // namespace
+}  // namespace mongo
@@ -49,11 +49,13 @@
 #include "mongo/db/pipeline/document_source_mock.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_test_service_context.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/stdx/unordered_set.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -202,6 +204,68 @@ TEST_F(DocumentSourceGroupTest, ShouldCorrectlyTrackMemoryUsageBetweenPauses) {
         group->getNext(), AssertionException, ErrorCodes::QueryExceededMemoryLimitNoDiskUseAllowed);
 }
 
+TEST_F(DocumentSourceGroupTest, BatchedAccumulationMatchesDocumentAtATimeAccumulation) {
+    auto expCtx = getExpCtx();
+    expCtx->inMongos = true;  // Disallow external sort.
+                              // This is the only way to do this in a debug build.
+
+    // Numeric inputs of every type, with missing, null and non-numeric values mixed in, spread
+    // over a handful of groups.
+    std::deque<DocumentSource::GetNextResult> inputs;
+    for (int i = 0; i < 1000; ++i) {
+        MutableDocument doc;
+        doc.addField("k", Value(i % 7));
+        switch (i % 5) {
+            case 0:
+                doc.addField("x", Value(i));
+                break;
+            case 1:
+                doc.addField("x", Value(static_cast<long long>(i) << 20));
+                break;
+            case 2:
+                doc.addField("x", Value(i * 0.5));
+                break;
+            case 3:
+                doc.addField("x", (i % 3) ? Value(BSONNULL) : Value("str"_sd));
+                break;
+            case 4:
+                break;
+        }
+        inputs.push_back(doc.freeze());
+    }
+
+    auto runGroup = [&](int batchSize) {
+        const int oldBatchSize = internalDocumentSourceGroupAccumulatorBatchSize.load();
+        internalDocumentSourceGroupAccumulatorBatchSize.store(batchSize);
+        ON_BLOCK_EXIT(
+            [&] { internalDocumentSourceGroupAccumulatorBatchSize.store(oldBatchSize); });
+
+        auto spec = fromjson(
+            "{$group: {_id: '$k', sum: {$sum: '$x'}, count: {$sum: 1}, avg: {$avg: '$x'},"
+            " min: {$min: '$x'}, max: {$max: '$x'}, ints: {$sum: {$toInt: '$k'}}}}");
+        auto group = DocumentSourceGroup::createFromBson(spec.firstElement(), expCtx);
+        auto mock = DocumentSourceMock::createForTest(inputs);
+        group->setSource(mock.get());
+
+        std::map<int, Document> results;
+        for (auto next = group->getNext(); next.isAdvanced(); next = group->getNext()) {
+            auto doc = next.releaseDocument();
+            results[doc["_id"].coerceToInt()] = doc;
+        }
+        return results;
+    };
+
+    const auto expected = runGroup(0);
+    ASSERT_EQ(expected.size(), 7U);
+    for (int batchSize : {1, 3, 64, 1000, 4096}) {
+        const auto actual = runGroup(batchSize);
+        ASSERT_EQ(actual.size(), expected.size());
+        for (auto&& [key, doc] : expected) {
+            ASSERT_DOCUMENT_EQ(actual.at(key), doc);
+        }
+    }
+}
+
 TEST_F(DocumentSourceGroupTest, ShouldReportSingleFieldGroupKeyAsARename) {
     auto expCtx = getExpCtx();
     VariablesParseState vps = expCtx->variablesParseState;
@@ -31,7 +31,14 @@
 
 #include "mongo/db/pipeline/document_source_lookup_change_post_image.h"
 
+#include <algorithm>
+
 #include "mongo/bson/simple_bsonelement_comparator.h"
+#include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/db/query/find_common.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/service_context.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -49,22 +56,224 @@ Value assertFieldHasType(const Document& fullDoc, StringData fieldName, BSONType
             val.getType() == expectedType);
     return val;
 }
+
+bool isUpdateOp(const Document& event) {
+    auto opTypeVal = assertFieldHasType(
+        event, DocumentSourceChangeStream::kOperationTypeField, BSONType::String);
+    return opTypeVal.getString() == DocumentSourceChangeStream::kUpdateOpType;
+}
+
+/**
+ * The update events of a batch whose post-images are looked up together.
+ */
+struct LookupGroup {
+    NamespaceString nss;
+    UUID collectionUUID;
+    Timestamp maxClusterTime;
+    std::vector<size_t> eventIndexes;
+};
 }  // namespace
 
 DocumentSource::GetNextResult DocumentSourceLookupChangePostImage::doGetNext() {
-    auto input = pSource->getNext();
-    if (!input.isAdvanced()) {
-        return input;
+    if (_batch.empty() && !_batchEnd) {
+        const auto batchSize = internalChangeStreamUpdateLookupBatchSize.load();
+        if (batchSize > 1) {
+            fillBatch(batchSize);
+        } else {
+            auto input = pSource->getNext();
+            if (!input.isAdvanced() || !isUpdateOp(input.getDocument())) {
+                return input;
+            }
+
+            MutableDocument output(input.releaseDocument());
+            output[kFullDocumentFieldName] = lookupPostImage(output.peek());
+            return output.freeze();
+        }
     }
-    auto opTypeVal = assertFieldHasType(
-        input.getDocument(), DocumentSourceChangeStream::kOperationTypeField, BSONType::String);
-    if (opTypeVal.getString() != DocumentSourceChangeStream::kUpdateOpType) {
-        return input;
+
+    if (!_batch.empty()) {
+        auto next = std::move(_batch.front());
+        _batch.pop_front();
+        return std::move(next);
+    }
+    auto batchEnd = std::move(*_batchEnd);
+    _batchEnd = boost::none;
+    return batchEnd;
+}
+
+void DocumentSourceLookupChangePostImage::fillBatch(size_t batchSize) {
+    auto opCtx = pExpCtx->opCtx;
+    auto clock = opCtx->getServiceContext()->getPreciseClockSource();
+
+    // Once the batch has its first event, wait for new events only until the batch is due to be
+    // looked up, rather than until the end of the getMore.
+    auto& awaitData = awaitDataState(opCtx);
+    const auto originalDeadline = awaitData.waitForInsertsDeadline;
+    ON_BLOCK_EXIT([&] { awaitData.waitForInsertsDeadline = originalDeadline; });
+    Date_t batchDeadline;
+
+    std::vector<Document> events;
+    while (events.size() < batchSize) {
+        auto input = pSource->getNext();
+        if (!input.isAdvanced()) {
+            _batchEnd = std::move(input);
+            break;
+        }
+        if (events.empty()) {
+            batchDeadline =
+                clock->now() + Milliseconds(internalChangeStreamUpdateLookupBatchMaxWaitMS.load());
+            awaitData.waitForInsertsDeadline = std::min(originalDeadline, batchDeadline);
+        }
+        events.emplace_back(input.releaseDocument());
+        if (clock->now() >= batchDeadline) {
+            break;
+        }
+    }
+
+    // Group the update events by collection, since a whole-db or whole-cluster stream may see
+    // updates on several.
+    std::vector<LookupGroup> groups;
+    for (size_t i = 0; i < events.size(); ++i) {
+        const auto& event = events[i];
+        if (!isUpdateOp(event)) {
+            continue;
+        }
+        auto nss = assertValidNamespace(event);
+        assertFieldHasType(event, DocumentSourceChangeStream::kDocumentKeyField, BSONType::Object);
+        auto resumeToken =
+            ResumeToken::parse(event[DocumentSourceChangeStream::kIdField].getDocument());
+        const auto& tokenData = resumeToken.getData();
+        invariant(tokenData.uuid);
+
+        auto group = std::find_if(groups.begin(), groups.end(), [&](const LookupGroup& group) {
+            return group.nss == nss && group.collectionUUID == *tokenData.uuid;
+        });
+        if (group == groups.end()) {
+            group = groups.insert(groups.end(), {std::move(nss), *tokenData.uuid, {}, {}});
+        }
+        group->maxClusterTime = std::max(group->maxClusterTime, tokenData.clusterTime);
+        group->eventIndexes.push_back(i);
+    }
+
+    for (auto&& group : groups) {
+        auto postImages = lookupPostImages(
+            events, group.eventIndexes, group.nss, group.collectionUUID, group.maxClusterTime);
+        for (size_t i = 0; i < group.eventIndexes.size(); ++i) {
+            auto& event = events[group.eventIndexes[i]];
+            MutableDocument output(std::move(event));
+            output[kFullDocumentFieldName] = std::move(postImages[i]);
+            event = output.freeze();
+        }
+    }
+
+    _batch.insert(_batch.end(),
+                  std::make_move_iterator(events.begin()),
+                  std::make_move_iterator(events.end()));
+}
+
+std::vector<Value> DocumentSourceLookupChangePostImage::lookupPostImages(
+    const std::vector<Document>& events,
+    const std::vector<size_t>& eventIndexes,
+    const NamespaceString& nss,
+    UUID collectionUUID,
+    Timestamp maxClusterTime) const {
+    // Build one filter which selects the documents of every distinct document key. Several events
+    // in the batch may share a document key, in which case they share its current version, just as
+    // they would if each were looked up separately.
+    auto keyPositions =
+        SimpleBSONObjComparator::kInstance.makeBSONObjIndexedUnorderedMap<std::vector<size_t>>();
+    std::vector<BSONObj> distinctKeys;
+    bool idOnlyKeys = true;
+    for (size_t i = 0; i < eventIndexes.size(); ++i) {
+        const auto& event = events[eventIndexes[i]];
+        auto documentKey =
+            event[DocumentSourceChangeStream::kDocumentKeyField].getDocument().toBson();
+        auto& positions = keyPositions[documentKey];
+        if (positions.empty()) {
+            idOnlyKeys = idOnlyKeys && documentKey.nFields() == 1 && documentKey.hasField("_id");
+            distinctKeys.push_back(documentKey);
+        }
+        positions.push_back(i);
     }
 
-    MutableDocument output(input.releaseDocument());
-    output[kFullDocumentFieldName] = lookupPostImage(output.peek());
-    return output.freeze();
+    BSONObjBuilder filter;
+    if (idOnlyKeys) {
+        BSONObjBuilder idFilter(filter.subobjStart("_id"));
+        BSONArrayBuilder ids(idFilter.subarrayStart("$in"));
+        for (auto&& key : distinctKeys) {
+            ids.append(key.firstElement());
+        }
+    } else {
+        BSONArrayBuilder keys(filter.subarrayStart("$or"));
+        for (auto&& key : distinctKeys) {
+            keys.append(key);
+        }
+    }
+
+    // The post-images may be read at any time after the latest of the updates.
+    const auto readConcern = pExpCtx->inMongos
+        ? boost::optional<BSONObj>(BSON("level"
+                                        << "majority"
+                                        << "afterClusterTime" << maxClusterTime))
+        : boost::none;
+    const auto allowSpeculativeMajorityRead = pExpCtx->inMongos;
+    auto lookedUpDocs = pExpCtx->mongoProcessInterface->lookupDocuments(
+        pExpCtx, nss, collectionUUID, filter.obj(), readConcern, allowSpeculativeMajorityRead);
+
+    std::vector<Value> postImages(eventIndexes.size(), Value(BSONNULL));
+    if (!lookedUpDocs) {
+        // The documents could not be fetched together, so look them up one at a time.
+        for (size_t i = 0; i < eventIndexes.size(); ++i) {
+            postImages[i] = lookupPostImage(events[eventIndexes[i]]);
+        }
+        return postImages;
+    }
+
+    // Match each document to the document keys it has. The keys of a collection usually all have
+    // the same fields, so try each distinct set of fields once.
+    std::vector<std::vector<std::string>> keyFieldSets;
+    for (auto&& key : distinctKeys) {
+        std::vector<std::string> fields;
+        for (auto&& elem : key) {
+            fields.push_back(elem.fieldName());
+        }
+        if (std::find(keyFieldSets.begin(), keyFieldSets.end(), fields) == keyFieldSets.end()) {
+            keyFieldSets.push_back(std::move(fields));
+        }
+    }
+
+    auto matchedKeys = SimpleBSONObjComparator::kInstance.makeBSONObjIndexedUnorderedMap<Value>();
+    for (auto&& doc : *lookedUpDocs) {
+        for (auto&& fields : keyFieldSets) {
+            BSONObjBuilder keyBuilder;
+            for (auto&& field : fields) {
+                auto value = doc.getNestedField(FieldPath(field));
+                if (value.nullish()) {
+                    keyBuilder.appendNull(field);
+                } else {
+                    value.addToBsonObj(&keyBuilder, field);
+                }
+            }
+            auto key = keyBuilder.obj();
+
+            auto positions = keyPositions.find(key);
+            if (positions == keyPositions.end()) {
+                continue;
+            }
+            auto inserted = matchedKeys.emplace(key, Value(doc));
+            if (!inserted.second) {
+                uasserted(ErrorCodes::ChangeStreamFatalError,
+                          str::stream() << "found more than one document with document key "
+                                        << key.toString() << " ["
+                                        << inserted.first->second.toString() << ", "
+                                        << doc.toString() << "]");
+            }
+            for (auto position : positions->second) {
+                postImages[position] = Value(doc);
+            }
+        }
+    }
+    return postImages;
 }
 
 NamespaceString DocumentSourceLookupChangePostImage::assertValidNamespace(
@@ -29,6 +29,9 @@
 
 #pragma once
 
+#include <deque>
+#include <vector>
+
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_change_stream.h"
 
@@ -37,6 +40,11 @@ namespace mongo {
 /**
  * Part of the change stream API machinery used to look up the post-image of a document. Uses the
  * "documentKey" field of the input to look up the new version of the document.
+ *
+ * If 'internalChangeStreamUpdateLookupBatchSize' is greater than 1, the stage gathers a batch of
+ * events from its source and looks up the post-images of all the update events among them with one
+ * query per collection, which on mongos is sent once to each targeted shard. The events are
+ * returned in their original order.
  */
 class DocumentSourceLookupChangePostImage final : public DocumentSource {
 public:
@@ -105,6 +113,14 @@ public:
         return kStageName.rawData();
     }
 
+    /**
+     * Returns true if this stage holds events which it has read from its source but not returned
+     * yet.
+     */
+    bool hasBufferedEvents() const {
+        return !_batch.empty();
+    }
+
 private:
     DocumentSourceLookupChangePostImage(const boost::intrusive_ptr<ExpressionContext>& expCtx)
         : DocumentSource(kStageName, expCtx) {}
@@ -114,6 +130,24 @@ private:
      */
     GetNextResult doGetNext() final;
 
+    /**
+     * Pulls up to 'batchSize' events from the source into '_batch', stopping early if the source
+     * pauses or is exhausted or if 'internalChangeStreamUpdateLookupBatchMaxWaitMS' passes, and
+     * then fills in the post-images of the update events among them.
+     */
+    void fillBatch(size_t batchSize);
+
+    /**
+     * Looks up the post-images of the update events at 'eventIndexes' in 'events', which must all
+     * be on the collection 'nss' with UUID 'collectionUUID', with a single query. Returns the
+     * post-images in the same order as 'eventIndexes'.
+     */
+    std::vector<Value> lookupPostImages(const std::vector<Document>& events,
+                                        const std::vector<size_t>& eventIndexes,
+                                        const NamespaceString& nss,
+                                        UUID collectionUUID,
+                                        Timestamp maxClusterTime) const;
+
     /**
      * Uses the "documentKey" field from 'updateOp' to look up the current version of the document.
      * Returns Value(BSONNULL) if the document couldn't be found.
@@ -126,6 +160,12 @@ private:
      * function verifies that the only the database names match.
      */
     NamespaceString assertValidNamespace(const Document& inputDoc) const;
+
+    // Events whose post-images have been looked up, waiting to be returned.
+    std::deque<Document> _batch;
+
+    // The pause or EOF which ended the current batch, returned once '_batch' is empty.
+    boost::optional<GetNextResult> _batchEnd;
 };
 
 }  // namespace mongo
@@ -45,6 +45,8 @@
 #include "mongo/db/pipeline/document_source_mock.h"
 #include "mongo/db/pipeline/field_path.h"
 #include "mongo/db/pipeline/process_interface/stub_lookup_single_document_process_interface.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -76,6 +78,33 @@ public:
         return ResumeToken(ResumeTokenData(ts, 0, 0, testUuid(), Value(Document{{"_id", id}})))
             .toDocument();
     }
+
+    Document makeUpdateEvent(int tokenId, Document documentKey) {
+        return Document{{"_id", makeResumeToken(tokenId)},
+                        {"documentKey", std::move(documentKey)},
+                        {"operationType", "update"_sd},
+                        {"ns",
+                         Document{{"db", getExpCtx()->ns.db()}, {"coll", getExpCtx()->ns.coll()}}}};
+    }
+
+    Document withFullDocument(Document event, Value fullDocument) {
+        MutableDocument output(std::move(event));
+        output["fullDocument"] = std::move(fullDocument);
+        return output.freeze();
+    }
+};
+
+/**
+ * Enables batched post-image lookups with the given batch size for the lifetime of the object.
+ */
+class BatchedLookupsEnabled {
+public:
+    explicit BatchedLookupsEnabled(int batchSize) {
+        internalChangeStreamUpdateLookupBatchSize.store(batchSize);
+    }
+    ~BatchedLookupsEnabled() {
+        internalChangeStreamUpdateLookupBatchSize.store(1);
+    }
 };
 
 TEST_F(DocumentSourceLookupChangePostImageTest, ShouldErrorIfMissingDocumentKeyOnUpdate) {
@@ -324,5 +353,134 @@ TEST_F(DocumentSourceLookupChangePostImageTest, ShouldPropagatePauses) {
     ASSERT_TRUE(lookupChangeStage->getNext().isEOF());
 }
 
+TEST_F(DocumentSourceLookupChangePostImageTest, ShouldLookUpBatchOfPostImagesTogetherInOrder) {
+    BatchedLookupsEnabled batching(10);
+    auto expCtx = getExpCtx();
+    auto lookupChangeStage = DocumentSourceLookupChangePostImage::create(expCtx);
+
+    auto insertEvent =
+        Document{{"_id", makeResumeToken(5)},
+                 {"documentKey", Document{{"_id", 5}}},
+                 {"operationType", "insert"_sd},
+                 {"ns", Document{{"db", expCtx->ns.db()}, {"coll", expCtx->ns.coll()}}},
+                 {"fullDocument", Document{{"_id", 5}}}};
+    auto mockLocalSource =
+        DocumentSourceMock::createForTest(deque<DocumentSource::GetNextResult>{
+            makeUpdateEvent(0, Document{{"_id", 0}}),
+            Document(insertEvent),
+            makeUpdateEvent(1, Document{{"_id", 1}}),
+            makeUpdateEvent(2, Document{{"_id", 0}}),
+            makeUpdateEvent(3, Document{{"_id", 3}})});
+    lookupChangeStage->setSource(mockLocalSource.get());
+
+    // The document with _id 3 has since been deleted.
+    deque<DocumentSource::GetNextResult> mockForeignContents{
+        Document{{"_id", 0}, {"x", 1}}, Document{{"_id", 1}, {"x", 2}}, Document{{"_id", 4}}};
+    auto mockInterface = std::make_unique<MockMongoInterface>(std::move(mockForeignContents));
+    auto mockInterfacePtr = mockInterface.get();
+    expCtx->mongoProcessInterface = std::move(mockInterface);
+
+    const std::vector<Document> expected{
+        withFullDocument(makeUpdateEvent(0, Document{{"_id", 0}}),
+                         Value(Document{{"_id", 0}, {"x", 1}})),
+        insertEvent,
+        withFullDocument(makeUpdateEvent(1, Document{{"_id", 1}}),
+                         Value(Document{{"_id", 1}, {"x", 2}})),
+        withFullDocument(makeUpdateEvent(2, Document{{"_id", 0}}),
+                         Value(Document{{"_id", 0}, {"x", 1}})),
+        withFullDocument(makeUpdateEvent(3, Document{{"_id", 3}}), Value(BSONNULL))};
+    for (auto&& expectedEvent : expected) {
+        auto next = lookupChangeStage->getNext();
+        ASSERT_TRUE(next.isAdvanced());
+        ASSERT_DOCUMENT_EQ(next.releaseDocument(), expectedEvent);
+    }
+    ASSERT_TRUE(lookupChangeStage->getNext().isEOF());
+    ASSERT_EQ(mockInterfacePtr->getNumLookupDocumentsCalls(), 1);
+}
+
+TEST_F(DocumentSourceLookupChangePostImageTest, ShouldMatchCompoundDocumentKeysWhenBatching) {
+    BatchedLookupsEnabled batching(10);
+    auto expCtx = getExpCtx();
+    auto lookupChangeStage = DocumentSourceLookupChangePostImage::create(expCtx);
+
+    auto mockLocalSource =
+        DocumentSourceMock::createForTest(deque<DocumentSource::GetNextResult>{
+            makeUpdateEvent(0, Document{{"shardKey", 1}, {"_id", 0}}),
+            makeUpdateEvent(1, Document{{"shardKey", 2}, {"_id", 1}}),
+            makeUpdateEvent(2, Document{{"shardKey", 3}, {"_id", 0}})});
+    lookupChangeStage->setSource(mockLocalSource.get());
+
+    deque<DocumentSource::GetNextResult> mockForeignContents{
+        Document{{"_id", 0}, {"shardKey", 1}}, Document{{"_id", 1}, {"shardKey", 2}}};
+    expCtx->mongoProcessInterface =
+        std::make_unique<MockMongoInterface>(std::move(mockForeignContents));
+
+    auto next = lookupChangeStage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_VALUE_EQ(next.getDocument()["fullDocument"],
+                    Value(Document{{"_id", 0}, {"shardKey", 1}}));
+    next = lookupChangeStage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_VALUE_EQ(next.getDocument()["fullDocument"],
+                    Value(Document{{"_id", 1}, {"shardKey", 2}}));
+
+    // The document with this _id has a different shard key, so is not the one this event changed.
+    next = lookupChangeStage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_VALUE_EQ(next.getDocument()["fullDocument"], Value(BSONNULL));
+}
+
+TEST_F(DocumentSourceLookupChangePostImageTest, ShouldEndBatchAtPauseOrBatchSize) {
+    BatchedLookupsEnabled batching(2);
+    auto expCtx = getExpCtx();
+    auto lookupChangeStage = DocumentSourceLookupChangePostImage::create(expCtx);
+
+    auto mockLocalSource =
+        DocumentSourceMock::createForTest(deque<DocumentSource::GetNextResult>{
+            makeUpdateEvent(0, Document{{"_id", 0}}),
+            DocumentSource::GetNextResult::makePauseExecution(),
+            makeUpdateEvent(1, Document{{"_id", 1}}),
+            makeUpdateEvent(2, Document{{"_id", 2}}),
+            makeUpdateEvent(3, Document{{"_id", 3}})});
+    lookupChangeStage->setSource(mockLocalSource.get());
+
+    deque<DocumentSource::GetNextResult> mockForeignContents{
+        Document{{"_id", 0}}, Document{{"_id", 1}}, Document{{"_id", 2}}, Document{{"_id", 3}}};
+    auto mockInterface = std::make_unique<MockMongoInterface>(std::move(mockForeignContents));
+    auto mockInterfacePtr = mockInterface.get();
+    expCtx->mongoProcessInterface = std::move(mockInterface);
+
+    ASSERT_TRUE(lookupChangeStage->getNext().isAdvanced());
+    ASSERT_EQ(mockInterfacePtr->getNumLookupDocumentsCalls(), 1);
+    ASSERT_TRUE(lookupChangeStage->getNext().isPaused());
+
+    for (int id = 1; id <= 3; ++id) {
+        auto next = lookupChangeStage->getNext();
+        ASSERT_TRUE(next.isAdvanced());
+        ASSERT_VALUE_EQ(next.getDocument()["fullDocument"], Value(Document{{"_id", id}}));
+    }
+    ASSERT_EQ(mockInterfacePtr->getNumLookupDocumentsCalls(), 3);
+    ASSERT_TRUE(lookupChangeStage->getNext().isEOF());
+}
+
+TEST_F(DocumentSourceLookupChangePostImageTest, ShouldErrorIfDocumentKeyIsNotUniqueWhenBatching) {
+    BatchedLookupsEnabled batching(10);
+    auto expCtx = getExpCtx();
+    auto lookupChangeStage = DocumentSourceLookupChangePostImage::create(expCtx);
+
+    auto mockLocalSource =
+        DocumentSourceMock::createForTest(deque<DocumentSource::GetNextResult>{
+            makeUpdateEvent(0, Document{{"_id", 0}}), makeUpdateEvent(1, Document{{"_id", 1}})});
+    lookupChangeStage->setSource(mockLocalSource.get());
+
+    deque<DocumentSource::GetNextResult> foreignCollection = {Document{{"_id", 0}},
+                                                              Document{{"_id", 0}}};
+    expCtx->mongoProcessInterface =
+        std::make_unique<MockMongoInterface>(std::move(foreignCollection));
+
+    ASSERT_THROWS_CODE(
+        lookupChangeStage->getNext(), AssertionException, ErrorCodes::ChangeStreamFatalError);
+}
+
 }  // namespace
 }  // namespace mongo
@@ -43,6 +43,7 @@
 #include "mongo/db/pipeline/document_path_support.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/util/str.h"
 
 namespace mongo {
@@ -84,6 +85,13 @@ DocumentSource::GetNextResult DocumentSourceMatch::doGetNext() {
     // The user facing error should have been generated earlier.
     massert(17309, "Should never call getNext on a $match stage with $text clause", !_isTextQuery);
 
+    if (_compiledFor != _expression.get()) {
+        _compiledFor = _expression.get();
+        _compiledFilter = internalQueryCompileMatchFilters.load()
+            ? CompiledFilter::compile(_expression.get())
+            : nullptr;
+    }
+
     auto nextInput = pSource->getNext();
     for (; nextInput.isAdvanced(); nextInput = pSource->getNext()) {
         // MatchExpression only takes BSON documents, so we have to make one. As an optimization,
@@ -93,7 +101,8 @@ DocumentSource::GetNextResult DocumentSourceMatch::doGetNext() {
             : document_path_support::documentToBsonWithPaths(nextInput.getDocument(),
                                                              _dependencies.fields);
 
-        if (_expression->matchesBSON(toMatch)) {
+        if (_compiledFilter ? _compiledFilter->matches(toMatch)
+                            : _expression->matchesBSON(toMatch)) {
             return nextInput;
         }
 
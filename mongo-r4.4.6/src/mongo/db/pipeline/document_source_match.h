@@ -192,6 +192,12 @@ protected:
 private:
     std::unique_ptr<MatchExpression> _expression;
 
+    // Compiled form of '_expression', built on the first call to doGetNext() once the expression
+    // has been optimized. '_compiledFor' records which expression it was built from, so that a
+    // replaced expression is recompiled; '_compiledFilter' is null if nothing was compilable.
+    std::unique_ptr<CompiledFilter> _compiledFilter;
+    const MatchExpression* _compiledFor = nullptr;
+
     bool _isTextQuery;
 
     // Cache the dependencies so that we know what fields we need to serialize to BSON for matching.
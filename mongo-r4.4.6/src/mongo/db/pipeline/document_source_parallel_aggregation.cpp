@@ -0,0 +1,375 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/document_source_parallel_aggregation.h"
+
+#include "mongo/db/client.h"
+#include "mongo/db/pipeline/document_source_group.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+
+namespace {
+
+// The number of worker threads in use by all parallel aggregations on this server. Bounded by
+// 'internalQueryParallelAggregationMaxWorkers'.
+AtomicWord<int> workersInUse{0};
+
+/**
+ * Reserves up to 'wanted' worker threads from the server-wide budget without blocking and returns
+ * the number actually reserved, which may be zero.
+ */
+size_t acquireWorkers(size_t wanted) {
+    auto inUse = workersInUse.load();
+    for (;;) {
+        auto available = internalQueryParallelAggregationMaxWorkers.load() - inUse;
+        auto granted = std::min(static_cast<int>(wanted), std::max(available, 0));
+        if (granted == 0) {
+            return 0;
+        }
+        if (workersInUse.compareAndSwap(&inUse, inUse + granted)) {
+            return granted;
+        }
+    }
+}
+
+void releaseWorkers(size_t count) {
+    workersInUse.subtractAndFetch(static_cast<int>(count));
+}
+
+/**
+ * Returns the pool shared by all parallel aggregations on the server. It has one thread for each
+ * worker of the server-wide budget, so a reserved worker never waits for a thread. The pool is
+ * intentionally leaked, as its threads may still be returning to it at shutdown.
+ */
+ThreadPool& getWorkerPool() {
+    static ThreadPool* const pool = [] {
+        ThreadPool::Options options;
+        options.poolName = "ParallelAggregationWorkers";
+        options.threadNamePrefix = "ParallelAggregationWorker-";
+        options.minThreads = 0;
+        options.maxThreads =
+            static_cast<size_t>(std::max(internalQueryParallelAggregationMaxWorkers.load(), 1));
+        options.onCreateThread = [](const std::string& threadName) {
+            Client::initThread(threadName.c_str());
+        };
+        auto pool = new ThreadPool(options);
+        pool->startup();
+        return pool;
+    }();
+    return *pool;
+}
+
+/**
+ * The outcome of running one copy of the partial pipeline.
+ */
+struct ConsumerState {
+    std::vector<Document> results;
+    Status status = Status::OK();
+    bool usedDisk = false;
+
+    // The OperationContext of a worker while it is executing, so that the thread running the
+    // command can interrupt it. Guarded by the mutex of the enclosing run.
+    OperationContext* opCtx = nullptr;
+};
+
+/**
+ * Drains 'pipeline' into 'state' and disposes of it, which releases its Exchange consumer so that
+ * the remaining consumers can make progress even if this one failed. The results of all consumers
+ * count towards the $group memory limit through 'bufferedBytes', since they are all held in memory
+ * until the merging half of the pipeline consumes them.
+ */
+void runPartialPipeline(OperationContext* opCtx,
+                        std::unique_ptr<Pipeline, PipelineDeleter> pipeline,
+                        AtomicWord<long long>* bufferedBytes,
+                        ConsumerState* state) {
+    try {
+        pipeline->reattachToOperationContext(opCtx);
+        while (auto next = pipeline->getNext()) {
+            uassert(ErrorCodes::QueryExceededMemoryLimitNoDiskUseAllowed,
+                    "Exceeded memory limit for $group, but didn't allow external sort."
+                    " Pass allowDiskUse:true to opt in.",
+                    bufferedBytes->addAndFetch(next->getApproximateSize()) <=
+                        internalDocumentSourceGroupMaxMemoryBytes.load());
+            state->results.push_back(std::move(*next));
+        }
+    } catch (const DBException& ex) {
+        state->status = ex.toStatus();
+    }
+
+    for (auto&& source : pipeline->getSources()) {
+        state->usedDisk = state->usedDisk || source->usedDisk();
+    }
+    pipeline->dispose(opCtx);
+    pipeline.get_deleter().dismissDisposal();
+}
+
+}  // namespace
+
+boost::intrusive_ptr<DocumentSourceParallelAggregation> DocumentSourceParallelAggregation::create(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    std::unique_ptr<Pipeline, PipelineDeleter> inputPipeline,
+    std::vector<BSONObj> partialPipeline,
+    size_t degree) {
+    return new DocumentSourceParallelAggregation(
+        expCtx, std::move(inputPipeline), std::move(partialPipeline), degree);
+}
+
+DocumentSourceParallelAggregation::DocumentSourceParallelAggregation(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    std::unique_ptr<Pipeline, PipelineDeleter> inputPipeline,
+    std::vector<BSONObj> partialPipeline,
+    size_t degree)
+    : DocumentSource(kStageName, expCtx),
+      _inputPipeline(std::move(inputPipeline)),
+      _partialPipeline(std::move(partialPipeline)),
+      _degree(std::max(degree, size_t{1})) {
+    invariant(_inputPipeline && !_inputPipeline->getSources().empty());
+    _inputSource = _inputPipeline->getSources().front();
+}
+
+int DocumentSourceParallelAggregation::getWorkersInUse() {
+    return workersInUse.load();
+}
+
+const char* DocumentSourceParallelAggregation::getSourceName() const {
+    return kStageName.rawData();
+}
+
+Value DocumentSourceParallelAggregation::serialize(
+    boost::optional<ExplainOptions::Verbosity> explain) const {
+    std::vector<Value> partialPipeline;
+    for (auto&& stage : _partialPipeline) {
+        partialPipeline.emplace_back(stage);
+    }
+
+    MutableDocument spec;
+    spec["degree"] = Value(static_cast<long long>(_degree));
+    if (explain && _numConsumers) {
+        spec["consumers"] = Value(static_cast<long long>(_numConsumers));
+    }
+    spec["pipeline"] = Value(std::move(partialPipeline));
+    return Value(DOC(getSourceName() << spec.freeze()));
+}
+
+void DocumentSourceParallelAggregation::detachFromOperationContext() {
+    if (_inputPipeline) {
+        _inputPipeline->detachFromOperationContext();
+    }
+}
+
+void DocumentSourceParallelAggregation::reattachToOperationContext(OperationContext* opCtx) {
+    if (_inputPipeline) {
+        _inputPipeline->reattachToOperationContext(opCtx);
+    }
+}
+
+void DocumentSourceParallelAggregation::doDispose() {
+    // Once executed, the input pipeline belongs to the Exchange, which disposes of it along with
+    // its last consumer.
+    if (_inputPipeline) {
+        _inputPipeline->dispose(pExpCtx->opCtx);
+        _inputPipeline.get_deleter().dismissDisposal();
+        _inputPipeline.reset();
+    }
+    _results.clear();
+}
+
+DocumentSource::GetNextResult DocumentSourceParallelAggregation::doGetNext() {
+    if (_inputPipeline) {
+        runPartialPipelines();
+    }
+
+    if (_results.empty()) {
+        return GetNextResult::makeEOF();
+    }
+
+    auto next = std::move(_results.front());
+    _results.pop_front();
+    return std::move(next);
+}
+
+void DocumentSourceParallelAggregation::runPartialPipelines() {
+    auto opCtx = pExpCtx->opCtx;
+    auto serviceContext = opCtx->getServiceContext();
+
+    const auto numWorkers = acquireWorkers(_degree - 1);
+    ON_BLOCK_EXIT([&] { releaseWorkers(numWorkers); });
+    _numConsumers = numWorkers + 1;
+
+    // Every consumer gets its own ExpressionContext, since nothing above the Exchange may be shared
+    // between threads. Each one produces partial results for the merging half of the pipeline, and
+    // the partial $group stages share the memory a single $group would have been allowed.
+    const auto maxGroupMemoryBytes =
+        static_cast<size_t>(internalDocumentSourceGroupMaxMemoryBytes.load());
+    std::vector<std::unique_ptr<Pipeline, PipelineDeleter>> pipelines;
+    std::vector<boost::intrusive_ptr<ExpressionContext>> consumerExpCtxs;
+    for (size_t i = 0; i < _numConsumers; ++i) {
+        auto expCtx = pExpCtx->copyWith(pExpCtx->ns, pExpCtx->uuid);
+        expCtx->needsMerge = true;
+        consumerExpCtxs.push_back(expCtx);
+        pipelines.push_back(Pipeline::parse(_partialPipeline, expCtx));
+        for (auto&& source : pipelines.back()->getSources()) {
+            if (auto group = dynamic_cast<DocumentSourceGroup*>(source.get())) {
+                group->setMaxMemoryUsageBytes(std::max(maxGroupMemoryBytes / _numConsumers,
+                                                       size_t{1}));
+            }
+        }
+    }
+
+    ExchangeSpec spec;
+    spec.setPolicy(ExchangePolicyEnum::kRoundRobin);
+    spec.setConsumers(_numConsumers);
+    _exchange = new Exchange(std::move(spec), std::move(_inputPipeline));
+
+    for (size_t i = 0; i < _numConsumers; ++i) {
+        pipelines[i]->addInitialSource(
+            new DocumentSourceExchange(consumerExpCtxs[i], _exchange, i, nullptr));
+        pipelines[i]->detachFromOperationContext();
+    }
+
+    // The input pipeline shares this stage's ExpressionContext, which the Exchange points at
+    // whichever thread happens to be loading. Nothing else reads it until all threads are done.
+    ON_BLOCK_EXIT([&] { pExpCtx->opCtx = opCtx; });
+
+    // The worker tasks share ownership of the state they signal on completion, since the last one
+    // to finish may still be releasing the mutex after this thread has stopped waiting.
+    struct WorkerSync {
+        Mutex mutex = MONGO_MAKE_LATCH("DocumentSourceParallelAggregation::WorkerSync::mutex");
+        stdx::condition_variable workersDone;
+        size_t numRunning = 0;
+        boost::optional<ErrorCodes::Error> killCode;
+    };
+    auto sync = std::make_shared<WorkerSync>();
+    std::vector<ConsumerState> states(_numConsumers);
+    AtomicWord<long long> bufferedBytes{0};
+
+    auto killWorkers = [&](ErrorCodes::Error code) {
+        stdx::lock_guard<Latch> lk(sync->mutex);
+        sync->killCode = code;
+        for (auto&& state : states) {
+            if (state.opCtx) {
+                stdx::lock_guard<Client> clientLock(*state.opCtx->getClient());
+                serviceContext->killOperation(clientLock, state.opCtx, code);
+            }
+        }
+    };
+
+    for (size_t i = 1; i < _numConsumers; ++i) {
+        auto state = &states[i];
+        {
+            stdx::lock_guard<Latch> lk(sync->mutex);
+            ++sync->numRunning;
+        }
+        getWorkerPool().schedule([&, i, state, sync](Status status) {
+            if (!status.isOK()) {
+                // The task could not be run. Its consumer still has to be released so that the
+                // Exchange does not wait on it forever, and since the documents routed to a
+                // released consumer are dropped the aggregation has to fail.
+                state->status = status.withContext("Failed to run a parallel aggregation worker");
+                pipelines[i]->dispose(opCtx);
+                pipelines[i].get_deleter().dismissDisposal();
+            } else {
+                auto workerOpCtx = cc().makeOperationContext();
+                {
+                    stdx::lock_guard<Latch> lk(sync->mutex);
+                    if (opCtx->getDeadline() != Date_t::max()) {
+                        workerOpCtx->setDeadlineByDate(opCtx->getDeadline(),
+                                                       opCtx->getTimeoutError());
+                    }
+                    if (sync->killCode) {
+                        stdx::lock_guard<Client> clientLock(cc());
+                        serviceContext->killOperation(
+                            clientLock, workerOpCtx.get(), *sync->killCode);
+                    }
+                    state->opCtx = workerOpCtx.get();
+                }
+
+                runPartialPipeline(
+                    workerOpCtx.get(), std::move(pipelines[i]), &bufferedBytes, state);
+            }
+
+            stdx::lock_guard<Latch> lk(sync->mutex);
+            state->opCtx = nullptr;
+            if (--sync->numRunning == 0) {
+                sync->workersDone.notify_all();
+            }
+        });
+    }
+
+    runPartialPipeline(opCtx, std::move(pipelines[0]), &bufferedBytes, &states[0]);
+    if (!states[0].status.isOK()) {
+        killWorkers(states[0].status.code());
+    }
+
+    // Do not hold up an interrupted operation until the workers finish on their own, but do not
+    // return before they have stopped using this run's state either.
+    try {
+        stdx::unique_lock<Latch> lk(sync->mutex);
+        opCtx->waitForConditionOrInterrupt(
+            sync->workersDone, lk, [&] { return sync->numRunning == 0; });
+    } catch (const DBException& ex) {
+        killWorkers(ex.code());
+        if (states[0].status.isOK()) {
+            states[0].status = ex.toStatus();
+        }
+        stdx::unique_lock<Latch> lk(sync->mutex);
+        sync->workersDone.wait(lk, [&] { return sync->numRunning == 0; });
+    }
+
+    // Report the error which caused the others, rather than the failures it induced in the
+    // remaining consumers of the Exchange.
+    auto isInduced = [&](const Status& status) {
+        return status.code() == ErrorCodes::ExchangePassthrough ||
+            (sync->killCode && status.code() == *sync->killCode);
+    };
+    boost::optional<Status> error;
+    for (auto&& state : states) {
+        if (!state.status.isOK() && (!error || (isInduced(*error) && !isInduced(state.status)))) {
+            error = state.status;
+        }
+    }
+    if (error) {
+        uassertStatusOK(*error);
+    }
+
+    for (auto&& state : states) {
+        _usedDisk = _usedDisk || state.usedDisk;
+        std::move(state.results.begin(), state.results.end(), std::back_inserter(_results));
+    }
+}
+
+}  // namespace mongo
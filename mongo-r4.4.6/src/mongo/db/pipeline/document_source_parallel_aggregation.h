@@ -0,0 +1,155 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <vector>
+
+#include "mongo/db/pipeline/document_source.h"
+#include "mongo/db/pipeline/document_source_exchange.h"
+
+namespace mongo {
+
+/**
+ * A DocumentSource which runs the partial, mergeable half of a split pipeline on several threads of
+ * this node and returns the union of their results. The input pipeline is distributed round robin
+ * among the threads through an Exchange; every thread runs its own copy of 'partialPipeline' (for
+ * example the leading $match/$project/$unwind stages and the shard half of a $group) against its
+ * share of the input, exactly as a shard would in a sharded aggregation. The merging half of the
+ * pipeline is expected to follow this stage.
+ *
+ * The thread executing the pipeline acts as one of the consumers. The remaining ones run in a
+ * thread pool shared by all parallel aggregations on the server, whose workers are reserved without
+ * blocking, so the degree of parallelism actually used may be lower than requested, down to
+ * executing everything on the calling thread. The partial results of all consumers are buffered
+ * until the merging half of the pipeline consumes them, and together with the partial $group
+ * stages they are bounded by the memory limit of a single $group.
+ */
+class DocumentSourceParallelAggregation final : public DocumentSource {
+public:
+    static constexpr StringData kStageName = "$_internalParallelAggregation"_sd;
+
+    static boost::intrusive_ptr<DocumentSourceParallelAggregation> create(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx,
+        std::unique_ptr<Pipeline, PipelineDeleter> inputPipeline,
+        std::vector<BSONObj> partialPipeline,
+        size_t degree);
+
+    /**
+     * Returns the number of worker threads currently in use by parallel aggregations across the
+     * server.
+     */
+    static int getWorkersInUse();
+
+    const char* getSourceName() const final;
+
+    Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
+
+    StageConstraints constraints(Pipeline::SplitState pipeState) const final {
+        StageConstraints constraints(StreamType::kBlocking,
+                                     PositionRequirement::kFirst,
+                                     HostTypeRequirement::kNone,
+                                     DiskUseRequirement::kNoDiskUse,
+                                     FacetRequirement::kNotAllowed,
+                                     TransactionRequirement::kNotAllowed,
+                                     LookupRequirement::kNotAllowed,
+                                     UnionRequirement::kNotAllowed);
+
+        constraints.requiresInputDocSource = false;
+        return constraints;
+    }
+
+    boost::optional<DistributedPlanLogic> distributedPlanLogic() final {
+        return boost::none;
+    }
+
+    /**
+     * This stage reads through its own input pipeline and has no direct source.
+     */
+    void setSource(DocumentSource* source) final {
+        invariant(!source);
+    }
+
+    void detachFromOperationContext() final;
+
+    void reattachToOperationContext(OperationContext* opCtx) final;
+
+    bool usedDisk() final {
+        return _usedDisk;
+    }
+
+    /**
+     * Returns the first stage of the input pipeline, typically the $cursor stage reading the
+     * collection. It remains valid, though disposed, after the input has been exhausted.
+     */
+    DocumentSource* getInputSource() const {
+        return _inputSource.get();
+    }
+
+    /**
+     * Returns the number of threads, including the calling one, among which the input was split.
+     * Zero until the stage has been executed.
+     */
+    size_t getNumConsumers() const {
+        return _numConsumers;
+    }
+
+private:
+    DocumentSourceParallelAggregation(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                      std::unique_ptr<Pipeline, PipelineDeleter> inputPipeline,
+                                      std::vector<BSONObj> partialPipeline,
+                                      size_t degree);
+
+    GetNextResult doGetNext() final;
+
+    void doDispose() final;
+
+    /**
+     * Runs 'partialPipeline' over the whole input on the calling thread and up to 'degree - 1'
+     * worker threads, buffering the results in '_results'. Throws the first error encountered by
+     * any of the threads after all of them have finished.
+     */
+    void runPartialPipelines();
+
+    // The pipeline producing the input. Handed over to '_exchange' on execution.
+    std::unique_ptr<Pipeline, PipelineDeleter> _inputPipeline;
+    boost::intrusive_ptr<DocumentSource> _inputSource;
+
+    const std::vector<BSONObj> _partialPipeline;
+    const size_t _degree;
+
+    boost::intrusive_ptr<Exchange> _exchange;
+    size_t _numConsumers = 0;
+    bool _usedDisk = false;
+
+    std::deque<Document> _results;
+};
+
+}  // namespace mongo
@@ -0,0 +1,187 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <map>
+#include <set>
+
+#include "mongo/db/pipeline/aggregation_context_fixture.h"
+#include "mongo/db/pipeline/document_source_mock.h"
+#include "mongo/db/pipeline/document_source_parallel_aggregation.h"
+#include "mongo/db/pipeline/sharded_agg_helpers.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+class DocumentSourceParallelAggregationTest : public AggregationContextFixture {
+protected:
+    void setUp() override {
+        _oldMaxWorkers = internalQueryParallelAggregationMaxWorkers.load();
+        _oldMaxGroupMemoryBytes = internalDocumentSourceGroupMaxMemoryBytes.load();
+    }
+
+    void tearDown() override {
+        internalQueryParallelAggregationMaxWorkers.store(_oldMaxWorkers);
+        internalDocumentSourceGroupMaxMemoryBytes.store(_oldMaxGroupMemoryBytes);
+    }
+
+    auto makeInputPipeline(int nDocs) {
+        std::deque<DocumentSource::GetNextResult> docs;
+        for (int i = 0; i < nDocs; ++i) {
+            docs.emplace_back(Document{{"_id", i}, {"k", i % 7}, {"d", i == 777 ? 0 : 1}});
+        }
+        return Pipeline::create({new DocumentSourceMock(std::move(docs), getExpCtx())},
+                                getExpCtx());
+    }
+
+    auto makeStage(int nDocs, std::vector<BSONObj> partialPipeline, size_t degree) {
+        return DocumentSourceParallelAggregation::create(
+            getExpCtx(), makeInputPipeline(nDocs), std::move(partialPipeline), degree);
+    }
+
+    std::vector<Document> drain(DocumentSource* stage) {
+        std::vector<Document> results;
+        for (auto next = stage->getNext(); next.isAdvanced(); next = stage->getNext()) {
+            results.push_back(next.releaseDocument());
+        }
+        stage->dispose();
+        return results;
+    }
+
+private:
+    int _oldMaxWorkers;
+    long long _oldMaxGroupMemoryBytes;
+};
+
+TEST_F(DocumentSourceParallelAggregationTest, ReturnsEveryResultOfEveryConsumer) {
+    internalQueryParallelAggregationMaxWorkers.store(8);
+    auto stage = makeStage(1000, {fromjson("{$match: {_id: {$mod: [2, 0]}}}")}, 4);
+
+    auto results = drain(stage.get());
+    ASSERT_EQ(stage->getNumConsumers(), 4U);
+    ASSERT_EQ(DocumentSourceParallelAggregation::getWorkersInUse(), 0);
+
+    std::set<int> ids;
+    for (auto&& doc : results) {
+        ids.insert(doc["_id"].getInt());
+    }
+    ASSERT_EQ(results.size(), 500U);
+    ASSERT_EQ(ids.size(), 500U);
+    for (int id : ids) {
+        ASSERT_EQ(id % 2, 0);
+    }
+}
+
+TEST_F(DocumentSourceParallelAggregationTest, PartialGroupsAddUpToTheSerialResult) {
+    internalQueryParallelAggregationMaxWorkers.store(8);
+    auto stage = makeStage(1000, {fromjson("{$group: {_id: '$k', n: {$sum: 1}}}")}, 3);
+
+    std::map<int, long long> counts;
+    for (auto&& doc : drain(stage.get())) {
+        counts[doc["_id"].getInt()] += doc["n"].coerceToLong();
+    }
+    ASSERT_EQ(stage->getNumConsumers(), 3U);
+    ASSERT_EQ(counts.size(), 7U);
+    for (auto&& [k, n] : counts) {
+        ASSERT_EQ(n, 1000 / 7 + (k < 1000 % 7 ? 1 : 0));
+    }
+}
+
+TEST_F(DocumentSourceParallelAggregationTest, MergedPipelineMatchesTheSerialResult) {
+    internalQueryParallelAggregationMaxWorkers.store(8);
+    auto split = sharded_agg_helpers::splitPipeline(Pipeline::parse(
+        {fromjson("{$match: {_id: {$gte: 10}}}"),
+         fromjson("{$group: {_id: '$k', n: {$sum: 1}, avg: {$avg: '$_id'}, max: {$max: '$_id'}}}")},
+        getExpCtx()));
+    auto stage = makeStage(1000, split.shardsPipeline->serializeToBson(), 4);
+    split.mergePipeline->addInitialSource(stage);
+
+    std::map<int, Document> results;
+    while (auto next = split.mergePipeline->getNext()) {
+        ASSERT_TRUE(results.emplace(next->getField("_id").getInt(), *next).second);
+    }
+    ASSERT_EQ(stage->getNumConsumers(), 4U);
+    ASSERT_EQ(results.size(), 7U);
+
+    for (int k = 0; k < 7; ++k) {
+        long long n = 0;
+        long long sum = 0;
+        int max = 0;
+        for (int id = 10; id < 1000; ++id) {
+            if (id % 7 == k) {
+                ++n;
+                sum += id;
+                max = id;
+            }
+        }
+        ASSERT_EQ(results[k]["n"].coerceToLong(), n);
+        ASSERT_EQ(results[k]["avg"].coerceToDouble(), static_cast<double>(sum) / n);
+        ASSERT_EQ(results[k]["max"].getInt(), max);
+    }
+}
+
+TEST_F(DocumentSourceParallelAggregationTest, PartialResultsShareTheGroupMemoryLimit) {
+    internalQueryParallelAggregationMaxWorkers.store(8);
+    auto stage = makeStage(1000, {fromjson("{$group: {_id: '$_id', n: {$sum: 1}}}")}, 4);
+
+    // The partial $group stages and their buffered results may together use no more memory than a
+    // single $group, which could not hold one group per document within this limit either.
+    internalDocumentSourceGroupMaxMemoryBytes.store(40 * 1024);
+
+    ON_BLOCK_EXIT([&] { stage->dispose(); });
+    ASSERT_THROWS_CODE(stage->getNext(),
+                       AssertionException,
+                       ErrorCodes::QueryExceededMemoryLimitNoDiskUseAllowed);
+    ASSERT_EQ(DocumentSourceParallelAggregation::getWorkersInUse(), 0);
+}
+
+TEST_F(DocumentSourceParallelAggregationTest, RunsOnTheCallingThreadWhenNoWorkerIsAvailable) {
+    internalQueryParallelAggregationMaxWorkers.store(0);
+    auto stage = makeStage(100, {fromjson("{$project: {k: 1}}")}, 4);
+
+    auto results = drain(stage.get());
+    ASSERT_EQ(stage->getNumConsumers(), 1U);
+    ASSERT_EQ(results.size(), 100U);
+}
+
+TEST_F(DocumentSourceParallelAggregationTest, ReportsTheOriginalErrorOfAFailedConsumer) {
+    internalQueryParallelAggregationMaxWorkers.store(8);
+    auto stage = makeStage(1000, {fromjson("{$project: {x: {$divide: [1, '$d']}}}")}, 4);
+
+    ON_BLOCK_EXIT([&] { stage->dispose(); });
+    ASSERT_THROWS_CODE(stage->getNext(), AssertionException, 16608);
+    ASSERT_EQ(DocumentSourceParallelAggregation::getWorkersInUse(), 0);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -91,7 +91,7 @@ DocumentSource::GetNextResult DocumentSourceSort::doGetNext() {
         return GetNextResult::makeEOF();
     }
 
-    return GetNextResult{_sortExecutor->getNext().second};
+    return GetNextResult{_sortExecutor->getNextData()};
 }
 
 void DocumentSourceSort::serializeToArray(
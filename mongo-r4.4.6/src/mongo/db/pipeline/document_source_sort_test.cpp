@@ -45,8 +45,11 @@
 #include "mongo/db/pipeline/document_source_mock.h"
 #include "mongo/db/pipeline/document_source_sort.h"
 #include "mongo/db/pipeline/pipeline.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/platform/random.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -430,6 +433,76 @@ TEST_F(DocumentSourceSortExecutionTest, ShouldBeAbleToPauseLoadingWhileSpilled)
     ASSERT_VALUE_EQ(next.releaseDocument()["_id"], Value(0));
 }
 
+TEST_F(DocumentSourceSortExecutionTest, KeyStringSortKeysSortLikeValueSortKeys) {
+    auto expCtx = getExpCtx();
+    unittest::TempDir tempDir("DocumentSourceSortTest");
+    expCtx->tempDir = tempDir.path();
+    expCtx->allowDiskUse = true;
+
+    // Documents whose sort keys mix types, equivalent numbers and missing fields.
+    PseudoRandom random(7);
+    deque<DocumentSource::GetNextResult> inputDocs;
+    for (int id = 0; id < 2000; ++id) {
+        MutableDocument doc;
+        doc.addField("_id", Value(id));
+        switch (random.nextInt32(8)) {
+            case 0:
+                break;
+            case 1:
+                doc.addField("a", Value(BSONNULL));
+                break;
+            case 2:
+                doc.addField("a", Value(random.nextInt32(10)));
+                break;
+            case 3:
+                doc.addField("a", Value(random.nextInt32(10) + 0.5));
+                break;
+            case 4:
+                doc.addField("a", Value(static_cast<long long>(random.nextInt32(10))));
+                break;
+            case 5:
+                doc.addField("a", Value(std::string(random.nextInt32(3), 'x')));
+                break;
+            case 6:
+                doc.addField("a", Value(Document{{"b", random.nextInt32(3)}}));
+                break;
+            default:
+                doc.addField("a", Value(random.nextInt32(2) == 0));
+                break;
+        }
+        doc.addField("c", Value(random.nextInt32(4)));
+        inputDocs.push_back(doc.freeze());
+    }
+
+    auto runSort = [&](bool sortKeysAsKeyStrings, size_t maxMemoryUsageBytes) {
+        internalQuerySortKeysAsKeyStrings.store(sortKeysAsKeyStrings);
+        ON_BLOCK_EXIT([] { internalQuerySortKeysAsKeyStrings.store(true); });
+
+        auto sort = DocumentSourceSort::create(
+            expCtx, BSON("a" << 1 << "c" << -1 << "_id" << 1), 0, maxMemoryUsageBytes);
+        auto mock = DocumentSourceMock::createForTest(inputDocs);
+        sort->setSource(mock.get());
+
+        vector<Document> results;
+        for (auto next = sort->getNext(); next.isAdvanced(); next = sort->getNext()) {
+            results.push_back(next.releaseDocument());
+        }
+        return results;
+    };
+
+    auto expected = runSort(false, 100 * 1024 * 1024);
+    ASSERT_EQ(expected.size(), inputDocs.size());
+
+    // Sort both entirely in memory and with many spills, which merges the sorted runs.
+    for (auto maxMemoryUsageBytes : {size_t(100 * 1024 * 1024), size_t(16 * 1024)}) {
+        auto actual = runSort(true, maxMemoryUsageBytes);
+        ASSERT_EQ(actual.size(), expected.size());
+        for (size_t i = 0; i < actual.size(); ++i) {
+            ASSERT_DOCUMENT_EQ(actual[i], expected[i]);
+        }
+    }
+}
+
 TEST_F(DocumentSourceSortExecutionTest,
        ShouldErrorIfNotAllowedToSpillToDiskAndResultSetIsTooLarge) {
     auto expCtx = getExpCtx();
@@ -0,0 +1,722 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/expression_compiler.h"
+
+#include <boost/algorithm/string.hpp>
+
+#include "mongo/db/query/datetime/date_time_support.h"
+#include "mongo/platform/overflow_arithmetic.h"
+#include "mongo/util/summation.h"
+
+namespace mongo {
+
+using Slot = CompiledExpression::Slot;
+using Tag = CompiledExpression::Slot::Tag;
+using OpCode = CompiledExpression::OpCode;
+using DatePart = CompiledExpression::DatePart;
+using Instruction = CompiledExpression::Instruction;
+
+namespace {
+
+// The truth value of each comparison operator for a comparison result of -1, 0 and 1, indexed
+// like ExpressionCompare::CmpOp.
+const bool kCmpTruthValues[][3] = {
+    {false, true, false},  // EQ
+    {true, false, true},   // NE
+    {false, false, true},  // GT
+    {false, true, true},   // GTE
+    {true, false, false},  // LT
+    {true, true, false},   // LTE
+};
+
+template <typename T>
+int threeWayCompare(T lhs, T rhs) {
+    return lhs < rhs ? -1 : (lhs > rhs ? 1 : 0);
+}
+
+bool isIntegral(Tag tag) {
+    return tag == Tag::kInt || tag == Tag::kLong;
+}
+
+long long integralValue(const Slot& slot) {
+    return slot.tag == Tag::kInt ? slot.intValue : slot.longValue;
+}
+
+Slot makeBool(bool value) {
+    Slot slot;
+    slot.tag = Tag::kBool;
+    slot.boolValue = value;
+    return slot;
+}
+
+Slot makeInt(int value) {
+    Slot slot;
+    slot.tag = Tag::kInt;
+    slot.intValue = value;
+    return slot;
+}
+
+Slot makeIntOrLong(long long value) {
+    if (value >= std::numeric_limits<int>::min() && value <= std::numeric_limits<int>::max()) {
+        return makeInt(static_cast<int>(value));
+    }
+    Slot slot;
+    slot.tag = Tag::kLong;
+    slot.longValue = value;
+    return slot;
+}
+
+template <typename Derived>
+bool isA(const Expression* expr) {
+    return dynamic_cast<const Derived*>(expr) != nullptr;
+}
+
+/**
+ * Returns the date part computed by 'expr' if it is one of the date part operators evaluated
+ * without a timezone.
+ */
+boost::optional<DatePart> getDatePart(const Expression* expr) {
+    boost::optional<DatePart> part;
+    if (isA<ExpressionYear>(expr)) {
+        part = DatePart::kYear;
+    } else if (isA<ExpressionMonth>(expr)) {
+        part = DatePart::kMonth;
+    } else if (isA<ExpressionDayOfMonth>(expr)) {
+        part = DatePart::kDayOfMonth;
+    } else if (isA<ExpressionHour>(expr)) {
+        part = DatePart::kHour;
+    } else if (isA<ExpressionMinute>(expr)) {
+        part = DatePart::kMinute;
+    } else if (isA<ExpressionSecond>(expr)) {
+        part = DatePart::kSecond;
+    } else if (isA<ExpressionMillisecond>(expr)) {
+        part = DatePart::kMillisecond;
+    } else if (isA<ExpressionDayOfWeek>(expr)) {
+        part = DatePart::kDayOfWeek;
+    } else if (isA<ExpressionDayOfYear>(expr)) {
+        part = DatePart::kDayOfYear;
+    }
+
+    // The second child is the timezone.
+    if (part && expr->getChildren()[1]) {
+        return boost::none;
+    }
+    return part;
+}
+
+}  // namespace
+
+Slot Slot::unbox(Value value) {
+    Slot slot;
+    switch (value.getType()) {
+        case EOO:
+            slot.tag = Tag::kMissing;
+            break;
+        case jstNULL:
+            slot.tag = Tag::kNull;
+            break;
+        case Bool:
+            slot.tag = Tag::kBool;
+            slot.boolValue = value.getBool();
+            break;
+        case NumberInt:
+            slot.tag = Tag::kInt;
+            slot.intValue = value.getInt();
+            break;
+        case NumberLong:
+            slot.tag = Tag::kLong;
+            slot.longValue = value.getLong();
+            break;
+        case NumberDouble:
+            slot.tag = Tag::kDouble;
+            slot.doubleValue = value.getDouble();
+            break;
+        case Date:
+            slot.tag = Tag::kDate;
+            slot.longValue = value.getDate().toMillisSinceEpoch();
+            break;
+        default:
+            slot.tag = Tag::kValue;
+            slot.value = std::move(value);
+            break;
+    }
+    return slot;
+}
+
+Value Slot::box() const {
+    switch (tag) {
+        case Tag::kMissing:
+            return Value();
+        case Tag::kNull:
+            return Value(BSONNULL);
+        case Tag::kBool:
+            return Value(boolValue);
+        case Tag::kInt:
+            return Value(intValue);
+        case Tag::kLong:
+            return Value(longValue);
+        case Tag::kDouble:
+            return Value(doubleValue);
+        case Tag::kDate:
+            return Value(Date_t::fromMillisSinceEpoch(longValue));
+        case Tag::kValue:
+            return value;
+    }
+    MONGO_UNREACHABLE;
+}
+
+bool Slot::coerceToBool() const {
+    switch (tag) {
+        case Tag::kMissing:
+        case Tag::kNull:
+            return false;
+        case Tag::kBool:
+            return boolValue;
+        case Tag::kInt:
+            return intValue;
+        case Tag::kLong:
+            return longValue;
+        case Tag::kDouble:
+            return doubleValue != 0;
+        case Tag::kDate:
+            return true;
+        case Tag::kValue:
+            return value.coerceToBool();
+    }
+    MONGO_UNREACHABLE;
+}
+
+/**
+ * Flattens an Expression tree into a CompiledExpression. Each node is given its own result
+ * register, and forward jumps are patched once their target is emitted.
+ */
+class CompiledExpression::Compiler {
+public:
+    explicit Compiler(CompiledExpression* program) : _program(program) {}
+
+    /**
+     * Returns true if the compiler does anything better than the tree for 'expr' itself. Constants
+     * and field paths are not worth compiling on their own.
+     */
+    static bool isCompiled(const Expression* expr) {
+        return isA<ExpressionAdd>(expr) || isA<ExpressionCompare>(expr) ||
+            isA<ExpressionCond>(expr) || isA<ExpressionIfNull>(expr) ||
+            isA<ExpressionConcat>(expr) || isA<ExpressionToLower>(expr) ||
+            isA<ExpressionToUpper>(expr) || isA<ExpressionStrLenBytes>(expr) ||
+            getDatePart(expr);
+    }
+
+    /**
+     * Emits the instructions evaluating 'expr' and returns the register holding its result.
+     */
+    uint32_t compile(const Expression* expr) {
+        if (auto constant = dynamic_cast<const ExpressionConstant*>(expr)) {
+            const uint32_t dst = newRegister();
+            _program->_constants.push_back(Slot::unbox(constant->getValue()));
+            emit(OpCode::kLoadConstant, dst, _program->_constants.size() - 1);
+            return dst;
+        }
+
+        if (auto fieldPath = dynamic_cast<const ExpressionFieldPath*>(expr)) {
+            if (fieldPath->isRootFieldPath() && fieldPath->getFieldPath().getPathLength() > 1) {
+                const uint32_t dst = newRegister();
+                _program->_fieldPaths.push_back(fieldPath);
+                emit(OpCode::kLoadField, dst, _program->_fieldPaths.size() - 1);
+                return dst;
+            }
+            return compileTree(expr);
+        }
+
+        if (isA<ExpressionAdd>(expr)) {
+            return compileVariadic(OpCode::kAdd, expr);
+        }
+
+        if (isA<ExpressionConcat>(expr)) {
+            return compileVariadic(OpCode::kConcat, expr);
+        }
+
+        if (auto compare = dynamic_cast<const ExpressionCompare*>(expr)) {
+            const uint32_t lhs = compile(expr->getChildren()[0].get());
+            const uint32_t rhs = compile(expr->getChildren()[1].get());
+            const uint32_t dst = newRegister();
+            emit(OpCode::kCompare, dst, lhs, rhs).sub = compare->getOp();
+            return dst;
+        }
+
+        if (isA<ExpressionCond>(expr)) {
+            // if (!cond) goto else; dst = then; goto end; else: dst = else; end:
+            const uint32_t dst = newRegister();
+            const uint32_t cond = compile(expr->getChildren()[0].get());
+            const size_t jumpToElse = emitIndex(OpCode::kJumpIfFalse, 0, cond);
+            emit(OpCode::kMove, dst, compile(expr->getChildren()[1].get()));
+            const size_t jumpToEnd = emitIndex(OpCode::kJump, 0);
+            _program->_program[jumpToElse].b = nextPc();
+            emit(OpCode::kMove, dst, compile(expr->getChildren()[2].get()));
+            _program->_program[jumpToEnd].a = nextPc();
+            return dst;
+        }
+
+        if (isA<ExpressionIfNull>(expr)) {
+            // dst = lhs; if (!lhs.nullish()) goto end; dst = rhs; end:
+            const uint32_t dst = newRegister();
+            const uint32_t lhs = compile(expr->getChildren()[0].get());
+            emit(OpCode::kMove, dst, lhs);
+            const size_t jumpToEnd = emitIndex(OpCode::kJumpIfNotNullish, 0, lhs);
+            emit(OpCode::kMove, dst, compile(expr->getChildren()[1].get()));
+            _program->_program[jumpToEnd].b = nextPc();
+            return dst;
+        }
+
+        if (isA<ExpressionToLower>(expr)) {
+            return compileUnary(OpCode::kToLower, expr);
+        }
+
+        if (isA<ExpressionToUpper>(expr)) {
+            return compileUnary(OpCode::kToUpper, expr);
+        }
+
+        if (isA<ExpressionStrLenBytes>(expr)) {
+            return compileUnary(OpCode::kStrLenBytes, expr);
+        }
+
+        if (auto part = getDatePart(expr)) {
+            const uint32_t dst = compileUnary(OpCode::kDatePart, expr);
+            _program->_program.back().sub = static_cast<uint8_t>(*part);
+            return dst;
+        }
+
+        return compileTree(expr);
+    }
+
+    uint32_t numRegisters() const {
+        return _numRegisters;
+    }
+
+private:
+    uint32_t newRegister() {
+        return _numRegisters++;
+    }
+
+    uint32_t nextPc() const {
+        return _program->_program.size();
+    }
+
+    Instruction& emit(OpCode op, uint32_t dst, uint32_t a = 0, uint32_t b = 0) {
+        _program->_program.push_back(Instruction{op, 0, dst, a, b});
+        return _program->_program.back();
+    }
+
+    size_t emitIndex(OpCode op, uint32_t dst, uint32_t a = 0, uint32_t b = 0) {
+        emit(op, dst, a, b);
+        return _program->_program.size() - 1;
+    }
+
+    uint32_t compileTree(const Expression* expr) {
+        const uint32_t dst = newRegister();
+        _program->_trees.push_back(expr);
+        emit(OpCode::kEvalTree, dst, _program->_trees.size() - 1);
+        return dst;
+    }
+
+    uint32_t compileUnary(OpCode op, const Expression* expr) {
+        const uint32_t operand = compile(expr->getChildren()[0].get());
+        const uint32_t dst = newRegister();
+        emit(op, dst, operand);
+        return dst;
+    }
+
+    /**
+     * $add and $concat stop at the first nullish operand, returning null, and fail at the first
+     * invalid one, so each operand is checked as soon as it is computed:
+     *
+     *   for each operand: r = operand; check r (if nullish: dst = null, goto end)
+     *   dst = op(operands)
+     *   end:
+     */
+    uint32_t compileVariadic(OpCode op, const Expression* expr) {
+        const uint32_t dst = newRegister();
+
+        // The operands of nested $add and $concat expressions are appended to '_operands' while
+        // this one's are computed, so collect them separately first.
+        std::vector<uint32_t> operands;
+        std::vector<size_t> checks;
+        for (auto&& child : expr->getChildren()) {
+            operands.push_back(compile(child.get()));
+            checks.push_back(emitIndex(OpCode::kCheckOperand, dst, operands.size() - 1));
+            _program->_program.back().sub = static_cast<uint8_t>(op);
+        }
+
+        const uint32_t first = _program->_operands.size();
+        _program->_operands.insert(_program->_operands.end(), operands.begin(), operands.end());
+        emit(op, dst, first, operands.size());
+
+        for (auto check : checks) {
+            auto& instruction = _program->_program[check];
+            instruction.a += first;
+            instruction.b = nextPc();
+            instruction.c = first;
+        }
+        return dst;
+    }
+
+    CompiledExpression* const _program;
+    uint32_t _numRegisters = 0;
+};
+
+std::unique_ptr<CompiledExpression> CompiledExpression::compile(
+    boost::intrusive_ptr<Expression> expr) {
+    if (!Compiler::isCompiled(expr.get())) {
+        return nullptr;
+    }
+
+    std::unique_ptr<CompiledExpression> program(new CompiledExpression(expr));
+    Compiler compiler(program.get());
+    program->_result = compiler.compile(expr.get());
+    program->_registers.resize(compiler.numRegisters());
+    return program;
+}
+
+size_t CompiledExpression::numTreeFallbacks() const {
+    return std::count_if(_program.begin(), _program.end(), [](const Instruction& instruction) {
+        return instruction.op == OpCode::kEvalTree;
+    });
+}
+
+Value CompiledExpression::evaluate(const Document& root, Variables* variables) const {
+    Slot* const registers = _registers.data();
+    const Instruction* const program = _program.data();
+    const size_t programSize = _program.size();
+
+    size_t pc = 0;
+    while (pc < programSize) {
+        const Instruction& instruction = program[pc++];
+        Slot& dst = registers[instruction.dst];
+
+        switch (instruction.op) {
+            case OpCode::kLoadConstant:
+                dst = _constants[instruction.a];
+                break;
+            case OpCode::kLoadField:
+                dst = Slot::unbox(loadField(_fieldPaths[instruction.a], root, variables));
+                break;
+            case OpCode::kEvalTree:
+                dst = Slot::unbox(_trees[instruction.a]->evaluate(root, variables));
+                break;
+            case OpCode::kMove:
+                dst = registers[instruction.a];
+                break;
+            case OpCode::kJump:
+                pc = instruction.a;
+                break;
+            case OpCode::kJumpIfFalse:
+                if (!registers[instruction.a].coerceToBool()) {
+                    pc = instruction.b;
+                }
+                break;
+            case OpCode::kJumpIfNotNullish:
+                if (!registers[instruction.a].nullish()) {
+                    pc = instruction.b;
+                }
+                break;
+            case OpCode::kCheckOperand:
+                if (checkOperand(instruction)) {
+                    dst.tag = Tag::kNull;
+                    pc = instruction.b;
+                }
+                break;
+            case OpCode::kAdd:
+                dst = evaluateAdd(&_operands[instruction.a], instruction.b);
+                break;
+            case OpCode::kConcat:
+                dst = evaluateConcat(&_operands[instruction.a], instruction.b);
+                break;
+            case OpCode::kCompare:
+                dst = evaluateCompare(static_cast<ExpressionCompare::CmpOp>(instruction.sub),
+                                      registers[instruction.a],
+                                      registers[instruction.b]);
+                break;
+            case OpCode::kToLower:
+            case OpCode::kToUpper: {
+                std::string str = registers[instruction.a].box().coerceToString();
+                if (instruction.op == OpCode::kToLower) {
+                    boost::to_lower(str);
+                } else {
+                    boost::to_upper(str);
+                }
+                dst = Slot::unbox(Value(str));
+                break;
+            }
+            case OpCode::kStrLenBytes: {
+                const Slot& str = registers[instruction.a];
+                const BSONType type = str.tag == Tag::kValue ? str.value.getType() : Bool;
+                uassert(34473,
+                        str::stream() << "$strLenBytes requires a string argument, found: "
+                                      << typeName(str.box().getType()),
+                        type == BSONType::String);
+                const size_t strLen = str.value.getStringData().size();
+                uassert(34470,
+                        "string length could not be represented as an int.",
+                        strLen <= std::numeric_limits<int>::max());
+                dst = makeInt(static_cast<int>(strLen));
+                break;
+            }
+            case OpCode::kDatePart:
+                dst = evaluateDatePart(static_cast<DatePart>(instruction.sub),
+                                       registers[instruction.a]);
+                break;
+        }
+    }
+
+    return registers[_result].box();
+}
+
+Value CompiledExpression::loadField(const ExpressionFieldPath* fieldPath,
+                                    const Document& root,
+                                    Variables* variables) {
+    // Like ExpressionFieldPath::evaluatePath(), but iterative. Paths through arrays are left to
+    // the tree.
+    const FieldPath& path = fieldPath->getFieldPath();
+    const size_t last = path.getPathLength() - 1;
+
+    Document current = root;
+    for (size_t i = 1; i < last; ++i) {
+        Value next = current[path.getFieldName(i)];
+        switch (next.getType()) {
+            case Object:
+                current = next.getDocument();
+                break;
+            case Array:
+                return fieldPath->evaluate(root, variables);
+            default:
+                return Value();
+        }
+    }
+    return current[path.getFieldName(last)];
+}
+
+bool CompiledExpression::checkOperand(const Instruction& instruction) const {
+    const Slot& operand = _registers[_operands[instruction.a]];
+    const bool isConcat = static_cast<OpCode>(instruction.sub) == OpCode::kConcat;
+
+    if (operand.nullish()) {
+        return true;
+    }
+
+    if (isConcat) {
+        uassert(16702,
+                str::stream() << "$concat only supports strings, not "
+                              << typeName(operand.box().getType()),
+                operand.tag == Tag::kValue && operand.value.getType() == String);
+        return false;
+    }
+
+    switch (operand.tag) {
+        case Tag::kInt:
+        case Tag::kLong:
+        case Tag::kDouble:
+            return false;
+        case Tag::kDate:
+            for (size_t i = instruction.c; i < instruction.a; ++i) {
+                uassert(16612,
+                        "only one date allowed in an $add expression",
+                        _registers[_operands[i]].tag != Tag::kDate);
+            }
+            return false;
+        default:
+            uassert(16554,
+                    str::stream() << "$add only supports numeric or date types, not "
+                                  << typeName(operand.box().getType()),
+                    operand.tag == Tag::kValue && operand.value.getType() == NumberDecimal);
+            return false;
+    }
+}
+
+Slot CompiledExpression::evaluateAdd(const uint32_t* operands, size_t n) const {
+    // Integers are summed exactly while they fit in a long, which gives the same result as the
+    // compensated summation below.
+    long long integralTotal = 0;
+    bool haveLong = false;
+    bool allIntegral = true;
+    for (size_t i = 0; i < n && allIntegral; ++i) {
+        const Slot& operand = _registers[operands[i]];
+        allIntegral = isIntegral(operand.tag) &&
+            !overflow::add(integralTotal, integralValue(operand), &integralTotal);
+        haveLong = haveLong || operand.tag == Tag::kLong;
+    }
+    if (allIntegral) {
+        if (haveLong) {
+            Slot slot;
+            slot.tag = Tag::kLong;
+            slot.longValue = integralTotal;
+            return slot;
+        }
+        return makeIntOrLong(integralTotal);
+    }
+
+    // The same computation as ExpressionAdd::evaluate().
+    DoubleDoubleSummation nonDecimalTotal;
+    Decimal128 decimalTotal;
+    BSONType totalType = NumberInt;
+    bool haveDate = false;
+    for (size_t i = 0; i < n; ++i) {
+        const Slot& operand = _registers[operands[i]];
+        switch (operand.tag) {
+            case Tag::kInt:
+                nonDecimalTotal.addDouble(operand.intValue);
+                break;
+            case Tag::kLong:
+                nonDecimalTotal.addLong(operand.longValue);
+                if (totalType == NumberInt)
+                    totalType = NumberLong;
+                break;
+            case Tag::kDouble:
+                nonDecimalTotal.addDouble(operand.doubleValue);
+                if (totalType != NumberDecimal)
+                    totalType = NumberDouble;
+                break;
+            case Tag::kDate:
+                haveDate = true;
+                nonDecimalTotal.addLong(operand.longValue);
+                break;
+            default:
+                // Operands were checked to be numbers or dates.
+                decimalTotal = decimalTotal.add(operand.value.getDecimal());
+                totalType = NumberDecimal;
+                break;
+        }
+    }
+
+    if (haveDate) {
+        int64_t longTotal;
+        if (totalType == NumberDecimal) {
+            longTotal = decimalTotal.add(nonDecimalTotal.getDecimal()).toLong();
+        } else {
+            uassert(ErrorCodes::Overflow, "date overflow in $add", nonDecimalTotal.fitsLong());
+            longTotal = nonDecimalTotal.getLong();
+        }
+        Slot slot;
+        slot.tag = Tag::kDate;
+        slot.longValue = longTotal;
+        return slot;
+    }
+
+    Slot slot;
+    switch (totalType) {
+        case NumberDecimal:
+            return Slot::unbox(Value(decimalTotal.add(nonDecimalTotal.getDecimal())));
+        case NumberLong:
+            if (nonDecimalTotal.fitsLong()) {
+                slot.tag = Tag::kLong;
+                slot.longValue = nonDecimalTotal.getLong();
+                return slot;
+            }
+        // Fallthrough.
+        case NumberInt:
+            if (nonDecimalTotal.fitsLong())
+                return makeIntOrLong(nonDecimalTotal.getLong());
+        // Fallthrough.
+        default:
+            slot.tag = Tag::kDouble;
+            slot.doubleValue = nonDecimalTotal.getDouble();
+            return slot;
+    }
+}
+
+Slot CompiledExpression::evaluateConcat(const uint32_t* operands, size_t n) const {
+    // Operands were checked to be strings.
+    StringBuilder result;
+    for (size_t i = 0; i < n; ++i) {
+        result << _registers[operands[i]].value.getStringData();
+    }
+    return Slot::unbox(Value(result.str()));
+}
+
+Slot CompiledExpression::evaluateCompare(ExpressionCompare::CmpOp op,
+                                         const Slot& lhs,
+                                         const Slot& rhs) const {
+    int cmp;
+    if (isIntegral(lhs.tag) && isIntegral(rhs.tag)) {
+        cmp = threeWayCompare(integralValue(lhs), integralValue(rhs));
+    } else if (lhs.tag == Tag::kDouble && rhs.tag == Tag::kDouble &&
+               !std::isnan(lhs.doubleValue) && !std::isnan(rhs.doubleValue)) {
+        cmp = threeWayCompare(lhs.doubleValue, rhs.doubleValue);
+    } else if (lhs.tag == Tag::kBool && rhs.tag == Tag::kBool) {
+        cmp = threeWayCompare(lhs.boolValue, rhs.boolValue);
+    } else if (lhs.tag == Tag::kDate && rhs.tag == Tag::kDate) {
+        cmp = threeWayCompare(lhs.longValue, rhs.longValue);
+    } else {
+        cmp = _source->getExpressionContext()->getValueComparator().compare(lhs.box(), rhs.box());
+        cmp = cmp < 0 ? -1 : (cmp > 0 ? 1 : 0);
+    }
+
+    if (op == ExpressionCompare::CMP) {
+        return makeInt(cmp);
+    }
+    return makeBool(kCmpTruthValues[op][cmp + 1]);
+}
+
+Slot CompiledExpression::evaluateDatePart(DatePart part, const Slot& dateSlot) {
+    if (dateSlot.nullish()) {
+        Slot slot;
+        slot.tag = Tag::kNull;
+        return slot;
+    }
+
+    const Date_t date = dateSlot.tag == Tag::kDate
+        ? Date_t::fromMillisSinceEpoch(dateSlot.longValue)
+        : dateSlot.box().coerceToDate();
+    const TimeZone utc = TimeZoneDatabase::utcZone();
+
+    switch (part) {
+        case DatePart::kYear:
+            return makeInt(utc.dateParts(date).year);
+        case DatePart::kMonth:
+            return makeInt(utc.dateParts(date).month);
+        case DatePart::kDayOfMonth:
+            return makeInt(utc.dateParts(date).dayOfMonth);
+        case DatePart::kHour:
+            return makeInt(utc.dateParts(date).hour);
+        case DatePart::kMinute:
+            return makeInt(utc.dateParts(date).minute);
+        case DatePart::kSecond:
+            return makeInt(utc.dateParts(date).second);
+        case DatePart::kMillisecond:
+            return makeInt(utc.dateParts(date).millisecond);
+        case DatePart::kDayOfWeek:
+            return makeInt(utc.dayOfWeek(date));
+        case DatePart::kDayOfYear:
+            return makeInt(utc.dayOfYear(date));
+    }
+    MONGO_UNREACHABLE;
+}
+
+}  // namespace mongo
@@ -0,0 +1,183 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "mongo/db/pipeline/expression.h"
+
+namespace mongo {
+
+/**
+ * A linear, register-based program equivalent to an optimized Expression tree.
+ *
+ * Evaluating an Expression tree makes one virtual call per node and boxes every intermediate
+ * result as a Value. A CompiledExpression instead runs a flat list of instructions in a single
+ * loop. Each instruction reads and writes registers which hold booleans, numbers and dates
+ * unboxed, so that only the final result and values which are neither of those (strings, objects
+ * and so on) are materialized as Values.
+ *
+ * The compiler handles constants, field paths rooted at $$ROOT or $$CURRENT, $add, the comparison
+ * operators, $cond, $ifNull, $concat, $toLower, $toUpper, $strLenBytes and the date part operators
+ * evaluated without a timezone. Any other subtree is kept as is and evaluated through the tree by a
+ * single instruction, so every Expression can be compiled; compile() only declines those for which
+ * nothing would be gained.
+ *
+ * The program refers to the nodes of the tree it was compiled from, and keeps the tree alive.
+ * Evaluation reuses a register file owned by the program, so a CompiledExpression, like the
+ * pipeline stage holding it, must only be evaluated by one thread at a time.
+ */
+class CompiledExpression {
+public:
+    /**
+     * Compiles 'expr', which should already have been optimized. Returns nullptr if 'expr' is not
+     * supported by the compiler at its root, in which case it should be evaluated as a tree.
+     */
+    static std::unique_ptr<CompiledExpression> compile(boost::intrusive_ptr<Expression> expr);
+
+    /**
+     * Returns the same result as, and throws the same errors as, calling evaluate() on the
+     * Expression this was compiled from.
+     */
+    Value evaluate(const Document& root, Variables* variables) const;
+
+    /**
+     * The Expression this was compiled from.
+     */
+    const Expression* source() const {
+        return _source.get();
+    }
+
+    /**
+     * The number of instructions in the program, and how many of them evaluate a subtree which was
+     * not compiled. For testing.
+     */
+    size_t numInstructions() const {
+        return _program.size();
+    }
+    size_t numTreeFallbacks() const;
+
+    /**
+     * A register. Booleans, numbers other than decimals, dates, null and missing are held unboxed.
+     */
+    struct Slot {
+        enum class Tag : uint8_t { kMissing, kNull, kBool, kInt, kLong, kDouble, kDate, kValue };
+
+        static Slot unbox(Value value);
+        Value box() const;
+
+        bool nullish() const {
+            return tag == Tag::kMissing || tag == Tag::kNull ||
+                (tag == Tag::kValue && value.nullish());
+        }
+
+        bool coerceToBool() const;
+
+        Tag tag = Tag::kMissing;
+        union {
+            bool boolValue;
+            int intValue;
+            long long longValue;  // Also holds dates, as milliseconds since the epoch.
+            double doubleValue;
+        };
+        Value value;  // Only set when 'tag' is kValue.
+    };
+
+    enum class OpCode : uint8_t {
+        kLoadConstant,     // dst = constants[a]
+        kLoadField,        // dst = the value of fieldPaths[a] in the root document
+        kEvalTree,         // dst = trees[a]->evaluate()
+        kMove,             // dst = a
+        kJump,             // pc = a
+        kJumpIfFalse,      // if !a.coerceToBool(): pc = b
+        kJumpIfNotNullish, // if !a.nullish(): pc = b
+        kCheckOperand,     // validates operands[a] of the $add or $concat ('sub') whose operands
+                           // start at operands[c], and if it is nullish: dst = null, pc = b
+        kAdd,              // dst = $add of operands[a, a + b)
+        kCompare,          // dst = $cmp or one of the comparisons of a and b, selected by 'sub'
+        kConcat,           // dst = $concat of operands[a, a + b)
+        kToLower,          // dst = $toLower of a
+        kToUpper,          // dst = $toUpper of a
+        kStrLenBytes,      // dst = $strLenBytes of a
+        kDatePart,         // dst = the part of date a selected by 'sub', in UTC
+    };
+
+    enum class DatePart : uint8_t {
+        kYear,
+        kMonth,
+        kDayOfMonth,
+        kHour,
+        kMinute,
+        kSecond,
+        kMillisecond,
+        kDayOfWeek,
+        kDayOfYear,
+    };
+
+    struct Instruction {
+        OpCode op;
+        uint8_t sub = 0;
+        uint32_t dst = 0;
+        uint32_t a = 0;
+        uint32_t b = 0;
+        uint32_t c = 0;
+    };
+
+private:
+    class Compiler;
+
+    explicit CompiledExpression(boost::intrusive_ptr<Expression> source)
+        : _source(std::move(source)) {}
+
+    bool checkOperand(const Instruction& instruction) const;
+    Slot evaluateAdd(const uint32_t* operands, size_t n) const;
+    Slot evaluateConcat(const uint32_t* operands, size_t n) const;
+    Slot evaluateCompare(ExpressionCompare::CmpOp op, const Slot& lhs, const Slot& rhs) const;
+    static Slot evaluateDatePart(DatePart part, const Slot& date);
+    static Value loadField(const ExpressionFieldPath* fieldPath,
+                           const Document& root,
+                           Variables* variables);
+
+    const boost::intrusive_ptr<Expression> _source;
+
+    std::vector<Instruction> _program;
+    std::vector<Slot> _constants;
+    std::vector<uint32_t> _operands;
+    std::vector<const ExpressionFieldPath*> _fieldPaths;
+    std::vector<const Expression*> _trees;
+
+    // The register holding the result once the program has run.
+    uint32_t _result = 0;
+
+    mutable std::vector<Slot> _registers;
+};
+
+}  // namespace mongo
@@ -0,0 +1,245 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/document_value/document.h"
+#include "mongo/db/exec/document_value/document_value_test_util.h"
+#include "mongo/db/json.h"
+#include "mongo/db/pipeline/expression.h"
+#include "mongo/db/pipeline/expression_compiler.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+class CompiledExpressionTest : public unittest::Test {
+protected:
+    boost::intrusive_ptr<Expression> parse(const std::string& json) {
+        return Expression::parseExpression(_expCtx, fromjson(json), _expCtx->variablesParseState)
+            ->optimize();
+    }
+
+    std::unique_ptr<CompiledExpression> compile(const std::string& json) {
+        auto compiled = CompiledExpression::compile(parse(json));
+        ASSERT(compiled) << json;
+        return compiled;
+    }
+
+    Value evaluate(const CompiledExpression& compiled, const Document& doc) {
+        return compiled.evaluate(doc, &_expCtx->variables);
+    }
+
+    /**
+     * Asserts that the compiled form of 'json' returns the same values, of the same types, and
+     * throws the same errors as the tree on each of 'docs'.
+     */
+    void assertSameAsTree(const std::string& json, const std::vector<std::string>& docs) {
+        auto compiled = compile(json);
+        for (auto&& docJson : docs) {
+            Document doc(fromjson(docJson));
+            auto run = [&](auto&& expr) -> StatusWith<Value> {
+                try {
+                    return expr.evaluate(doc, &_expCtx->variables);
+                } catch (const DBException& ex) {
+                    return ex.toStatus();
+                }
+            };
+
+            auto expected = run(*compiled->source());
+            auto actual = run(*compiled);
+            ASSERT_EQ(expected.isOK(), actual.isOK()) << json << " on " << docJson;
+            if (!expected.isOK()) {
+                ASSERT_EQ(expected.getStatus().code(), actual.getStatus().code())
+                    << json << " on " << docJson;
+                continue;
+            }
+            ASSERT_VALUE_EQ(expected.getValue(), actual.getValue());
+            ASSERT_EQ(expected.getValue().getType(), actual.getValue().getType())
+                << json << " on " << docJson;
+        }
+    }
+
+    boost::intrusive_ptr<ExpressionContextForTest> _expCtx = new ExpressionContextForTest();
+};
+
+TEST_F(CompiledExpressionTest, DeclinesExpressionsWithNothingToCompile) {
+    ASSERT_FALSE(CompiledExpression::compile(parse("{$const: 1}")));
+    ASSERT_FALSE(CompiledExpression::compile(parse("{$add: [1, 2]}")));
+    ASSERT_FALSE(CompiledExpression::compile(parse("{$abs: '$a'}")));
+}
+
+TEST_F(CompiledExpressionTest, FallsBackToTreeForUnsupportedSubtrees) {
+    auto compiled = compile("{$add: ['$a', {$abs: '$b'}, {$multiply: ['$a', 2]}]}");
+    ASSERT_EQ(2U, compiled->numTreeFallbacks());
+    ASSERT_VALUE_EQ(Value(9), evaluate(*compiled, Document{{"a", 2}, {"b", -3}}));
+
+    compiled = compile("{$add: ['$a', '$b.c']}");
+    ASSERT_EQ(0U, compiled->numTreeFallbacks());
+}
+
+TEST_F(CompiledExpressionTest, Add) {
+    const std::vector<std::string> docs = {
+        "{a: 1, b: 2}",
+        "{a: 2147483647, b: 1}",
+        "{a: 9223372036854775807, b: 1}",
+        "{a: {$numberLong: '1'}, b: 2}",
+        "{a: 1.5, b: 2}",
+        "{a: NaN, b: 2}",
+        "{a: {$numberDecimal: '1.1'}, b: 2}",
+        "{a: {$date: 1000}, b: 2}",
+        "{a: {$date: 1000}, b: 2.5}",
+        "{a: {$date: 1000}, b: {$date: 1000}}",
+        "{a: null, b: 'str'}",
+        "{b: 1}",
+        "{a: 'str', b: null}",
+        "{a: true, b: 1}",
+    };
+    assertSameAsTree("{$add: ['$a', '$b']}", docs);
+    assertSameAsTree("{$add: ['$a', '$b', 1]}", docs);
+    assertSameAsTree("{$add: ['$a', {$add: ['$b', '$a']}]}", docs);
+}
+
+TEST_F(CompiledExpressionTest, Comparisons) {
+    const std::vector<std::string> docs = {
+        "{a: 1, b: 2}",
+        "{a: 2, b: 2}",
+        "{a: {$numberLong: '3'}, b: 2}",
+        "{a: 2, b: 2.0}",
+        "{a: NaN, b: NaN}",
+        "{a: NaN, b: 1}",
+        "{a: true, b: false}",
+        "{a: {$date: 5}, b: {$date: -5}}",
+        "{a: 'abc', b: 'abd'}",
+        "{a: null}",
+        "{}",
+        "{a: [1, 2], b: {c: 1}}",
+    };
+    for (auto op : {"$eq", "$ne", "$gt", "$gte", "$lt", "$lte", "$cmp"}) {
+        assertSameAsTree(str::stream() << "{" << op << ": ['$a', '$b']}", docs);
+    }
+}
+
+TEST_F(CompiledExpressionTest, ComparisonsRespectCollation) {
+    _expCtx->setCollator(
+        std::make_unique<CollatorInterfaceMock>(CollatorInterfaceMock::MockType::kAlwaysEqual));
+    auto compiled = compile("{$eq: ['$a', '$b']}");
+    ASSERT_VALUE_EQ(Value(true), evaluate(*compiled, Document{{"a", "x"_sd}, {"b", "y"_sd}}));
+}
+
+TEST_F(CompiledExpressionTest, CondAndIfNull) {
+    const std::vector<std::string> docs = {
+        "{a: 1, b: 'x', c: 'y'}",
+        "{a: 0, b: 'x', c: 'y'}",
+        "{a: null, b: 'x', c: 'y'}",
+        "{a: 'str', b: 1}",
+        "{b: 2, c: 3}",
+        "{a: {$date: 0}, c: 3}",
+        "{a: {$undefined: true}, b: 1}",
+    };
+    assertSameAsTree("{$cond: ['$a', '$b', '$c']}", docs);
+    assertSameAsTree("{$cond: {if: {$gt: ['$a', 0]}, then: {$add: ['$a', 1]}, else: '$c'}}", docs);
+    assertSameAsTree("{$ifNull: ['$a', '$b']}", docs);
+    assertSameAsTree("{$ifNull: [{$add: ['$a', 1]}, {$ifNull: ['$c', 'none']}]}", docs);
+}
+
+TEST_F(CompiledExpressionTest, CondOnlyEvaluatesTheTakenBranch) {
+    // The untaken branch would fail.
+    auto compiled = compile("{$cond: ['$a', 1, {$add: ['$s', 1]}]}");
+    ASSERT_VALUE_EQ(Value(1), evaluate(*compiled, Document{{"a", true}, {"s", "x"_sd}}));
+    ASSERT_THROWS_CODE(
+        evaluate(*compiled, Document{{"a", false}, {"s", "x"_sd}}), AssertionException, 16554);
+}
+
+TEST_F(CompiledExpressionTest, AddStopsAtFirstNullishOperand) {
+    // The tree returns null without evaluating the $concat, which would fail.
+    auto compiled = compile("{$add: ['$a', {$strLenBytes: {$concat: ['$s', 1]}}]}");
+    ASSERT_VALUE_EQ(Value(BSONNULL), evaluate(*compiled, Document{{"s", "x"_sd}}));
+}
+
+TEST_F(CompiledExpressionTest, StringOperators) {
+    const std::vector<std::string> docs = {
+        "{a: 'Hello', b: 'World'}",
+        "{a: 'Hello', b: null}",
+        "{a: 'Hello'}",
+        "{a: 1, b: 'World'}",
+        "{a: 1.5, b: {$date: 0}}",
+        "{a: '', b: ''}",
+    };
+    assertSameAsTree("{$concat: ['$a', ' ', '$b']}", docs);
+    assertSameAsTree("{$toLower: '$a'}", docs);
+    assertSameAsTree("{$toUpper: {$concat: ['$a', '$b']}}", docs);
+    assertSameAsTree("{$strLenBytes: '$a'}", docs);
+}
+
+TEST_F(CompiledExpressionTest, DateOperators) {
+    const std::vector<std::string> docs = {
+        "{d: {$date: '2020-02-29T13:14:15.016Z'}}",
+        "{d: {$date: -1}}",
+        "{d: {$timestamp: {t: 1000, i: 1}}}",
+        "{d: {$oid: '5e5a4b3c2d1e0f0a1b2c3d4e'}}",
+        "{d: null}",
+        "{}",
+        "{d: 'not a date'}",
+    };
+    for (auto op : {"$year",
+                    "$month",
+                    "$dayOfMonth",
+                    "$hour",
+                    "$minute",
+                    "$second",
+                    "$millisecond",
+                    "$dayOfWeek",
+                    "$dayOfYear"}) {
+        assertSameAsTree(str::stream() << "{" << op << ": '$d'}", docs);
+    }
+
+    // With a timezone, the date operators are evaluated by the tree.
+    ASSERT_FALSE(CompiledExpression::compile(
+        parse("{$year: {date: '$d', timezone: 'America/New_York'}}")));
+}
+
+TEST_F(CompiledExpressionTest, FieldPaths) {
+    const std::vector<std::string> docs = {
+        "{a: {b: {c: 1}}}",
+        "{a: {b: [{c: 1}, {c: 2}, {d: 3}]}}",
+        "{a: [{b: {c: 1}}, 5]}",
+        "{a: {b: 1}}",
+        "{a: 1}",
+        "{}",
+    };
+    assertSameAsTree("{$ifNull: ['$a.b.c', 'missing']}", docs);
+    assertSameAsTree("{$ifNull: ['$$ROOT.a.b', 'missing']}", docs);
+    assertSameAsTree("{$ifNull: ['$$ROOT', 'missing']}", docs);
+}
+
+}  // namespace
+}  // namespace mongo
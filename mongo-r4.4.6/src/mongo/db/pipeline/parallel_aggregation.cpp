@@ -0,0 +1,173 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/parallel_aggregation.h"
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/pipeline/document_source_cursor.h"
+#include "mongo/db/pipeline/document_source_geo_near_cursor.h"
+#include "mongo/db/pipeline/document_source_group.h"
+#include "mongo/db/pipeline/document_source_match.h"
+#include "mongo/db/pipeline/document_source_parallel_aggregation.h"
+#include "mongo/db/pipeline/document_source_single_document_transformation.h"
+#include "mongo/db/pipeline/document_source_sort.h"
+#include "mongo/db/pipeline/document_source_unwind.h"
+#include "mongo/db/pipeline/sharded_agg_helpers.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/repl/read_concern_args.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+namespace parallel_aggregation {
+
+namespace {
+
+bool isEligibleContext(const Collection* collection,
+                       const AggregationRequest& request,
+                       const ExpressionContext& expCtx) {
+    // With 'allowDiskUse' the pipeline runs serially, where $group can spill rather than hold the
+    // partial results of every consumer in memory.
+    if (!collection || expCtx.ns.isOplog() || expCtx.explain || expCtx.inMongos ||
+        expCtx.fromMongos || expCtx.needsMerge || expCtx.allowDiskUse ||
+        expCtx.tailableMode != TailableModeEnum::kNormal || request.getExchangeSpec()) {
+        return false;
+    }
+
+    auto opCtx = expCtx.opCtx;
+    if (opCtx->inMultiDocumentTransaction()) {
+        return false;
+    }
+
+    // The worker threads read with the default read concern of their own operations.
+    const auto& readConcernArgs = repl::ReadConcernArgs::get(opCtx);
+    if (readConcernArgs.getArgsAfterClusterTime() || readConcernArgs.getArgsAtClusterTime() ||
+        (readConcernArgs.getLevel() != repl::ReadConcernLevel::kLocalReadConcern &&
+         readConcernArgs.getLevel() != repl::ReadConcernLevel::kAvailableReadConcern)) {
+        return false;
+    }
+
+    return static_cast<long long>(collection->dataSize(opCtx)) >=
+        internalQueryParallelAggregationMinCollectionBytes.load();
+}
+
+/**
+ * Returns true if 'pipeline' reads a collection through a plain $cursor stage, as opposed to one
+ * returning $geoNear results in order of distance.
+ */
+bool hasCollectionScanInput(const Pipeline& pipeline) {
+    const auto& sources = pipeline.getSources();
+    return !sources.empty() && dynamic_cast<DocumentSourceCursor*>(sources.front().get()) &&
+        !dynamic_cast<DocumentSourceGeoNearCursor*>(sources.front().get());
+}
+
+/**
+ * Returns true if 'request' sorts its input ahead of its first $group. Such a $sort is absorbed
+ * into the $cursor stage and so no longer appears in the pipeline.
+ */
+bool sortsBeforeGroup(const AggregationRequest& request) {
+    for (auto&& stage : request.getPipeline()) {
+        StringData name = stage.firstElementFieldNameStringData();
+        if (name == DocumentSourceGroup::kStageName) {
+            return false;
+        }
+        if (name == DocumentSourceSort::kStageName) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Returns true if every accumulator of 'group' produces the same result whatever the order of its
+ * input. Accumulators such as $first, $last and $push do not, nor do user-defined ones.
+ */
+bool hasOrderInsensitiveAccumulators(const DocumentSourceGroup& group) {
+    static const StringDataSet kOrderInsensitiveAccumulators{
+        "$sum", "$avg", "$min", "$max", "$addToSet", "$stdDevPop", "$stdDevSamp"};
+    for (auto&& statement : group.getAccumulatedFields()) {
+        if (!kOrderInsensitiveAccumulators.count(statement.makeAccumulator()->getOpName())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+bool isEligibleShape(const Pipeline& pipeline, const AggregationRequest& request) {
+    const auto& sources = pipeline.getSources();
+    if (sources.empty() || sortsBeforeGroup(request)) {
+        return false;
+    }
+
+    for (auto it = std::next(sources.begin()); it != sources.end(); ++it) {
+        if (auto group = dynamic_cast<DocumentSourceGroup*>(it->get())) {
+            return hasOrderInsensitiveAccumulators(*group);
+        }
+        StringData name = (*it)->getSourceName();
+        if (name != DocumentSourceMatch::kStageName && name != DocumentSourceUnwind::kStageName &&
+            !dynamic_cast<DocumentSourceSingleDocumentTransformation*>(it->get())) {
+            return false;
+        }
+    }
+    return false;
+}
+
+std::unique_ptr<Pipeline, PipelineDeleter> parallelizeIfEligible(
+    const Collection* collection,
+    const AggregationRequest& request,
+    std::unique_ptr<Pipeline, PipelineDeleter> pipeline) {
+    const auto degree = internalQueryParallelAggregationDegree.load();
+    if (degree < 2 || internalQueryParallelAggregationMaxWorkers.load() < 1) {
+        return pipeline;
+    }
+
+    auto expCtx = pipeline->getContext();
+    if (!isEligibleContext(collection, request, *expCtx) || !hasCollectionScanInput(*pipeline) ||
+        !isEligibleShape(*pipeline, request)) {
+        return pipeline;
+    }
+
+    auto inputPipeline = Pipeline::create({pipeline->popFront()}, expCtx);
+    auto split = sharded_agg_helpers::splitPipeline(std::move(pipeline));
+    invariant(!split.shardCursorsSortSpec);
+
+    auto parallelStage =
+        DocumentSourceParallelAggregation::create(expCtx,
+                                                  std::move(inputPipeline),
+                                                  split.shardsPipeline->serializeToBson(),
+                                                  static_cast<size_t>(degree));
+    split.mergePipeline->addInitialSource(std::move(parallelStage));
+    return std::move(split.mergePipeline);
+}
+
+}  // namespace parallel_aggregation
+}  // namespace mongo
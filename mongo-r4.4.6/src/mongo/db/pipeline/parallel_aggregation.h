@@ -0,0 +1,68 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/db/pipeline/aggregation_request.h"
+#include "mongo/db/pipeline/pipeline.h"
+
+namespace mongo {
+
+class Collection;
+
+namespace parallel_aggregation {
+
+/**
+ * If 'pipeline', whose $cursor stage has already been attached, is eligible for intra-node parallel
+ * execution, splits it with the same logic used for sharded aggregations and returns the merging
+ * half preceded by a $_internalParallelAggregation stage, which runs the shard half on several
+ * threads over the output of the $cursor stage. Otherwise returns 'pipeline' unchanged.
+ *
+ * A pipeline is eligible when it reads an unsharded collection of at least
+ * 'internalQueryParallelAggregationMinCollectionBytes' at read concern "local" or "available"
+ * outside of a transaction and without 'allowDiskUse', and has an eligible shape as described
+ * below.
+ */
+std::unique_ptr<Pipeline, PipelineDeleter> parallelizeIfEligible(
+    const Collection* collection,
+    const AggregationRequest& request,
+    std::unique_ptr<Pipeline, PipelineDeleter> pipeline);
+
+/**
+ * Returns true if the stages of 'pipeline' after its first one, which reads the input, can run as
+ * independent partial pipelines over arbitrary parts of that input. These are $match, $project,
+ * $addFields, $replaceRoot and $unwind stages followed by a $group, optionally followed by any
+ * other stages. The $group may only use accumulators whose result does not depend on the order of
+ * their input, and 'request' must not sort ahead of it, since the consumers see the input in no
+ * particular order.
+ */
+bool isEligibleShape(const Pipeline& pipeline, const AggregationRequest& request);
+
+}  // namespace parallel_aggregation
+}  // namespace mongo
@@ -0,0 +1,94 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/parallel_aggregation.h"
+
+#include "mongo/db/pipeline/aggregation_context_fixture.h"
+#include "mongo/db/pipeline/document_source_mock.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+class ParallelAggregationEligibilityTest : public AggregationContextFixture {
+protected:
+    /**
+     * Returns whether 'requestPipeline' is eligible once any leading $sort has been absorbed into
+     * its input stage, for which a mock stands in.
+     */
+    bool isEligible(std::vector<BSONObj> requestPipeline) {
+        AggregationRequest request(getExpCtx()->ns, requestPipeline);
+
+        std::vector<BSONObj> stages;
+        for (auto&& stage : requestPipeline) {
+            if (stage.firstElementFieldNameStringData() != "$sort"_sd) {
+                stages.push_back(stage);
+            }
+        }
+        auto pipeline = Pipeline::parse(stages, getExpCtx());
+        pipeline->addInitialSource(DocumentSourceMock::createForTest());
+        return parallel_aggregation::isEligibleShape(*pipeline, request);
+    }
+};
+
+TEST_F(ParallelAggregationEligibilityTest, StatelessStagesFollowedByAGroupAreEligible) {
+    ASSERT_TRUE(isEligible({fromjson("{$match: {a: {$gt: 1}}}"),
+                            fromjson("{$unwind: '$b'}"),
+                            fromjson("{$addFields: {c: {$add: ['$a', 1]}}}"),
+                            fromjson("{$group: {_id: '$c', n: {$sum: 1}, m: {$max: '$b'}}}"),
+                            fromjson("{$sort: {n: -1}}")}));
+}
+
+TEST_F(ParallelAggregationEligibilityTest, PipelineWithoutAGroupIsNotEligible) {
+    ASSERT_FALSE(isEligible({fromjson("{$match: {a: 1}}"), fromjson("{$project: {a: 1}}")}));
+}
+
+TEST_F(ParallelAggregationEligibilityTest, StatefulStageBeforeTheGroupIsNotEligible) {
+    ASSERT_FALSE(
+        isEligible({fromjson("{$limit: 10}"), fromjson("{$group: {_id: '$a', n: {$sum: 1}}}")}));
+}
+
+TEST_F(ParallelAggregationEligibilityTest, OrderSensitiveAccumulatorsAreNotEligible) {
+    for (auto&& accumulator : {"$first", "$last", "$push", "$mergeObjects"}) {
+        ASSERT_FALSE(isEligible({BSON("$group" << BSON("_id"
+                                                       << "$a"
+                                                       << "x" << BSON(accumulator << "$b")))}))
+            << accumulator;
+    }
+}
+
+TEST_F(ParallelAggregationEligibilityTest, SortAbsorbedIntoTheInputIsNotEligible) {
+    ASSERT_FALSE(isEligible(
+        {fromjson("{$sort: {b: 1}}"), fromjson("{$group: {_id: '$a', n: {$sum: 1}}}")}));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -58,11 +58,13 @@
 #include "mongo/db/ops/write_ops_gen.h"
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_change_stream.h"
+#include "mongo/db/pipeline/document_source_change_stream_shared_reader.h"
 #include "mongo/db/pipeline/document_source_cursor.h"
 #include "mongo/db/pipeline/document_source_geo_near.h"
 #include "mongo/db/pipeline/document_source_geo_near_cursor.h"
 #include "mongo/db/pipeline/document_source_group.h"
 #include "mongo/db/pipeline/document_source_match.h"
+#include "mongo/db/pipeline/document_source_parallel_aggregation.h"
 #include "mongo/db/pipeline/document_source_sample.h"
 #include "mongo/db/pipeline/document_source_sample_from_random_cursor.h"
 #include "mongo/db/pipeline/document_source_single_document_transformation.h"
@@ -754,12 +756,29 @@ Timestamp PipelineD::getLatestOplogTimestamp(const Pipeline* pipeline) {
             dynamic_cast<DocumentSourceCursor*>(pipeline->_sources.front().get())) {
         return docSourceCursor->getLatestOplogTimestamp();
     }
+    if (auto sharedReader = dynamic_cast<DocumentSourceChangeStreamSharedReader*>(
+            pipeline->_sources.front().get())) {
+        return sharedReader->getLatestOplogTimestamp();
+    }
     return Timestamp();
 }
 
+namespace {
+/**
+ * Returns the $cursor stage feeding 'pipeline', either directly or through the input of a
+ * $_internalParallelAggregation stage, or nullptr if there is none.
+ */
+DocumentSourceCursor* getInputCursor(const Pipeline::SourceContainer& sources) {
+    auto source = sources.front().get();
+    if (auto parallelStage = dynamic_cast<DocumentSourceParallelAggregation*>(source)) {
+        source = parallelStage->getInputSource();
+    }
+    return dynamic_cast<DocumentSourceCursor*>(source);
+}
+}  // namespace
+
 std::string PipelineD::getPlanSummaryStr(const Pipeline* pipeline) {
-    if (auto docSourceCursor =
-            dynamic_cast<DocumentSourceCursor*>(pipeline->_sources.front().get())) {
+    if (auto docSourceCursor = getInputCursor(pipeline->_sources)) {
         return docSourceCursor->getPlanSummaryStr();
     }
 
@@ -769,8 +788,7 @@ std::string PipelineD::getPlanSummaryStr(const Pipeline* pipeline) {
 void PipelineD::getPlanSummaryStats(const Pipeline* pipeline, PlanSummaryStats* statsOut) {
     invariant(statsOut);
 
-    if (auto docSourceCursor =
-            dynamic_cast<DocumentSourceCursor*>(pipeline->_sources.front().get())) {
+    if (auto docSourceCursor = getInputCursor(pipeline->_sources)) {
         *statsOut = docSourceCursor->getPlanSummaryStats();
     }
 
@@ -48,6 +48,7 @@
 #include "mongo/db/curop.h"
 #include "mongo/db/cursor_manager.h"
 #include "mongo/db/db_raii.h"
+#include "mongo/db/index/index_access_method.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/pipeline/document_source_cursor.h"
 #include "mongo/db/pipeline/lite_parsed_pipeline.h"
@@ -74,6 +75,23 @@ namespace mongo {
 
 namespace {
 
+/**
+ * Sets the speculative read timestamp appropriately after a document lookup done locally, based
+ * on the timestamp used by the transaction.
+ */
+void setSpeculativeReadTimestampAfterLookup(OperationContext* opCtx) {
+    repl::SpeculativeMajorityReadInfo& speculativeMajorityReadInfo =
+        repl::SpeculativeMajorityReadInfo::get(opCtx);
+    if (speculativeMajorityReadInfo.isSpeculativeRead()) {
+        // Speculative majority reads are required to use the 'kNoOverlap' read source.
+        invariant(opCtx->recoveryUnit()->getTimestampReadSource() ==
+                  RecoveryUnit::ReadSource::kNoOverlap);
+        boost::optional<Timestamp> readTs = opCtx->recoveryUnit()->getPointInTimeReadTimestamp();
+        invariant(readTs);
+        speculativeMajorityReadInfo.setSpeculativeReadTimestampForward(*readTs);
+    }
+}
+
 class MongoDResourceYielder : public ResourceYielder {
 public:
     void yield(OperationContext* opCtx) override {
@@ -195,6 +213,12 @@ std::vector<Document> CommonMongodProcessInterface::getIndexStats(OperationConte
             doc["building"] = Value(true);
         }
 
+        BSONObjBuilder cacheResidency;
+        if (entry->accessMethod()->getSortedDataInterface()->appendCacheResidencyStats(
+                opCtx, &cacheResidency)) {
+            doc["cacheResidency"] = Value(cacheResidency.obj());
+        }
+
         indexStats.push_back(doc.freeze());
     }
     return indexStats;
@@ -347,21 +371,42 @@ boost::optional<Document> CommonMongodProcessInterface::lookupSingleDocument(
                                 << ", " << next->toString() << "]");
     }
 
-    // Set the speculative read timestamp appropriately after we do a document lookup locally. We
-    // set the speculative read timestamp based on the timestamp used by the transaction.
-    repl::SpeculativeMajorityReadInfo& speculativeMajorityReadInfo =
-        repl::SpeculativeMajorityReadInfo::get(expCtx->opCtx);
-    if (speculativeMajorityReadInfo.isSpeculativeRead()) {
-        // Speculative majority reads are required to use the 'kNoOverlap' read source.
-        invariant(expCtx->opCtx->recoveryUnit()->getTimestampReadSource() ==
-                  RecoveryUnit::ReadSource::kNoOverlap);
-        boost::optional<Timestamp> readTs =
-            expCtx->opCtx->recoveryUnit()->getPointInTimeReadTimestamp();
-        invariant(readTs);
-        speculativeMajorityReadInfo.setSpeculativeReadTimestampForward(*readTs);
+    setSpeculativeReadTimestampAfterLookup(expCtx->opCtx);
+    return lookedUpDocument;
+}
+
+boost::optional<std::vector<Document>> CommonMongodProcessInterface::lookupDocuments(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    const NamespaceString& nss,
+    UUID collectionUUID,
+    const BSONObj& filter,
+    boost::optional<BSONObj> readConcern,
+    bool allowSpeculativeMajorityRead) {
+    // As for lookupSingleDocument(), a read concern and speculative majority reads are only
+    // expected on mongos.
+    invariant(!readConcern);
+    invariant(!allowSpeculativeMajorityRead);
+
+    std::unique_ptr<Pipeline, PipelineDeleter> pipeline;
+    try {
+        auto foreignExpCtx = expCtx->copyWith(
+            nss,
+            collectionUUID,
+            _getCollectionDefaultCollator(expCtx->opCtx, nss.db(), collectionUUID));
+        MakePipelineOptions opts;
+        opts.allowTargetingShards = false;
+        pipeline = Pipeline::makePipeline({BSON("$match" << filter)}, foreignExpCtx, opts);
+    } catch (const ExceptionFor<ErrorCodes::NamespaceNotFound>&) {
+        return std::vector<Document>{};
     }
 
-    return lookedUpDocument;
+    std::vector<Document> lookedUpDocuments;
+    while (auto next = pipeline->getNext()) {
+        lookedUpDocuments.push_back(std::move(*next));
+    }
+
+    setSpeculativeReadTimestampAfterLookup(expCtx->opCtx);
+    return lookedUpDocuments;
 }
 
 BackupCursorState CommonMongodProcessInterface::openBackupCursor(
@@ -368,6 +368,21 @@ public:
         boost::optional<BSONObj> readConcern,
         bool allowSpeculativeMajorityRead = false) = 0;
 
+    /**
+     * Returns every document matching 'filter', which selects documents by their document keys, so
+     * that the documents for several document keys can be looked up at once. Returns no documents
+     * if the namespace does not exist. Returns boost::none if the matching documents could not all
+     * be fetched in a single round trip, in which case the caller should look them up one at a time
+     * with lookupSingleDocument().
+     */
+    virtual boost::optional<std::vector<Document>> lookupDocuments(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx,
+        const NamespaceString& nss,
+        UUID,
+        const BSONObj& filter,
+        boost::optional<BSONObj> readConcern,
+        bool allowSpeculativeMajorityRead = false) = 0;
+
     /**
      * Returns a vector of all idle (non-pinned) local cursors.
      */
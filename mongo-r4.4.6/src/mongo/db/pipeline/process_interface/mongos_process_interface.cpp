@@ -84,6 +84,85 @@ StatusWith<CachedCollectionRoutingInfo> getCollectionRoutingInfo(
     return swRoutingInfo;
 }
 
+/**
+ * Dispatches a 'find' with the given filter to the shards which may own the documents it selects
+ * in the collection 'nss', and returns the resulting cursors. Throws NamespaceNotFound if the
+ * collection no longer exists with the given UUID.
+ */
+std::vector<RemoteCursor> establishLookupCursors(const intrusive_ptr<ExpressionContext>& expCtx,
+                                                 const NamespaceString& nss,
+                                                 UUID collectionUUID,
+                                                 const BSONObj& filterObj,
+                                                 boost::optional<int> batchSize,
+                                                 boost::optional<BSONObj> readConcern,
+                                                 bool allowSpeculativeMajorityRead) {
+    auto foreignExpCtx = expCtx->copyWith(nss, collectionUUID);
+
+    // Create the find command to be dispatched to the shard(s) in order to return the post-image.
+    BSONObjBuilder cmdBuilder;
+    bool findCmdIsByUuid(foreignExpCtx->uuid);
+    if (findCmdIsByUuid) {
+        foreignExpCtx->uuid->appendToBuilder(&cmdBuilder, "find");
+    } else {
+        cmdBuilder.append("find", nss.coll());
+    }
+    cmdBuilder.append("filter", filterObj);
+    if (batchSize) {
+        cmdBuilder.append("batchSize", *batchSize);
+    }
+    if (readConcern) {
+        cmdBuilder.append(repl::ReadConcernArgs::kReadConcernFieldName, *readConcern);
+    }
+    if (allowSpeculativeMajorityRead) {
+        cmdBuilder.append("allowSpeculativeMajorityRead", true);
+    }
+
+    auto findCmd = cmdBuilder.obj();
+    auto catalogCache = Grid::get(expCtx->opCtx)->catalogCache();
+    return sharded_agg_helpers::shardVersionRetry(
+        expCtx->opCtx,
+        catalogCache,
+        expCtx->ns,
+        str::stream() << "Looking up document matching " << redact(filterObj),
+        [&]() -> std::vector<RemoteCursor> {
+            // Verify that the collection exists, with the correct UUID.
+            auto routingInfo = uassertStatusOK(getCollectionRoutingInfo(foreignExpCtx));
+
+            // Finalize the 'find' command object based on the routing table information.
+            if (findCmdIsByUuid && routingInfo.cm()) {
+                // Find by UUID and shard versioning do not work together (SERVER-31946).  In
+                // the sharded case we've already checked the UUID, so find by namespace is
+                // safe.  In the unlikely case that the collection has been deleted and a new
+                // collection with the same name created through a different mongos or the
+                // collection had its shard key refined, the shard version will be detected as
+                // stale, as shard versions contain an 'epoch' field unique to the collection.
+                findCmd = findCmd.addField(BSON("find" << nss.coll()).firstElement());
+                findCmdIsByUuid = false;
+            }
+
+            // Build the versioned requests to be dispatched to the shards. Typically, only a
+            // single shard will be targeted here; however, in certain cases where only the _id
+            // is present, we may need to scatter-gather the query to all shards in order to
+            // find the document.
+            auto requests = getVersionedRequestsForTargetedShards(expCtx->opCtx,
+                                                                  nss,
+                                                                  routingInfo,
+                                                                  findCmd,
+                                                                  filterObj,
+                                                                  CollationSpec::kSimpleSpec);
+
+            // Dispatch the requests. The 'establishCursors' method conveniently prepares the
+            // result into a vector of cursor responses for us.
+            return establishCursors(
+                expCtx->opCtx,
+                Grid::get(expCtx->opCtx)->getExecutorPool()->getArbitraryExecutor(),
+                nss,
+                ReadPreferenceSetting::get(expCtx->opCtx),
+                std::move(requests),
+                false);
+        });
+}
+
 bool supportsUniqueKey(const boost::intrusive_ptr<ExpressionContext>& expCtx,
                        const BSONObj& index,
                        const std::set<FieldPath>& uniqueKeyPaths) {
@@ -130,70 +209,14 @@ boost::optional<Document> MongosProcessInterface::lookupSingleDocument(
     const Document& filter,
     boost::optional<BSONObj> readConcern,
     bool allowSpeculativeMajorityRead) {
-    auto foreignExpCtx = expCtx->copyWith(nss, collectionUUID);
-
-    // Create the find command to be dispatched to the shard(s) in order to return the post-image.
-    auto filterObj = filter.toBson();
-    BSONObjBuilder cmdBuilder;
-    bool findCmdIsByUuid(foreignExpCtx->uuid);
-    if (findCmdIsByUuid) {
-        foreignExpCtx->uuid->appendToBuilder(&cmdBuilder, "find");
-    } else {
-        cmdBuilder.append("find", nss.coll());
-    }
-    cmdBuilder.append("filter", filterObj);
-    if (readConcern) {
-        cmdBuilder.append(repl::ReadConcernArgs::kReadConcernFieldName, *readConcern);
-    }
-    if (allowSpeculativeMajorityRead) {
-        cmdBuilder.append("allowSpeculativeMajorityRead", true);
-    }
-
     try {
-        auto findCmd = cmdBuilder.obj();
-        auto catalogCache = Grid::get(expCtx->opCtx)->catalogCache();
-        auto shardResults = sharded_agg_helpers::shardVersionRetry(
-            expCtx->opCtx,
-            catalogCache,
-            expCtx->ns,
-            str::stream() << "Looking up document matching " << redact(filter.toBson()),
-            [&]() -> std::vector<RemoteCursor> {
-                // Verify that the collection exists, with the correct UUID.
-                auto routingInfo = uassertStatusOK(getCollectionRoutingInfo(foreignExpCtx));
-
-                // Finalize the 'find' command object based on the routing table information.
-                if (findCmdIsByUuid && routingInfo.cm()) {
-                    // Find by UUID and shard versioning do not work together (SERVER-31946).  In
-                    // the sharded case we've already checked the UUID, so find by namespace is
-                    // safe.  In the unlikely case that the collection has been deleted and a new
-                    // collection with the same name created through a different mongos or the
-                    // collection had its shard key refined, the shard version will be detected as
-                    // stale, as shard versions contain an 'epoch' field unique to the collection.
-                    findCmd = findCmd.addField(BSON("find" << nss.coll()).firstElement());
-                    findCmdIsByUuid = false;
-                }
-
-                // Build the versioned requests to be dispatched to the shards. Typically, only a
-                // single shard will be targeted here; however, in certain cases where only the _id
-                // is present, we may need to scatter-gather the query to all shards in order to
-                // find the document.
-                auto requests = getVersionedRequestsForTargetedShards(expCtx->opCtx,
-                                                                      nss,
-                                                                      routingInfo,
-                                                                      findCmd,
-                                                                      filterObj,
-                                                                      CollationSpec::kSimpleSpec);
-
-                // Dispatch the requests. The 'establishCursors' method conveniently prepares the
-                // result into a vector of cursor responses for us.
-                return establishCursors(
-                    expCtx->opCtx,
-                    Grid::get(expCtx->opCtx)->getExecutorPool()->getArbitraryExecutor(),
-                    nss,
-                    ReadPreferenceSetting::get(expCtx->opCtx),
-                    std::move(requests),
-                    false);
-            });
+        auto shardResults = establishLookupCursors(expCtx,
+                                                   nss,
+                                                   collectionUUID,
+                                                   filter.toBson(),
+                                                   boost::none,
+                                                   readConcern,
+                                                   allowSpeculativeMajorityRead);
 
         // Iterate all shard results and build a single composite batch. We also enforce the
         // requirement that only a single document should have been returned from across the
@@ -224,6 +247,50 @@ boost::optional<Document> MongosProcessInterface::lookupSingleDocument(
     }
 }
 
+boost::optional<std::vector<Document>> MongosProcessInterface::lookupDocuments(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    const NamespaceString& nss,
+    UUID collectionUUID,
+    const BSONObj& filter,
+    boost::optional<BSONObj> readConcern,
+    bool allowSpeculativeMajorityRead) {
+    std::vector<RemoteCursor> shardResults;
+    try {
+        // Ask each shard for all of its matching documents in its first batch, so that the lookup
+        // takes one round trip per targeted shard.
+        shardResults = establishLookupCursors(expCtx,
+                                              nss,
+                                              collectionUUID,
+                                              filter,
+                                              std::numeric_limits<int>::max(),
+                                              readConcern,
+                                              allowSpeculativeMajorityRead);
+    } catch (const ExceptionFor<ErrorCodes::NamespaceNotFound>&) {
+        return std::vector<Document>{};
+    }
+
+    std::vector<Document> lookedUpDocuments;
+    bool exhausted = true;
+    for (auto&& shardResult : shardResults) {
+        auto& shardCursor = shardResult.getCursorResponse();
+        for (auto&& doc : shardCursor.getBatch()) {
+            lookedUpDocuments.emplace_back(doc);
+        }
+        if (shardCursor.getCursorId() != 0) {
+            // The matching documents did not fit in a single batch. Rather than fetching the
+            // rest, have the caller fall back to looking up the documents one at a time.
+            exhausted = false;
+            auto executor = Grid::get(expCtx->opCtx)->getExecutorPool()->getArbitraryExecutor();
+            killRemoteCursor(expCtx->opCtx, executor.get(), std::move(shardResult), nss);
+        }
+    }
+
+    if (!exhausted) {
+        return boost::none;
+    }
+    return lookedUpDocuments;
+}
+
 BSONObj MongosProcessInterface::_reportCurrentOpForClient(
     OperationContext* opCtx,
     Client* client,
@@ -81,4 +81,27 @@ boost::optional<Document> StubLookupSingleDocumentProcessInterface::lookupSingle
     return lookedUpDocument;
 }
 
+boost::optional<std::vector<Document>> StubLookupSingleDocumentProcessInterface::lookupDocuments(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    const NamespaceString& nss,
+    UUID collectionUUID,
+    const BSONObj& filter,
+    boost::optional<BSONObj> readConcern,
+    bool allowSpeculativeMajorityRead) {
+    ++_numLookupDocumentsCalls;
+    auto foreignExpCtx = expCtx->copyWith(nss, collectionUUID, boost::none);
+    std::unique_ptr<Pipeline, PipelineDeleter> pipeline;
+    try {
+        pipeline = Pipeline::makePipeline({BSON("$match" << filter)}, foreignExpCtx);
+    } catch (ExceptionFor<ErrorCodes::NamespaceNotFound>&) {
+        return std::vector<Document>{};
+    }
+
+    std::vector<Document> lookedUpDocuments;
+    while (auto next = pipeline->getNext()) {
+        lookedUpDocuments.push_back(std::move(*next));
+    }
+    return lookedUpDocuments;
+}
+
 }  // namespace mongo
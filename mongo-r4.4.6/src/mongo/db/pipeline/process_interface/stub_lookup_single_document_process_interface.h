@@ -80,6 +80,21 @@ public:
         boost::optional<BSONObj> readConcern,
         bool allowSpeculativeMajorityRead);
 
+    boost::optional<std::vector<Document>> lookupDocuments(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx,
+        const NamespaceString& nss,
+        UUID collectionUUID,
+        const BSONObj& filter,
+        boost::optional<BSONObj> readConcern,
+        bool allowSpeculativeMajorityRead);
+
+    /**
+     * Returns the number of calls to lookupDocuments() so far.
+     */
+    int getNumLookupDocumentsCalls() const {
+        return _numLookupDocumentsCalls;
+    }
+
     std::unique_ptr<ShardFilterer> getShardFilterer(
         const boost::intrusive_ptr<ExpressionContext>& expCtx) const override {
         // Try to emulate the behavior mongos and mongod would each follow.
@@ -92,5 +107,6 @@ public:
 
 private:
     std::deque<DocumentSource::GetNextResult> _mockResults;
+    int _numLookupDocumentsCalls = 0;
 };
 }  // namespace mongo
@@ -207,6 +207,16 @@ public:
         MONGO_UNREACHABLE;
     }
 
+    boost::optional<std::vector<Document>> lookupDocuments(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx,
+        const NamespaceString& nss,
+        UUID collectionUUID,
+        const BSONObj& filter,
+        boost::optional<BSONObj> readConcern,
+        bool allowSpeculativeMajorityRead) {
+        MONGO_UNREACHABLE;
+    }
+
     std::vector<GenericCursor> getIdleCursors(const boost::intrusive_ptr<ExpressionContext>& expCtx,
                                               CurrentOpUserMode userMode) const {
         MONGO_UNREACHABLE;
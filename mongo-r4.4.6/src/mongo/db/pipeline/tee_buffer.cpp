@@ -37,16 +37,24 @@
 
 namespace mongo {
 
-TeeBuffer::TeeBuffer(size_t nConsumers, size_t bufferSizeBytes)
-    : _bufferSizeBytes(bufferSizeBytes), _consumers(nConsumers) {}
-
-boost::intrusive_ptr<TeeBuffer> TeeBuffer::create(size_t nConsumers, int bufferSizeBytes) {
+TeeBuffer::TeeBuffer(size_t nConsumers, size_t bufferSizeBytes, size_t bufferSizeDocuments)
+    : _bufferSizeBytes(bufferSizeBytes),
+      _bufferSizeDocuments(bufferSizeDocuments),
+      _consumers(nConsumers) {}
+
+boost::intrusive_ptr<TeeBuffer> TeeBuffer::create(size_t nConsumers,
+                                                  int bufferSizeBytes,
+                                                  int bufferSizeDocuments) {
     uassert(40309, "need at least one consumer for a TeeBuffer", nConsumers > 0);
     uassert(40310,
             str::stream() << "TeeBuffer requires a positive buffer size, was given "
                           << bufferSizeBytes,
             bufferSizeBytes > 0);
-    return new TeeBuffer(nConsumers, bufferSizeBytes);
+    uassert(4930300,
+            str::stream() << "TeeBuffer requires a non-negative document limit, was given "
+                          << bufferSizeDocuments,
+            bufferSizeDocuments >= 0);
+    return new TeeBuffer(nConsumers, bufferSizeBytes, bufferSizeDocuments);
 }
 
 DocumentSource::GetNextResult TeeBuffer::getNext(size_t consumerId) {
@@ -85,7 +93,8 @@ void TeeBuffer::loadNextBatch() {
         bytesInBuffer += input.getDocument().getApproximateSize();
         _buffer.push_back(std::move(input));
 
-        if (bytesInBuffer >= _bufferSizeBytes) {
+        if (bytesInBuffer >= _bufferSizeBytes ||
+            (_bufferSizeDocuments > 0 && _buffer.size() >= _bufferSizeDocuments)) {
             break;  // Need to break here so we don't get the next input and accidentally ignore it.
         }
     }
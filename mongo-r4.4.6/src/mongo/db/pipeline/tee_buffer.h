@@ -50,10 +50,13 @@ class TeeBuffer : public RefCountable {
 public:
     /**
      * Creates a TeeBuffer that will make results available to 'nConsumers' consumers. Note that
-     * 'bufferSizeBytes' is a soft cap, and may be exceeded by one document's worth (~16MB).
+     * 'bufferSizeBytes' is a soft cap, and may be exceeded by one document's worth (~16MB). A batch
+     * also ends after 'bufferSizeDocuments' documents, unless it is 0.
      */
     static boost::intrusive_ptr<TeeBuffer> create(
-        size_t nConsumers, int bufferSizeBytes = internalQueryFacetBufferSizeBytes.load());
+        size_t nConsumers,
+        int bufferSizeBytes = internalQueryFacetBufferSizeBytes.load(),
+        int bufferSizeDocuments = internalQueryFacetBufferSizeDocuments.load());
 
     void setSource(DocumentSource* source) {
         _source = source;
@@ -84,18 +87,19 @@ public:
     DocumentSource::GetNextResult getNext(size_t consumerId);
 
 private:
-    TeeBuffer(size_t nConsumers, size_t bufferSizeBytes);
+    TeeBuffer(size_t nConsumers, size_t bufferSizeBytes, size_t bufferSizeDocuments);
 
     /**
      * Clears '_buffer', then keeps requesting results from '_source' and pushing them all into
-     * '_buffer', until more than '_bufferSizeBytes' of documents have been returned, or until
-     * '_source' is exhausted.
+     * '_buffer', until more than '_bufferSizeBytes' of documents or '_bufferSizeDocuments'
+     * documents have been returned, or until '_source' is exhausted.
      */
     void loadNextBatch();
 
     DocumentSource* _source = nullptr;
 
     const size_t _bufferSizeBytes;
+    const size_t _bufferSizeDocuments;
     std::vector<DocumentSource::GetNextResult> _buffer;
 
     struct ConsumerInfo {
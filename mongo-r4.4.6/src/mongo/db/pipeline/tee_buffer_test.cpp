@@ -140,6 +140,35 @@ TEST(TeeBufferTest, ShouldTellConsumerToPauseIfItFinishesBatchBeforeOtherConsume
     ASSERT_TRUE(teeBuffer->getNext(1).isEOF());
 }
 
+TEST(TeeBufferTest, ShouldRequireNonNegativeDocumentLimit) {
+    ASSERT_THROWS_CODE(TeeBuffer::create(1, 1024, -1), AssertionException, 4930300);
+}
+
+TEST(TeeBufferTest, ShouldEndBatchOnceDocumentLimitIsReached) {
+    std::deque<DocumentSource::GetNextResult> inputs{
+        Document{{"a", 1}}, Document{{"a", 2}}, Document{{"a", 3}}};
+    auto mock = DocumentSourceMock::createForTest(inputs);
+
+    const size_t nConsumers = 2;
+    auto teeBuffer = TeeBuffer::create(nConsumers, 1024 * 1024, 2);
+    teeBuffer->setSource(mock.get());
+
+    // The first batch holds two documents even though all three would fit within the byte limit.
+    for (size_t consumerId = 0; consumerId < nConsumers; ++consumerId) {
+        ASSERT_DOCUMENT_EQ(teeBuffer->getNext(consumerId).getDocument(),
+                           inputs[0].getDocument());
+        ASSERT_DOCUMENT_EQ(teeBuffer->getNext(consumerId).getDocument(),
+                           inputs[1].getDocument());
+    }
+
+    ASSERT_DOCUMENT_EQ(teeBuffer->getNext(0).getDocument(), inputs[2].getDocument());
+    ASSERT_TRUE(teeBuffer->getNext(0).isPaused());
+    ASSERT_DOCUMENT_EQ(teeBuffer->getNext(1).getDocument(), inputs[2].getDocument());
+
+    ASSERT_TRUE(teeBuffer->getNext(0).isEOF());
+    ASSERT_TRUE(teeBuffer->getNext(1).isEOF());
+}
+
 TEST(TeeBufferTest, ShouldAllowOtherConsumersToAdvanceOnceTrailingConsumerIsDisposed) {
     std::deque<DocumentSource::GetNextResult> inputs{Document{{"a", 1}}, Document{{"a", 2}}};
     auto mock = DocumentSourceMock::createForTest(inputs);
@@ -507,6 +507,10 @@ void Explain::statsToBSON(const PlanStageStats& stats,
             bob->appendNumber("seeks", spec->seeks);
             bob->appendNumber("dupsTested", spec->dupsTested);
             bob->appendNumber("dupsDropped", spec->dupsDropped);
+            if (spec->keysDroppedBySortThreshold) {
+                bob->appendNumber("keysDroppedBySortThreshold",
+                                  spec->keysDroppedBySortThreshold);
+            }
         }
     } else if (STAGE_OR == stats.stageType) {
         OrStats* spec = static_cast<OrStats*>(stats.specific.get());
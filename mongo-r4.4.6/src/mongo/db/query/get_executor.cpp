@@ -79,6 +79,7 @@
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/query/query_planner_common.h"
 #include "mongo/db/query/query_settings.h"
+#include "mongo/db/query/query_stats_store.h"
 #include "mongo/db/query/stage_builder.h"
 #include "mongo/db/repl/optime.h"
 #include "mongo/db/repl/replication_coordinator.h"
@@ -415,6 +416,13 @@ StatusWith<PrepareExecutionResult> prepareExecution(OperationContext* opCtx,
                     "Using idhack: {canonicalQuery_Short}",
                     "canonicalQuery_Short"_attr = redact(canonicalQuery->toStringShort()));
 
+        // Idhack queries bypass the plan cache and so never get a query hash there. Compute one
+        // so that their executions can be attributed to a shape in the query stats store.
+        if (QueryStatsStore::isEnabled()) {
+            CurOp::get(opCtx)->debug().queryHash =
+                canonical_query_encoder::computeHash(canonicalQuery->encodeKey());
+        }
+
         root = std::make_unique<IDHackStage>(
             canonicalQuery->getExpCtx().get(), canonicalQuery.get(), ws, descriptor);
 
@@ -0,0 +1,157 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/query_stats_store.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/service_context.h"
+#include "mongo/util/hex.h"
+
+namespace mongo {
+
+namespace {
+
+const auto getQueryStatsStore = ServiceContext::declareDecoration<QueryStatsStore>();
+
+/**
+ * Builds the index key for a shape into 'key': the raw bytes of the query hash followed by the
+ * namespace. Reusing the caller's buffer keeps lookups of known shapes allocation-free.
+ */
+void makeKey(StringData ns, uint32_t queryHash, std::string* key) {
+    key->assign(reinterpret_cast<const char*>(&queryHash), sizeof(queryHash));
+    key->append(ns.rawData(), ns.size());
+}
+
+}  // namespace
+
+void QueryStatsEntry::record(const QueryStatsMetrics& metrics) {
+    lastSeen = metrics.now;
+    ++execCount;
+    totalExecMicros += metrics.execMicros;
+    docsExamined += metrics.docsExamined;
+    keysExamined += metrics.keysExamined;
+    nreturned += metrics.nreturned;
+    bytesReturned += metrics.bytesReturned;
+    latency.increment(metrics.execMicros, metrics.readWriteType);
+}
+
+BSONObj QueryStatsEntry::toBSON() const {
+    BSONObjBuilder builder;
+    builder.append("ns", ns);
+    builder.append("queryHash", unsignedIntToFixedLengthHex(queryHash));
+    builder.append("firstSeen", firstSeen);
+    builder.append("lastSeen", lastSeen);
+    builder.append("execCount", execCount);
+    builder.append("totalExecMicros", totalExecMicros);
+    builder.append("docsExamined", docsExamined);
+    builder.append("keysExamined", keysExamined);
+    builder.append("nreturned", nreturned);
+    builder.append("bytesReturned", bytesReturned);
+    {
+        BSONObjBuilder latencyBuilder(builder.subobjStart("latencyStats"));
+        latency.append(true, false, &latencyBuilder);
+    }
+    return builder.obj();
+}
+
+QueryStatsStore& QueryStatsStore::get(ServiceContext* service) {
+    return getQueryStatsStore(service);
+}
+
+QueryStatsStore::QueryStatsStore() : _partitions(kNumPartitions) {}
+
+bool QueryStatsStore::isEnabled() {
+    return internalQueryStatsStoreMaxEntries.load() > 0;
+}
+
+void QueryStatsStore::record(const NamespaceString& nss,
+                             uint32_t queryHash,
+                             const QueryStatsMetrics& metrics) {
+    const int maxEntries = internalQueryStatsStoreMaxEntries.load();
+    if (maxEntries <= 0) {
+        return;
+    }
+    const size_t capacity = (static_cast<size_t>(maxEntries) + kNumPartitions - 1) / kNumPartitions;
+
+    thread_local std::string key;
+    makeKey(nss.ns(), queryHash, &key);
+
+    auto& partition = _partitions[queryHash % kNumPartitions];
+    stdx::lock_guard<Latch> lk(partition.mutex);
+
+    auto it = partition.index.find(key);
+    if (it != partition.index.end()) {
+        partition.entries.splice(partition.entries.begin(), partition.entries, it->second);
+    } else {
+        partition.entries.emplace_front(std::piecewise_construct,
+                                        std::forward_as_tuple(key),
+                                        std::forward_as_tuple(nss.ns(), queryHash, metrics.now));
+        partition.index.emplace(key, partition.entries.begin());
+    }
+    partition.entries.front().second.record(metrics);
+
+    // The limit may have been lowered at runtime, so this can evict more than one entry.
+    while (partition.entries.size() > capacity) {
+        partition.index.erase(partition.entries.back().first);
+        partition.entries.pop_back();
+    }
+}
+
+std::vector<BSONObj> QueryStatsStore::getEntries() const {
+    std::vector<BSONObj> entries;
+    for (const auto& partition : _partitions) {
+        stdx::lock_guard<Latch> lk(partition.mutex);
+        for (const auto& node : partition.entries) {
+            entries.push_back(node.second.toBSON());
+        }
+    }
+    return entries;
+}
+
+size_t QueryStatsStore::size() const {
+    size_t total = 0;
+    for (const auto& partition : _partitions) {
+        stdx::lock_guard<Latch> lk(partition.mutex);
+        total += partition.entries.size();
+    }
+    return total;
+}
+
+void QueryStatsStore::clear() {
+    for (auto& partition : _partitions) {
+        stdx::lock_guard<Latch> lk(partition.mutex);
+        partition.index.clear();
+        partition.entries.clear();
+    }
+}
+
+}  // namespace mongo
@@ -0,0 +1,153 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/align/aligned_allocator.hpp>
+#include <list>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/stats/operation_latency_histogram.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/util/string_map.h"
+#include "mongo/util/time_support.h"
+#include "mongo/util/with_alignment.h"
+
+namespace mongo {
+
+class ServiceContext;
+
+/**
+ * The metrics of a single completed operation, as recorded against its query shape.
+ */
+struct QueryStatsMetrics {
+    Command::ReadWriteType readWriteType = Command::ReadWriteType::kRead;
+    long long execMicros = 0;
+    long long docsExamined = 0;
+    long long keysExamined = 0;
+    long long nreturned = 0;
+    long long bytesReturned = 0;
+    Date_t now;
+};
+
+/**
+ * Execution statistics accumulated over every run of one query shape against one namespace.
+ */
+struct QueryStatsEntry {
+    QueryStatsEntry(StringData ns, uint32_t queryHash, Date_t firstSeen)
+        : ns(ns.toString()), queryHash(queryHash), firstSeen(firstSeen), lastSeen(firstSeen) {}
+
+    void record(const QueryStatsMetrics& metrics);
+
+    BSONObj toBSON() const;
+
+    std::string ns;
+    uint32_t queryHash;
+    Date_t firstSeen;
+    Date_t lastSeen;
+    long long execCount = 0;
+    long long totalExecMicros = 0;
+    long long docsExamined = 0;
+    long long keysExamined = 0;
+    long long nreturned = 0;
+    long long bytesReturned = 0;
+    OperationLatencyHistogram latency;
+};
+
+/**
+ * Keeps execution statistics for the most recently run query shapes, keyed by namespace and query
+ * hash. The number of shapes tracked is bounded by 'internalQueryStatsStoreMaxEntries'; once full,
+ * the least recently run shape is evicted.
+ *
+ * Entries are spread over a fixed number of partitions by query hash, each with its own lock and
+ * LRU order, so that concurrent operations on different shapes rarely contend. Eviction is
+ * therefore approximate across the store as a whole: each partition holds at most its share of
+ * the configured maximum.
+ */
+class QueryStatsStore {
+    QueryStatsStore(const QueryStatsStore&) = delete;
+    QueryStatsStore& operator=(const QueryStatsStore&) = delete;
+
+public:
+    static constexpr size_t kNumPartitions = 16;
+
+    static QueryStatsStore& get(ServiceContext* service);
+
+    QueryStatsStore();
+
+    /**
+     * Returns whether recording is currently enabled.
+     */
+    static bool isEnabled();
+
+    /**
+     * Adds 'metrics' to the statistics of the shape identified by 'nss' and 'queryHash', creating
+     * its entry if needed. Does nothing when the store is disabled.
+     */
+    void record(const NamespaceString& nss, uint32_t queryHash, const QueryStatsMetrics& metrics);
+
+    /**
+     * Returns a BSON snapshot of every entry. Partitions are locked one at a time, so the snapshot
+     * is not atomic across partitions.
+     */
+    std::vector<BSONObj> getEntries() const;
+
+    /**
+     * Returns the number of shapes currently tracked.
+     */
+    size_t size() const;
+
+    /**
+     * Removes all entries.
+     */
+    void clear();
+
+private:
+    using EntryList = std::list<std::pair<std::string, QueryStatsEntry>>;
+
+    struct Partition {
+        mutable Mutex mutex = MONGO_MAKE_LATCH("QueryStatsStore::Partition::mutex");
+
+        // Most recently used first. Each node carries the key it is indexed under.
+        EntryList entries;
+        StringMap<EntryList::iterator> index;
+    };
+
+    using CacheAlignedPartition = CacheAligned<Partition>;
+
+    std::vector<CacheAlignedPartition, boost::alignment::aligned_allocator<CacheAlignedPartition>>
+        _partitions;
+};
+
+}  // namespace mongo
@@ -0,0 +1,108 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/query/query_stats_store.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kNss("test.coll");
+
+QueryStatsMetrics makeMetrics() {
+    QueryStatsMetrics metrics;
+    metrics.execMicros = 100;
+    metrics.docsExamined = 10;
+    metrics.keysExamined = 10;
+    metrics.nreturned = 1;
+    metrics.bytesReturned = 128;
+    metrics.now = Date_t::now();
+    return metrics;
+}
+
+class QueryStatsStoreBenchmark : public benchmark::Fixture {
+protected:
+    QueryStatsStore store;
+};
+
+// Every thread runs the same shape, so every record contends on one partition
+BENCHMARK_DEFINE_F(QueryStatsStoreBenchmark, BM_QueryStatsRecordSameShape)
+(benchmark::State& state) {
+    const auto metrics = makeMetrics();
+    for (auto keepRunning : state) {
+        store.record(kNss, 1, metrics);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Every thread runs its own shape, the common case of a mixed workload
+BENCHMARK_DEFINE_F(QueryStatsStoreBenchmark, BM_QueryStatsRecordDistinctShapes)
+(benchmark::State& state) {
+    const auto metrics = makeMetrics();
+    const uint32_t queryHash = state.thread_index;
+    for (auto keepRunning : state) {
+        store.record(kNss, queryHash, metrics);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Every record is for a shape not yet in the store and evicts another one
+BENCHMARK_DEFINE_F(QueryStatsStoreBenchmark, BM_QueryStatsRecordEvict)(benchmark::State& state) {
+    const int originalMaxEntries = internalQueryStatsStoreMaxEntries.load();
+    if (state.thread_index == 0) {
+        internalQueryStatsStoreMaxEntries.store(state.range(0));
+    }
+
+    const auto metrics = makeMetrics();
+    uint32_t queryHash = state.thread_index << 24;
+    for (auto keepRunning : state) {
+        store.record(kNss, queryHash++, metrics);
+    }
+    state.SetItemsProcessed(state.iterations());
+
+    if (state.thread_index == 0) {
+        store.clear();
+        internalQueryStatsStoreMaxEntries.store(originalMaxEntries);
+    }
+}
+
+BENCHMARK_REGISTER_F(QueryStatsStoreBenchmark, BM_QueryStatsRecordSameShape)->ThreadRange(1, 64);
+BENCHMARK_REGISTER_F(QueryStatsStoreBenchmark, BM_QueryStatsRecordDistinctShapes)
+    ->ThreadRange(1, 64);
+BENCHMARK_REGISTER_F(QueryStatsStoreBenchmark, BM_QueryStatsRecordEvict)
+    ->Arg(QueryStatsStore::kNumPartitions)
+    ->Arg(5000)
+    ->ThreadRange(1, 64);
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,168 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/query_stats_store.h"
+
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/hex.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kNss("test.coll");
+
+QueryStatsMetrics makeMetrics(long long execMicros, long long docsExamined = 0) {
+    QueryStatsMetrics metrics;
+    metrics.execMicros = execMicros;
+    metrics.docsExamined = docsExamined;
+    metrics.keysExamined = docsExamined;
+    metrics.nreturned = 1;
+    metrics.bytesReturned = 100;
+    metrics.now = Date_t::fromMillisSinceEpoch(execMicros);
+    return metrics;
+}
+
+/**
+ * Returns the entry for 'queryHash' on 'nss', or an empty object if the store does not hold one.
+ */
+BSONObj findEntry(const QueryStatsStore& store,
+                  uint32_t queryHash,
+                  const NamespaceString& nss = kNss) {
+    for (auto&& entry : store.getEntries()) {
+        if (entry["queryHash"].str() == unsignedIntToFixedLengthHex(queryHash) &&
+            entry["ns"].str() == nss.ns()) {
+            return entry;
+        }
+    }
+    return BSONObj();
+}
+
+/**
+ * Sets 'internalQueryStatsStoreMaxEntries' for the lifetime of the test.
+ */
+class QueryStatsStoreTest : public unittest::Test {
+protected:
+    void setMaxEntries(int maxEntries) {
+        internalQueryStatsStoreMaxEntries.store(maxEntries);
+    }
+
+    void tearDown() override {
+        internalQueryStatsStoreMaxEntries.store(_originalMaxEntries);
+    }
+
+    QueryStatsStore store;
+
+private:
+    const int _originalMaxEntries = internalQueryStatsStoreMaxEntries.load();
+};
+
+TEST_F(QueryStatsStoreTest, RecordAccumulatesMetricsForShape) {
+    store.record(kNss, 1, makeMetrics(10, 5));
+    store.record(kNss, 1, makeMetrics(30, 7));
+
+    ASSERT_EQ(store.size(), 1U);
+    auto entry = findEntry(store, 1);
+    ASSERT_FALSE(entry.isEmpty());
+    ASSERT_EQ(entry["execCount"].numberLong(), 2);
+    ASSERT_EQ(entry["totalExecMicros"].numberLong(), 40);
+    ASSERT_EQ(entry["docsExamined"].numberLong(), 12);
+    ASSERT_EQ(entry["keysExamined"].numberLong(), 12);
+    ASSERT_EQ(entry["nreturned"].numberLong(), 2);
+    ASSERT_EQ(entry["bytesReturned"].numberLong(), 200);
+    ASSERT_EQ(entry["firstSeen"].Date(), Date_t::fromMillisSinceEpoch(10));
+    ASSERT_EQ(entry["lastSeen"].Date(), Date_t::fromMillisSinceEpoch(30));
+    ASSERT_EQ(entry["latencyStats"]["reads"]["ops"].numberLong(), 2);
+    ASSERT_EQ(entry["latencyStats"]["reads"]["latency"].numberLong(), 40);
+}
+
+TEST_F(QueryStatsStoreTest, ShapesAreKeyedByNamespaceAndHash) {
+    const NamespaceString otherNss("test.other");
+    store.record(kNss, 1, makeMetrics(10));
+    store.record(otherNss, 1, makeMetrics(10));
+    store.record(kNss, 2, makeMetrics(10));
+
+    ASSERT_EQ(store.size(), 3U);
+    ASSERT_EQ(findEntry(store, 1)["execCount"].numberLong(), 1);
+    ASSERT_EQ(findEntry(store, 1, otherNss)["execCount"].numberLong(), 1);
+    ASSERT_EQ(findEntry(store, 2)["execCount"].numberLong(), 1);
+}
+
+TEST_F(QueryStatsStoreTest, EvictsLeastRecentlyRunShape) {
+    // Two entries per partition. Hashes that are multiples of the partition count all land in the
+    // same partition.
+    setMaxEntries(2 * QueryStatsStore::kNumPartitions);
+    const uint32_t first = 0;
+    const uint32_t second = QueryStatsStore::kNumPartitions;
+    const uint32_t third = 2 * QueryStatsStore::kNumPartitions;
+
+    store.record(kNss, first, makeMetrics(10));
+    store.record(kNss, second, makeMetrics(10));
+    // Running 'first' again makes 'second' the least recently run shape.
+    store.record(kNss, first, makeMetrics(10));
+    store.record(kNss, third, makeMetrics(10));
+
+    ASSERT_EQ(store.size(), 2U);
+    ASSERT_EQ(findEntry(store, first)["execCount"].numberLong(), 2);
+    ASSERT_TRUE(findEntry(store, second).isEmpty());
+    ASSERT_EQ(findEntry(store, third)["execCount"].numberLong(), 1);
+}
+
+TEST_F(QueryStatsStoreTest, LoweringLimitEvictsOnNextRecord) {
+    setMaxEntries(4 * QueryStatsStore::kNumPartitions);
+    for (uint32_t i = 0; i < 4; ++i) {
+        store.record(kNss, i * QueryStatsStore::kNumPartitions, makeMetrics(10));
+    }
+    ASSERT_EQ(store.size(), 4U);
+
+    setMaxEntries(QueryStatsStore::kNumPartitions);
+    store.record(kNss, 0, makeMetrics(10));
+    ASSERT_EQ(store.size(), 1U);
+    ASSERT_EQ(findEntry(store, 0)["execCount"].numberLong(), 2);
+}
+
+TEST_F(QueryStatsStoreTest, RecordIsNoOpWhenDisabled) {
+    setMaxEntries(0);
+    ASSERT_FALSE(QueryStatsStore::isEnabled());
+    store.record(kNss, 1, makeMetrics(10));
+    ASSERT_EQ(store.size(), 0U);
+}
+
+TEST_F(QueryStatsStoreTest, ClearRemovesAllEntries) {
+    store.record(kNss, 1, makeMetrics(10));
+    store.record(kNss, 2, makeMetrics(10));
+    store.clear();
+    ASSERT_EQ(store.size(), 0U);
+    ASSERT_TRUE(store.getEntries().empty());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,143 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <vector>
+
+#include "mongo/base/string_data.h"
+
+namespace mongo {
+
+// Ranges with fewer elements than this are sorted by comparison rather than by further radix
+// passes.
+constexpr size_t kRadixSortCutoff = 32;
+
+/**
+ * Sorts the range [begin, end) by the byte strings returned by 'getBytes', which must return a
+ * StringData for an element of the range. The resulting order is that of StringData::compare(),
+ * i.e. an unsigned byte-wise comparison in which a string sorts before every string it is a
+ * proper prefix of. The sort is stable, like the std::stable_sort() it stands in for.
+ *
+ * This is a most-significant-digit radix sort: each pass partitions a range into 257 buckets by
+ * the byte at the current depth, with a separate bucket for the strings that end before that
+ * depth, and then recurses into every bucket holding more than one element. A pass first assigns
+ * every element its position in the partitioned range, keeping elements of the same bucket in
+ * their current order, and then moves the elements into place along the cycles of that
+ * permutation, so it needs one index per element of extra space rather than a copy of the range.
+ * Ranges smaller than 'kRadixSortCutoff' are finished with a stable comparison sort of the
+ * remaining suffixes. The recursion is driven by an explicit stack, so long common prefixes cannot
+ * exhaust the call stack.
+ *
+ * This is intended for keys that are already normalized into memcmp-comparable form, such as
+ * KeyStrings, where it replaces O(n log n) full key comparisons with a few linear passes.
+ */
+template <typename RandomIt, typename GetBytes>
+void msdRadixSort(RandomIt begin, RandomIt end, const GetBytes& getBytes) {
+    // Bucket 0 holds the strings which end before the current depth. Bucket 'b + 1' holds the
+    // strings whose byte at the current depth is 'b'.
+    constexpr size_t kNumBuckets = 257;
+
+    struct Range {
+        RandomIt begin;
+        RandomIt end;
+        size_t depth;
+    };
+
+    auto bucketOf = [&](const auto& elem, size_t depth) -> size_t {
+        StringData bytes = getBytes(elem);
+        return depth < bytes.size() ? static_cast<unsigned char>(bytes[depth]) + 1 : 0;
+    };
+
+    std::vector<Range> stack;
+    stack.push_back({begin, end, 0});
+
+    std::array<size_t, kNumBuckets> counts;
+    std::array<size_t, kNumBuckets> next;
+    std::vector<size_t> destinations;
+
+    while (!stack.empty()) {
+        const Range range = stack.back();
+        stack.pop_back();
+
+        const size_t size = std::distance(range.begin, range.end);
+        if (size < kRadixSortCutoff) {
+            const size_t depth = range.depth;
+            std::stable_sort(range.begin, range.end, [&](const auto& lhs, const auto& rhs) {
+                StringData lhsBytes = getBytes(lhs);
+                StringData rhsBytes = getBytes(rhs);
+                return lhsBytes.substr(std::min(depth, lhsBytes.size()))
+                           .compare(rhsBytes.substr(std::min(depth, rhsBytes.size()))) < 0;
+            });
+            continue;
+        }
+
+        counts.fill(0);
+        for (auto it = range.begin; it != range.end; ++it) {
+            ++counts[bucketOf(*it, range.depth)];
+        }
+
+        size_t offset = 0;
+        for (size_t bucket = 0; bucket < kNumBuckets; ++bucket) {
+            next[bucket] = offset;
+            offset += counts[bucket];
+        }
+
+        destinations.resize(size);
+        for (size_t i = 0; i < size; ++i) {
+            destinations[i] = next[bucketOf(*(range.begin + i), range.depth)]++;
+        }
+
+        // Move every element to its destination, swapping each displaced element on along its
+        // cycle until the cycle closes.
+        for (size_t i = 0; i < size; ++i) {
+            while (destinations[i] != i) {
+                const size_t target = destinations[i];
+                std::iter_swap(range.begin + i, range.begin + target);
+                std::swap(destinations[i], destinations[target]);
+            }
+        }
+
+        // The strings in bucket 0 are all equal, so only the other buckets need further sorting.
+        size_t bucketBegin = counts[0];
+        for (size_t bucket = 1; bucket < kNumBuckets; ++bucket) {
+            if (counts[bucket] > 1) {
+                stack.push_back({range.begin + bucketBegin,
+                                 range.begin + bucketBegin + counts[bucket],
+                                 range.depth + 1});
+            }
+            bucketBegin += counts[bucket];
+        }
+    }
+}
+
+}  // namespace mongo
@@ -0,0 +1,145 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/sorter/radix_sort.h"
+
+#include <algorithm>
+#include <deque>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "mongo/platform/random.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using Element = std::pair<std::string, int>;
+
+StringData getBytes(const Element& elem) {
+    return elem.first;
+}
+
+/**
+ * Sorts 'input' with msdRadixSort() and checks that the result is the same as that of a stable
+ * comparison sort in the order given by StringData::compare(), so that equal strings keep their
+ * order in 'input'.
+ */
+template <typename Container>
+void assertRadixSortMatchesComparisonSort(Container input) {
+    auto expected = input;
+    std::stable_sort(expected.begin(), expected.end(), [](const Element& lhs, const Element& rhs) {
+        return getBytes(lhs).compare(getBytes(rhs)) < 0;
+    });
+
+    auto actual = input;
+    msdRadixSort(actual.begin(), actual.end(), getBytes);
+
+    ASSERT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < actual.size(); ++i) {
+        ASSERT_EQ(actual[i].first, expected[i].first);
+        ASSERT_EQ(actual[i].second, expected[i].second);
+    }
+}
+
+std::vector<Element> makeRandomStrings(PseudoRandom& random,
+                                       size_t count,
+                                       size_t maxLength,
+                                       int alphabetSize,
+                                       const std::string& commonPrefix = "") {
+    std::vector<Element> elems;
+    for (size_t i = 0; i < count; ++i) {
+        std::string str = commonPrefix;
+        const size_t length = random.nextInt32(maxLength + 1);
+        for (size_t j = 0; j < length; ++j) {
+            str.push_back(static_cast<char>(random.nextInt32(alphabetSize)));
+        }
+        elems.emplace_back(std::move(str), static_cast<int>(i));
+    }
+    return elems;
+}
+
+TEST(RadixSortTest, EmptyAndSingleElementRanges) {
+    assertRadixSortMatchesComparisonSort(std::vector<Element>{});
+    assertRadixSortMatchesComparisonSort(std::vector<Element>{{"a", 0}});
+}
+
+TEST(RadixSortTest, SmallRangeUsesComparisonSort) {
+    assertRadixSortMatchesComparisonSort(
+        std::vector<Element>{{"b", 0}, {"", 1}, {"ab", 2}, {"a", 3}, {"b", 4}});
+}
+
+TEST(RadixSortTest, PrefixesSortBeforeLongerStrings) {
+    std::vector<Element> elems;
+    for (int i = 0; i < 200; ++i) {
+        elems.emplace_back(std::string(i % 50, 'a'), i);
+    }
+    assertRadixSortMatchesComparisonSort(elems);
+}
+
+TEST(RadixSortTest, BytesCompareUnsigned) {
+    std::vector<Element> elems;
+    for (int i = 0; i < 512; ++i) {
+        elems.emplace_back(std::string(1, static_cast<char>(255 - i % 256)), i);
+    }
+    msdRadixSort(elems.begin(), elems.end(), getBytes);
+    ASSERT_EQ(elems.front().first, std::string(1, '\0'));
+    ASSERT_EQ(elems.back().first, std::string(1, static_cast<char>(255)));
+}
+
+TEST(RadixSortTest, RandomStrings) {
+    PseudoRandom random(1);
+    assertRadixSortMatchesComparisonSort(makeRandomStrings(random, 10000, 20, 256));
+    assertRadixSortMatchesComparisonSort(makeRandomStrings(random, 10000, 20, 2));
+}
+
+TEST(RadixSortTest, LongCommonPrefix) {
+    PseudoRandom random(2);
+    assertRadixSortMatchesComparisonSort(
+        makeRandomStrings(random, 1000, 4, 4, std::string(10000, 'x')));
+}
+
+TEST(RadixSortTest, EqualStringsKeepTheirOrder) {
+    PseudoRandom random(4);
+    // Few distinct strings, so that every radix pass and the comparison sort of small buckets
+    // both see many equal strings.
+    assertRadixSortMatchesComparisonSort(makeRandomStrings(random, 10000, 3, 3));
+}
+
+TEST(RadixSortTest, SortsDeque) {
+    PseudoRandom random(3);
+    auto elems = makeRandomStrings(random, 5000, 10, 16);
+    assertRadixSortMatchesComparisonSort(std::deque<Element>(elems.begin(), elems.end()));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -50,6 +50,7 @@
 
 #include <boost/filesystem/operations.hpp>
 #include <snappy.h>
+#include <type_traits>
 #include <vector>
 
 #include "mongo/base/string_data.h"
@@ -117,6 +118,29 @@ void dassertCompIsSane(const Comparator& comp, const Data& lhs, const Data& rhs)
 #endif
 }
 
+template <typename Comparator, typename RandomIt, typename = void>
+struct HasCustomSort : std::false_type {};
+
+template <typename Comparator, typename RandomIt>
+struct HasCustomSort<Comparator,
+                     RandomIt,
+                     std::void_t<decltype(std::declval<const Comparator&>().sort(
+                         std::declval<RandomIt>(), std::declval<RandomIt>()))>> : std::true_type {
+};
+
+/**
+ * Sorts the in-memory data in [begin, end) using the comparator's own sort() if it provides one,
+ * see sorter.h, or else a stable comparison sort with 'less'.
+ */
+template <typename RandomIt, typename Comparator, typename Less>
+void sortInMemory(RandomIt begin, RandomIt end, const Comparator& comp, const Less& less) {
+    if constexpr (HasCustomSort<Comparator, RandomIt>::value) {
+        comp.sort(begin, end);
+    } else {
+        std::stable_sort(begin, end, less);
+    }
+}
+
 /**
  * Returns results from sorted in-memory storage.
  */
@@ -580,7 +604,7 @@ private:
 
     void sort() {
         STLComparator less(_comp);
-        std::stable_sort(_data.begin(), _data.end(), less);
+        sortInMemory(_data.begin(), _data.end(), _comp, less);
 
         // Does 2x more compares than stable_sort
         // TODO test on windows
@@ -657,6 +681,10 @@ public:
         _best = {contender.first.getOwned(), contender.second.getOwned()};
     }
 
+    const Key* getThreshold() const {
+        return _haveData ? &_best.first : nullptr;
+    }
+
     Iterator* done() {
         if (_haveData) {
             return new InMemIterator<Key, Value>(_best);
@@ -759,6 +787,14 @@ public:
             spill();
     }
 
+    const Key* getThreshold() const {
+        // Once full, '_data' is a max-heap whose front is the worst value kept.
+        if (_data.size() == _opts.limit) {
+            return &_data.front().first;
+        }
+        return _haveCutoff ? &_cutoff.first : nullptr;
+    }
+
     Iterator* done() {
         if (_iters.empty()) {
             sort();
@@ -790,7 +826,7 @@ private:
         if (_data.size() == _opts.limit) {
             std::sort_heap(_data.begin(), _data.end(), less);
         } else {
-            std::stable_sort(_data.begin(), _data.end(), less);
+            sortInMemory(_data.begin(), _data.end(), _comp, less);
         }
     }
 
@@ -85,6 +85,15 @@
  *     }
  *     Ordering _ord;
  * };
+ *
+ * A Comparator may additionally provide a member
+ *
+ * template <typename RandomIt>
+ * void sort(RandomIt begin, RandomIt end) const;
+ *
+ * which the Sorter then uses instead of a comparison sort to order its in-memory data. It must
+ * produce an order consistent with operator() and, like the default comparison sort, be stable.
+ * This allows comparators over normalized byte keys to use a radix sort.
  */
 
 namespace mongo {
@@ -227,6 +236,15 @@ public:
      */
     virtual Iterator* done() = 0;
 
+    /**
+     * Returns a key such that any data added with a key comparing greater than or equal to it can
+     * not be part of the output, or nullptr if there is no such key yet. Only sorters with a limit
+     * ever have one. The returned pointer is invalidated by the next call to add() or done().
+     */
+    virtual const Key* getThreshold() const {
+        return nullptr;
+    }
+
     virtual ~Sorter() {}
 
     bool usedDisk() const {
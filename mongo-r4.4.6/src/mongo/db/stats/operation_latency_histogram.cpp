@@ -186,6 +186,21 @@ void OperationLatencyHistogram::_incrementData(uint64_t latency, int bucket, His
     data->sum += latency;
 }
 
+void OperationLatencyHistogram::_addData(const HistogramData& from, HistogramData* to) {
+    for (size_t i = 0; i < kMaxBuckets; i++) {
+        to->buckets[i] += from.buckets[i];
+    }
+    to->entryCount += from.entryCount;
+    to->sum += from.sum;
+}
+
+void OperationLatencyHistogram::add(const OperationLatencyHistogram& other) {
+    _addData(other._reads, &_reads);
+    _addData(other._writes, &_writes);
+    _addData(other._commands, &_commands);
+    _addData(other._transactions, &_transactions);
+}
+
 void OperationLatencyHistogram::increment(uint64_t latency, Command::ReadWriteType type) {
     int bucket = _getBucket(latency);
     switch (type) {
@@ -54,6 +54,11 @@ public:
      */
     void increment(uint64_t latency, Command::ReadWriteType type);
 
+    /**
+     * Adds the bucket counts and latency totals of 'other' to this histogram.
+     */
+    void add(const OperationLatencyHistogram& other);
+
     /**
      * Appends the four histograms with latency totals and operation counts.
      */
@@ -78,6 +83,8 @@ private:
 
     void _incrementData(uint64_t latency, int bucket, HistogramData* data);
 
+    static void _addData(const HistogramData& from, HistogramData* to);
+
     HistogramData _reads, _writes, _commands, _transactions;
 };
 }  // namespace mongo
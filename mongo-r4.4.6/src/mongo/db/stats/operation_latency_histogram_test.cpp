@@ -93,6 +93,25 @@ TEST(OperationLatencyHistogram, CheckBucketCountsAndTotalLatency) {
     }
 }
 
+TEST(OperationLatencyHistogram, AddMergesBucketsAndTotals) {
+    OperationLatencyHistogram first, second, expected;
+    for (int i = 0; i < kMaxBuckets; i++) {
+        first.increment(kLowerBounds[i], Command::ReadWriteType::kRead);
+        second.increment(kLowerBounds[i], Command::ReadWriteType::kRead);
+        second.increment(kLowerBounds[i] + 1, Command::ReadWriteType::kTransaction);
+        expected.increment(kLowerBounds[i], Command::ReadWriteType::kRead);
+        expected.increment(kLowerBounds[i], Command::ReadWriteType::kRead);
+        expected.increment(kLowerBounds[i] + 1, Command::ReadWriteType::kTransaction);
+    }
+
+    first.add(second);
+
+    BSONObjBuilder mergedBuilder, expectedBuilder;
+    first.append(true, false, &mergedBuilder);
+    expected.append(true, false, &expectedBuilder);
+    ASSERT_BSONOBJ_EQ(mergedBuilder.obj(), expectedBuilder.obj());
+}
+
 TEST(OperationLatencyHistogram, CheckBucketCountsAndTotalLatencySlowBuckets) {
     OperationLatencyHistogram hist;
     // Increment at the boundary, boundary+1, and boundary-1.
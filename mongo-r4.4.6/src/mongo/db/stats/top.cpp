@@ -33,8 +33,12 @@
 
 #include "mongo/db/stats/top.h"
 
+#include <algorithm>
+
 #include "mongo/db/jsobj.h"
 #include "mongo/db/service_context.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/processinfo.h"
 
 namespace mongo {
 
@@ -47,6 +51,13 @@ namespace {
 
 const auto getTop = ServiceContext::declareDecoration<Top>();
 
+// Threads are assigned shards round-robin the first time they record
+AtomicWord<unsigned> nextShard{0};
+
+size_t shardsForAvailableCores() {
+    return std::clamp<size_t>(ProcessInfo::getNumAvailableCores(), 1, Top::kMaxShards);
+}
+
 }  // namespace
 
 Top::UsageData::UsageData(const UsageData& older, const UsageData& newer) {
@@ -66,11 +77,42 @@ Top::CollectionData::CollectionData(const CollectionData& older, const Collectio
       remove(older.remove, newer.remove),
       commands(older.commands, newer.commands) {}
 
+void Top::CollectionData::add(const CollectionData& other) {
+    total.add(other.total);
+    readLock.add(other.readLock);
+    writeLock.add(other.writeLock);
+    queries.add(other.queries);
+    getmore.add(other.getmore);
+    insert.add(other.insert);
+    update.add(other.update);
+    remove.add(other.remove);
+    commands.add(other.commands);
+    opLatencyHistogram.add(other.opLatencyHistogram);
+}
+
+Top::Top() : _shards(shardsForAvailableCores()) {}
+
 // static
 Top& Top::get(ServiceContext* service) {
     return getTop(service);
 }
 
+Top::Shard& Top::_shardForThisThread() {
+    thread_local const unsigned ticket = nextShard.fetchAndAdd(1);
+    return _shards[ticket % _shards.size()];
+}
+
+Top::UsageMap Top::_mergeUsage() const {
+    UsageMap merged;
+    for (const auto& shard : _shards) {
+        stdx::lock_guard<SimpleMutex> lk(shard.lock);
+        for (const auto& entry : shard.usage) {
+            merged[entry.first].add(entry.second);
+        }
+    }
+    return merged;
+}
+
 void Top::record(OperationContext* opCtx,
                  StringData ns,
                  LogicalOp logicalOp,
@@ -82,9 +124,10 @@ void Top::record(OperationContext* opCtx,
         return;
 
     auto hashedNs = UsageMap::hasher().hashed_key(ns);
-    stdx::lock_guard<SimpleMutex> lk(_lock);
+    auto& shard = _shardForThisThread();
+    stdx::lock_guard<SimpleMutex> lk(shard.lock);
 
-    CollectionData& coll = _usage[hashedNs];
+    CollectionData& coll = shard.usage[hashedNs];
     _record(opCtx, coll, logicalOp, lockType, micros, readWriteType);
 }
 
@@ -134,18 +177,19 @@ void Top::_record(OperationContext* opCtx,
 }
 
 void Top::collectionDropped(const NamespaceString& nss) {
-    stdx::lock_guard<SimpleMutex> lk(_lock);
-    _usage.erase(nss.ns());
+    auto hashedNs = UsageMap::hasher().hashed_key(nss.ns());
+    for (auto& shard : _shards) {
+        stdx::lock_guard<SimpleMutex> lk(shard.lock);
+        shard.usage.erase(hashedNs);
+    }
 }
 
 void Top::cloneMap(Top::UsageMap& out) const {
-    stdx::lock_guard<SimpleMutex> lk(_lock);
-    out = _usage;
+    out = _mergeUsage();
 }
 
 void Top::append(BSONObjBuilder& b) {
-    stdx::lock_guard<SimpleMutex> lk(_lock);
-    _appendToUsageMap(b, _usage);
+    _appendToUsageMap(b, _mergeUsage());
 }
 
 void Top::_appendToUsageMap(BSONObjBuilder& b, const UsageMap& map) const {
@@ -190,9 +234,17 @@ void Top::appendLatencyStats(const NamespaceString& nss,
                              bool includeHistograms,
                              BSONObjBuilder* builder) {
     auto hashedNs = UsageMap::hasher().hashed_key(nss.ns());
-    stdx::lock_guard<SimpleMutex> lk(_lock);
+    OperationLatencyHistogram histogram;
+    for (const auto& shard : _shards) {
+        stdx::lock_guard<SimpleMutex> lk(shard.lock);
+        auto it = shard.usage.find(hashedNs);
+        if (it != shard.usage.end()) {
+            histogram.add(it->second.opLatencyHistogram);
+        }
+    }
+
     BSONObjBuilder latencyStatsBuilder;
-    _usage[hashedNs].opLatencyHistogram.append(includeHistograms, false, &latencyStatsBuilder);
+    histogram.append(includeHistograms, false, &latencyStatsBuilder);
     builder->append("ns", nss.ns());
     builder->append("latencyStats", latencyStatsBuilder.obj());
 }
@@ -203,21 +255,27 @@ void Top::incrementGlobalLatencyStats(OperationContext* opCtx,
     if (!opCtx->shouldIncrementLatencyStats())
         return;
 
-    stdx::lock_guard<SimpleMutex> guard(_lock);
-    _incrementHistogram(opCtx, latency, &_globalHistogramStats, readWriteType);
+    auto& shard = _shardForThisThread();
+    stdx::lock_guard<SimpleMutex> guard(shard.lock);
+    _incrementHistogram(opCtx, latency, &shard.globalHistogramStats, readWriteType);
 }
 
 void Top::appendGlobalLatencyStats(bool includeHistograms,
                                    bool slowMSBucketsOnly,
                                    BSONObjBuilder* builder) {
-    stdx::lock_guard<SimpleMutex> guard(_lock);
-    _globalHistogramStats.append(includeHistograms, slowMSBucketsOnly, builder);
+    OperationLatencyHistogram histogram;
+    for (const auto& shard : _shards) {
+        stdx::lock_guard<SimpleMutex> guard(shard.lock);
+        histogram.add(shard.globalHistogramStats);
+    }
+    histogram.append(includeHistograms, slowMSBucketsOnly, builder);
 }
 
 //ӳͳ  db.serverstatus().opLatencies.transactionsͳ
 void Top::incrementGlobalTransactionLatencyStats(uint64_t latency) {
-    stdx::lock_guard<SimpleMutex> guard(_lock);
-    _globalHistogramStats.increment(latency, Command::ReadWriteType::kTransaction);
+    auto& shard = _shardForThisThread();
+    stdx::lock_guard<SimpleMutex> guard(shard.lock);
+    shard.globalHistogramStats.increment(latency, Command::ReadWriteType::kTransaction);
 }
 
 void Top::_incrementHistogram(OperationContext* opCtx,
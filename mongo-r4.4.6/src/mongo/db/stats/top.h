@@ -33,13 +33,16 @@
  * DB usage monitor.
  */
 
+#include <boost/align/aligned_allocator.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
+#include <vector>
 
 #include "mongo/db/commands.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/stats/operation_latency_histogram.h"
 #include "mongo/util/concurrency/mutex.h"
 #include "mongo/util/string_map.h"
+#include "mongo/util/with_alignment.h"
 
 namespace mongo {
 
@@ -47,12 +50,27 @@ class ServiceContext;
 
 /**
  * tracks usage by collection
+ *
+ * Operations record into one of numShards() shards picked by the recording thread, so concurrent
+ * operations on the same collection rarely contend on the same lock or cache line. Readers merge
+ * the shards one at a time and never block recording on all of them at once.
+ *
+ * mongod runs a thread per connection, so a busy namespace ends up with an entry in every shard,
+ * each with its own latency histogram of about 1.7KB. Memory and the cost of merging therefore
+ * grow with the number of shards, which is the number of available cores up to kMaxShards: more
+ * shards than cores running operations at once would not reduce contention any further.
  */
 class Top {
 public:
+    static constexpr size_t kMaxShards = 16;
+
     static Top& get(ServiceContext* service);
 
-    Top() = default;
+    Top();
+
+    size_t numShards() const {
+        return _shards.size();
+    }
 
     struct UsageData {
         UsageData() : time(0), count(0) {}
@@ -64,6 +82,11 @@ public:
             count++;
             time += micros;
         }
+
+        void add(const UsageData& other) {
+            count += other.count;
+            time += other.time;
+        }
     };
 
     struct CollectionData {
@@ -73,6 +96,11 @@ public:
         CollectionData() {}
         CollectionData(const CollectionData& older, const CollectionData& newer);
 
+        /**
+         * Accumulates the counters and latency histogram of 'other' into this.
+         */
+        void add(const CollectionData& other);
+
         UsageData total;
 
         UsageData readLock;
@@ -153,9 +181,24 @@ private:
                              OperationLatencyHistogram* histogram,
                              Command::ReadWriteType readWriteType);
 
-    mutable SimpleMutex _lock;
-    OperationLatencyHistogram _globalHistogramStats;
-    UsageMap _usage;
+    struct Shard {
+        mutable SimpleMutex lock;
+        OperationLatencyHistogram globalHistogramStats;
+        UsageMap usage;
+    };
+    using CacheAlignedShard = CacheAligned<Shard>;
+
+    /**
+     * Returns the shard the calling thread records into.
+     */
+    Shard& _shardForThisThread();
+
+    /**
+     * Merges the usage maps of all shards.
+     */
+    UsageMap _mergeUsage() const;
+
+    std::vector<CacheAlignedShard, boost::alignment::aligned_allocator<CacheAlignedShard>> _shards;
 };
 
 }  // namespace mongo
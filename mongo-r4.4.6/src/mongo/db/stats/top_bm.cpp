@@ -0,0 +1,132 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/db/client.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/stats/top.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+namespace {
+
+class TopBenchmark : public benchmark::Fixture {
+public:
+    /**
+     * Creates one Client with an OperationContext per benchmark thread.
+     */
+    void makeClients(int k) {
+        clients.reserve(k);
+        for (int i = 0; i < k; ++i) {
+            auto client = getGlobalServiceContext()->makeClient(str::stream()
+                                                                << "top client for thread " << i);
+            auto opCtx = client->makeOperationContext();
+            clients.emplace_back(std::move(client), std::move(opCtx));
+        }
+    }
+
+    // Thread 0 creates the clients, the others may only use them once the benchmark loop started
+    void recordLoop(benchmark::State& state, const std::string& ns) {
+        for (auto keepRunning : state) {
+            top.record(clients[state.thread_index].second.get(),
+                       ns,
+                       LogicalOp::opQuery,
+                       Top::LockType::ReadLocked,
+                       100,
+                       false,
+                       Command::ReadWriteType::kRead);
+        }
+        state.SetItemsProcessed(state.iterations());
+    }
+
+protected:
+    std::vector<std::pair<ServiceContext::UniqueClient, ServiceContext::UniqueOperationContext>>
+        clients;
+    Top top;
+};
+
+
+// Every thread records into the same collection, the worst case for the old single lock
+BENCHMARK_DEFINE_F(TopBenchmark, BM_TopRecordSameCollection)(benchmark::State& state) {
+    if (state.thread_index == 0) {
+        makeClients(state.threads);
+    }
+
+    recordLoop(state, "test.coll");
+
+    if (state.thread_index == 0) {
+        clients.clear();
+    }
+}
+
+// Every thread records into its own collection
+BENCHMARK_DEFINE_F(TopBenchmark, BM_TopRecordManyCollections)(benchmark::State& state) {
+    if (state.thread_index == 0) {
+        makeClients(state.threads);
+    }
+
+    recordLoop(state, str::stream() << "test.coll" << state.thread_index);
+
+    if (state.thread_index == 0) {
+        clients.clear();
+    }
+}
+
+// Thread 0 aggregates the statistics as the top command and $collStats do while the other
+// threads record
+BENCHMARK_DEFINE_F(TopBenchmark, BM_TopRecordWithReader)(benchmark::State& state) {
+    if (state.thread_index == 0) {
+        makeClients(state.threads);
+    }
+
+    if (state.thread_index == 0) {
+        for (auto keepRunning : state) {
+            BSONObjBuilder builder;
+            top.append(builder);
+            top.appendLatencyStats(NamespaceString("test.coll"), true, &builder);
+            benchmark::DoNotOptimize(builder.done());
+        }
+    } else {
+        recordLoop(state, "test.coll");
+    }
+
+    if (state.thread_index == 0) {
+        clients.clear();
+    }
+}
+
+BENCHMARK_REGISTER_F(TopBenchmark, BM_TopRecordSameCollection)->ThreadRange(1, 64);
+BENCHMARK_REGISTER_F(TopBenchmark, BM_TopRecordManyCollections)->ThreadRange(1, 64);
+BENCHMARK_REGISTER_F(TopBenchmark, BM_TopRecordWithReader)->ThreadRange(2, 64);
+
+}  // namespace
+}  // namespace mongo
@@ -29,7 +29,12 @@
 
 #include "mongo/platform/basic.h"
 
+#include <vector>
+
+#include "mongo/db/client.h"
+#include "mongo/db/service_context_test_fixture.h"
 #include "mongo/db/stats/top.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 
 namespace {
@@ -40,4 +45,65 @@ TEST(TopTest, CollectionDropped) {
     Top().collectionDropped(NamespaceString("test.coll"));
 }
 
+class TopShardingTest : public ServiceContextTest {
+protected:
+    // Records 'numOps' inserts on 'ns' from each of 'numThreads' threads
+    void recordFromThreads(Top& top, StringData ns, int numThreads, int numOps) {
+        std::vector<stdx::thread> threads;
+        for (int t = 0; t < numThreads; t++) {
+            threads.emplace_back([&, t] {
+                ThreadClient tc("TopShardingTest" + std::to_string(t), getServiceContext());
+                auto opCtx = tc->makeOperationContext();
+                for (int i = 0; i < numOps; i++) {
+                    top.record(opCtx.get(),
+                               ns,
+                               LogicalOp::opInsert,
+                               Top::LockType::WriteLocked,
+                               10,
+                               false,
+                               Command::ReadWriteType::kWrite);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+};
+
+TEST_F(TopShardingTest, RecordsFromManyThreadsAreMerged) {
+    Top top;
+    const int numThreads = 2 * top.numShards() + 1;
+    const int numOps = 100;
+    recordFromThreads(top, "test.coll", numThreads, numOps);
+
+    Top::UsageMap usage;
+    top.cloneMap(usage);
+    ASSERT_EQ(usage.size(), 1U);
+    const auto& coll = usage["test.coll"];
+    ASSERT_EQ(coll.total.count, numThreads * numOps);
+    ASSERT_EQ(coll.total.time, numThreads * numOps * 10);
+    ASSERT_EQ(coll.insert.count, numThreads * numOps);
+    ASSERT_EQ(coll.writeLock.count, numThreads * numOps);
+    ASSERT_EQ(coll.readLock.count, 0);
+
+    BSONObjBuilder builder;
+    top.append(builder);
+    auto obj = builder.obj();
+    ASSERT_EQ(obj["test.coll"]["insert"]["count"].numberLong(), numThreads * numOps);
+}
+
+TEST_F(TopShardingTest, CollectionDroppedFromEveryShard) {
+    Top top;
+    recordFromThreads(top, "test.dropped", top.numShards(), 1);
+    recordFromThreads(top, "test.kept", 1, 1);
+
+    top.collectionDropped(NamespaceString("test.dropped"));
+
+    Top::UsageMap usage;
+    top.cloneMap(usage);
+    ASSERT_EQ(usage.size(), 1U);
+    ASSERT(usage.find("test.kept") != usage.end());
+}
+
 }  // namespace
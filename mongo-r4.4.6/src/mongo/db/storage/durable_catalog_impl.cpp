@@ -862,7 +862,27 @@ Status DurableCatalogImpl::renameCollection(OperationContext* opCtx,
                                             RecordId catalogId,
                                             const NamespaceString& toNss,
                                             bool stayTemp) {
-    return _replaceEntry(opCtx, catalogId, toNss, stayTemp);
+    Status status = _replaceEntry(opCtx, catalogId, toNss, stayTemp);
+    if (!status.isOK()) {
+        return status;
+    }
+
+    // Pairs of ident and index name, empty for the collection itself
+    std::vector<std::pair<std::string, std::string>> idents;
+    idents.emplace_back(getEntry(catalogId).ident, std::string());
+    std::vector<std::string> indexNames;
+    getAllIndexes(opCtx, catalogId, &indexNames);
+    for (auto& indexName : indexNames) {
+        idents.emplace_back(getIndexIdent(opCtx, catalogId, indexName), std::move(indexName));
+    }
+
+    opCtx->recoveryUnit()->onCommit(
+        [kvEngine = _engine->getEngine(), idents = std::move(idents), toNss](auto commitTime) {
+            for (const auto& [ident, indexName] : idents) {
+                kvEngine->setIdentNamespace(ident, toNss, indexName);
+            }
+        });
+    return Status::OK();
 }
 
 Status DurableCatalogImpl::dropCollection(OperationContext* opCtx, RecordId catalogId) {
@@ -150,6 +150,15 @@ public:
         return {{_it->first, _it->second.toRecordData()}};
     }
 
+    boost::optional<Record> seekAfter(const RecordId& id) final {
+        _lastMoveWasRestore = false;
+        _needFirstSeek = false;
+        _it = _records.upper_bound(id);
+        if (_it == _records.end())
+            return {};
+        return {{_it->first, _it->second.toRecordData()}};
+    }
+
     void save() final {
         if (!_needFirstSeek && !_lastMoveWasRestore)
             _savedId = _it == _records.end() ? RecordId() : _it->first;
@@ -236,6 +236,14 @@ public:
                                     StringData ident,
                                     const IndexDescriptor* desc){};
 
+    /**
+     * Called once the rename of the collection owning 'ident' has committed, with its new
+     * namespace. Index idents also pass the name of their index in 'indexName'.
+     */
+    virtual void setIdentNamespace(StringData ident,
+                                   const NamespaceString& nss,
+                                   StringData indexName = StringData()) {}
+
     /**
      * See StorageEngine::beginBackup for details
      */
@@ -37,6 +37,7 @@
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/record_id.h"
 #include "mongo/db/storage/record_data.h"
+#include "mongo/util/duration.h"
 
 namespace mongo {
 
@@ -171,6 +172,18 @@ public:
      */
     virtual boost::optional<Record> seekExact(const RecordId& id) = 0;
 
+    /**
+     * Seeks to the first Record with an id after 'id' in the direction of the cursor, whether or
+     * not a Record with id 'id' exists, and returns it. Returns boost::none if there is no such
+     * Record.
+     *
+     * Throws for storage engines which do not support it.
+     */
+    virtual boost::optional<Record> seekAfter(const RecordId& id) {
+        uasserted(ErrorCodes::CommandNotSupported,
+                  "This storage engine does not support seeking after a RecordId");
+    }
+
     /**
      * Prepares for state changes in underlying data without necessarily saving the current
      * state.
@@ -402,6 +415,28 @@ public:
      */
     virtual void cappedTruncateAfter(OperationContext* opCtx, RecordId end, bool inclusive) = 0;
 
+    /**
+     * Removes every record with an id from 'first' through 'last', inclusive. Must be called in a
+     * WriteUnitOfWork, and not on a capped collection.
+     *
+     * The default implementation deletes the records one at a time; storage engines which can
+     * remove a range of records more cheaply should override it.
+     */
+    virtual void deleteRecordRange(OperationContext* opCtx,
+                                   const RecordId& first,
+                                   const RecordId& last) {
+        std::vector<RecordId> ids;
+        auto cursor = getCursor(opCtx);
+        for (auto record = cursor->seekExact(first); record && record->id <= last;
+             record = cursor->next()) {
+            ids.push_back(record->id);
+        }
+        cursor.reset();
+        for (auto&& id : ids) {
+            deleteRecord(opCtx, id);
+        }
+    }
+
     /**
      * does this RecordStore support the compact operation?
      *
@@ -423,9 +458,14 @@ public:
     /**
      * Attempt to reduce the storage space used by this RecordStore.
      *
+     * If 'timeout' is set, gives up with ErrorCodes::ExceededTimeLimit once compaction has run for
+     * that long. Calling compact() again continues to reduce the storage space, which allows
+     * compaction to be done in bounded chunks. Timeouts are only supported if
+     * supportsOnlineCompaction() returns true.
+     *
      * Only called if compactSupported() returns true.
      */
-    virtual Status compact(OperationContext* opCtx) {
+    virtual Status compact(OperationContext* opCtx, boost::optional<Seconds> timeout) {
         MONGO_UNREACHABLE;
     }
 
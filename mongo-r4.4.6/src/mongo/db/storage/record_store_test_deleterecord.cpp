@@ -137,5 +137,48 @@ TEST(RecordStoreTestHarness, DeleteMultipleRecords) {
     }
 }
 
+// Insert multiple records and delete a range of them.
+TEST(RecordStoreTestHarness, DeleteRecordRange) {
+    const auto harnessHelper(newRecordStoreHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
+
+    const int nToInsert = 10;
+    RecordId locs[nToInsert];
+    for (int i = 0; i < nToInsert; i++) {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        {
+            stringstream ss;
+            ss << "record " << i;
+            string data = ss.str();
+
+            WriteUnitOfWork uow(opCtx.get());
+            StatusWith<RecordId> res =
+                rs->insertRecord(opCtx.get(), data.c_str(), data.size() + 1, Timestamp());
+            ASSERT_OK(res.getStatus());
+            locs[i] = res.getValue();
+            uow.commit();
+        }
+    }
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        {
+            WriteUnitOfWork uow(opCtx.get());
+            rs->deleteRecordRange(opCtx.get(), locs[2], locs[6]);
+            uow.commit();
+        }
+    }
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        ASSERT_EQUALS(nToInsert - 5, rs->numRecords(opCtx.get()));
+
+        RecordData data;
+        for (int i = 0; i < nToInsert; i++) {
+            ASSERT_EQUALS(i < 2 || i > 6, rs->findRecord(opCtx.get(), locs[i], &data));
+        }
+    }
+}
+
 }  // namespace
 }  // namespace mongo
@@ -118,8 +118,11 @@ public:
     /**
      * Attempt to reduce the storage space used by this index via compaction. Only called if the
      * indexed record store supports compaction-in-place.
+     *
+     * If 'timeout' is set, gives up with ErrorCodes::ExceededTimeLimit once compaction has run for
+     * that long, as RecordStore::compact() does.
      */
-    virtual Status compact(OperationContext* opCtx) {
+    virtual Status compact(OperationContext* opCtx, boost::optional<Seconds> timeout) {
         return Status::OK();
     }
 
@@ -138,6 +141,14 @@ public:
                                    BSONObjBuilder* output,
                                    double scale) const = 0;
 
+    /**
+     * Appends how much of this index the storage engine currently holds in its cache, for engines
+     * that track it. Returns false, appending nothing, otherwise.
+     */
+    virtual bool appendCacheResidencyStats(OperationContext* opCtx, BSONObjBuilder* output) const {
+        return false;
+    }
+
 
     /**
      * Return the number of bytes consumed by 'this' index.
@@ -0,0 +1,234 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_cache_residency.h"
+
+#include <algorithm>
+
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
+
+namespace mongo {
+
+namespace {
+
+// The namespace, or "<namespace>.$<index name>" for an index.
+std::string makeLabel(StringData ns, StringData indexName) {
+    std::string label = ns.toString();
+    if (!indexName.empty()) {
+        label += ".$" + indexName;
+    }
+    return label;
+}
+
+/**
+ * Reads the cache statistics of the table at 'uri'. Returns boost::none if its statistics cursor
+ * cannot be opened, for instance because the table was dropped since the pass started.
+ */
+boost::optional<WiredTigerCacheResidency::Sample> readSample(WT_SESSION* session,
+                                                             const std::string& uri) {
+    WT_CURSOR* cursor = nullptr;
+    const std::string statsUri = "statistics:" + uri;
+    if (session->open_cursor(session, statsUri.c_str(), nullptr, "statistics=(fast)", &cursor) !=
+        0) {
+        return boost::none;
+    }
+    ON_BLOCK_EXIT([&] { cursor->close(cursor); });
+
+    // A single cursor serves every statistic, rather than one cursor per value as
+    // WiredTigerUtil::getStatisticsValue() would open.
+    auto readStat = [&](int key) -> long long {
+        cursor->set_key(cursor, key);
+        int64_t value = 0;
+        if (cursor->search(cursor) != 0 ||
+            cursor->get_value(cursor, nullptr, nullptr, &value) != 0) {
+            return 0;
+        }
+        return value;
+    };
+
+    WiredTigerCacheResidency::Sample sample;
+    sample.sampledAt = Date_t::now();
+    sample.bytesInCache = readStat(WT_STAT_DSRC_CACHE_BYTES_INUSE);
+    sample.bytesDirty = readStat(WT_STAT_DSRC_CACHE_BYTES_DIRTY);
+    sample.pagesReadIntoCache = readStat(WT_STAT_DSRC_CACHE_READ);
+    sample.pagesRequested = readStat(WT_STAT_DSRC_CACHE_PAGES_REQUESTED);
+    sample.pagesEvicted =
+        readStat(WT_STAT_DSRC_CACHE_EVICTION_CLEAN) + readStat(WT_STAT_DSRC_CACHE_EVICTION_DIRTY);
+    return sample;
+}
+
+}  // namespace
+
+void WiredTigerCacheResidency::Sample::append(BSONObjBuilder* builder) const {
+    builder->append("bytesInCache", bytesInCache);
+    builder->append("bytesDirty", bytesDirty);
+    builder->append("pagesReadIntoCache", pagesReadIntoCache);
+    builder->append("pagesRequested", pagesRequested);
+    builder->append("pagesEvicted", pagesEvicted);
+    if (hitRatio) {
+        builder->append("hitRatio", *hitRatio);
+    }
+    builder->append("sampledAt", sampledAt);
+}
+
+void WiredTigerCacheResidency::registerTable(const std::string& uri,
+                                             StringData ns,
+                                             StringData indexName) {
+    auto label = makeLabel(ns, indexName);
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    _tables[uri] = Table{std::move(label), boost::none};
+}
+
+void WiredTigerCacheResidency::relabelTable(const std::string& uri,
+                                            StringData ns,
+                                            StringData indexName) {
+    auto label = makeLabel(ns, indexName);
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    auto it = _tables.find(uri);
+    if (it != _tables.end()) {
+        it->second.label = std::move(label);
+    }
+}
+
+void WiredTigerCacheResidency::unregisterTable(const std::string& uri) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    _tables.erase(uri);
+}
+
+size_t WiredTigerCacheResidency::sample(WT_SESSION* session, size_t maxTables, size_t topN) {
+    Timer timer;
+
+    std::vector<std::string> uris;
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        const size_t count = std::min(maxTables, _tables.size());
+        uris.reserve(count);
+        auto it = _tables.upper_bound(_lastSampledUri);
+        while (uris.size() < count) {
+            if (it == _tables.end()) {
+                it = _tables.begin();
+            }
+            uris.push_back(it->first);
+            ++it;
+        }
+    }
+
+    std::vector<boost::optional<Sample>> samples;
+    samples.reserve(uris.size());
+    for (const auto& uri : uris) {
+        samples.push_back(readSample(session, uri));
+    }
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    for (size_t i = 0; i < uris.size(); ++i) {
+        auto it = _tables.find(uris[i]);
+        if (it == _tables.end() || !samples[i]) {
+            continue;
+        }
+
+        auto& sample = *samples[i];
+        const auto& previous = it->second.sample;
+        if (previous && sample.pagesRequested >= previous->pagesRequested &&
+            sample.pagesReadIntoCache >= previous->pagesReadIntoCache) {
+            const auto requested = sample.pagesRequested - previous->pagesRequested;
+            const auto read = sample.pagesReadIntoCache - previous->pagesReadIntoCache;
+            if (requested > 0) {
+                sample.hitRatio =
+                    1.0 - std::min(1.0, static_cast<double>(read) / static_cast<double>(requested));
+            } else {
+                // Nothing was requested, so carry the last known ratio forward.
+                sample.hitRatio = previous->hitRatio;
+            }
+        }
+        // Otherwise this is the first sample, or WiredTiger reopened the table and reset its
+        // counters; either way there is no interval to compute a ratio over.
+        it->second.sample = std::move(sample);
+    }
+
+    if (!uris.empty()) {
+        _lastSampledUri = uris.back();
+    }
+
+    std::vector<const Table*> sampled;
+    for (const auto& entry : _tables) {
+        if (entry.second.sample) {
+            sampled.push_back(&entry.second);
+        }
+    }
+    const auto top = std::min(topN, sampled.size());
+    std::partial_sort(
+        sampled.begin(), sampled.begin() + top, sampled.end(), [](const Table* a, const Table* b) {
+            return a->sample->bytesInCache > b->sample->bytesInCache;
+        });
+    _top.clear();
+    for (size_t i = 0; i < top; ++i) {
+        _top.emplace_back(sampled[i]->label, *sampled[i]->sample);
+    }
+
+    ++_passes;
+    _lastPassTables = uris.size();
+    _lastPassMicros = timer.micros();
+    return uris.size();
+}
+
+bool WiredTigerCacheResidency::appendSample(const std::string& uri,
+                                            BSONObjBuilder* builder) const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    auto it = _tables.find(uri);
+    if (it == _tables.end() || !it->second.sample) {
+        return false;
+    }
+    it->second.sample->append(builder);
+    return true;
+}
+
+void WiredTigerCacheResidency::appendServerStatus(BSONObjBuilder* builder) const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    builder->append("tables", static_cast<long long>(_tables.size()));
+    builder->append("passes", _passes);
+    builder->append("lastPassTables", _lastPassTables);
+    builder->append("lastPassMicros", _lastPassMicros);
+
+    // FTDC keeps numbers as integers and so drops 'hitRatio'; the page counters let tooling
+    // compute it over any interval instead. The top tables are listed by rank rather than by
+    // label, so that FTDC sees the same field names whichever tables are on top.
+    BSONObjBuilder topBuilder(builder->subobjStart("top"));
+    for (size_t rank = 0; rank < _top.size(); ++rank) {
+        BSONObjBuilder tableBuilder(topBuilder.subobjStart(std::to_string(rank)));
+        tableBuilder.append("ns", _top[rank].first);
+        _top[rank].second.append(&tableBuilder);
+    }
+}
+
+}  // namespace mongo
@@ -0,0 +1,132 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include <wiredtiger.h>
+
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+/**
+ * Tracks how much of each collection and index table is resident in the WiredTiger cache.
+ *
+ * The KV engine registers tables with the namespace they belong to as it opens them, relabels them
+ * when their collection is renamed, and a background thread periodically calls sample() to read a
+ * handful of cache statistics from each table's statistics cursor. Only the latest sample of a
+ * table is kept. Samples are reported through collStats, $indexStats and the
+ * "wiredTigerCacheResidency" serverStatus section.
+ */
+class WiredTigerCacheResidency {
+public:
+    /**
+     * The cache statistics of one table at one point in time. The page counters are cumulative
+     * since WiredTiger opened the table.
+     */
+    struct Sample {
+        void append(BSONObjBuilder* builder) const;
+
+        Date_t sampledAt;
+        long long bytesInCache = 0;
+        long long bytesDirty = 0;
+        long long pagesReadIntoCache = 0;
+        long long pagesRequested = 0;
+        long long pagesEvicted = 0;
+
+        // The fraction of page requests between the previous sample and this one that did not
+        // have to read the page into the cache. Unset until a table has seen requests between two
+        // samples.
+        boost::optional<double> hitRatio;
+    };
+
+    /**
+     * Starts tracking the table at 'uri'. Indexes pass the name of the index in 'indexName'.
+     * Registering a table again replaces its namespace and discards its sample.
+     */
+    void registerTable(const std::string& uri, StringData ns, StringData indexName = StringData());
+
+    /**
+     * Changes the namespace of the table at 'uri', if it is tracked, keeping its sample. Called
+     * when its collection is renamed. The top tables pick up the new label on the next pass.
+     */
+    void relabelTable(const std::string& uri, StringData ns, StringData indexName = StringData());
+
+    void unregisterTable(const std::string& uri);
+
+    /**
+     * Samples at most 'maxTables' tables, continuing in uri order after the last table sampled by
+     * the previous pass and wrapping around, then recomputes the 'topN' tables with the most bytes
+     * in cache. No lock is held while statistics cursors are open. Returns the number of tables
+     * sampled.
+     */
+    size_t sample(WT_SESSION* session, size_t maxTables, size_t topN);
+
+    /**
+     * Appends the latest sample of the table at 'uri' to 'builder'. Returns false, appending
+     * nothing, if the table has not been sampled yet.
+     */
+    bool appendSample(const std::string& uri, BSONObjBuilder* builder) const;
+
+    /**
+     * Appends statistics about the sampling itself and the top tables of the last pass, under
+     * "top.0", "top.1" and so on in order of bytes in cache, each with its label as "ns".
+     */
+    void appendServerStatus(BSONObjBuilder* builder) const;
+
+private:
+    struct Table {
+        // The namespace, or "<namespace>.$<index name>" for an index.
+        std::string label;
+        boost::optional<Sample> sample;
+    };
+
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("WiredTigerCacheResidency::_mutex");
+
+    // Ordered by uri so that a pass can resume after the last table sampled.
+    std::map<std::string, Table> _tables;
+    std::string _lastSampledUri;
+
+    long long _passes = 0;
+    long long _lastPassTables = 0;
+    long long _lastPassMicros = 0;
+
+    // Labels and samples of the tables with the most bytes in cache as of the last pass.
+    std::vector<std::pair<std::string, Sample>> _top;
+};
+
+}  // namespace mongo
@@ -49,6 +49,7 @@
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_customization_hooks.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_global_options.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
@@ -373,9 +374,20 @@ bool WiredTigerIndex::appendCustomStats(OperationContext* opCtx,
         output->append("code", static_cast<int>(status.code()));
         output->append("reason", status.reason());
     }
+
+    BSONObjBuilder cacheResidency;
+    if (appendCacheResidencyStats(opCtx, &cacheResidency)) {
+        output->append("cacheResidency", cacheResidency.obj());
+    }
     return true;
 }
 
+bool WiredTigerIndex::appendCacheResidencyStats(OperationContext* opCtx,
+                                                BSONObjBuilder* output) const {
+    auto engine = WiredTigerRecoveryUnit::get(opCtx)->getSessionCache()->getKVEngine();
+    return engine && engine->getCacheResidency()->appendSample(_uri, output);
+}
+
 Status WiredTigerIndex::dupKeyCheck(OperationContext* opCtx, const KeyString::Value& key) {
     invariant(unique());
 
@@ -488,13 +500,15 @@ Status WiredTigerIndex::initAsEmpty(OperationContext* opCtx) {
     return Status::OK();
 }
 
-Status WiredTigerIndex::compact(OperationContext* opCtx) {
+Status WiredTigerIndex::compact(OperationContext* opCtx, boost::optional<Seconds> timeout) {
     dassert(opCtx->lockState()->isWriteLocked());
     WiredTigerSessionCache* cache = WiredTigerRecoveryUnit::get(opCtx)->getSessionCache();
     if (!cache->isEphemeral()) {
         WT_SESSION* s = WiredTigerRecoveryUnit::get(opCtx)->getSession()->getSession();
         opCtx->recoveryUnit()->abandonSnapshot();
-        int ret = s->compact(s, uri().c_str(), "timeout=0");
+        const std::string config = str::stream()
+            << "timeout=" << (timeout ? durationCount<Seconds>(*timeout) : 0);
+        int ret = s->compact(s, uri().c_str(), config.c_str());
         if (MONGO_unlikely(WTCompactIndexEBUSY.shouldFail())) {
             ret = EBUSY;
         }
@@ -504,6 +518,10 @@ Status WiredTigerIndex::compact(OperationContext* opCtx) {
                           str::stream() << "Compaction interrupted on " << uri().c_str()
                                         << " due to cache eviction pressure");
         }
+        if (ret == ETIMEDOUT) {
+            return Status(ErrorCodes::ExceededTimeLimit,
+                          str::stream() << "Compaction of " << uri().c_str() << " timed out");
+        }
         invariantWTOK(ret);
     }
     return Status::OK();
@@ -105,6 +105,7 @@ public:
     virtual bool appendCustomStats(OperationContext* opCtx,
                                    BSONObjBuilder* output,
                                    double scale) const;
+    bool appendCacheResidencyStats(OperationContext* opCtx, BSONObjBuilder* output) const override;
     virtual Status dupKeyCheck(OperationContext* opCtx, const KeyString::Value& keyString);
 
     virtual bool isEmpty(OperationContext* opCtx);
@@ -113,7 +114,7 @@ public:
 
     virtual Status initAsEmpty(OperationContext* opCtx);
 
-    virtual Status compact(OperationContext* opCtx);
+    virtual Status compact(OperationContext* opCtx, boost::optional<Seconds> timeout);
 
     const std::string& uri() const {
         return _uri;
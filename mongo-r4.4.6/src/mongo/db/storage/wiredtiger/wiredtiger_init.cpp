@@ -122,10 +122,16 @@ public:
             // Intentionally leaked.
             MONGO_COMPILER_VARIABLE_UNUSED auto leakedSection =
                 new WiredTigerServerStatusSection(kv);
+            MONGO_COMPILER_VARIABLE_UNUSED auto leakedCacheSection =
+                new WiredTigerCacheServerStatusSection();
+            MONGO_COMPILER_VARIABLE_UNUSED auto leakedCacheResidencySection =
+                new WiredTigerCacheResidencyServerStatusSection(kv);
 
             // This allows unit tests to run this code without encountering memory leaks
 #if __has_feature(address_sanitizer)
             __lsan_ignore_object(leakedSection);
+            __lsan_ignore_object(leakedCacheSection);
+            __lsan_ignore_object(leakedCacheResidencySection);
 #endif
         }
 
@@ -239,6 +239,63 @@ private:
     stdx::condition_variable _condvar;
 };
 
+class WiredTigerKVEngine::WiredTigerCacheResidencySampler : public BackgroundJob {
+public:
+    explicit WiredTigerCacheResidencySampler(WT_CONNECTION* conn,
+                                             WiredTigerCacheResidency* cacheResidency)
+        : BackgroundJob(false /* deleteSelf */), _conn(conn), _cacheResidency(cacheResidency) {}
+
+    virtual string name() const {
+        return "WTCacheResidencySampler";
+    }
+
+    virtual void run() {
+        ThreadClient tc(name(), getGlobalServiceContext());
+        LOGV2_DEBUG(5600140, 1, "starting {name} thread", "name"_attr = name());
+
+        while (!_shuttingDown.load()) {
+            {
+                stdx::unique_lock<Latch> lock(_mutex);
+                MONGO_IDLE_THREAD_BLOCK;
+                // The interval is adjustable at runtime, so even when sampling is disabled wake up
+                // periodically to check whether it has been enabled.
+                const auto intervalSecs = gWiredTigerCacheResidencySampleIntervalSecs.load();
+                _condvar.wait_for(lock,
+                                  stdx::chrono::seconds(intervalSecs > 0 ? intervalSecs : 10),
+                                  [&] { return _shuttingDown.load(); });
+            }
+
+            if (_shuttingDown.load() || gWiredTigerCacheResidencySampleIntervalSecs.load() == 0) {
+                continue;
+            }
+
+            WiredTigerSession session(_conn);
+            _cacheResidency->sample(session.getSession(),
+                                    gWiredTigerCacheResidencyMaxTablesPerPass.load(),
+                                    gWiredTigerCacheResidencyReportTopN.load());
+        }
+        LOGV2_DEBUG(5600141, 1, "stopping {name} thread", "name"_attr = name());
+    }
+
+    void shutdown() {
+        _shuttingDown.store(true);
+        {
+            stdx::unique_lock<Latch> lock(_mutex);
+            _condvar.notify_one();
+        }
+        wait();
+    }
+
+private:
+    WT_CONNECTION* _conn;
+    WiredTigerCacheResidency* _cacheResidency;
+    AtomicWord<bool> _shuttingDown{false};
+
+    // Protects _condvar, on which the sampler idles between passes.
+    Mutex _mutex = MONGO_MAKE_LATCH("WiredTigerCacheResidencySampler::_mutex");
+    stdx::condition_variable _condvar;
+};
+
 std::string toString(const StorageEngine::OldestActiveTransactionTimestampResult& r) {
     if (r.isOK()) {
         if (r.getValue()) {
@@ -842,6 +899,10 @@ WiredTigerKVEngine::~WiredTigerKVEngine() {
 }
 
 void WiredTigerKVEngine::startAsyncThreads() {
+    _cacheResidencySampler =
+        std::make_unique<WiredTigerCacheResidencySampler>(_conn, &_cacheResidency);
+    _cacheResidencySampler->go();
+
     if (!_ephemeral) {
         if (!_readOnly) {
             _checkpointThread =
@@ -982,6 +1043,11 @@ void WiredTigerKVEngine::cleanShutdown() {
         _sessionSweeper->shutdown();
         LOGV2(22319, "Finished shutting down session sweeper thread");
     }
+    if (_cacheResidencySampler) {
+        LOGV2(5600142, "Shutting down cache residency sampler thread");
+        _cacheResidencySampler->shutdown();
+        LOGV2(5600143, "Finished shutting down cache residency sampler thread");
+    }
     if (_checkpointThread) {
         LOGV2(22322, "Shutting down checkpoint thread");
         _checkpointThread->shutdown();
@@ -1555,6 +1621,8 @@ std::unique_ptr<RecordStore> WiredTigerKVEngine::getGroupedRecordStore(
     }
     ret->postConstructorInit(opCtx);
 
+    _cacheResidency.registerTable(_uri(ident), ns);
+
     // Sizes should always be checked when creating a collection during rollback or replication
     // recovery. This is in case the size storer information is no longer accurate. This may be
     // necessary if capped deletes are rolled-back, if rollback occurs across a collection rename,
@@ -1614,6 +1682,8 @@ Status WiredTigerKVEngine::createGroupedSortedDataInterface(OperationContext* op
 
 std::unique_ptr<SortedDataInterface> WiredTigerKVEngine::getGroupedSortedDataInterface(
     OperationContext* opCtx, StringData ident, const IndexDescriptor* desc, KVPrefix prefix) {
+    _cacheResidency.registerTable(_uri(ident), desc->parentNS().ns(), desc->indexName());
+
     if (desc->unique()) {
         return std::make_unique<WiredTigerIndexUnique>(opCtx, _uri(ident), desc, prefix, _readOnly);
     }
@@ -1681,8 +1751,15 @@ void WiredTigerKVEngine::alterIdentMetadata(OperationContext* opCtx,
         session.getSession()->alter(session.getSession(), uri.c_str(), alterString.c_str()));
 }
 
+void WiredTigerKVEngine::setIdentNamespace(StringData ident,
+                                           const NamespaceString& nss,
+                                           StringData indexName) {
+    _cacheResidency.relabelTable(_uri(ident), nss.ns(), indexName);
+}
+
 Status WiredTigerKVEngine::dropIdent(OperationContext* opCtx, RecoveryUnit* ru, StringData ident) {
     string uri = _uri(ident);
+    _cacheResidency.unregisterTable(uri);
 
     WiredTigerRecoveryUnit* wtRu = checked_cast<WiredTigerRecoveryUnit*>(ru);
     wtRu->getSessionNoTxn()->closeAllCursors(uri);
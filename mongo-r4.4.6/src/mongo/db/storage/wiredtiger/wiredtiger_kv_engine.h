@@ -42,6 +42,7 @@
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/storage/kv/kv_engine.h"
 #include "mongo/db/storage/storage_engine.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_cache_residency.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_oplog_manager.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
@@ -175,6 +176,10 @@ public:
                             StringData ident,
                             const IndexDescriptor* desc) override;
 
+    void setIdentNamespace(StringData ident,
+                           const NamespaceString& nss,
+                           StringData indexName) override;
+
     Status okToRename(OperationContext* opCtx,
                       StringData fromNS,
                       StringData toNS,
@@ -307,6 +312,13 @@ public:
         return _oplogManager.get();
     }
 
+    /*
+     * Tracks the cache residency of every collection and index table this engine has opened.
+     */
+    WiredTigerCacheResidency* getCacheResidency() {
+        return &_cacheResidency;
+    }
+
     static void appendGlobalStats(BSONObjBuilder& b);
 
     Timestamp getStableTimestamp() const override;
@@ -355,6 +367,7 @@ public:
 private:
     class WiredTigerSessionSweeper;
     class WiredTigerCheckpointThread;
+    class WiredTigerCacheResidencySampler;
 
     /**
      * Opens a connection on the WiredTiger database 'path' with the configuration 'wtOpenConfig'.
@@ -442,8 +455,12 @@ private:
     // timestamp.
     const bool _keepDataHistory = true;
 
+    // Declared before its sampler thread, which must stop first.
+    WiredTigerCacheResidency _cacheResidency;
+
     std::unique_ptr<WiredTigerSessionSweeper> _sessionSweeper;
     std::unique_ptr<WiredTigerCheckpointThread> _checkpointThread;
+    std::unique_ptr<WiredTigerCacheResidencySampler> _cacheResidencySampler;
 
     std::string _rsOptions;
     std::string _indexOptions;
@@ -334,6 +334,67 @@ TEST_F(WiredTigerKVEngineTest, TestOplogTruncation) {
     assertPinnedMovesSoon(Timestamp(40, 1));
 }
 
+TEST_F(WiredTigerKVEngineTest, CacheResidencyIsSampledPerTable) {
+    auto opCtxPtr = _makeOperationContext();
+
+    NamespaceString nss("a.b");
+    std::string ident = "collection-cache-residency";
+    std::string record = "abcd";
+    CollectionOptions defaultCollectionOptions;
+
+    ASSERT_OK(
+        _engine->createRecordStore(opCtxPtr.get(), nss.ns(), ident, defaultCollectionOptions));
+    auto rs = _engine->getRecordStore(opCtxPtr.get(), nss.ns(), ident, defaultCollectionOptions);
+    ASSERT(rs);
+
+    RecordId loc;
+    {
+        WriteUnitOfWork uow(opCtxPtr.get());
+        StatusWith<RecordId> res =
+            rs->insertRecord(opCtxPtr.get(), record.c_str(), record.length() + 1, Timestamp());
+        ASSERT_OK(res.getStatus());
+        loc = res.getValue();
+        uow.commit();
+    }
+
+    auto cacheResidency = _engine->getCacheResidency();
+    WiredTigerSession session(_engine->getConnection());
+    ASSERT_EQ(1U, cacheResidency->sample(session.getSession(), 10, 10));
+
+    // The hit ratio needs page requests between two samples.
+    ASSERT_EQ(record, std::string(rs->dataFor(opCtxPtr.get(), loc).data()));
+    opCtxPtr->recoveryUnit()->abandonSnapshot();
+    ASSERT_EQ(1U, cacheResidency->sample(session.getSession(), 10, 10));
+
+    BSONObjBuilder sampleBuilder;
+    ASSERT(cacheResidency->appendSample("table:" + ident, &sampleBuilder));
+    auto sample = sampleBuilder.obj();
+    ASSERT_GT(sample["bytesInCache"].numberLong(), 0) << sample;
+    ASSERT_GT(sample["pagesRequested"].numberLong(), 0) << sample;
+    ASSERT(sample["hitRatio"].isNumber()) << sample;
+    ASSERT_LTE(sample["hitRatio"].numberDouble(), 1.0) << sample;
+
+    BSONObjBuilder serverStatusBuilder;
+    cacheResidency->appendServerStatus(&serverStatusBuilder);
+    auto serverStatus = serverStatusBuilder.obj();
+    ASSERT_EQ(1, serverStatus["tables"].numberLong()) << serverStatus;
+    ASSERT_EQ("a.b", serverStatus["top"]["0"]["ns"].str()) << serverStatus;
+
+    // A rename relabels the table and keeps its sample.
+    _engine->setIdentNamespace(ident, NamespaceString("a.c"), StringData());
+    BSONObjBuilder renamedSampleBuilder;
+    ASSERT(cacheResidency->appendSample("table:" + ident, &renamedSampleBuilder));
+    ASSERT_EQ(1U, cacheResidency->sample(session.getSession(), 10, 10));
+    BSONObjBuilder renamedBuilder;
+    cacheResidency->appendServerStatus(&renamedBuilder);
+    auto renamed = renamedBuilder.obj();
+    ASSERT_EQ("a.c", renamed["top"]["0"]["ns"].str()) << renamed;
+
+    rs.reset();
+    ASSERT_OK(_engine->dropIdent(opCtxPtr.get(), opCtxPtr.get()->recoveryUnit(), ident));
+    ASSERT_EQ(0U, cacheResidency->sample(session.getSession(), 10, 10));
+}
+
 std::unique_ptr<KVHarnessHelper> makeHelper(ServiceContext* svcCtx) {
     return std::make_unique<WiredTigerKVHarnessHelper>(svcCtx);
 }
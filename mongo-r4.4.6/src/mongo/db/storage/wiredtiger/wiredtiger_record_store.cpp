@@ -1760,14 +1760,17 @@ Status WiredTigerRecordStore::truncate(OperationContext* opCtx) {
     return Status::OK();
 }
 
-Status WiredTigerRecordStore::compact(OperationContext* opCtx) {
+Status WiredTigerRecordStore::compact(OperationContext* opCtx,
+                                     boost::optional<Seconds> timeout) {
     dassert(opCtx->lockState()->isWriteLocked());
 
     WiredTigerSessionCache* cache = WiredTigerRecoveryUnit::get(opCtx)->getSessionCache();
     if (!cache->isEphemeral()) {
         WT_SESSION* s = WiredTigerRecoveryUnit::get(opCtx)->getSession()->getSession();
         opCtx->recoveryUnit()->abandonSnapshot();
-        int ret = s->compact(s, getURI().c_str(), "timeout=0");
+        const std::string config = str::stream()
+            << "timeout=" << (timeout ? durationCount<Seconds>(*timeout) : 0);
+        int ret = s->compact(s, getURI().c_str(), config.c_str());
         if (MONGO_unlikely(WTCompactRecordStoreEBUSY.shouldFail())) {
             ret = EBUSY;
         }
@@ -1777,6 +1780,10 @@ Status WiredTigerRecordStore::compact(OperationContext* opCtx) {
                           str::stream() << "Compaction interrupted on " << getURI().c_str()
                                         << " due to cache eviction pressure");
         }
+        if (ret == ETIMEDOUT) {
+            return Status(ErrorCodes::ExceededTimeLimit,
+                          str::stream() << "Compaction of " << getURI().c_str() << " timed out");
+        }
         invariantWTOK(ret);
     }
     return Status::OK();
@@ -1872,6 +1879,13 @@ void WiredTigerRecordStore::appendCustomStats(OperationContext* opCtx,
         bob.append("code", static_cast<int>(status.code()));
         bob.append("reason", status.reason());
     }
+
+    if (_kvEngine) {
+        BSONObjBuilder cacheResidency;
+        if (_kvEngine->getCacheResidency()->appendSample(getURI(), &cacheResidency)) {
+            bob.append("cacheResidency", cacheResidency.obj());
+        }
+    }
 }
 
 void WiredTigerRecordStore::waitForAllEarlierOplogWritesToBeVisible(OperationContext* opCtx) const {
@@ -2043,6 +2057,45 @@ void WiredTigerRecordStore::_increaseDataSize(OperationContext* opCtx, int64_t a
         _sizeStorer->store(_uri, _sizeInfo);
 }
 
+void WiredTigerRecordStore::deleteRecordRange(OperationContext* opCtx,
+                                              const RecordId& first,
+                                              const RecordId& last) {
+    dassert(opCtx->lockState()->isWriteLocked());
+    invariant(opCtx->lockState()->inAWriteUnitOfWork());
+    invariant(!isCapped());
+    invariant(first <= last);
+    // Initialize the next record id counter before deleting, as in deleteRecord().
+    _initNextIdIfNeeded(opCtx);
+
+    // Compute the number and associated sizes of the records to delete.
+    int64_t recordsRemoved = 0;
+    int64_t bytesRemoved = 0;
+    {
+        auto cursor = getCursor(opCtx, true);
+        for (auto record = cursor->seekExact(first); record && record->id <= last;
+             record = cursor->next()) {
+            recordsRemoved++;
+            bytesRemoved += record->data.size();
+        }
+    }
+    if (recordsRemoved == 0) {
+        return;
+    }
+
+    WiredTigerCursor startWrap(_uri, _tableId, true, opCtx);
+    WT_CURSOR* start = startWrap.get();
+    setKey(start, first);
+    WiredTigerCursor stopWrap(_uri, _tableId, true, opCtx);
+    WT_CURSOR* stop = stopWrap.get();
+    setKey(stop, last);
+
+    WT_SESSION* session = WiredTigerRecoveryUnit::get(opCtx)->getSession()->getSession();
+    invariantWTOK(WT_OP_CHECK(session->truncate(session, nullptr, start, stop, nullptr)));
+
+    _changeNumRecords(opCtx, -recordsRemoved);
+    _increaseDataSize(opCtx, -bytesRemoved);
+}
+
 void WiredTigerRecordStore::cappedTruncateAfter(OperationContext* opCtx,
                                                 RecordId end,
                                                 bool inclusive) {
@@ -2264,6 +2317,19 @@ boost::optional<Record> WiredTigerRecordStoreCursorBase::seekExact(const RecordI
     return {{id, {static_cast<const char*>(value.data), static_cast<int>(value.size)}}};
 }
 
+boost::optional<Record> WiredTigerRecordStoreCursorBase::seekAfter(const RecordId& id) {
+    invariant(_hasRestored);
+
+    // Restoring a cursor which last returned 'id' positions it so that next() returns the first
+    // record after 'id', even if 'id' itself no longer exists.
+    save();
+    _lastReturnedId = id;
+    _eof = false;
+    if (!restore()) {
+        return {};
+    }
+    return next();
+}
 
 void WiredTigerRecordStoreCursorBase::save() {
     try {
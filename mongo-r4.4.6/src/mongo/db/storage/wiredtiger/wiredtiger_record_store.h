@@ -181,7 +181,7 @@ public:
 
     virtual Timestamp getPinnedOplog() const final;
 
-    virtual Status compact(OperationContext* opCtx) final;
+    virtual Status compact(OperationContext* opCtx, boost::optional<Seconds> timeout) final;
 
     virtual bool isInRecordIdOrder() const override {
         return true;
@@ -197,6 +197,10 @@ public:
 
     virtual void cappedTruncateAfter(OperationContext* opCtx, RecordId end, bool inclusive);
 
+    void deleteRecordRange(OperationContext* opCtx,
+                           const RecordId& first,
+                           const RecordId& last) override;
+
     virtual boost::optional<RecordId> oplogStartHack(OperationContext* opCtx,
                                                      const RecordId& startingPosition) const;
 
@@ -445,6 +449,8 @@ public:
 
     boost::optional<Record> seekExact(const RecordId& id);
 
+    boost::optional<Record> seekAfter(const RecordId& id);
+
     void save();
 
     void saveUnpositioned();
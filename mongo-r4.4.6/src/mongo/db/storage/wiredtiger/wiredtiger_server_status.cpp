@@ -92,4 +92,47 @@ BSONObj WiredTigerServerStatusSection::generateSection(OperationContext* opCtx,
     return bob.obj();
 }
 
+WiredTigerCacheServerStatusSection::WiredTigerCacheServerStatusSection()
+    : ServerStatusSection("wiredTigerCache") {}
+
+bool WiredTigerCacheServerStatusSection::includeByDefault() const {
+    return false;
+}
+
+BSONObj WiredTigerCacheServerStatusSection::generateSection(
+    OperationContext* opCtx, const BSONElement& configElement) const {
+    Lock::GlobalLock lk(opCtx, LockMode::MODE_IS);
+
+    // As for the "wiredTiger" section, no transaction is opened.
+    WiredTigerSession* session = WiredTigerRecoveryUnit::get(opCtx)->getSessionNoTxn();
+    invariant(session);
+
+    BSONObjBuilder bob;
+    Status status = WiredTigerUtil::exportStatisticsCategoryToBSON(
+        session->getSession(), "statistics:", "statistics=(fast)", "cache", &bob);
+    if (!status.isOK()) {
+        bob.append("error", "unable to retrieve statistics");
+        bob.append("code", static_cast<int>(status.code()));
+        bob.append("reason", status.reason());
+    }
+    return bob.obj();
+}
+
+WiredTigerCacheResidencyServerStatusSection::WiredTigerCacheResidencyServerStatusSection(
+    WiredTigerKVEngine* engine)
+    : ServerStatusSection("wiredTigerCacheResidency"), _engine(engine) {}
+
+bool WiredTigerCacheResidencyServerStatusSection::includeByDefault() const {
+    return true;
+}
+
+BSONObj WiredTigerCacheResidencyServerStatusSection::generateSection(
+    OperationContext* opCtx, const BSONElement& configElement) const {
+    // Only reports the samples already taken, so unlike the "wiredTiger" section no lock or
+    // WiredTiger session is needed.
+    BSONObjBuilder bob;
+    _engine->getCacheResidency()->appendServerStatus(&bob);
+    return bob.obj();
+}
+
 }  // namespace mongo
@@ -50,4 +50,32 @@ private:
     WiredTigerKVEngine* _engine;
 };
 
+/**
+ * Adds "wiredTigerCache" to the results of db.serverStatus() when requested: only the cache
+ * statistics of the "wiredTiger" section, for samplers which read them far more often than the
+ * whole section could be generated.
+ */
+class WiredTigerCacheServerStatusSection : public ServerStatusSection {
+public:
+    WiredTigerCacheServerStatusSection();
+    bool includeByDefault() const override;
+    BSONObj generateSection(OperationContext* opCtx,
+                            const BSONElement& configElement) const override;
+};
+
+/**
+ * Adds "wiredTigerCacheResidency" to the results of db.serverStatus(): the tables with the most
+ * bytes in the WiredTiger cache as of the last cache residency sampling pass.
+ */
+class WiredTigerCacheResidencyServerStatusSection : public ServerStatusSection {
+public:
+    WiredTigerCacheResidencyServerStatusSection(WiredTigerKVEngine* engine);
+    bool includeByDefault() const override;
+    BSONObj generateSection(OperationContext* opCtx,
+                            const BSONElement& configElement) const override;
+
+private:
+    WiredTigerKVEngine* _engine;
+};
+
 }  // namespace mongo
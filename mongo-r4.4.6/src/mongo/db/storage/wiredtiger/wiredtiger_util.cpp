@@ -889,6 +889,38 @@ Status WiredTigerUtil::exportTableToBSON(WT_SESSION* session,
     return Status::OK();
 }
 
+Status WiredTigerUtil::exportStatisticsCategoryToBSON(WT_SESSION* session,
+                                                      const std::string& uri,
+                                                      const std::string& config,
+                                                      StringData category,
+                                                      BSONObjBuilder* bob) {
+    invariant(session);
+    invariant(bob);
+    WT_CURSOR* c = nullptr;
+    const char* cursorConfig = config.empty() ? nullptr : config.c_str();
+    int ret = session->open_cursor(session, uri.c_str(), nullptr, cursorConfig, &c);
+    if (ret != 0) {
+        return Status(ErrorCodes::CursorNotFound,
+                      str::stream() << "unable to open cursor at URI " << uri
+                                    << ". reason: " << wiredtiger_strerror(ret));
+    }
+    invariant(c);
+    ON_BLOCK_EXIT([&] { c->close(c); });
+
+    const std::string prefix = category + ":";
+    const char* desc;
+    uint64_t value;
+    while (c->next(c) == 0 && c->get_value(c, &desc, nullptr, &value) == 0) {
+        StringData key(desc);
+        if (!key.startsWith(prefix)) {
+            continue;
+        }
+        bob->appendNumber(str::ltrim(key.substr(prefix.size()).toString()),
+                          castStatisticsValue<long long>(value));
+    }
+    return Status::OK();
+}
+
 void WiredTigerUtil::appendSnapshotWindowSettings(WiredTigerKVEngine* engine,
                                                   WiredTigerSession* session,
                                                   BSONObjBuilder* bob) {
@@ -153,6 +153,17 @@ public:
                                     BSONObjBuilder* bob,
                                     const std::vector<std::string>& filter);
 
+    /**
+     * Reads the statistics of 'category', such as "cache", from the statistics table at 'uri' and
+     * exports them to BSON, named as exportTableToBSON() names them within their category's
+     * sub-object. Skips every other statistic.
+     */
+    static Status exportStatisticsCategoryToBSON(WT_SESSION* s,
+                                                 const std::string& uri,
+                                                 const std::string& config,
+                                                 StringData category,
+                                                 BSONObjBuilder* bob);
+
     /**
      * Appends information about the storage engine's currently available snapshots and the settings
      * that affect that window of maintained history.
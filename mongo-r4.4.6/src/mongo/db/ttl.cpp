@@ -33,18 +33,23 @@
 
 #include "mongo/db/ttl.h"
 
+#include <deque>
+#include <map>
+
 #include "mongo/base/counter.h"
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/auth/user_name.h"
+#include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/database_holder.h"
 #include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/client.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/commands/fsync_locked.h"
 #include "mongo/db/commands/server_status_metric.h"
-#include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/exec/delete.h"
+#include "mongo/db/index/index_access_method.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/ops/insert.h"
@@ -52,11 +57,14 @@
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/durable_catalog.h"
+#include "mongo/db/storage/index_entry_comparison.h"
 #include "mongo/db/ttl_collection_cache.h"
 #include "mongo/db/ttl_gen.h"
 #include "mongo/logv2/log.h"
+#include "mongo/platform/mutex.h"
 #include "mongo/util/background.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/exit.h"
 
 namespace mongo {
@@ -70,6 +78,267 @@ ServerStatusMetricField<Counter64> ttlPassesDisplay("ttl.passes", &ttlPasses);
 ServerStatusMetricField<Counter64> ttlDeletedDocumentsDisplay("ttl.deletedDocuments",
                                                               &ttlDeletedDocuments);
 
+namespace {
+
+const Date_t kDawnOfTime = Date_t::fromMillisSinceEpoch(std::numeric_limits<long long>::min());
+
+// A rough size for the oplog entry of a TTL delete, excluding the namespace: the entry's fixed
+// fields plus a typical _id.
+const long long kEstimatedDeleteOplogEntryBytes = 128;
+
+/**
+ * The deletion statistics of each TTL index, reported under serverStatus.metrics.ttl.indexes.
+ */
+class TTLIndexStats {
+public:
+    struct Entry {
+        NamespaceString nss;
+        std::string indexName;
+        long long deletedDocuments = 0;
+
+        // An estimate of the number of expired documents the index still has to delete, as of the
+        // last batch deleted from it.
+        long long backlogEstimate = 0;
+    };
+
+    void recordBatch(const NamespaceString& nss,
+                     const std::string& indexName,
+                     long long deleted,
+                     long long backlogEstimate) {
+        stdx::lock_guard<Latch> lk(_mutex);
+        auto& entry = _entries[nss.ns() + '.' + indexName];
+        entry.nss = nss;
+        entry.indexName = indexName;
+        entry.deletedDocuments += deleted;
+        entry.backlogEstimate = backlogEstimate;
+    }
+
+    /**
+     * Forgets the indexes which are not in 'liveIndexes', given as namespace and index spec.
+     */
+    void retainOnly(const std::vector<std::pair<NamespaceString, BSONObj>>& liveIndexes) {
+        std::set<std::string> live;
+        for (auto&& index : liveIndexes) {
+            live.insert(index.first.ns() + '.' + index.second["name"].str());
+        }
+
+        stdx::lock_guard<Latch> lk(_mutex);
+        for (auto it = _entries.begin(); it != _entries.end();) {
+            it = live.count(it->first) ? std::next(it) : _entries.erase(it);
+        }
+    }
+
+    void append(BSONObjBuilder& b, StringData fieldName) const {
+        BSONArrayBuilder indexes(b.subarrayStart(fieldName));
+        stdx::lock_guard<Latch> lk(_mutex);
+        for (auto&& [key, entry] : _entries) {
+            BSONObjBuilder index(indexes.subobjStart());
+            index.append("ns", entry.nss.ns());
+            index.append("name", entry.indexName);
+            index.append("deletedDocuments", entry.deletedDocuments);
+            index.append("backlogEstimate", entry.backlogEstimate);
+        }
+    }
+
+private:
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("TTLIndexStats::_mutex");
+    std::map<std::string, Entry> _entries;
+};
+
+TTLIndexStats ttlIndexStats;
+
+class TTLIndexStatsMetric : public ServerStatusMetric {
+public:
+    TTLIndexStatsMetric() : ServerStatusMetric("ttl.indexes") {}
+
+    void appendAtLeaf(BSONObjBuilder& b) const override {
+        ttlIndexStats.append(b, _leafName);
+    }
+} ttlIndexStatsMetric;
+
+/**
+ * Limits how fast the TTL monitor deletes documents and generates oplog entries, across all of its
+ * workers, by allotting a budget of deletes and oplog bytes to each one-second window. Workers
+ * reserve their share of the budget before deleting, so that concurrent batches cannot overshoot
+ * it. A window which is overdrawn passes its debt on to the following windows.
+ */
+class TTLDeleteBudget {
+public:
+    /**
+     * Blocks until the current window has budget left, then reserves it for up to 'maxDeletes'
+     * deletes whose oplog entries take 'oplogBytesPerDelete' each. Returns the number of deletes
+     * reserved, which is always at least one, or throws if 'opCtx' is interrupted.
+     */
+    long long reserve(OperationContext* opCtx,
+                      long long maxDeletes,
+                      long long oplogBytesPerDelete) {
+        auto clock = opCtx->getServiceContext()->getFastClockSource();
+        stdx::unique_lock<Latch> lk(_mutex);
+        while (true) {
+            const auto maxDeletesPerSecond = ttlMonitorMaxDeletesPerSecond.load();
+            const auto maxOplogBytesPerSecond = ttlMonitorMaxOplogBytesPerSecond.load();
+
+            const auto now = clock->now();
+            if (now >= _windowStart + Seconds(1)) {
+                const auto windows = durationCount<Seconds>(now - _windowStart);
+                _deletes = maxDeletesPerSecond
+                    ? std::max(0LL, _deletes - windows * maxDeletesPerSecond)
+                    : 0;
+                _oplogBytes = maxOplogBytesPerSecond
+                    ? std::max(0LL, _oplogBytes - windows * maxOplogBytesPerSecond)
+                    : 0;
+                _windowStart = now;
+            }
+
+            long long reserved = maxDeletes;
+            if (maxDeletesPerSecond) {
+                reserved = std::min(reserved, maxDeletesPerSecond - _deletes);
+            }
+            if (maxOplogBytesPerSecond) {
+                // A single delete may cost more than a whole window allows; it is let through
+                // once the window is clear, and the debt is paid off by the following windows.
+                const auto oplogBytesLeft = maxOplogBytesPerSecond - _oplogBytes;
+                reserved = std::min(
+                    reserved,
+                    oplogBytesLeft < oplogBytesPerDelete && _oplogBytes == 0
+                        ? 1
+                        : oplogBytesLeft / oplogBytesPerDelete);
+            }
+            if (reserved > 0) {
+                _deletes += reserved;
+                _oplogBytes += reserved * oplogBytesPerDelete;
+                return reserved;
+            }
+
+            const auto windowEnd = _windowStart + Seconds(1);
+            lk.unlock();
+            opCtx->sleepUntil(windowEnd);
+            lk.lock();
+        }
+    }
+
+    /**
+     * Returns the budget of 'deletes' reserved deletes which did not take place.
+     */
+    void release(long long deletes, long long oplogBytesPerDelete) {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _deletes = std::max(0LL, _deletes - deletes);
+        _oplogBytes = std::max(0LL, _oplogBytes - deletes * oplogBytesPerDelete);
+    }
+
+private:
+    Mutex _mutex = MONGO_MAKE_LATCH("TTLDeleteBudget::_mutex");
+    Date_t _windowStart;
+    long long _deletes = 0;
+    long long _oplogBytes = 0;
+};
+
+/**
+ * A TTL index with expired documents left to delete in the current pass.
+ */
+struct TTLIndexJob {
+    NamespaceString nss;
+    BSONObj spec;
+};
+
+/**
+ * Returns the oldest or newest date among the keys of the TTL index 'entry', if it has any.
+ */
+boost::optional<Date_t> findEdgeDate(OperationContext* opCtx,
+                                     const IndexCatalogEntry* entry,
+                                     bool ascendingKey,
+                                     bool oldest) {
+    auto sdi = entry->accessMethod()->getSortedDataInterface();
+
+    // Walk the index in the direction which visits dates in the order wanted.
+    const bool forward = ascendingKey == oldest;
+    auto cursor = entry->accessMethod()->newCursor(opCtx, forward);
+    const auto seekKey = IndexEntryComparison::makeKeyStringFromBSONKeyForSeek(
+        BSON("" << (oldest ? kDawnOfTime : Date_t::max())),
+        sdi->getKeyStringVersion(),
+        sdi->getOrdering(),
+        forward,
+        true);
+    auto keyEntry = cursor->seek(seekKey, SortedDataInterface::Cursor::kWantKey);
+    if (!keyEntry || keyEntry->key.firstElementType() != BSONType::Date) {
+        return boost::none;
+    }
+    return keyEntry->key.firstElement().date();
+}
+
+/**
+ * Estimates how many documents with a key no later than 'expirationTime' remain in the collection,
+ * by assuming that its documents' dates are spread evenly between the earliest and latest dates in
+ * the TTL index 'desc'.
+ */
+long long estimateBacklog(OperationContext* opCtx,
+                          Collection* collection,
+                          const IndexDescriptor* desc,
+                          Date_t expirationTime) {
+    const auto entry = collection->getIndexCatalog()->getEntry(desc);
+    const bool ascendingKey = desc->keyPattern().firstElement().number() >= 0;
+    const auto oldest = findEdgeDate(opCtx, entry, ascendingKey, true);
+    const auto newest = findEdgeDate(opCtx, entry, ascendingKey, false);
+    if (!oldest || !newest || *oldest > expirationTime) {
+        return 0;
+    }
+
+    const auto numRecords = static_cast<long long>(collection->numRecords(opCtx));
+    if (*newest <= expirationTime || *newest == *oldest) {
+        return numRecords;
+    }
+    const double expiredFraction = durationCount<Milliseconds>(expirationTime - *oldest) /
+        static_cast<double>(durationCount<Milliseconds>(*newest - *oldest));
+    return static_cast<long long>(numRecords * expiredFraction);
+}
+
+/**
+ * Deletes up to 'limit' documents from the start of 'collection', whose documents expire in the
+ * order they were inserted, stopping at the first document whose 'keyField' is not a date no later
+ * than 'expirationTime'. The documents are removed from the record store as one range rather than
+ * one at a time, so the deletes must not be replicated. Returns the number of documents deleted.
+ */
+long long deleteExpiredRange(OperationContext* opCtx,
+                             Collection* collection,
+                             StringData keyField,
+                             Date_t expirationTime,
+                             long long limit) {
+    return writeConflictRetry(opCtx, "ttlRangeDelete", collection->ns().ns(), [&] {
+        WriteUnitOfWork wuow(opCtx);
+
+        RecordId first;
+        RecordId last;
+        long long numExpired = 0;
+        {
+            auto cursor = collection->getCursor(opCtx);
+            while (numExpired < limit) {
+                auto record = cursor->next();
+                if (!record) {
+                    break;
+                }
+                const auto elt =
+                    dotted_path_support::extractElementAtPath(record->data.toBson(), keyField);
+                if (elt.type() != BSONType::Date || elt.date() > expirationTime) {
+                    break;
+                }
+                if (first.isNull()) {
+                    first = record->id;
+                }
+                last = record->id;
+                ++numExpired;
+            }
+        }
+
+        if (numExpired > 0) {
+            collection->deleteDocumentRange(opCtx, first, last, nullptr);
+        }
+        wuow.commit();
+        return numExpired;
+    });
+}
+
+}  // namespace
+
 class TTLMonitor : public BackgroundJob {
 public:
     TTLMonitor(ServiceContext* serviceContext) : _serviceContext(serviceContext) {}
@@ -88,11 +357,15 @@ public:
             tc.get()->setSystemOperationKillable(lk);
         }
 
+        // Whether the last pass ended with expired documents left to delete, in which case the
+        // next one starts straight away.
+        bool passTruncated = false;
         while (!globalInShutdownDeprecated()) {
-            {
+            if (!passTruncated) {
                 MONGO_IDLE_THREAD_BLOCK;
                 sleepsecs(ttlMonitorSleepSecs.load());
             }
+            passTruncated = false;
 
             LOGV2_DEBUG(22528, 3, "thread awake");
 
@@ -109,7 +382,7 @@ public:
             }
 
             try {
-                doTTLPass();
+                passTruncated = doTTLPass();
             } catch (const WriteConflictException&) {
                 LOGV2_DEBUG(22531, 1, "got WriteConflictException");
             } catch (const ExceptionForCat<ErrorCategory::Interruption>& interruption) {
@@ -122,7 +395,11 @@ public:
     }
 
 private:
-    void doTTLPass() {
+    /**
+     * Deletes the expired documents of every TTL index. Returns true if the pass ran out of time
+     * before it was done.
+     */
+    bool doTTLPass() {
         const ServiceContext::UniqueOperationContext opCtxPtr = cc().makeOperationContext();
         OperationContext& opCtx = *opCtxPtr;
 
@@ -130,7 +407,7 @@ private:
         if (repl::ReplicationCoordinator::get(&opCtx)->getReplicationMode() ==
                 repl::ReplicationCoordinator::modeReplSet &&
             !repl::ReplicationCoordinator::get(&opCtx)->getMemberState().readable())
-            return;
+            return false;
 
         TTLCollectionCache& ttlCollectionCache = TTLCollectionCache::get(getGlobalServiceContext());
         std::vector<std::pair<UUID, std::string>> ttlInfos = ttlCollectionCache.getTTLInfos();
@@ -186,35 +463,135 @@ private:
             ttlIndexes.push_back(std::make_pair(*nss, spec.getOwned()));
         }
 
-        for (const auto& it : ttlIndexes) {
+        ttlIndexStats.retainOnly(ttlIndexes);
+        if (ttlIndexes.empty()) {
+            return false;
+        }
+
+        // The indexes take turns to delete a batch of documents each, on a bounded number of
+        // workers, until every index has no expired documents left. A pass which is still running
+        // when the next one is due ends after the current round, so that the next pass can pick up
+        // new TTL indexes; the remaining documents are deleted then, without waiting for the
+        // usual interval.
+        {
+            stdx::lock_guard<Latch> lk(_jobsMutex);
+            _jobs.clear();
+            for (auto&& index : ttlIndexes) {
+                _jobs.push_back({index.first, index.second});
+            }
+            _passDeadline = Date_t::now() + Seconds(ttlMonitorSleepSecs.load());
+            _passInterrupted = false;
+            _passTruncated = false;
+        }
+
+        const auto numWorkers =
+            std::min<size_t>(ttlIndexes.size(), ttlMonitorMaxConcurrency.load());
+        ThreadPool::Options options;
+        options.poolName = "TTLMonitorWorkers";
+        options.threadNamePrefix = "TTLMonitorWorker-";
+        options.minThreads = 0;
+        options.maxThreads = numWorkers;
+        options.onCreateThread = [](const std::string& threadName) {
+            Client::initThread(threadName.c_str());
+            AuthorizationSession::get(cc())->grantInternalAuthorization(&cc());
+            stdx::lock_guard<Client> lk(cc());
+            cc().setSystemOperationKillable(lk);
+        };
+        ThreadPool workers(options);
+        workers.startup();
+        for (size_t i = 0; i < numWorkers; ++i) {
+            workers.schedule([this](Status status) {
+                if (status.isOK()) {
+                    runTTLWorker();
+                }
+            });
+        }
+        workers.shutdown();
+        workers.join();
+
+        if (_passInterrupted) {
+            LOGV2_WARNING(22537,
+                          "TTLMonitor was interrupted, waiting {ttlMonitorSleepSecs_load} "
+                          "seconds before doing another pass",
+                          "TTLMonitor was interrupted, waiting before doing another pass",
+                          "wait"_attr = Milliseconds(Seconds(ttlMonitorSleepSecs.load())));
+            return false;
+        }
+        return _passTruncated;
+    }
+
+    /**
+     * Deletes batches of expired documents from the TTL indexes in '_jobs', in turn, until there
+     * are none left or the pass ends.
+     */
+    void runTTLWorker() {
+        while (true) {
+            TTLIndexJob job;
+            {
+                stdx::lock_guard<Latch> lk(_jobsMutex);
+                if (_jobs.empty() || _passInterrupted) {
+                    return;
+                }
+                job = std::move(_jobs.front());
+                _jobs.pop_front();
+            }
+
+            bool moreToDelete = false;
             try {
-                doTTLForIndex(&opCtx, it.first, it.second);
+                const ServiceContext::UniqueOperationContext opCtx = cc().makeOperationContext();
+
+                // Reserve the budget for the batch up front, and give back whatever it did not
+                // use. The budget of a batch which fails part way through is not given back, as
+                // it is not known how much of it was used.
+                const long long oplogBytesPerDelete =
+                    kEstimatedDeleteOplogEntryBytes + job.nss.size();
+                const long long batchSize = _deleteBudget.reserve(
+                    opCtx.get(), ttlMonitorBatchSize.load(), oplogBytesPerDelete);
+                long long numDeleted = 0;
+                moreToDelete =
+                    doTTLBatchForIndex(opCtx.get(), job.nss, job.spec, batchSize, &numDeleted);
+                _deleteBudget.release(batchSize - numDeleted, oplogBytesPerDelete);
             } catch (const ExceptionForCat<ErrorCategory::Interruption>&) {
-                LOGV2_WARNING(22537,
-                              "TTLMonitor was interrupted, waiting {ttlMonitorSleepSecs_load} "
-                              "seconds before doing another pass",
-                              "TTLMonitor was interrupted, waiting before doing another pass",
-                              "wait"_attr = Milliseconds(Seconds(ttlMonitorSleepSecs.load())));
+                stdx::lock_guard<Latch> lk(_jobsMutex);
+                _passInterrupted = true;
                 return;
+            } catch (const WriteConflictException&) {
+                LOGV2_DEBUG(5600151, 1, "TTL batch got WriteConflictException");
             } catch (const DBException& dbex) {
                 LOGV2_ERROR(22538,
                             "Error processing ttl index: {it_second} -- {dbex}",
                             "Error processing TTL index",
-                            "index"_attr = it.second,
+                            "index"_attr = job.spec,
                             "error"_attr = dbex);
                 // Continue on to the next index.
-                continue;
+            }
+
+            // Put the index back at the end of the queue, behind every other index with expired
+            // documents, unless the pass is over.
+            if (moreToDelete && !globalInShutdownDeprecated()) {
+                stdx::lock_guard<Latch> lk(_jobsMutex);
+                if (Date_t::now() < _passDeadline) {
+                    _jobs.push_back(std::move(job));
+                } else {
+                    _passTruncated = true;
+                }
             }
         }
     }
 
     /**
-     * Remove documents from the collection using the specified TTL index after a sufficient amount
-     * of time has passed according to its expiry specification.
+     * Remove a batch of up to 'batchSize' documents from the collection using the specified TTL
+     * index after a sufficient amount of time has passed according to its expiry specification.
+     * Sets 'numDeletedOut' to the number of documents removed. Returns whether the index may have
+     * more expired documents to delete.
      */
-    void doTTLForIndex(OperationContext* opCtx, NamespaceString collectionNSS, BSONObj idx) {
+    bool doTTLBatchForIndex(OperationContext* opCtx,
+                            NamespaceString collectionNSS,
+                            BSONObj idx,
+                            long long batchSize,
+                            long long* numDeletedOut) {
         if (collectionNSS.isDropPendingNamespace()) {
-            return;
+            return false;
         }
         if (!userAllowedWriteNS(collectionNSS).isOK()) {
             LOGV2_ERROR(
@@ -223,17 +600,17 @@ private:
                 "Namespace doesn't allow deletes, skipping TTL job",
                 logAttrs(collectionNSS),
                 "index"_attr = idx);
-            return;
+            return false;
         }
 
         const BSONObj key = idx["key"].Obj();
-        const StringData name = idx["name"].valueStringData();
+        const std::string name = idx["name"].str();
         if (key.nFields() != 1) {
             LOGV2_ERROR(22540,
                         "key for ttl index can only have 1 field, skipping ttl job for: {index}",
                         "Key for ttl index can only have 1 field, skipping TTL job",
                         "index"_attr = idx);
-            return;
+            return false;
         }
 
         LOGV2_DEBUG(22533,
@@ -253,11 +630,11 @@ private:
         Collection* collection = autoGetCollection.getCollection();
         if (!collection) {
             // Collection was dropped.
-            return;
+            return false;
         }
 
         if (!repl::ReplicationCoordinator::get(opCtx)->canAcceptWritesFor(opCtx, collectionNSS)) {
-            return;
+            return false;
         }
 
         const IndexDescriptor* desc = collection->getIndexCatalog()->findIndexByName(opCtx, name);
@@ -267,7 +644,7 @@ private:
                         "index not found (index build in progress? index dropped?), skipping ttl "
                         "job for: {idx}",
                         "idx"_attr = idx);
-            return;
+            return false;
         }
 
         // Re-read 'idx' from the descriptor, in case the collection or index definition changed
@@ -279,7 +656,7 @@ private:
                         "special index can't be used as a ttl index, skipping ttl job for: {index}",
                         "Special index can't be used as a TTL index, skipping TTL job",
                         "index"_attr = idx);
-            return;
+            return false;
         }
 
         BSONElement secondsExpireElt = idx[IndexDescriptor::kExpireAfterSecondsFieldName];
@@ -291,11 +668,9 @@ private:
                         "field"_attr = IndexDescriptor::kExpireAfterSecondsFieldName,
                         "type"_attr = typeName(secondsExpireElt.type()),
                         "index"_attr = idx);
-            return;
+            return false;
         }
 
-        const Date_t kDawnOfTime =
-            Date_t::fromMillisSinceEpoch(std::numeric_limits<long long>::min());
         const Date_t expirationTime = Date_t::now() - Seconds(secondsExpireElt.numberLong());
         const BSONObj startKey = BSON("" << kDawnOfTime);
         const BSONObj endKey = BSON("" << expirationTime);
@@ -316,42 +691,90 @@ private:
         auto canonicalQuery = CanonicalQuery::canonicalize(opCtx, std::move(qr));
         invariant(canonicalQuery.getStatus());
 
-        auto params = std::make_unique<DeleteStageParams>();
-        params->isMulti = true;
-        params->canonicalQuery = canonicalQuery.getValue().get();
-
-        auto exec =
-            InternalPlanner::deleteWithIndexScan(opCtx,
-                                                 collection,
-                                                 std::move(params),
-                                                 desc,
-                                                 startKey,
-                                                 endKey,
-                                                 BoundInclusion::kIncludeBothStartAndEndKeys,
-                                                 PlanExecutor::YIELD_AUTO,
-                                                 direction);
-
-        Status result = exec->executePlan();
-        if (!result.isOK()) {
-            if (result == ErrorCodes::QueryPlanKilled) {
-                // It is expected that a collection drop can kill a query plan while the TTL monitor
-                // is deleting an old document, so ignore this error.
-                return;
+        // The expired documents of a collection which expires in insertion order are at its
+        // start, where they can be removed as a range. The index scan below then only has to pick
+        // up any expired documents which were inserted out of order. A standalone that has since
+        // joined a replica set replicates its deletes, so only the index scan is used there.
+        long long numDeleted = 0;
+        if (DurableCatalog::get(opCtx)
+                ->getCollectionOptions(opCtx, collection->getCatalogId())
+                .expireInInsertionOrder &&
+            repl::ReplicationCoordinator::get(opCtx)->isOplogDisabledFor(opCtx, collectionNSS)) {
+            numDeleted =
+                deleteExpiredRange(opCtx, collection, keyFieldName, expirationTime, batchSize);
+            LOGV2_DEBUG(5600100,
+                        1,
+                        "Deleted expired range",
+                        logAttrs(collectionNSS),
+                        "numDeleted"_attr = numDeleted);
+        }
+
+        bool failed = false;
+        if (numDeleted < batchSize) {
+            auto params = std::make_unique<DeleteStageParams>();
+            params->isMulti = true;
+            params->limit = batchSize - numDeleted;
+            params->canonicalQuery = canonicalQuery.getValue().get();
+
+            auto exec =
+                InternalPlanner::deleteWithIndexScan(opCtx,
+                                                     collection,
+                                                     std::move(params),
+                                                     desc,
+                                                     startKey,
+                                                     endKey,
+                                                     BoundInclusion::kIncludeBothStartAndEndKeys,
+                                                     PlanExecutor::YIELD_AUTO,
+                                                     direction);
+
+            Status result = exec->executePlan();
+            if (result.isOK()) {
+                numDeleted += DeleteStage::getNumDeleted(*exec);
+            } else {
+                // It is expected that a collection drop can kill a query plan while the TTL
+                // monitor is deleting an old document, so don't report this error.
+                if (result != ErrorCodes::QueryPlanKilled) {
+                    LOGV2_ERROR(22543,
+                                "ttl query execution for index {index} failed with status: "
+                                "{error}",
+                                "TTL query execution failed",
+                                "index"_attr = idx,
+                                "error"_attr = redact(result));
+                }
+                failed = true;
             }
-            LOGV2_ERROR(22543,
-                        "ttl query execution for index {index} failed with status: {error}",
-                        "TTL query execution failed",
-                        "index"_attr = idx,
-                        "error"_attr = redact(result));
-            return;
         }
 
-        const long long numDeleted = DeleteStage::getNumDeleted(*exec);
         ttlDeletedDocuments.increment(numDeleted);
+        *numDeletedOut = numDeleted;
         LOGV2_DEBUG(22536, 1, "deleted: {numDeleted}", "numDeleted"_attr = numDeleted);
+
+        // A batch which stopped short of its limit exhausted the expired range.
+        const bool moreToDelete = !failed && numDeleted >= batchSize;
+        long long backlogEstimate = 0;
+        if (moreToDelete) {
+            // Look the index up again, since the delete may have yielded its locks.
+            if (auto currentDesc = collection->getIndexCatalog()->findIndexByName(opCtx, name)) {
+                backlogEstimate =
+                    estimateBacklog(opCtx, collection, currentDesc, expirationTime);
+            }
+        }
+        ttlIndexStats.recordBatch(collectionNSS, name, numDeleted, backlogEstimate);
+        return moreToDelete;
     }
 
     ServiceContext* _serviceContext;
+
+    TTLDeleteBudget _deleteBudget;
+
+    // The TTL indexes of the current pass with expired documents left to delete.
+    Mutex _jobsMutex = MONGO_MAKE_LATCH("TTLMonitor::_jobsMutex");
+    std::deque<TTLIndexJob> _jobs;
+    Date_t _passDeadline;
+    bool _passInterrupted = false;
+
+    // Whether an index was left with expired documents because the pass ran out of time.
+    bool _passTruncated = false;
 };
 
 namespace {
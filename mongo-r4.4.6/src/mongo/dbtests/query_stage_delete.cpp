@@ -185,6 +185,52 @@ public:
     }
 };
 
+/**
+ * Test that a multi delete with a limit stops once it has deleted that many documents.
+ */
+class QueryStageDeleteLimit : public QueryStageDeleteBase {
+public:
+    void run() {
+        dbtests::WriteContextForTests ctx(&_opCtx, nss.ns());
+
+        Collection* coll = ctx.getCollection();
+        ASSERT(coll);
+
+        CollectionScanParams collScanParams;
+        collScanParams.direction = CollectionScanParams::FORWARD;
+        collScanParams.tailable = false;
+
+        const long long limit = 7;
+        auto deleteStageParams = std::make_unique<DeleteStageParams>();
+        deleteStageParams->isMulti = true;
+        deleteStageParams->limit = limit;
+
+        WorkingSet ws;
+        DeleteStage deleteStage(
+            _expCtx.get(),
+            std::move(deleteStageParams),
+            &ws,
+            coll,
+            new CollectionScan(_expCtx.get(), coll, collScanParams, &ws, nullptr));
+
+        const DeleteStats* stats = static_cast<const DeleteStats*>(deleteStage.getSpecificStats());
+
+        while (!deleteStage.isEOF()) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            PlanStage::StageState state = deleteStage.work(&id);
+            invariant(PlanStage::NEED_TIME == state || PlanStage::IS_EOF == state);
+        }
+
+        ASSERT_EQUALS(static_cast<size_t>(limit), stats->docsDeleted);
+
+        // Only the first 'limit' documents of the scan were deleted.
+        vector<RecordId> recordIds;
+        getRecordIds(coll, CollectionScanParams::FORWARD, &recordIds);
+        ASSERT_EQUALS(numObj() - limit, recordIds.size());
+        ASSERT_EQUALS(limit, coll->docFor(&_opCtx, recordIds[0]).value()["foo"].numberLong());
+    }
+};
+
 /**
  * Test that the delete stage returns an owned copy of the original document if returnDeleted is
  * specified.
@@ -260,6 +306,7 @@ public:
     void setupTests() {
         // Stage-specific tests below.
         add<QueryStageDeleteUpcomingObjectWasDeleted>();
+        add<QueryStageDeleteLimit>();
         add<QueryStageDeleteReturnOldDoc>();
     }
 };
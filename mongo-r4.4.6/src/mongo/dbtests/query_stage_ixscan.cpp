@@ -33,6 +33,7 @@
 #include "mongo/db/client.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/exec/index_scan.h"
+#include "mongo/db/exec/sort.h"
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/jsobj.h"
@@ -317,6 +318,120 @@ public:
     }
 };
 
+// A sort key threshold in the scan direction ends the scan at the first key past the threshold.
+class QueryStageIxscanSortKeyThresholdStopsScan : public IndexScanTest {
+public:
+    void run() {
+        setup();
+
+        for (int i = 1; i <= 10; ++i) {
+            insert(BSON("_id" << i << "x" << i));
+        }
+
+        std::unique_ptr<IndexScan> ixscan(
+            createIndexScan(BSON("x" << 1), BSON("x" << 10), true, true));
+        auto threshold = std::make_shared<SortKeyThreshold>(FieldPath("x"), true /* ascending */);
+        ASSERT_TRUE(ixscan->setSortKeyThreshold(threshold));
+        threshold->set(Value(4));
+
+        for (int i = 1; i <= 4; ++i) {
+            ASSERT_BSONOBJ_EQ(getNext(ixscan.get())->keyData[0].keyData, BSON("" << i));
+        }
+
+        WorkingSetID id;
+        ASSERT_EQ(PlanStage::IS_EOF, ixscan->work(&id));
+        ASSERT(ixscan->isEOF());
+
+        auto stats = static_cast<const IndexScanStats*>(ixscan->getSpecificStats());
+        ASSERT_EQ(5U, stats->keysExamined);
+        ASSERT_EQ(0U, stats->keysDroppedBySortThreshold);
+    }
+};
+
+// A sort key threshold against the scan direction drops the keys past it but keeps scanning.
+class QueryStageIxscanSortKeyThresholdDropsKeys : public IndexScanTest {
+public:
+    void run() {
+        setup();
+
+        for (int i = 1; i <= 10; ++i) {
+            insert(BSON("_id" << i << "x" << i));
+        }
+
+        std::unique_ptr<IndexScan> ixscan(
+            createIndexScan(BSON("x" << 1), BSON("x" << 10), true, true));
+        auto threshold = std::make_shared<SortKeyThreshold>(FieldPath("x"), false /* ascending */);
+        ASSERT_TRUE(ixscan->setSortKeyThreshold(threshold));
+        threshold->set(Value(7));
+
+        for (int i = 7; i <= 10; ++i) {
+            ASSERT_BSONOBJ_EQ(getNext(ixscan.get())->keyData[0].keyData, BSON("" << i));
+        }
+
+        WorkingSetID id;
+        ASSERT_EQ(PlanStage::IS_EOF, ixscan->work(&id));
+
+        auto stats = static_cast<const IndexScanStats*>(ixscan->getSpecificStats());
+        ASSERT_EQ(10U, stats->keysExamined);
+        ASSERT_EQ(6U, stats->keysDroppedBySortThreshold);
+    }
+};
+
+// The index can not evaluate a threshold once it is multikey on the threshold's field.
+class QueryStageIxscanSortKeyThresholdRejectedWhenMultikey : public IndexScanTest {
+public:
+    void run() {
+        setup();
+
+        insert(fromjson("{_id: 1, x: [1, 2, 3]}"));
+
+        std::unique_ptr<IndexScan> ixscan(
+            createIndexScan(BSON("x" << 1), BSON("x" << 3), true, true));
+        ASSERT_FALSE(ixscan->setSortKeyThreshold(
+            std::make_shared<SortKeyThreshold>(FieldPath("x"), true /* ascending */)));
+    }
+};
+
+// A top-k sort over an index scan stops the scan once the scan can't produce a better key.
+class QueryStageIxscanTopKSortStopsScan : public IndexScanTest {
+public:
+    void run() {
+        setup();
+
+        for (int i = 10; i >= 1; --i) {
+            insert(BSON("_id" << i << "x" << i));
+        }
+
+        auto ixscan = createIndexScan(BSON("x" << 1), BSON("x" << 10), true, true);
+        SortStageDefault sort(_expCtx,
+                              &_ws,
+                              SortPattern{BSON("x" << 1), _expCtx},
+                              3 /* limit */,
+                              1024 * 1024 /* maxMemoryUsageBytes */,
+                              false /* addSortKeyMetadata */,
+                              std::unique_ptr<PlanStage>(ixscan));
+
+        std::vector<BSONObj> results;
+        WorkingSetID id;
+        PlanStage::StageState state;
+        while ((state = sort.work(&id)) != PlanStage::IS_EOF) {
+            ASSERT_NE(PlanStage::FAILURE, state);
+            if (state == PlanStage::ADVANCED) {
+                results.push_back(_ws.get(id)->keyData[0].keyData);
+            }
+        }
+
+        ASSERT_EQ(3U, results.size());
+        for (int i = 0; i < 3; ++i) {
+            ASSERT_BSONOBJ_EQ(results[i], BSON("" << i + 1));
+        }
+
+        // The scan returned keys 1, 2 and 3, and stopped at key 4.
+        auto stats = static_cast<const IndexScanStats*>(ixscan->getSpecificStats());
+        ASSERT_EQ(4U, stats->keysExamined);
+    }
+};
+
 class All : public OldStyleSuiteSpecification {
 public:
     All() : OldStyleSuiteSpecification("query_stage_ixscan") {}
@@ -327,6 +442,10 @@ public:
         add<QueryStageIxscanInsertDuringSaveExclusive>();
         add<QueryStageIxscanInsertDuringSaveExclusive2>();
         add<QueryStageIxscanInsertDuringSaveReverse>();
+        add<QueryStageIxscanSortKeyThresholdStopsScan>();
+        add<QueryStageIxscanSortKeyThresholdDropsKeys>();
+        add<QueryStageIxscanSortKeyThresholdRejectedWhenMultikey>();
+        add<QueryStageIxscanTopKSortStopsScan>();
     }
 };
 
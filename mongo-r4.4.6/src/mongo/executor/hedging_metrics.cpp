@@ -29,6 +29,8 @@
 
 #include "mongo/executor/hedging_metrics.h"
 
+#include "mongo/platform/bits.h"
+
 namespace mongo {
 
 namespace {
@@ -67,12 +69,96 @@ void HedgingMetrics::incrementNumAdvantageouslyHedgedOperations() {
     _numAdvantageouslyHedgedOperations.fetchAndAdd(1);
 }
 
+long long HedgingMetrics::getNumHedgesAvoidedByDelay() const {
+    return _numHedgesAvoidedByDelay.load();
+}
+
+void HedgingMetrics::incrementNumHedgesAvoidedByDelay() {
+    _numHedgesAvoidedByDelay.fetchAndAdd(1);
+}
+
+void HedgingMetrics::recordLatency(const HostAndPort& host, Milliseconds latency) {
+    stdx::lock_guard<Latch> lk(_latencyMutex);
+    auto& histogram = _latencies[host];
+    if (!histogram) {
+        histogram = std::make_unique<LatencyHistogram>();
+    }
+    histogram->record(latency);
+}
+
+boost::optional<Milliseconds> HedgingMetrics::getLatencyPercentile(const HostAndPort& host,
+                                                                   int percentile) const {
+    stdx::lock_guard<Latch> lk(_latencyMutex);
+    auto it = _latencies.find(host);
+    if (it == _latencies.end()) {
+        return boost::none;
+    }
+    return it->second->percentile(percentile);
+}
+
+size_t HedgingMetrics::LatencyHistogram::bucketFor(long long millis) {
+    if (millis < static_cast<long long>(kNumExactBuckets)) {
+        return millis < 0 ? 0 : static_cast<size_t>(millis);
+    }
+
+    const int exponent = 63 - countLeadingZeros64(millis);
+    if (exponent >= 32) {
+        return kNumBuckets - 1;
+    }
+
+    const size_t subBucket = (millis >> (exponent - 3)) & (kSubBucketsPerPowerOfTwo - 1);
+    return kNumExactBuckets + (exponent - 4) * kSubBucketsPerPowerOfTwo + subBucket;
+}
+
+long long HedgingMetrics::LatencyHistogram::bucketUpperBound(size_t bucket) {
+    if (bucket < kNumExactBuckets) {
+        return bucket;
+    }
+
+    const int exponent = 4 + (bucket - kNumExactBuckets) / kSubBucketsPerPowerOfTwo;
+    const long long subBucket = (bucket - kNumExactBuckets) % kSubBucketsPerPowerOfTwo;
+    const long long lowerBound = (kSubBucketsPerPowerOfTwo + subBucket) << (exponent - 3);
+    return lowerBound + (1LL << (exponent - 3)) - 1;
+}
+
+void HedgingMetrics::LatencyHistogram::record(Milliseconds latency) {
+    if (_total >= kLatencyDecaySamples) {
+        _total = 0;
+        for (auto& count : _counts) {
+            count /= 2;
+            _total += count;
+        }
+    }
+
+    ++_counts[bucketFor(durationCount<Milliseconds>(latency))];
+    ++_total;
+}
+
+boost::optional<Milliseconds> HedgingMetrics::LatencyHistogram::percentile(int percentile) const {
+    invariant(percentile > 0 && percentile <= 100);
+    if (_total < kMinLatencySamples) {
+        return boost::none;
+    }
+
+    // The rank of the sample at the requested percentile, rounded up.
+    const uint64_t rank = (static_cast<uint64_t>(_total) * percentile + 99) / 100;
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < kNumBuckets; ++bucket) {
+        seen += _counts[bucket];
+        if (seen >= rank) {
+            return Milliseconds(bucketUpperBound(bucket));
+        }
+    }
+    MONGO_UNREACHABLE;
+}
+
 BSONObj HedgingMetrics::toBSON() const {
     BSONObjBuilder builder;
 
     builder.append("numTotalOperations", _numTotalOperations.load());
     builder.append("numTotalHedgedOperations", _numTotalHedgedOperations.load());
     builder.append("numAdvantageouslyHedgedOperations", _numAdvantageouslyHedgedOperations.load());
+    builder.append("numHedgesAvoidedByDelay", _numHedgesAvoidedByDelay.load());
 
     return builder.obj();
 }
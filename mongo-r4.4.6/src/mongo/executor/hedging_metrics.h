@@ -29,8 +29,16 @@
 
 #pragma once
 
+#include <array>
+#include <boost/optional.hpp>
+#include <memory>
+
 #include "mongo/db/operation_context.h"
 #include "mongo/db/service_context.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/duration.h"
+#include "mongo/util/net/hostandport.h"
 
 namespace mongo {
 
@@ -56,9 +64,58 @@ public:
     long long getNumAdvantageouslyHedgedOperations() const;
     void incrementNumAdvantageouslyHedgedOperations();
 
+    long long getNumHedgesAvoidedByDelay() const;
+    void incrementNumHedgesAvoidedByDelay();
+
+    /**
+     * Records the round trip time of a successful response from 'host' to an operation that was
+     * eligible for hedging.
+     */
+    void recordLatency(const HostAndPort& host, Milliseconds latency);
+
+    /**
+     * Returns an upper bound for the given percentile (in the range (0, 100]) of the latencies
+     * recently recorded for 'host', or boost::none if not enough samples have been recorded for
+     * that host yet.
+     */
+    boost::optional<Milliseconds> getLatencyPercentile(const HostAndPort& host,
+                                                       int percentile) const;
+
     BSONObj toBSON() const;
 
+    // The number of samples needed for a host before a latency percentile is reported for it.
+    static constexpr uint32_t kMinLatencySamples = 20;
+
+    // Once a host has this many samples, all of its bucket counts are halved so that the
+    // percentiles follow the recent behavior of the host.
+    static constexpr uint32_t kLatencyDecaySamples = 2048;
+
 private:
+    /**
+     * Log-linear histogram of response latencies in milliseconds. Latencies below 16ms are
+     * counted exactly, larger latencies fall into one of 8 buckets per power of two, which bounds
+     * the relative error of a reported percentile to 12.5%.
+     */
+    class LatencyHistogram {
+    public:
+        static constexpr size_t kNumExactBuckets = 16;
+        static constexpr size_t kSubBucketsPerPowerOfTwo = 8;
+        // Powers of two from 2^4 up to 2^31 milliseconds are split into sub-buckets.
+        static constexpr size_t kNumBuckets =
+            kNumExactBuckets + (32 - 4) * kSubBucketsPerPowerOfTwo;
+
+        void record(Milliseconds latency);
+        boost::optional<Milliseconds> percentile(int percentile) const;
+
+        static size_t bucketFor(long long millis);
+        static long long bucketUpperBound(size_t bucket);
+
+    private:
+        std::array<uint32_t, kNumBuckets> _counts{};
+        uint32_t _total{0};
+    };
+
+
     // The number of all operations with readPreference options such that they could be hedged.
     AtomicWord<long long> _numTotalOperations{0};
 
@@ -68,6 +125,13 @@ private:
     // The number of all operations where a rpc other than the first one fulfilled the client
     // request.
     AtomicWord<long long> _numAdvantageouslyHedgedOperations{0};
+
+    // The number of hedged operations where the first response arrived before the hedge delay
+    // expired, so that no additional rpc had to be dispatched.
+    AtomicWord<long long> _numHedgesAvoidedByDelay{0};
+
+    mutable Mutex _latencyMutex = MONGO_MAKE_LATCH("HedgingMetrics::_latencyMutex");
+    stdx::unordered_map<HostAndPort, std::unique_ptr<LatencyHistogram>> _latencies;
 };
 
 }  // namespace mongo
@@ -0,0 +1,94 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/executor/hedging_metrics.h"
+
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const HostAndPort kHost1("host1", 27017);
+const HostAndPort kHost2("host2", 27017);
+
+TEST(HedgingMetricsTest, NoLatencyPercentileWithoutEnoughSamples) {
+    HedgingMetrics metrics;
+    ASSERT_FALSE(metrics.getLatencyPercentile(kHost1, 50));
+
+    for (uint32_t i = 1; i < HedgingMetrics::kMinLatencySamples; ++i) {
+        metrics.recordLatency(kHost1, Milliseconds(10));
+    }
+    ASSERT_FALSE(metrics.getLatencyPercentile(kHost1, 50));
+
+    metrics.recordLatency(kHost1, Milliseconds(10));
+    ASSERT_EQ(Milliseconds(10), *metrics.getLatencyPercentile(kHost1, 50));
+    ASSERT_FALSE(metrics.getLatencyPercentile(kHost2, 50));
+}
+
+TEST(HedgingMetricsTest, LatencyPercentilesAreTrackedPerHost) {
+    HedgingMetrics metrics;
+    for (int millis = 1; millis <= 100; ++millis) {
+        metrics.recordLatency(kHost1, Milliseconds(millis));
+        metrics.recordLatency(kHost2, Milliseconds(millis * 100));
+    }
+
+    // Small latencies are counted exactly.
+    ASSERT_EQ(Milliseconds(10), *metrics.getLatencyPercentile(kHost1, 10));
+
+    // Larger latencies are reported as an upper bound within 12.5% of the exact percentile.
+    auto assertPercentileNear = [&](const HostAndPort& host, int percentile, Milliseconds exact) {
+        auto reported = *metrics.getLatencyPercentile(host, percentile);
+        ASSERT_GTE(reported, exact);
+        ASSERT_LTE(reported, exact + exact / 8);
+    };
+    assertPercentileNear(kHost1, 50, Milliseconds(50));
+    assertPercentileNear(kHost1, 95, Milliseconds(95));
+    assertPercentileNear(kHost1, 100, Milliseconds(100));
+    assertPercentileNear(kHost2, 50, Milliseconds(5000));
+    assertPercentileNear(kHost2, 99, Milliseconds(9900));
+}
+
+TEST(HedgingMetricsTest, OldLatenciesDecay) {
+    HedgingMetrics metrics;
+    for (uint32_t i = 0; i < HedgingMetrics::kLatencyDecaySamples; ++i) {
+        metrics.recordLatency(kHost1, Milliseconds(5));
+    }
+    ASSERT_EQ(Milliseconds(5), *metrics.getLatencyPercentile(kHost1, 50));
+
+    // Once the host becomes slow, the percentiles follow after a bounded number of samples.
+    for (uint32_t i = 0; i < HedgingMetrics::kLatencyDecaySamples; ++i) {
+        metrics.recordLatency(kHost1, Milliseconds(15));
+    }
+    ASSERT_EQ(Milliseconds(15), *metrics.getLatencyPercentile(kHost1, 50));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -280,7 +280,8 @@ NetworkInterfaceTL::CommandState::CommandState(NetworkInterfaceTL* interface_,
 
 auto NetworkInterfaceTL::CommandState::make(NetworkInterfaceTL* interface,
                                             RemoteCommandRequestOnAny request,
-                                            const TaskExecutor::CallbackHandle& cbHandle) {
+                                            const TaskExecutor::CallbackHandle& cbHandle,
+                                            bool delayHedges) {
     auto state = std::make_shared<CommandState>(interface, std::move(request), cbHandle);
     auto [promise, future] = makePromiseFuture<RemoteCommandOnAnyResponse>();
     state->promise = std::move(promise);
@@ -302,6 +303,11 @@ auto NetworkInterfaceTL::CommandState::make(NetworkInterfaceTL* interface,
 
     state->requestManager = std::make_unique<RequestManager>(state.get());
 
+    // The hedge timer must exist before cancelCommand() can find the command and finish it.
+    if (delayHedges) {
+        state->hedgeTimer = interface->_reactor->makeTimer();
+    }
+
     {
         stdx::lock_guard lk(interface->_inProgressMutex);
         if (interface->inShutdown()) {
@@ -384,6 +390,13 @@ void NetworkInterfaceTL::CommandStateBase::tryFinish(Status status) noexcept {
 
     // The command has resolved one way or another.
     timer->cancel(baton);
+    if (hedgeTimer) {
+        // The hedges were only avoided if the first target answered before they were sent.
+        if (claimHedges(HedgeState::kAvoided) && status.isOK() && interface->_svcCtx) {
+            HedgingMetrics::get(interface->_svcCtx)->incrementNumHedgesAvoidedByDelay();
+        }
+        hedgeTimer->cancel(baton);
+    }
 
     if (interface->_counters) {
         // Increment our counters for the integration test
@@ -473,7 +486,18 @@ Status NetworkInterfaceTL::startCommand(const TaskExecutor::CallbackHandle& cbHa
                   });
     }
 
-    auto [cmdState, future] = CommandState::make(this, request, cbHandle);
+    // A hedged command may delay its additional requests until the first target has been slower
+    // than the configured percentile of its recent latencies, so that the hedges are only paid for
+    // by the operations that hit a slow host.
+    boost::optional<Milliseconds> hedgeDelay;
+    if (_svcCtx && request.hedgeOptions && request.hedgeOptions->delayPercentile > 0 &&
+        request.target.size() > 1 && !targetHostsInAlphabeticalOrder) {
+        hedgeDelay = HedgingMetrics::get(_svcCtx)->getLatencyPercentile(
+            request.target[0], request.hedgeOptions->delayPercentile);
+    }
+    const bool delayHedges = hedgeDelay && *hedgeDelay > Milliseconds(0);
+
+    auto [cmdState, future] = CommandState::make(this, request, cbHandle, delayHedges);
     if (cmdState->requestOnAny.timeout != cmdState->requestOnAny.kNoTimeout) {
         cmdState->deadline = cmdState->stopwatch.start() + cmdState->requestOnAny.timeout;
     }
@@ -534,21 +558,81 @@ Status NetworkInterfaceTL::startCommand(const TaskExecutor::CallbackHandle& cbHa
         return Status::OK();
     }
 
-    // Attempt to get a connection to every target host
-    for (size_t idx = 0; idx < request.target.size(); ++idx) {
+    auto getConnAndSend = [this, cmdState = cmdState, targetHostsInAlphabeticalOrder](size_t idx) {
+        const auto& request = cmdState->requestOnAny;
         auto connFuture = _pool->get(request.target[idx], request.sslMode, request.timeout);
 
         // If connection future is ready or requests should be sent in order, send the request
         // immediately.
         if (connFuture.isReady() || targetHostsInAlphabeticalOrder) {
             cmdState->requestManager->trySend(std::move(connFuture).getNoThrow(), idx);
-            continue;
+            return;
         }
 
         // Otherwise, schedule the request.
         std::move(connFuture).thenRunOn(_reactor).getAsync([cmdState = cmdState, idx](auto swConn) {
             cmdState->requestManager->trySend(std::move(swConn), idx);
         });
+    };
+
+    if (!delayHedges) {
+        // Attempt to get a connection to every target host
+        for (size_t idx = 0; idx < request.target.size(); ++idx) {
+            getConnAndSend(idx);
+        }
+
+        return Status::OK();
+    }
+
+    LOGV2_DEBUG(5600154,
+                2,
+                "Delaying hedged requests",
+                "requestId"_attr = cmdState->requestOnAny.id,
+                "delay"_attr = *hedgeDelay);
+
+    auto sendHedges = [cmdState = cmdState, getConnAndSend] {
+        for (size_t idx = 1; idx < cmdState->requestOnAny.target.size(); ++idx) {
+            getConnAndSend(idx);
+        }
+    };
+
+    // The timer is armed before the first request is sent so that a fast response always
+    // observes it and cancels it in tryFinish().
+    cmdState->hedgeTimer->waitUntil(now() + *hedgeDelay, baton)
+        .getAsync([cmdState = cmdState, sendHedges](Status status) {
+            if (status.isOK() && cmdState->claimHedges(CommandState::HedgeState::kSent)) {
+                sendHedges();
+                return;
+            }
+
+            if (cmdState->hedgeState.load() == CommandState::HedgeState::kAvoided) {
+                // The command finished before the hedges were sent. Resolve the connections that
+                // were never requested so the RequestManager's accounting stays consistent.
+                const Status notSent(ErrorCodes::CallbackCanceled,
+                                     "Command finished before the hedged requests were sent");
+                for (size_t idx = 1; idx < cmdState->requestOnAny.target.size(); ++idx) {
+                    cmdState->requestManager->trySend(notSent, idx);
+                }
+            }
+        });
+
+    // There is no point in waiting for a first target which cannot even be connected to, so the
+    // hedges are sent straight away if its connection fails.
+    auto sendFirst = [cmdState = cmdState, sendHedges](
+                         StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+        if (!swConn.isOK() && cmdState->claimHedges(CommandState::HedgeState::kSent)) {
+            cmdState->hedgeTimer->cancel(cmdState->baton);
+            sendHedges();
+        }
+        cmdState->requestManager->trySend(std::move(swConn), 0);
+    };
+    const auto& requestOnAny = cmdState->requestOnAny;
+    auto connFuture =
+        _pool->get(requestOnAny.target[0], requestOnAny.sslMode, requestOnAny.timeout);
+    if (connFuture.isReady()) {
+        sendFirst(std::move(connFuture).getNoThrow());
+    } else {
+        std::move(connFuture).thenRunOn(_reactor).getAsync(std::move(sendFirst));
     }
 
     return Status::OK();
@@ -796,6 +880,12 @@ void NetworkInterfaceTL::RequestState::resolve(Future<RemoteCommandResponse> fut
             returnConnection(status);
 
             auto commandStatus = getStatusFromCommandResult(response.data);
+            if (status.isOK() && commandStatus.isOK() && cmdState->requestOnAny.hedgeOptions &&
+                interface()->_svcCtx) {
+                // Track the latencies of hedge-eligible commands per host to derive hedge delays.
+                HedgingMetrics::get(interface()->_svcCtx)->recordLatency(host, stopwatch.elapsed());
+            }
+
             // Ignore maxTimeMS expiration errors for hedged reads without triggering the finish
             // line.
             if (isHedge && commandStatus == ErrorCodes::MaxTimeMSExpired) {
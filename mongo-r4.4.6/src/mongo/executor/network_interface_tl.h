@@ -166,6 +166,26 @@ private:
         BatonHandle baton;
         std::unique_ptr<transport::ReactorTimer> timer;
 
+        // Only set for hedged commands whose additional requests are delayed, see
+        // HedgeOptions::delayPercentile. It is created before the command is published to
+        // cancelCommand() and tryFinish(), and never reassigned.
+        std::unique_ptr<transport::ReactorTimer> hedgeTimer;
+
+        // What became of the delayed hedges. They are sent by whichever of the hedge timer or a
+        // failure to connect to the first target moves them out of kPending first, or avoided if
+        // the command finishes first.
+        enum class HedgeState { kPending, kSent, kAvoided };
+        AtomicWord<HedgeState> hedgeState{HedgeState::kPending};
+
+        /**
+         * Moves the delayed hedges from kPending to 'newState'. Returns false if another path got
+         * there first.
+         */
+        bool claimHedges(HedgeState newState) {
+            auto expected = HedgeState::kPending;
+            return hedgeState.compareAndSwap(&expected, newState);
+        }
+
         std::unique_ptr<RequestManager> requestManager;
 
         // TODO replace the finishLine with an atomic bool. It is no longer tracking allowed
@@ -183,9 +203,11 @@ private:
 
         // Create a new CommandState in a shared_ptr
         // Prefer this over raw construction
+        // If 'delayHedges' is set, the command gets a hedge timer.
         static auto make(NetworkInterfaceTL* interface,
                          RemoteCommandRequestOnAny request,
-                         const TaskExecutor::CallbackHandle& cbHandle);
+                         const TaskExecutor::CallbackHandle& cbHandle,
+                         bool delayHedges = false);
 
         Future<RemoteCommandResponse> sendRequest(
             std::shared_ptr<RequestState> requestState) override;
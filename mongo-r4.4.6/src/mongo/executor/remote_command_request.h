@@ -46,6 +46,10 @@ struct RemoteCommandRequestBase {
     struct HedgeOptions {
         size_t count = 0;
         int maxTimeMSForHedgedReads = 0;
+        // If positive, the additional requests are only sent once the first target has not
+        // responded within this percentile of its recently observed latencies. Otherwise all
+        // requests are sent as soon as connections are available.
+        int delayPercentile = 0;
     };
 
     enum FireAndForgetMode { kOn, kOff };
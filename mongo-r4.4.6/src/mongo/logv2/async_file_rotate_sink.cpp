@@ -0,0 +1,434 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/logv2/async_file_rotate_sink.h"
+
+#include <algorithm>
+#include <boost/log/attributes/value_extraction.hpp>
+#include <fmt/format.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "mongo/logv2/attribute_storage.h"
+#include "mongo/logv2/attributes.h"
+#include "mongo/logv2/file_rotate_sink.h"
+#include "mongo/logv2/json_formatter.h"
+#include "mongo/logv2/log_severity.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo::logv2 {
+namespace {
+// Identifies a sink in the per-thread ring cache. Ids are never reused so a thread cannot confuse
+// the ring of a destroyed sink with the ring of a sink later allocated at the same address.
+AtomicWord<unsigned long long> nextSinkId{0};
+
+// Most memory a ring keeps allocated in its slots for reuse once their records are written
+constexpr size_t kMaxRetainedRingBytes = 64 * 1024;
+
+// Most bytes of records buffered across all rings and not yet written. A record which does not fit
+// is handled as if its ring were full.
+constexpr long long kMaxBufferedBytes = 16 * 1024 * 1024;
+
+// Minimum time between two reports of dropped records
+constexpr Seconds kDroppedReportInterval{1};
+
+struct RingBuffer {
+    explicit RingBuffer(size_t capacity) : slots(capacity), retainedCapacity(capacity) {}
+
+    bool empty() const {
+        return head.load() == tail.load();
+    }
+
+    std::vector<std::string> slots;
+    // Next slot to write to the file, only advanced by the writer thread
+    AtomicWord<unsigned long long> head{0};
+    // Next slot to fill, only advanced by the logging thread owning the ring
+    AtomicWord<unsigned long long> tail{0};
+    // Set when the sink is destroyed, the owning thread then forgets the ring
+    AtomicWord<bool> detached{false};
+
+    // Capacity each slot kept after its record was written, and their sum. Only accessed by the
+    // writer thread.
+    std::vector<size_t> retainedCapacity;
+    size_t retainedBytes = 0;
+};
+
+struct ThreadRings {
+    ~ThreadRings();
+
+    std::vector<std::pair<unsigned long long, std::shared_ptr<RingBuffer>>> rings;
+};
+
+// Trivially destructible so it remains valid while other thread_locals log during thread exit
+thread_local bool threadRingsDestroyed = false;
+thread_local bool isAsyncLogWriterThread = false;
+thread_local ThreadRings threadRings;
+
+ThreadRings::~ThreadRings() {
+    threadRingsDestroyed = true;
+}
+
+}  // namespace
+
+struct AsyncFileRotateSink::Impl {
+    Impl(boost::shared_ptr<FileRotateSink> backend,
+         size_t bufferRecords,
+         OverflowPolicy overflowPolicy,
+         LogTimestampFormat timestampFormat)
+        : backend(std::move(backend)),
+          bufferRecords(std::max(bufferRecords, size_t(1))),
+          overflowPolicy(overflowPolicy),
+          timestampFormat(timestampFormat) {
+        writer = stdx::thread([this] { run(); });
+    }
+
+    ~Impl() {
+        {
+            stdx::lock_guard lk(mutex);
+            shutdown = true;
+            writerCV.notify_one();
+        }
+        writer.join();
+
+        stdx::lock_guard lk(mutex);
+        for (auto& ring : rings) {
+            ring->detached.store(true);
+        }
+    }
+
+    RingBuffer* ringForThisThread() {
+        if (threadRingsDestroyed) {
+            return nullptr;
+        }
+
+        auto& cache = threadRings.rings;
+        for (auto it = cache.begin(); it != cache.end();) {
+            if (it->first == id) {
+                return it->second.get();
+            }
+            if (it->second->detached.load()) {
+                it = cache.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        auto ring = std::make_shared<RingBuffer>(bufferRecords);
+        {
+            stdx::lock_guard lk(mutex);
+            rings.push_back(ring);
+        }
+        cache.emplace_back(id, ring);
+        return ring.get();
+    }
+
+    void enqueue(RingBuffer* ring, const string_type& formatted) {
+        const auto capacity = ring->slots.size();
+        auto tail = ring->tail.loadRelaxed();
+        auto hasSpace = [&] {
+            return tail - ring->head.load() < capacity && reserveBufferedBytes(formatted.size());
+        };
+        if (!hasSpace()) {
+            if (overflowPolicy == OverflowPolicy::kDrop) {
+                dropped.fetchAndAdd(1);
+                return;
+            }
+
+            // Registering as blocked before checking for space again pairs with the writer freeing
+            // space before checking for blocked threads, so one of the two always sees the other.
+            blockedProducers.fetchAndAdd(1);
+            {
+                stdx::unique_lock lk(spaceMutex);
+                notifyWriter();
+                spaceCV.wait(lk, hasSpace);
+            }
+            blockedProducers.fetchAndSubtract(1);
+        }
+
+        ring->slots[tail % capacity].assign(formatted);
+        ring->tail.store(tail + 1);
+        notifyWriter();
+    }
+
+    // Accounts for a record of 'size' bytes in 'bufferedBytes', unless the buffers are full. A
+    // record larger than all of the buffers together is accepted once they are empty.
+    bool reserveBufferedBytes(size_t size) {
+        const auto bytes = static_cast<long long>(size);
+        auto current = bufferedBytes.load();
+        do {
+            if (current != 0 && current + bytes > kMaxBufferedBytes) {
+                return false;
+            }
+        } while (!bufferedBytes.compareAndSwap(&current, current + bytes));
+        return true;
+    }
+
+    // The writer publishes 'writerIdle' before checking the rings for records and logging threads
+    // publish a record before checking 'writerIdle', so one of the two always sees the other.
+    void notifyWriter() {
+        if (writerIdle.load()) {
+            stdx::lock_guard lk(mutex);
+            writerCV.notify_one();
+        }
+    }
+
+    // Wakes the logging threads waiting for the writer to free space in the buffers
+    void notifySpace() {
+        if (blockedProducers.load() > 0) {
+            stdx::lock_guard lk(spaceMutex);
+            spaceCV.notify_all();
+        }
+    }
+
+    void writeSynchronously(const string_type& formatted) {
+        stdx::lock_guard lk(backendMutex);
+        backend->consume(boost::log::record_view(), formatted);
+        backend->flush();
+    }
+
+    void flush() {
+        stdx::unique_lock lk(mutex);
+        if (shutdown) {
+            return;
+        }
+        auto target = ++flushRequested;
+        writerCV.notify_one();
+        flushedCV.wait(lk, [&] { return flushCompleted >= target; });
+    }
+
+    void run() {
+        isAsyncLogWriterThread = true;
+        setThreadName("AsyncLogWriter");
+
+        while (true) {
+            std::vector<std::shared_ptr<RingBuffer>> snapshot;
+            unsigned long long flushTarget;
+            bool stopping;
+            {
+                stdx::unique_lock lk(mutex);
+                writerIdle.store(true);
+                writerCV.wait(lk, [&] {
+                    return shutdown || flushRequested != flushCompleted ||
+                        std::any_of(rings.begin(), rings.end(), [](const auto& ring) {
+                               return !ring->empty();
+                           });
+                });
+                writerIdle.store(false);
+
+                // Rings only referenced from here belong to threads that exited. They can't
+                // receive more records so they are released once drained.
+                rings.erase(std::remove_if(rings.begin(),
+                                           rings.end(),
+                                           [](const auto& ring) {
+                                               return ring.use_count() == 1 && ring->empty();
+                                           }),
+                            rings.end());
+
+                snapshot = rings;
+                flushTarget = flushRequested;
+                stopping = shutdown;
+            }
+
+            drain(snapshot, stopping);
+
+            {
+                stdx::lock_guard lk(mutex);
+                flushCompleted = flushTarget;
+                flushedCV.notify_all();
+            }
+
+            if (stopping) {
+                return;
+            }
+        }
+    }
+
+    // Writes out every record present in the rings. Records from different threads are written in
+    // ring order, so their timestamps are only ordered per thread.
+    void drain(const std::vector<std::shared_ptr<RingBuffer>>& snapshot, bool stopping) {
+        stdx::lock_guard lk(backendMutex);
+        for (auto& ring : snapshot) {
+            const auto capacity = ring->slots.size();
+            auto head = ring->head.loadRelaxed();
+            const auto tail = ring->tail.load();
+            if (head == tail) {
+                continue;
+            }
+
+            long long written = 0;
+            for (; head != tail; ++head) {
+                const auto index = head % capacity;
+                auto& slot = ring->slots[index];
+                // FileRotateSink only uses the formatted string. The record itself may refer to
+                // attributes on the stack of a logging thread that has moved on.
+                backend->consume(boost::log::record_view(), slot);
+                written += slot.size();
+
+                // Keep the slot's memory for the next record unless the ring already keeps
+                // enough, so an idle ring holds on to a bounded amount of memory.
+                ring->retainedBytes -= ring->retainedCapacity[index];
+                if (ring->retainedBytes + slot.capacity() > kMaxRetainedRingBytes) {
+                    std::string().swap(slot);
+                }
+                ring->retainedCapacity[index] = slot.capacity();
+                ring->retainedBytes += slot.capacity();
+            }
+            ring->head.store(tail);
+            bufferedBytes.subtractAndFetch(written);
+            notifySpace();
+        }
+
+        reportDropped(stopping);
+        backend->flush();
+    }
+
+    void reportDropped(bool force) {
+        auto total = dropped.load();
+        auto now = Date_t::now();
+        if (total == droppedReported ||
+            (!force && now - lastDroppedReport < kDroppedReportInterval)) {
+            return;
+        }
+
+        DynamicAttributes attrs;
+        long long count = total - droppedReported;
+        attrs.add("dropped", count);
+        attrs.add("totalDropped", total);
+
+        fmt::memory_buffer buffer;
+        JSONFormatter(nullptr, timestampFormat)
+            .format(buffer,
+                    LogSeverity::Warning(),
+                    LogComponent::kControl,
+                    now,
+                    5600130,
+                    getThreadName(),
+                    "Dropped log records because the asynchronous log buffer was full",
+                    TypeErasedAttributeStorage(attrs),
+                    LogTag::kNone,
+                    LogTruncation::Disabled);
+        // Commented out log line below to get validation of the log id with the errorcodes
+        // linter LOGV2(5600130, "Dropped log records because the asynchronous log buffer was
+        // full");
+        backend->consume(boost::log::record_view(), string_type(buffer.data(), buffer.size()));
+
+        droppedReported = total;
+        lastDroppedReport = now;
+    }
+
+    boost::shared_ptr<FileRotateSink> backend;
+    const size_t bufferRecords;
+    const OverflowPolicy overflowPolicy;
+    const LogTimestampFormat timestampFormat;
+    const unsigned long long id = nextSinkId.fetchAndAdd(1);
+
+    AtomicWord<long long> dropped{0};
+    // Bytes of the records in the rings not yet written
+    AtomicWord<long long> bufferedBytes{0};
+    // Only accessed by the writer thread
+    long long droppedReported = 0;
+    Date_t lastDroppedReport;
+
+    // Serializes access to 'backend' between the writer thread, synchronous writes and rotation
+    stdx::mutex backendMutex;
+
+    // Guards the members below
+    stdx::mutex mutex;
+    stdx::condition_variable writerCV;
+    stdx::condition_variable flushedCV;
+    std::vector<std::shared_ptr<RingBuffer>> rings;
+    unsigned long long flushRequested = 0;
+    unsigned long long flushCompleted = 0;
+    bool shutdown = false;
+
+    AtomicWord<bool> writerIdle{false};
+    stdx::thread writer;
+
+    // Logging threads waiting for space in their ring or in the buffered bytes, with kBlock
+    AtomicWord<int> blockedProducers{0};
+    stdx::mutex spaceMutex;
+    stdx::condition_variable spaceCV;
+};
+
+AsyncFileRotateSink::AsyncFileRotateSink(boost::shared_ptr<FileRotateSink> backend,
+                                         size_t bufferRecords,
+                                         OverflowPolicy overflowPolicy,
+                                         LogTimestampFormat timestampFormat)
+    : _impl(std::make_unique<Impl>(
+          std::move(backend), bufferRecords, overflowPolicy, timestampFormat)) {}
+
+AsyncFileRotateSink::~AsyncFileRotateSink() {}
+
+Status AsyncFileRotateSink::rotate(bool rename, StringData renameSuffix) {
+    // Records logged before the rotation belong in the old file
+    flush();
+
+    stdx::lock_guard lk(_impl->backendMutex);
+    return _impl->backend->rotate(rename, renameSuffix);
+}
+
+void AsyncFileRotateSink::consume(const boost::log::record_view& rec,
+                                  const string_type& formatted_string) {
+    auto severity =
+        boost::log::extract<LogSeverity>(attributes::severity(), rec.attribute_values());
+    if (severity && severity.get() >= LogSeverity::Error()) {
+        // Errors often precede a quick exit which would lose buffered records, write everything
+        // out before returning
+        flush();
+        _impl->writeSynchronously(formatted_string);
+        return;
+    }
+
+    RingBuffer* ring = isAsyncLogWriterThread ? nullptr : _impl->ringForThisThread();
+    if (!ring) {
+        _impl->writeSynchronously(formatted_string);
+        return;
+    }
+
+    _impl->enqueue(ring, formatted_string);
+}
+
+void AsyncFileRotateSink::flush() {
+    if (isAsyncLogWriterThread) {
+        return;
+    }
+    _impl->flush();
+}
+
+long long AsyncFileRotateSink::droppedRecords() const {
+    return _impl->dropped.load();
+}
+
+}  // namespace mongo::logv2
@@ -0,0 +1,84 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/log/sinks/basic_sink_backend.hpp>
+#include <boost/log/sinks/frontend_requirements.hpp>
+#include <boost/shared_ptr.hpp>
+#include <memory>
+
+#include "mongo/base/status.h"
+#include "mongo/base/string_data.h"
+#include "mongo/logv2/log_format.h"
+
+namespace mongo::logv2 {
+class FileRotateSink;
+
+// boost::log backend sink that moves file I/O off the logging threads. Each logging thread appends
+// its formatted records to its own single-producer ring buffer without taking a lock, and a
+// dedicated writer thread drains the rings into the wrapped FileRotateSink. Records are formatted
+// on the logging thread because logv2 attributes refer to the caller's stack.
+//
+// When a ring is full the record either waits for the writer (kBlock) or is counted and dropped
+// (kDrop). A ring also counts as full while the records buffered across all rings exceed a fixed
+// number of bytes, and each ring keeps a bounded amount of slot memory for reuse once written. The
+// writer periodically reports the number of dropped records in the log file itself, and
+// serverStatus reports their total as metrics.log.asyncDroppedRecords. Error and severe records
+// are written synchronously so nothing is lost before a fatal exit.
+class AsyncFileRotateSink
+    : public boost::log::sinks::basic_formatted_sink_backend<
+          char,
+          boost::log::sinks::combine_requirements<boost::log::sinks::concurrent_feeding,
+                                                  boost::log::sinks::flushing>::type> {
+public:
+    enum class OverflowPolicy { kBlock, kDrop };
+
+    AsyncFileRotateSink(boost::shared_ptr<FileRotateSink> backend,
+                        size_t bufferRecords,
+                        OverflowPolicy overflowPolicy,
+                        LogTimestampFormat timestampFormat);
+    ~AsyncFileRotateSink();
+
+    Status rotate(bool rename, StringData renameSuffix);
+
+    void consume(const boost::log::record_view& rec, const string_type& formatted_string);
+
+    // Waits until every record consumed before the call has been written to the file
+    void flush();
+
+    // Number of records dropped because a ring buffer was full, since construction
+    long long droppedRecords() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> _impl;
+};
+
+}  // namespace mongo::logv2
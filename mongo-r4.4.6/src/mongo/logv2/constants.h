@@ -56,6 +56,9 @@ constexpr StringData kNullOptionalString = "(nothing)"_sd;
 constexpr LogTruncation kDefaultTruncation = LogTruncation::Enabled;
 constexpr int32_t kDefaultMaxAttributeOutputSizeKB = 10;
 
+// Number of records each logging thread can buffer when writing the log file asynchronously
+constexpr int32_t kDefaultAsyncBufferRecords = 1024;
+
 constexpr int32_t kUserAssertWithLogID = -1;
 
 }  // namespace mongo::logv2::constants
@@ -30,6 +30,7 @@
 #include "log_domain_global.h"
 
 #include "mongo/config.h"
+#include "mongo/logv2/async_file_rotate_sink.h"
 #include "mongo/logv2/component_settings_filter.h"
 #include "mongo/logv2/composite_backend.h"
 #include "mongo/logv2/console.h"
@@ -69,12 +70,16 @@ struct LogDomainGlobal::Impl {
 #endif
     typedef CompositeBackend<FileRotateSink, RamLogSink, RamLogSink, UserAssertSink>
         RotatableFileBackend;
+    typedef CompositeBackend<AsyncFileRotateSink, RamLogSink, RamLogSink, UserAssertSink>
+        AsyncRotatableFileBackend;
 
     Impl(LogDomainGlobal& parent);
     Status configure(LogDomainGlobal::ConfigurationOptions const& options);
     Status rotate(bool rename, StringData renameSuffix);
 
     const ConfigurationOptions& config() const;
+    long long droppedAsyncRecords() const;
+    void flushAsyncRecords();
 
     LogSource& source();
 
@@ -83,6 +88,8 @@ struct LogDomainGlobal::Impl {
     ConfigurationOptions _config;
     boost::shared_ptr<boost::log::sinks::unlocked_sink<ConsoleBackend>> _consoleSink;
     boost::shared_ptr<boost::log::sinks::unlocked_sink<RotatableFileBackend>> _rotatableFileSink;
+    boost::shared_ptr<boost::log::sinks::unlocked_sink<AsyncRotatableFileBackend>>
+        _asyncRotatableFileSink;
 #ifndef _WIN32
     boost::shared_ptr<boost::log::sinks::unlocked_sink<SyslogBackend>> _syslogSink;
 #endif
@@ -158,35 +165,73 @@ Status LogDomainGlobal::Impl::configure(LogDomainGlobal::ConfigurationOptions co
     }
 #endif
 
+    auto removeFileSinks = [this] {
+        if (_rotatableFileSink) {
+            boost::log::core::get()->remove_sink(_rotatableFileSink);
+            _rotatableFileSink.reset();
+        }
+        if (_asyncRotatableFileSink) {
+            boost::log::core::get()->remove_sink(_asyncRotatableFileSink);
+            _asyncRotatableFileSink.reset();
+        }
+    };
+
     if (options.fileEnabled) {
-        auto backend = boost::make_shared<RotatableFileBackend>(
-            boost::make_shared<FileRotateSink>(options.timestampFormat),
-            boost::make_shared<RamLogSink>(RamLog::get("global")),
-            boost::make_shared<RamLogSink>(RamLog::get("startupWarnings")),
-            boost::make_shared<UserAssertSink>());
-        Status ret = backend->lockedBackend<0>()->addFile(
+        auto fileSink = boost::make_shared<FileRotateSink>(options.timestampFormat);
+        Status ret = fileSink->addFile(
             options.filePath,
             options.fileOpenMode == ConfigurationOptions::OpenMode::kAppend ? true : false);
         if (!ret.isOK())
             return ret;
-        backend->lockedBackend<0>()->auto_flush(true);
-        backend->setFilter<2>(
-            TaggedSeverityFilter(_parent, {LogTag::kStartupWarnings}, LogSeverity::Log()));
-
-        _rotatableFileSink =
-            boost::make_shared<boost::log::sinks::unlocked_sink<RotatableFileBackend>>(backend);
-        _rotatableFileSink->set_filter(ComponentSettingsFilter(_parent, _settings));
-
-        boost::log::core::get()->add_sink(_rotatableFileSink);
-    } else if (_rotatableFileSink) {
-        boost::log::core::get()->remove_sink(_rotatableFileSink);
-        _rotatableFileSink.reset();
+        removeFileSinks();
+
+        if (options.fileAsync) {
+            // The writer thread flushes the file after every batch of records
+            fileSink->auto_flush(false);
+            auto backend = boost::make_shared<AsyncRotatableFileBackend>(
+                boost::make_shared<AsyncFileRotateSink>(std::move(fileSink),
+                                                        options.fileAsyncBufferRecords,
+                                                        options.fileAsyncOverflowPolicy,
+                                                        options.timestampFormat),
+                boost::make_shared<RamLogSink>(RamLog::get("global")),
+                boost::make_shared<RamLogSink>(RamLog::get("startupWarnings")),
+                boost::make_shared<UserAssertSink>());
+            backend->setFilter<2>(
+                TaggedSeverityFilter(_parent, {LogTag::kStartupWarnings}, LogSeverity::Log()));
+
+            _asyncRotatableFileSink =
+                boost::make_shared<boost::log::sinks::unlocked_sink<AsyncRotatableFileBackend>>(
+                    backend);
+            _asyncRotatableFileSink->set_filter(ComponentSettingsFilter(_parent, _settings));
+
+            boost::log::core::get()->add_sink(_asyncRotatableFileSink);
+        } else {
+            fileSink->auto_flush(true);
+            auto backend = boost::make_shared<RotatableFileBackend>(
+                std::move(fileSink),
+                boost::make_shared<RamLogSink>(RamLog::get("global")),
+                boost::make_shared<RamLogSink>(RamLog::get("startupWarnings")),
+                boost::make_shared<UserAssertSink>());
+            backend->setFilter<2>(
+                TaggedSeverityFilter(_parent, {LogTag::kStartupWarnings}, LogSeverity::Log()));
+
+            _rotatableFileSink =
+                boost::make_shared<boost::log::sinks::unlocked_sink<RotatableFileBackend>>(
+                    backend);
+            _rotatableFileSink->set_filter(ComponentSettingsFilter(_parent, _settings));
+
+            boost::log::core::get()->add_sink(_rotatableFileSink);
+        }
+    } else {
+        removeFileSinks();
     }
 
     auto setFormatters = [this](auto&& mkFmt) {
         _consoleSink->set_formatter(mkFmt());
         if (_rotatableFileSink)
             _rotatableFileSink->set_formatter(mkFmt());
+        if (_asyncRotatableFileSink)
+            _asyncRotatableFileSink->set_formatter(mkFmt());
 #ifndef _WIN32
         if (_syslogSink)
             _syslogSink->set_formatter(mkFmt());
@@ -228,9 +273,26 @@ Status LogDomainGlobal::Impl::rotate(bool rename, StringData renameSuffix) {
         auto backend = _rotatableFileSink->locked_backend()->lockedBackend<0>();
         return backend->rotate(rename, renameSuffix);
     }
+    if (_asyncRotatableFileSink) {
+        auto backend = _asyncRotatableFileSink->locked_backend()->lockedBackend<0>();
+        return backend->rotate(rename, renameSuffix);
+    }
     return Status::OK();
 }
 
+long long LogDomainGlobal::Impl::droppedAsyncRecords() const {
+    if (_asyncRotatableFileSink) {
+        return _asyncRotatableFileSink->locked_backend()->lockedBackend<0>()->droppedRecords();
+    }
+    return 0;
+}
+
+void LogDomainGlobal::Impl::flushAsyncRecords() {
+    if (_asyncRotatableFileSink) {
+        _asyncRotatableFileSink->locked_backend()->lockedBackend<0>()->flush();
+    }
+}
+
 LogSource& LogDomainGlobal::Impl::source() {
     // Use a thread_local logger so we don't need to have locking. thread_locals are destroyed
     // before statics so keep track of number of thread_locals we have active and if this code
@@ -288,5 +350,13 @@ LogComponentSettings& LogDomainGlobal::settings() {
     return _impl->_settings;
 }
 
+long long LogDomainGlobal::droppedAsyncRecords() const {
+    return _impl->droppedAsyncRecords();
+}
+
+void LogDomainGlobal::flushAsyncRecords() {
+    _impl->flushAsyncRecords();
+}
+
 }  // namespace logv2
 }  // namespace mongo
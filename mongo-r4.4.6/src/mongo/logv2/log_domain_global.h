@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include "mongo/logv2/async_file_rotate_sink.h"
 #include "mongo/logv2/constants.h"
 #include "mongo/logv2/log_domain_internal.h"
 #include "mongo/logv2/log_format.h"
@@ -46,6 +47,10 @@ public:
         std::string filePath;
         RotationMode fileRotationMode{RotationMode::kRename};
         OpenMode fileOpenMode{OpenMode::kTruncate};
+        bool fileAsync{false};
+        size_t fileAsyncBufferRecords{constants::kDefaultAsyncBufferRecords};
+        AsyncFileRotateSink::OverflowPolicy fileAsyncOverflowPolicy{
+            AsyncFileRotateSink::OverflowPolicy::kBlock};
         LogTimestampFormat timestampFormat{LogTimestampFormat::kISO8601UTC};
         bool syslogEnabled{false};
         int syslogFacility{-1};  // invalid facility by default, must be set
@@ -67,6 +72,12 @@ public:
 
     LogComponentSettings& settings();
 
+    // Number of records dropped by the asynchronous file sink since it was configured
+    long long droppedAsyncRecords() const;
+
+    // Waits until the records buffered by the asynchronous file sink have been written
+    void flushAsyncRecords();
+
 private:
     struct Impl;
     std::unique_ptr<Impl> _impl;
@@ -36,6 +36,7 @@
 #include "mongo/platform/basic.h"
 
 #include <benchmark/benchmark.h>
+#include <boost/filesystem/operations.hpp>
 #include <boost/iostreams/device/null.hpp>
 #include <boost/iostreams/stream.hpp>
 #include <boost/log/sinks/sync_frontend.hpp>
@@ -97,6 +98,47 @@ private:
     bool _shouldInit;
 };
 
+// RAII style helper class to log to a temporary file through the global domain, either
+// synchronously or through the asynchronous file sink.
+class ScopedFileLogV2Bench {
+public:
+    enum Mode { kSynchronous, kAsyncBlock, kAsyncDrop };
+
+    ScopedFileLogV2Bench(benchmark::State& state) : _state(state) {
+        _shouldInit = state.thread_index == 0;
+        if (_shouldInit) {
+            _path = (boost::filesystem::temp_directory_path() /
+                     boost::filesystem::unique_path("logv2_bm-%%%%-%%%%.log"))
+                        .string();
+
+            logv2::LogDomainGlobal::ConfigurationOptions config;
+            config.makeDisabled();
+            config.fileEnabled = true;
+            config.filePath = _path;
+            config.fileAsync = state.range(0) != kSynchronous;
+            config.fileAsyncOverflowPolicy = state.range(0) == kAsyncDrop
+                ? logv2::AsyncFileRotateSink::OverflowPolicy::kDrop
+                : logv2::AsyncFileRotateSink::OverflowPolicy::kBlock;
+            invariant(
+                logv2::LogManager::global().getGlobalDomainInternal().configure(config).isOK());
+        }
+    }
+
+    ~ScopedFileLogV2Bench() {
+        if (_shouldInit) {
+            auto& domain = logv2::LogManager::global().getGlobalDomainInternal();
+            _state.counters["dropped"] = domain.droppedAsyncRecords();
+            invariant(domain.configure({}).isOK());
+            boost::filesystem::remove(_path);
+        }
+    }
+
+private:
+    benchmark::State& _state;
+    std::string _path;
+    bool _shouldInit;
+};
+
 // "Expensive" way to create a string.
 std::string createLongString() {
     return std::string(1000, 'a') + std::string(1000, 'b') + std::string(1000, 'c') +
@@ -150,17 +192,41 @@ void BM_EnabledLogV2ManySmallArg(benchmark::State& state) {
     }
 }
 
+// Contended logging to a file, the time per iteration is what a logging thread waits for. Use
+// Arg 0 for the synchronous sink, 1 for the asynchronous sink blocking when full and 2 for the
+// asynchronous sink dropping records when full.
+void BM_FileLogV2(benchmark::State& state) {
+    ScopedFileLogV2Bench init(state);
+
+    for (auto _ : state) {
+        LOGV2(5600134,
+              "Slow query",
+              "ns"_attr = "test.coll"_sd,
+              "durationMillis"_attr = 150,
+              "planSummary"_attr = "IXSCAN { a: 1 }"_sd);
+    }
+}
+
 void ThreadCounts(benchmark::internal::Benchmark* b) {
     int tc[] = {1, 2, 4, 8};
     for (int t : tc)
         b->Threads(t);
 }
 
+void FileLogArgs(benchmark::internal::Benchmark* b) {
+    b->Arg(ScopedFileLogV2Bench::kSynchronous);
+    b->Arg(ScopedFileLogV2Bench::kAsyncBlock);
+    b->Arg(ScopedFileLogV2Bench::kAsyncDrop);
+    for (int t : {1, 4, 16})
+        b->Threads(t);
+}
+
 BENCHMARK(BM_NoopLogV2)->Apply(ThreadCounts);
 BENCHMARK(BM_NoopLogV2Arg)->Apply(ThreadCounts);
 BENCHMARK(BM_EnabledLogV2)->Apply(ThreadCounts);
 BENCHMARK(BM_EnabledLogV2ExpensiveArg)->Apply(ThreadCounts);
 BENCHMARK(BM_EnabledLogV2ManySmallArg)->Apply(ThreadCounts);
+BENCHMARK(BM_FileLogV2)->Apply(FileLogArgs)->UseRealTime();
 
 }  // namespace
 }  // namespace mongo
@@ -40,10 +40,12 @@
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/bson/json.h"
 #include "mongo/bson/oid.h"
+#include "mongo/logv2/async_file_rotate_sink.h"
 #include "mongo/logv2/bson_formatter.h"
 #include "mongo/logv2/component_settings_filter.h"
 #include "mongo/logv2/composite_backend.h"
 #include "mongo/logv2/constants.h"
+#include "mongo/logv2/file_rotate_sink.h"
 #include "mongo/logv2/json_formatter.h"
 #include "mongo/logv2/log.h"
 #include "mongo/logv2/log_capture_backend.h"
@@ -1711,6 +1713,107 @@ TEST_F(LogV2Test, FileLogging) {
     ASSERT(before_rotation == after_rotation);
 }
 
+TEST_F(LogV2Test, AsyncFileLogging) {
+    auto logv2_dir = std::make_unique<mongo::unittest::TempDir>("logv2");
+    std::string file_name = logv2_dir->path() + "/file.log";
+
+    auto readFile = [&](std::string const& filename) {
+        std::vector<std::string> lines;
+        std::ifstream file(filename);
+        for (std::string line; std::getline(file, line, '\n');)
+            lines.push_back(std::move(line));
+        return lines;
+    };
+
+    auto fileSink = boost::make_shared<FileRotateSink>(LogTimestampFormat::kISO8601UTC);
+    ASSERT_OK(fileSink->addFile(file_name, false));
+    auto backend = boost::make_shared<AsyncFileRotateSink>(
+        fileSink, 16, AsyncFileRotateSink::OverflowPolicy::kBlock, LogTimestampFormat::kISO8601UTC);
+    auto sink = wrapInUnlockedSink(backend);
+    applyDefaultFilterToSink(sink);
+    sink->set_formatter(PlainFormatter());
+    attachSink(sink);
+
+    // Records from every thread reach the file once the sink is flushed, none are dropped when
+    // the threads block on a full buffer.
+    constexpr int kNumPerThread = 1000;
+    std::vector<stdx::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&]() {
+            for (int i = 0; i < kNumPerThread; ++i)
+                LOGV2(5600131, "async");
+        });
+    }
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+
+    backend->flush();
+    auto lines = readFile(file_name);
+    ASSERT_EQ(lines.size(), threads.size() * kNumPerThread);
+    ASSERT_EQ(backend->droppedRecords(), 0);
+
+    // Rotation writes out buffered records before switching files
+    LOGV2(5600132, "before rotation");
+    ASSERT_OK(backend->rotate(true, ".rotated"));
+    ASSERT_EQ(readFile(file_name + ".rotated").back(), "before rotation");
+    ASSERT(readFile(file_name).empty());
+}
+
+TEST_F(LogV2Test, AsyncFileLoggingDrop) {
+    auto logv2_dir = std::make_unique<mongo::unittest::TempDir>("logv2");
+    std::string file_name = logv2_dir->path() + "/file.log";
+
+    auto fileSink = boost::make_shared<FileRotateSink>(LogTimestampFormat::kISO8601UTC);
+    ASSERT_OK(fileSink->addFile(file_name, false));
+    auto backend = boost::make_shared<AsyncFileRotateSink>(
+        fileSink, 1, AsyncFileRotateSink::OverflowPolicy::kDrop, LogTimestampFormat::kISO8601UTC);
+    auto sink = wrapInUnlockedSink(backend);
+    applyDefaultFilterToSink(sink);
+    sink->set_formatter(PlainFormatter());
+    attachSink(sink);
+
+    constexpr int kNumRecords = 10000;
+    for (int i = 0; i < kNumRecords; ++i)
+        LOGV2(5600133, "maybe dropped");
+    backend->flush();
+
+    // Every record is either written or counted as dropped. The drop report is JSON.
+    long long written = 0;
+    std::ifstream file(file_name);
+    for (std::string line; std::getline(file, line, '\n');) {
+        if (line == "maybe dropped")
+            ++written;
+    }
+    ASSERT_EQ(written + backend->droppedRecords(), kNumRecords);
+}
+
+TEST_F(LogV2Test, AsyncFileLoggingErrorIsSynchronous) {
+    auto logv2_dir = std::make_unique<mongo::unittest::TempDir>("logv2");
+    std::string file_name = logv2_dir->path() + "/file.log";
+
+    auto fileSink = boost::make_shared<FileRotateSink>(LogTimestampFormat::kISO8601UTC);
+    ASSERT_OK(fileSink->addFile(file_name, false));
+    auto backend = boost::make_shared<AsyncFileRotateSink>(
+        fileSink, 16, AsyncFileRotateSink::OverflowPolicy::kBlock, LogTimestampFormat::kISO8601UTC);
+    auto sink = wrapInUnlockedSink(backend);
+    applyDefaultFilterToSink(sink);
+    sink->set_formatter(PlainFormatter());
+    attachSink(sink);
+
+    // An error may be followed by a quick exit, so it is in the file, after the records buffered
+    // before it, by the time it returns.
+    LOGV2(5600152, "buffered");
+    LOGV2_ERROR(5600153, "error");
+    std::vector<std::string> lines;
+    std::ifstream file(file_name);
+    for (std::string line; std::getline(file, line, '\n');)
+        lines.push_back(std::move(line));
+    ASSERT_EQ(lines.size(), 2u);
+    ASSERT_EQ(lines[0], "buffered");
+    ASSERT_EQ(lines[1], "error");
+}
+
 TEST_F(LogV2Test, UserAssert) {
     std::vector<std::string> lines;
     auto sink = wrapInSynchronousSink(wrapInCompositeBackend(
@@ -33,6 +33,8 @@
 
 #include "mongo/s/chunk_manager.h"
 
+#include <numeric>
+
 #include "mongo/base/owned_pointer_vector.h"
 #include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/db/matcher/extensions_callback_noop.h"
@@ -67,6 +69,22 @@ void checkAllElementsAreOfType(BSONType type, const BSONObj& o) {
             allElementsAreOfType(type, o));
 }
 
+void checkChunksAreAdjacent(const ChunkInfo& left, const ChunkInfo& right) {
+    const auto& leftMax = left.getMax();
+    const auto& rightMin = right.getMin();
+    if (SimpleBSONObjComparator::kInstance.evaluate(leftMax == rightMin)) {
+        return;
+    }
+
+    uasserted(ErrorCodes::ConflictingOperationInProgress,
+              str::stream() << (SimpleBSONObjComparator::kInstance.evaluate(leftMax < rightMin)
+                                    ? "Gap"
+                                    : "Overlap")
+                            << " exists in the routing table between chunks "
+                            << left.getRange().toString() << " and "
+                            << right.getRange().toString());
+}
+
 std::string extractKeyStringInternal(const BSONObj& shardKeyValue, Ordering ordering) {
     BSONObjBuilder strippedKeyValue;
     for (const auto& elem : shardKeyValue) {
@@ -87,7 +105,7 @@ RoutingTableHistory::RoutingTableHistory(NamespaceString nss,
                                          KeyPattern shardKeyPattern,
                                          std::unique_ptr<CollatorInterface> defaultCollator,
                                          bool unique,
-                                         ChunkInfoMap chunkMap,
+                                         ChunkMap chunkMap,
                                          ChunkVersion collectionVersion)
     : _sequenceNumber(nextCMSequenceNumber.addAndFetch(1)),
       _nss(std::move(nss)),
@@ -100,6 +118,25 @@ RoutingTableHistory::RoutingTableHistory(NamespaceString nss,
       _collectionVersion(collectionVersion),
       _shardVersions(_constructShardVersionMap()) {}
 
+RoutingTableHistory::RoutingTableHistory(NamespaceString nss,
+                                         boost::optional<UUID> uuid,
+                                         KeyPattern shardKeyPattern,
+                                         std::unique_ptr<CollatorInterface> defaultCollator,
+                                         bool unique,
+                                         ChunkMap chunkMap,
+                                         ChunkVersion collectionVersion,
+                                         ShardVersionMap shardVersions)
+    : _sequenceNumber(nextCMSequenceNumber.addAndFetch(1)),
+      _nss(std::move(nss)),
+      _uuid(uuid),
+      _shardKeyPattern(shardKeyPattern),
+      _shardKeyOrdering(Ordering::make(_shardKeyPattern.toBSON())),
+      _defaultCollator(std::move(defaultCollator)),
+      _unique(unique),
+      _chunkMap(std::move(chunkMap)),
+      _collectionVersion(collectionVersion),
+      _shardVersions(std::move(shardVersions)) {}
+
 void RoutingTableHistory::setShardStale(const ShardId& shardId) {
     if (gEnableFinerGrainedCatalogCacheRefresh) {
         auto it = _shardVersions.find(shardId);
@@ -138,6 +175,51 @@ Chunk ChunkManager::findIntersectingChunk(const BSONObj& shardKey, const BSONObj
     return Chunk(*(it->second), _clusterTime);
 }
 
+std::vector<StatusWith<ShardId>> ChunkManager::getShardIdsForKeysWithSimpleCollation(
+    const std::vector<BSONObj>& shardKeys) const {
+    std::vector<std::string> keyStrings;
+    keyStrings.reserve(shardKeys.size());
+    for (const auto& shardKey : shardKeys) {
+        keyStrings.push_back(_rt->_extractKeyString(shardKey));
+    }
+
+    std::vector<size_t> keyOrder(shardKeys.size());
+    std::iota(keyOrder.begin(), keyOrder.end(), 0);
+    std::sort(keyOrder.begin(), keyOrder.end(), [&keyStrings](size_t lhs, size_t rhs) {
+        return keyStrings[lhs] < keyStrings[rhs];
+    });
+
+    std::vector<StatusWith<ShardId>> shardIds(
+        shardKeys.size(), StatusWith<ShardId>(ErrorCodes::ShardKeyNotFound, "not targeted"));
+
+    const auto& chunkMap = _rt->getChunkMap();
+    auto it = chunkMap.end();
+    for (const auto i : keyOrder) {
+        // The chunk which contained the previous key also contains this one, unless this key has
+        // reached the chunk's max.
+        if (it == chunkMap.end() || keyStrings[i] >= it->first) {
+            it = chunkMap.upper_bound(keyStrings[i]);
+        }
+
+        if (it == chunkMap.end() || !it->second->containsKey(shardKeys[i])) {
+            shardIds[i] = {ErrorCodes::ShardKeyNotFound,
+                           str::stream() << "Cannot target single shard using key " << shardKeys[i]
+                                         << " for namespace " << getns()};
+            continue;
+        }
+
+        // The chunk may have no history as of the cluster time of a snapshot read. Only that key
+        // fails to be targeted.
+        try {
+            shardIds[i] = it->second->getShardIdAt(_clusterTime);
+        } catch (const ExceptionFor<ErrorCodes::StaleChunkHistory>& ex) {
+            shardIds[i] = ex.toStatus();
+        }
+    }
+
+    return shardIds;
+}
+
 bool ChunkManager::keyBelongsToShard(const BSONObj& shardKey, const ShardId& shardId) const {
     if (shardKey.isEmpty())
         return false;
@@ -289,7 +371,7 @@ int RoutingTableHistory::getNShardsOwningChunks() const {
     return _shardVersions.size();
 }
 
-std::pair<ChunkInfoMap::const_iterator, ChunkInfoMap::const_iterator>
+std::pair<ChunkMap::const_iterator, ChunkMap::const_iterator>
 RoutingTableHistory::overlappingRanges(const BSONObj& min,
                                        const BSONObj& max,
                                        bool isMaxInclusive) const {
@@ -495,7 +577,7 @@ ShardVersionMap RoutingTableHistory::_constructShardVersionMap() const {
     const OID& epoch = _collectionVersion.epoch();
 
     ShardVersionMap shardVersions;
-    ChunkInfoMap::const_iterator current = _chunkMap.cbegin();
+    ChunkMap::const_iterator current = _chunkMap.cbegin();
 
     boost::optional<BSONObj> firstMin = boost::none;
     boost::optional<BSONObj> lastMax = boost::none;
@@ -511,17 +593,20 @@ ShardVersionMap RoutingTableHistory::_constructShardVersionMap() const {
         }
 
         auto& maxShardVersion = shardVersionIt->second.shardVersion;
+        auto& numChunks = shardVersionIt->second.numChunks;
 
         current =
             std::find_if(current,
                          _chunkMap.cend(),
-                         [&currentRangeShardId,
-                          &maxShardVersion](const ChunkInfoMap::value_type& chunkMapEntry) {
+                         [&currentRangeShardId, &maxShardVersion, &numChunks](
+                             const ChunkMap::value_type& chunkMapEntry) {
                              const auto& currentChunk = chunkMapEntry.second;
 
                              if (currentChunk->getShardIdAt(boost::none) != currentRangeShardId)
                                  return true;
 
+                             ++numChunks;
+
                              if (currentChunk->getLastmod() > maxShardVersion)
                                  maxShardVersion = currentChunk->getLastmod();
 
@@ -539,13 +624,17 @@ ShardVersionMap RoutingTableHistory::_constructShardVersionMap() const {
                 uasserted(ErrorCodes::ConflictingOperationInProgress,
                           str::stream()
                               << "Gap exists in the routing table between chunks "
-                              << _chunkMap.at(_extractKeyString(*lastMax))->getRange().toString()
+                              << _chunkMap.lower_bound(_extractKeyString(*lastMax))
+                                     ->second->getRange()
+                                     .toString()
                               << " and " << rangeLast->second->getRange().toString());
             else
                 uasserted(ErrorCodes::ConflictingOperationInProgress,
                           str::stream()
                               << "Overlap exists in the routing table between chunks "
-                              << _chunkMap.at(_extractKeyString(*lastMax))->getRange().toString()
+                              << _chunkMap.lower_bound(_extractKeyString(*lastMax))
+                                     ->second->getRange()
+                                     .toString()
                               << " and " << rangeLast->second->getRange().toString());
         }
 
@@ -571,6 +660,28 @@ ShardVersionMap RoutingTableHistory::_constructShardVersionMap() const {
     return shardVersions;
 }
 
+void RoutingTableHistory::_checkContinuityAround(const ChunkMap& chunkMap,
+                                                 const ChunkInfo& chunk) const {
+    const auto it = chunkMap.lower_bound(_extractKeyString(chunk.getMax()));
+    if (it == chunkMap.end() || it->second.get() != &chunk) {
+        // The chunk was itself replaced by a later change in the same refresh.
+        return;
+    }
+
+    if (it == chunkMap.begin()) {
+        checkAllElementsAreOfType(MinKey, chunk.getMin());
+    } else {
+        checkChunksAreAdjacent(*std::prev(it)->second, chunk);
+    }
+
+    const auto next = std::next(it);
+    if (next == chunkMap.end()) {
+        checkAllElementsAreOfType(MaxKey, chunk.getMax());
+    } else {
+        checkChunksAreAdjacent(chunk, *next->second);
+    }
+}
+
 std::string RoutingTableHistory::_extractKeyString(const BSONObj& shardKeyValue) const {
     return extractKeyStringInternal(shardKeyValue, _shardKeyOrdering);
 }
@@ -599,6 +710,28 @@ std::shared_ptr<RoutingTableHistory> RoutingTableHistory::makeUpdated(
     const auto startingCollectionVersion = getVersion();
     auto chunkMap = _chunkMap;
 
+    // When updating an existing routing table, the shard versions are derived from the current
+    // ones by accounting for the chunks which were replaced and inserted, instead of by another
+    // pass over the entire chunk map.
+    struct ShardChunksInfo {
+        ChunkVersion maxVersion;
+        size_t numChunks;
+
+        // Set if the chunk which defined 'maxVersion' was replaced and no other chunk has been
+        // placed on the shard since, in which case the shard's max version must be recomputed.
+        bool maxVersionRemoved;
+    };
+    const bool isIncremental = !_chunkMap.empty();
+    std::map<ShardId, ShardChunksInfo> shardChunks;
+    std::vector<std::shared_ptr<ChunkInfo>> insertedChunks;
+    if (isIncremental) {
+        for (const auto& [shardId, targetingInfo] : _shardVersions) {
+            shardChunks.emplace(
+                shardId,
+                ShardChunksInfo{targetingInfo.shardVersion, targetingInfo.numChunks, false});
+        }
+    }
+
     ChunkVersion collectionVersion = startingCollectionVersion;
     for (const auto& chunk : changedChunks) {
         const auto& chunkVersion = chunk.getVersion();
@@ -647,11 +780,37 @@ std::shared_ptr<RoutingTableHistory> RoutingTableHistory::makeUpdated(
             newChunk->getWritesTracker()->addBytesWritten(bytesInReplacedChunk);
         }
 
-        // Erase all chunks from the map, which overlap the chunk we got from the persistent store
-        chunkMap.erase(low, high);
+        if (isIncremental) {
+            for (auto it = low; it != high; ++it) {
+                const auto& replacedChunk = *it->second;
+                auto shardIt = shardChunks.find(replacedChunk.getShardIdAt(boost::none));
+                invariant(shardIt != shardChunks.end());
+                auto& shardInfo = shardIt->second;
+
+                invariant(shardInfo.numChunks > 0);
+                --shardInfo.numChunks;
+                if (replacedChunk.getLastmod() == shardInfo.maxVersion) {
+                    shardInfo.maxVersionRemoved = true;
+                }
+            }
+
+            // Changes are applied in ascending version order, so the new chunk always carries the
+            // highest version on its shard.
+            auto& shardInfo =
+                shardChunks
+                    .emplace(newChunk->getShardIdAt(boost::none),
+                             ShardChunksInfo{ChunkVersion(0, 0, chunkVersion.epoch()), 0, false})
+                    .first->second;
+            ++shardInfo.numChunks;
+            shardInfo.maxVersion = chunkVersion;
+            shardInfo.maxVersionRemoved = false;
+
+            insertedChunks.push_back(newChunk);
+        }
 
-        // Insert only the chunk itself
-        chunkMap.insert(std::make_pair(chunkMaxKeyString, newChunk));
+        // Replace all chunks in the map which overlap the chunk we got from the persistent store
+        // with only the chunk itself
+        chunkMap.replaceRange(low, high, std::make_pair(chunkMaxKeyString, std::move(newChunk)));
     }
 
     // If at least one diff was applied, the metadata is correct, but it might not have changed so
@@ -665,6 +824,42 @@ std::shared_ptr<RoutingTableHistory> RoutingTableHistory::makeUpdated(
         return shared_from_this();
     }
 
+    if (isIncremental) {
+        // Gaps and overlaps can only have been introduced next to the chunks which changed.
+        for (const auto& chunk : insertedChunks) {
+            _checkContinuityAround(chunkMap, *chunk);
+        }
+
+        const bool needsFullShardVersionRebuild =
+            std::any_of(shardChunks.begin(), shardChunks.end(), [](const auto& entry) {
+                return entry.second.numChunks > 0 && entry.second.maxVersionRemoved;
+            });
+
+        if (!needsFullShardVersionRebuild) {
+            ShardVersionMap shardVersions;
+            for (const auto& [shardId, shardInfo] : shardChunks) {
+                if (shardInfo.numChunks == 0) {
+                    continue;
+                }
+
+                auto& targetingInfo =
+                    shardVersions.emplace(shardId, collectionVersion.epoch()).first->second;
+                targetingInfo.shardVersion = shardInfo.maxVersion;
+                targetingInfo.numChunks = shardInfo.numChunks;
+            }
+
+            return std::shared_ptr<RoutingTableHistory>(
+                new RoutingTableHistory(_nss,
+                                        _uuid,
+                                        KeyPattern(getShardKeyPattern().getKeyPattern()),
+                                        CollatorInterface::cloneCollator(getDefaultCollator()),
+                                        isUnique(),
+                                        std::move(chunkMap),
+                                        collectionVersion,
+                                        std::move(shardVersions)));
+        }
+    }
+
     return std::shared_ptr<RoutingTableHistory>(
         new RoutingTableHistory(_nss,
                                 _uuid,
@@ -37,6 +37,7 @@
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/query/collation/collator_interface.h"
 #include "mongo/s/chunk.h"
+#include "mongo/s/chunk_map.h"
 #include "mongo/s/chunk_version.h"
 #include "mongo/s/client/shard.h"
 #include "mongo/s/shard_key_pattern.h"
@@ -49,9 +50,6 @@ struct QuerySolutionNode;
 class OperationContext;
 class ChunkManager;
 
-// Ordered map from the max for each chunk to an entry describing the chunk
-using ChunkInfoMap = std::map<std::string, std::shared_ptr<ChunkInfo>>;
-
 struct ShardVersionTargetingInfo {
     // Indicates whether the shard is stale and thus needs a catalog cache refresh. Is false by
     // default.
@@ -60,6 +58,9 @@ struct ShardVersionTargetingInfo {
     // Max chunk version for the shard.
     ChunkVersion shardVersion;
 
+    // Number of chunks owned by the shard.
+    size_t numChunks{0};
+
     ShardVersionTargetingInfo(const OID& epoch);
 };
 
@@ -102,6 +103,10 @@ public:
      *
      * The changes in "changedChunks" must be sorted in ascending order by chunk version, and adhere
      * to the requirements of the routing table update algorithm.
+     *
+     * The new instance shares the unchanged parts of the chunk map with this one, and its shard
+     * versions are derived from this instance's, so the cost is proportional to the number of
+     * changed chunks rather than to the size of the routing table.
      */
     std::shared_ptr<RoutingTableHistory> makeUpdated(const std::vector<ChunkType>& changedChunks);
 
@@ -157,7 +162,7 @@ public:
      */
     ChunkVersion getVersionForLogging(const ShardId& shardId) const;
 
-    const ChunkInfoMap& getChunkMap() const {
+    const ChunkMap& getChunkMap() const {
         return _chunkMap;
     }
 
@@ -186,7 +191,7 @@ public:
         return _uuid;
     }
 
-    std::pair<ChunkInfoMap::const_iterator, ChunkInfoMap::const_iterator> overlappingRanges(
+    std::pair<ChunkMap::const_iterator, ChunkMap::const_iterator> overlappingRanges(
         const BSONObj& min, const BSONObj& max, bool isMaxInclusive) const;
 
 
@@ -196,14 +201,30 @@ private:
                         KeyPattern shardKeyPattern,
                         std::unique_ptr<CollatorInterface> defaultCollator,
                         bool unique,
-                        ChunkInfoMap chunkMap,
+                        ChunkMap chunkMap,
                         ChunkVersion collectionVersion);
 
+    RoutingTableHistory(NamespaceString nss,
+                        boost::optional<UUID> uuid,
+                        KeyPattern shardKeyPattern,
+                        std::unique_ptr<CollatorInterface> defaultCollator,
+                        bool unique,
+                        ChunkMap chunkMap,
+                        ChunkVersion collectionVersion,
+                        ShardVersionMap shardVersions);
+
     /**
      * Does a single pass over the chunkMap and constructs the ShardVersionMap object.
      */
     ShardVersionMap _constructShardVersionMap() const;
 
+    /**
+     * Checks that the entry for "chunk" in "chunkMap" abuts its neighbours, and that it starts at
+     * MinKey or ends at MaxKey if it is the first or last chunk. Used to validate an incrementally
+     * updated map, where gaps and overlaps can only appear next to the changed chunks.
+     */
+    void _checkContinuityAround(const ChunkMap& chunkMap, const ChunkInfo& chunk) const;
+
     ChunkVersion _getVersion(const ShardId& shardName, bool throwOnStaleShard) const;
 
     std::string _extractKeyString(const BSONObj& shardKeyValue) const;
@@ -231,7 +252,7 @@ private:
 
     // Map from the max for each chunk to an entry describing the chunk. The union of all chunks'
     // ranges must cover the complete space from [MinKey, MaxKey).
-    const ChunkInfoMap _chunkMap;
+    const ChunkMap _chunkMap;
 
     // Max version across all chunks
     const ChunkVersion _collectionVersion;
@@ -253,7 +274,7 @@ public:
     class ConstChunkIterator {
     public:
         ConstChunkIterator() = default;
-        explicit ConstChunkIterator(ChunkInfoMap::const_iterator iter,
+        explicit ConstChunkIterator(ChunkMap::const_iterator iter,
                                     boost::optional<Timestamp> clusterTime)
             : _iter{std::move(iter)}, _clusterTime{std::move(clusterTime)} {}
 
@@ -275,7 +296,7 @@ public:
         }
 
     private:
-        ChunkInfoMap::const_iterator _iter;
+        ChunkMap::const_iterator _iter;
         boost::optional<Timestamp> _clusterTime;
     };
 
@@ -383,6 +404,19 @@ public:
         return findIntersectingChunk(shardKey, CollationSpec::kSimpleSpec);
     }
 
+    /**
+     * Bulk version of findIntersectingChunkWithSimpleCollation, which returns the id of the shard
+     * owning the chunk that contains each of "shardKeys", or ShardKeyNotFound for the keys which
+     * are not contained in any chunk, or StaleChunkHistory for the keys whose chunk has no history
+     * as of the cluster time.
+     *
+     * The keys are encoded and sorted once and the chunk map is walked in key order, so runs of
+     * keys which fall into the same chunk, such as monotonically increasing keys, are resolved
+     * without any further lookups.
+     */
+    std::vector<StatusWith<ShardId>> getShardIdsForKeysWithSimpleCollation(
+        const std::vector<BSONObj>& shardKeys) const;
+
     /**
      * Finds the shard id of the shard that owns the chunk minKey belongs to, assuming the simple
      * collation because shard keys do not support non-simple collations.
@@ -521,5 +521,32 @@ TEST_F(ChunkManagerQueryTest, SnapshotQueryWithMoreShardsThanLatestMetadata) {
     ASSERT_EQ(2, shardIds.size());
 }
 
+TEST_F(ChunkManagerQueryTest, GetShardIdsForKeysReportsStaleChunkHistoryPerKey) {
+    const auto epoch = OID::gen();
+    ChunkVersion version(1, 0, epoch);
+
+    ChunkType chunk0(kNss, {BSON("x" << MINKEY), BSON("x" << 0)}, version, ShardId("0"));
+    chunk0.setName(OID::gen());
+    chunk0.setHistory({ChunkHistory(Timestamp(1, 0), ShardId("0"))});
+
+    // The second chunk has no history as of the cluster time below.
+    version.incMajor();
+    ChunkType chunk1(kNss, {BSON("x" << 0), BSON("x" << MAXKEY)}, version, ShardId("1"));
+    chunk1.setName(OID::gen());
+    chunk1.setHistory({ChunkHistory(Timestamp(20, 0), ShardId("1"))});
+
+    auto routingTable = RoutingTableHistory::makeNew(
+        kNss, boost::none, BSON("x" << 1), nullptr, false, epoch, {chunk0, chunk1});
+    ChunkManager chunkManager(routingTable, Timestamp(5, 0));
+
+    auto shardIds = chunkManager.getShardIdsForKeysWithSimpleCollation(
+        {BSON("x" << 10), BSON("x" << -10), BSON("x" << 20)});
+    ASSERT_EQ(3U, shardIds.size());
+    ASSERT_EQ(ErrorCodes::StaleChunkHistory, shardIds[0].getStatus());
+    ASSERT_OK(shardIds[1].getStatus());
+    ASSERT_EQ(ShardId("0"), shardIds[1].getValue());
+    ASSERT_EQ(ErrorCodes::StaleChunkHistory, shardIds[2].getStatus());
+}
+
 }  // namespace
 }  // namespace mongo
@@ -124,6 +124,66 @@ void BM_IncrementalRefreshOfPessimalBalancedDistribution(benchmark::State& state
 
 BENCHMARK(BM_IncrementalRefreshOfPessimalBalancedDistribution)->Args({2, 50000});
 
+/**
+ * Applies a migration (a moved chunk plus the version bump of a chunk left on the donor) to a
+ * routing table and measures the cost of building the refreshed routing table.
+ */
+template <typename ShardSelectorFn>
+void BM_IncrementalRefreshAfterMigration(benchmark::State& state, ShardSelectorFn selectShard) {
+    const int nShards = state.range(0);
+    const int nChunks = state.range(1);
+    auto cm = makeChunkManagerWithShardSelector(nShards, nChunks, selectShard);
+
+    const auto collName = NamespaceString(cm->getChunkManager()->getns());
+    const int movedChunk = nChunks / 2;
+    const auto donor = selectShard(movedChunk, nShards, nChunks);
+    const auto recipient = selectShard(movedChunk + 1, nShards, nChunks);
+
+    auto postMoveVersion = cm->getChunkManager()->getVersion();
+    std::vector<ChunkType> newChunks;
+    postMoveVersion.incMajor();
+    newChunks.emplace_back(
+        collName, getRangeForChunk(movedChunk, nChunks), postMoveVersion, recipient);
+    postMoveVersion.incMinor();
+    newChunks.emplace_back(collName, getRangeForChunk(0, nChunks), postMoveVersion, donor);
+
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(runIncrementalUpdate(*cm, newChunks));
+    }
+}
+
+/**
+ * Splits a single chunk of a routing table into 'nSplits' chunks and measures the cost of building
+ * the refreshed routing table.
+ */
+template <typename ShardSelectorFn>
+void BM_IncrementalRefreshAfterSplit(benchmark::State& state, ShardSelectorFn selectShard) {
+    const int nShards = state.range(0);
+    const int nChunks = state.range(1);
+    constexpr int nSplits = 10;
+    auto cm = makeChunkManagerWithShardSelector(nShards, nChunks, selectShard);
+
+    const auto collName = NamespaceString(cm->getChunkManager()->getns());
+    const int splitChunk = nChunks / 2;
+    const auto owner = selectShard(splitChunk, nShards, nChunks);
+    const auto range = getRangeForChunk(splitChunk, nChunks);
+    const int rangeMin = range.getMin()["_id"].numberInt();
+
+    auto postSplitVersion = cm->getChunkManager()->getVersion();
+    postSplitVersion.incMajor();
+    std::vector<ChunkType> newChunks;
+    for (int i = 0; i < nSplits; ++i) {
+        const auto min = i == 0 ? range.getMin() : BSON("_id" << rangeMin + i * 10);
+        const auto max = i + 1 == nSplits ? range.getMax() : BSON("_id" << rangeMin + (i + 1) * 10);
+        newChunks.emplace_back(collName, ChunkRange{min, max}, postSplitVersion, owner);
+        postSplitVersion.incMinor();
+    }
+
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(runIncrementalUpdate(*cm, newChunks));
+    }
+}
+
 template <typename ShardSelectorFn>
 auto BM_FullBuildOfChunkManager(benchmark::State& state, ShardSelectorFn selectShard) {
     const int nShards = state.range(0);
@@ -416,6 +476,25 @@ MONGO_INITIALIZER(RegisterBenchmarks)(InitializerContext* context) {
             ->Args({2, 2});
     }
 
+    // Refreshes are compared against full builds of the same routing tables, up to the sizes at
+    // which a full rebuild takes seconds.
+    std::initializer_list<benchmark::internal::Benchmark*> refreshCases{
+        REGISTER_BENCHMARK_CAPTURE(BM_FullBuildOfChunkManager, Optimal, optimalShardSelector),
+        REGISTER_BENCHMARK_CAPTURE(
+            BM_IncrementalRefreshAfterMigration, Pessimal, pessimalShardSelector),
+        REGISTER_BENCHMARK_CAPTURE(
+            BM_IncrementalRefreshAfterMigration, Optimal, optimalShardSelector),
+        REGISTER_BENCHMARK_CAPTURE(
+            BM_IncrementalRefreshAfterSplit, Pessimal, pessimalShardSelector),
+        REGISTER_BENCHMARK_CAPTURE(BM_IncrementalRefreshAfterSplit, Optimal, optimalShardSelector),
+        REGISTER_BENCHMARK_CAPTURE(
+            BM_FindIntersectingChunk, Optimal, makeChunkManagerWithOptimalBalancedDistribution),
+    };
+
+    for (auto bmCase : refreshCases) {
+        bmCase->Args({10, 500000})->Args({100, 1000000})->Unit(benchmark::kMicrosecond);
+    }
+
     return Status::OK();
 }
 
@@ -0,0 +1,177 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/chunk_map.h"
+
+#include <algorithm>
+
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+namespace {
+
+const auto kKeyLessThanEntry = [](const std::string& key, const ChunkMap::value_type& entry) {
+    return key < entry.first;
+};
+
+const auto kEntryLessThanKey = [](const ChunkMap::value_type& entry, const std::string& key) {
+    return entry.first < key;
+};
+
+}  // namespace
+
+ChunkMap::const_iterator ChunkMap::upper_bound(const std::string& key) const {
+    const auto blockIt = std::upper_bound(_blockMaxKeys.begin(), _blockMaxKeys.end(), key);
+    const size_t blockIndex = std::distance(_blockMaxKeys.begin(), blockIt);
+    if (blockIndex == _blocks.size()) {
+        return end();
+    }
+
+    // The max key of this block sorts after 'key', so the search cannot run off its end.
+    const auto& block = *_blocks[blockIndex];
+    const auto it = std::upper_bound(block.begin(), block.end(), key, kKeyLessThanEntry);
+    return {&_blocks, blockIndex, size_t(std::distance(block.begin(), it))};
+}
+
+ChunkMap::const_iterator ChunkMap::lower_bound(const std::string& key) const {
+    const auto blockIt = std::lower_bound(_blockMaxKeys.begin(), _blockMaxKeys.end(), key);
+    const size_t blockIndex = std::distance(_blockMaxKeys.begin(), blockIt);
+    if (blockIndex == _blocks.size()) {
+        return end();
+    }
+
+    const auto& block = *_blocks[blockIndex];
+    const auto it = std::lower_bound(block.begin(), block.end(), key, kEntryLessThanKey);
+    return {&_blocks, blockIndex, size_t(std::distance(block.begin(), it))};
+}
+
+void ChunkMap::replaceRange(const_iterator first, const_iterator last, value_type entry) {
+    invariant(first._blocks == &_blocks && last._blocks == &_blocks);
+
+    if (_blocks.empty()) {
+        invariant(first == end() && last == end());
+        _blockMaxKeys.push_back(entry.first);
+        _blocks.push_back(std::make_shared<Block>(1, std::move(entry)));
+        _size = 1;
+        return;
+    }
+
+    // Appending after the last entry, which is how the initial routing table is usually built.
+    if (first == end()) {
+        invariant(last == end());
+        const size_t lastBlock = _blocks.size() - 1;
+        _blockMaxKeys[lastBlock] = entry.first;
+        _mutableBlock(lastBlock).push_back(std::move(entry));
+        ++_size;
+        _splitBlockIfFull(lastBlock);
+        return;
+    }
+
+    const size_t firstBlock = first._block;
+    const size_t firstPos = first._pos;
+
+    // Express the end of the range as a position within the last block it touches, so that a
+    // range ending exactly at a block boundary does not drag the following block into the update.
+    size_t lastBlock = last._block;
+    size_t lastPos = last._pos;
+    if (lastPos == 0 && lastBlock > firstBlock) {
+        --lastBlock;
+        lastPos = _blocks[lastBlock]->size();
+    }
+
+    if (firstBlock == lastBlock) {
+        auto& block = _mutableBlock(firstBlock);
+        _size -= lastPos - firstPos;
+        ++_size;
+        if (lastPos > firstPos) {
+            block[firstPos] = std::move(entry);
+            block.erase(block.begin() + firstPos + 1, block.begin() + lastPos);
+        } else {
+            block.insert(block.begin() + firstPos, std::move(entry));
+        }
+        _blockMaxKeys[firstBlock] = block.back().first;
+        _splitBlockIfFull(firstBlock);
+        return;
+    }
+
+    // The range spans several blocks, so stitch the untouched prefix of the first block, the new
+    // entry and the untouched suffix of the last block into a single new block.
+    const auto& firstBlockEntries = *_blocks[firstBlock];
+    const auto& lastBlockEntries = *_blocks[lastBlock];
+
+    size_t removed = (firstBlockEntries.size() - firstPos) + lastPos;
+    for (size_t i = firstBlock + 1; i < lastBlock; ++i) {
+        removed += _blocks[i]->size();
+    }
+
+    auto merged = std::make_shared<Block>();
+    merged->reserve(firstPos + 1 + lastBlockEntries.size() - lastPos);
+    merged->insert(
+        merged->end(), firstBlockEntries.begin(), firstBlockEntries.begin() + firstPos);
+    merged->push_back(std::move(entry));
+    merged->insert(merged->end(), lastBlockEntries.begin() + lastPos, lastBlockEntries.end());
+
+    _blockMaxKeys[firstBlock] = merged->back().first;
+    _blocks[firstBlock] = std::move(merged);
+    _blocks.erase(_blocks.begin() + firstBlock + 1, _blocks.begin() + lastBlock + 1);
+    _blockMaxKeys.erase(_blockMaxKeys.begin() + firstBlock + 1,
+                        _blockMaxKeys.begin() + lastBlock + 1);
+
+    _size -= removed;
+    ++_size;
+    _splitBlockIfFull(firstBlock);
+}
+
+ChunkMap::Block& ChunkMap::_mutableBlock(size_t index) {
+    auto& block = _blocks[index];
+    if (block.use_count() > 1) {
+        block = std::make_shared<Block>(*block);
+    }
+    return *block;
+}
+
+void ChunkMap::_splitBlockIfFull(size_t index) {
+    auto& block = *_blocks[index];
+    if (block.size() <= kMaxBlockSize) {
+        return;
+    }
+
+    const auto middle = block.begin() + block.size() / 2;
+    auto upperHalf = std::make_shared<Block>(std::make_move_iterator(middle),
+                                             std::make_move_iterator(block.end()));
+    block.erase(middle, block.end());
+
+    _blockMaxKeys[index] = block.back().first;
+    _blockMaxKeys.insert(_blockMaxKeys.begin() + index + 1, upperHalf->back().first);
+    _blocks.insert(_blocks.begin() + index + 1, std::move(upperHalf));
+}
+
+}  // namespace mongo
@@ -0,0 +1,189 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <iterator>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "mongo/s/chunk.h"
+
+namespace mongo {
+
+/**
+ * Ordered map from the KeyString encoding of the max for each chunk to an entry describing the
+ * chunk.
+ *
+ * The entries are stored in fixed-capacity sorted blocks, and the max key of every block is kept in
+ * a separate flat array, so a lookup is a binary search over contiguous keys followed by a binary
+ * search within a single block.
+ *
+ * Copies share their blocks. A block is only copied the first time a map which shares it modifies
+ * it, so applying a refresh to a copy of a routing table costs time proportional to the number of
+ * blocks plus the size of the blocks it touches, and never changes the contents seen through the
+ * original map.
+ */
+class ChunkMap {
+public:
+    using value_type = std::pair<std::string, std::shared_ptr<ChunkInfo>>;
+
+    // Blocks are split in two once they grow past this many entries.
+    static constexpr size_t kMaxBlockSize = 256;
+
+private:
+    using Block = std::vector<value_type>;
+    using BlockVector = std::vector<std::shared_ptr<Block>>;
+
+public:
+    class const_iterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = ChunkMap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = const value_type&;
+
+        const_iterator() = default;
+
+        reference operator*() const {
+            return (*(*_blocks)[_block])[_pos];
+        }
+        pointer operator->() const {
+            return &**this;
+        }
+
+        const_iterator& operator++() {
+            if (++_pos == (*_blocks)[_block]->size()) {
+                ++_block;
+                _pos = 0;
+            }
+            return *this;
+        }
+        const_iterator operator++(int) {
+            auto result = *this;
+            ++*this;
+            return result;
+        }
+
+        const_iterator& operator--() {
+            if (_pos == 0) {
+                _pos = (*_blocks)[--_block]->size();
+            }
+            --_pos;
+            return *this;
+        }
+        const_iterator operator--(int) {
+            auto result = *this;
+            --*this;
+            return result;
+        }
+
+        bool operator==(const const_iterator& other) const {
+            return _block == other._block && _pos == other._pos;
+        }
+        bool operator!=(const const_iterator& other) const {
+            return !(*this == other);
+        }
+
+    private:
+        friend class ChunkMap;
+
+        const_iterator(const BlockVector* blocks, size_t block, size_t pos)
+            : _blocks(blocks), _block(block), _pos(pos) {}
+
+        const BlockVector* _blocks{nullptr};
+        size_t _block{0};
+        size_t _pos{0};
+    };
+
+    ChunkMap() = default;
+
+    const_iterator begin() const {
+        return {&_blocks, 0, 0};
+    }
+    const_iterator cbegin() const {
+        return begin();
+    }
+
+    const_iterator end() const {
+        return {&_blocks, _blocks.size(), 0};
+    }
+    const_iterator cend() const {
+        return end();
+    }
+
+    size_t size() const {
+        return _size;
+    }
+
+    bool empty() const {
+        return _size == 0;
+    }
+
+    /**
+     * Returns the first entry whose key sorts after 'key', which for a key encoded with the shard
+     * key ordering is the chunk containing it.
+     */
+    const_iterator upper_bound(const std::string& key) const;
+
+    /**
+     * Returns the first entry whose key does not sort before 'key'.
+     */
+    const_iterator lower_bound(const std::string& key) const;
+
+    /**
+     * Removes the entries in ['first', 'last') and inserts 'entry' in their place. The key of
+     * 'entry' must sort after the entries preceding 'first' and before 'last'. Invalidates all
+     * iterators into this map, but not into maps which share blocks with it.
+     */
+    void replaceRange(const_iterator first, const_iterator last, value_type entry);
+
+private:
+    /**
+     * Returns the block at 'index', first copying it if any other map shares it.
+     */
+    Block& _mutableBlock(size_t index);
+
+    /**
+     * Splits the block at 'index' in two if it has grown past kMaxBlockSize.
+     */
+    void _splitBlockIfFull(size_t index);
+
+    BlockVector _blocks;
+
+    // The key of the last entry of each block, parallel to '_blocks'.
+    std::vector<std::string> _blockMaxKeys;
+
+    size_t _size{0};
+};
+
+}  // namespace mongo
@@ -0,0 +1,161 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/chunk_map.h"
+
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+namespace {
+
+std::string makeKey(int i) {
+    return str::stream() << "key" << std::string(6 - std::to_string(i).size(), '0') << i;
+}
+
+// Builds a map whose keys are makeKey(0), makeKey(step), ... for 'n' entries. The entries carry no
+// ChunkInfo, since ChunkMap only orders them by key.
+ChunkMap makeMap(int n, int step = 1) {
+    ChunkMap map;
+    for (int i = 0; i < n; ++i) {
+        map.replaceRange(map.end(), map.end(), {makeKey(i * step), nullptr});
+    }
+    return map;
+}
+
+std::vector<std::string> keysOf(const ChunkMap& map) {
+    std::vector<std::string> keys;
+    for (const auto& entry : map) {
+        keys.push_back(entry.first);
+    }
+    return keys;
+}
+
+TEST(ChunkMapTest, AppendsAcrossManyBlocksInOrder) {
+    const int n = 5 * ChunkMap::kMaxBlockSize + 7;
+    auto map = makeMap(n);
+    ASSERT_EQ(size_t(n), map.size());
+
+    int i = 0;
+    for (const auto& entry : map) {
+        ASSERT_EQ(makeKey(i++), entry.first);
+    }
+    ASSERT_EQ(n, i);
+    ASSERT_EQ(n, std::distance(map.begin(), map.end()));
+    ASSERT_EQ(makeKey(n - 1), std::prev(map.end())->first);
+}
+
+TEST(ChunkMapTest, BoundsFindSurroundingEntries) {
+    auto map = makeMap(3 * ChunkMap::kMaxBlockSize, 10);
+
+    for (int i = 0; i < 3 * int(ChunkMap::kMaxBlockSize); ++i) {
+        ASSERT_EQ(makeKey(i * 10), map.lower_bound(makeKey(i * 10))->first);
+        const auto upper = map.upper_bound(makeKey(i * 10));
+        if (i + 1 < 3 * int(ChunkMap::kMaxBlockSize)) {
+            ASSERT_EQ(makeKey((i + 1) * 10), upper->first);
+        } else {
+            ASSERT(upper == map.end());
+        }
+        ASSERT_EQ(makeKey((i + 1) * 10), map.upper_bound(makeKey(i * 10 + 5))->first);
+    }
+    ASSERT(map.upper_bound(makeKey(999999)) == map.end());
+    ASSERT(map.lower_bound("") == map.begin());
+}
+
+TEST(ChunkMapTest, ReplaceRangeWithinBlock) {
+    auto map = makeMap(10, 10);
+    map.replaceRange(
+        map.lower_bound(makeKey(20)), map.lower_bound(makeKey(50)), {makeKey(45), {}});
+
+    const std::vector<std::string> expected{makeKey(0),
+                                            makeKey(10),
+                                            makeKey(45),
+                                            makeKey(50),
+                                            makeKey(60),
+                                            makeKey(70),
+                                            makeKey(80),
+                                            makeKey(90)};
+    ASSERT_TRUE(keysOf(map) == expected);
+    ASSERT_EQ(expected.size(), map.size());
+}
+
+TEST(ChunkMapTest, InsertWithEmptyRangeGrowsAndSplitsBlock) {
+    auto map = makeMap(ChunkMap::kMaxBlockSize, 10);
+    for (int i = 0; i < int(ChunkMap::kMaxBlockSize); ++i) {
+        const auto pos = map.lower_bound(makeKey(i * 10 + 5));
+        map.replaceRange(pos, pos, {makeKey(i * 10 + 5), {}});
+    }
+
+    ASSERT_EQ(2 * ChunkMap::kMaxBlockSize, map.size());
+    auto keys = keysOf(map);
+    ASSERT_TRUE(std::is_sorted(keys.begin(), keys.end()));
+    for (int i = 0; i < int(ChunkMap::kMaxBlockSize); ++i) {
+        ASSERT_EQ(makeKey(i * 10 + 5), map.upper_bound(makeKey(i * 10))->first);
+    }
+}
+
+TEST(ChunkMapTest, ReplaceRangeSpanningSeveralBlocks) {
+    const int n = 4 * ChunkMap::kMaxBlockSize;
+    auto map = makeMap(n);
+
+    map.replaceRange(
+        map.lower_bound(makeKey(10)), map.lower_bound(makeKey(n - 10)), {makeKey(n - 11), {}});
+
+    ASSERT_EQ(size_t(10 + 1 + 10), map.size());
+    auto keys = keysOf(map);
+    ASSERT_EQ(makeKey(9), keys[9]);
+    ASSERT_EQ(makeKey(n - 11), keys[10]);
+    ASSERT_EQ(makeKey(n - 10), keys[11]);
+    ASSERT_EQ(makeKey(n - 10), map.upper_bound(makeKey(n - 11))->first);
+    ASSERT_EQ(makeKey(n - 11), map.upper_bound(makeKey(100))->first);
+}
+
+TEST(ChunkMapTest, CopiesAreUnaffectedByUpdates) {
+    const int n = 3 * ChunkMap::kMaxBlockSize;
+    const auto original = makeMap(n, 10);
+    const auto originalKeys = keysOf(original);
+
+    auto copy = original;
+    copy.replaceRange(
+        copy.lower_bound(makeKey(100)), copy.lower_bound(makeKey(200)), {makeKey(150), {}});
+    copy.replaceRange(copy.end(), copy.end(), {makeKey(999999), {}});
+
+    ASSERT_TRUE(keysOf(original) == originalKeys);
+    ASSERT_EQ(size_t(n), original.size());
+    ASSERT_EQ(makeKey(100), original.upper_bound(makeKey(95))->first);
+
+    ASSERT_EQ(size_t(n - 10 + 1 + 1), copy.size());
+    ASSERT_EQ(makeKey(150), copy.upper_bound(makeKey(95))->first);
+    ASSERT_EQ(makeKey(999999), std::prev(copy.end())->first);
+}
+
+}  // namespace
+}  // namespace mongo
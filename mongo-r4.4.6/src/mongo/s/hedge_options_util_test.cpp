@@ -72,7 +72,8 @@ protected:
                            const BSONObj& cmdObj,
                            const BSONObj& rspObj,
                            const bool hedge,
-                           const int maxTimeMSForHedgedReads = kMaxTimeMSForHedgedReadsDefault) {
+                           const int maxTimeMSForHedgedReads = kMaxTimeMSForHedgedReadsDefault,
+                           const int hedgedReadsDelayPercentile = 0) {
         setParameters(serverParameters);
 
         auto readPref = uassertStatusOK(ReadPreferenceSetting::fromInnerBSON(rspObj));
@@ -81,6 +82,7 @@ protected:
         if (hedge) {
             ASSERT_TRUE(hedgeOptions.has_value());
             ASSERT_EQ(hedgeOptions->maxTimeMSForHedgedReads, maxTimeMSForHedgedReads);
+            ASSERT_EQ(hedgeOptions->delayPercentile, hedgedReadsDelayPercentile);
         } else {
             ASSERT_FALSE(hedgeOptions.has_value());
         }
@@ -93,10 +95,13 @@ protected:
     static inline const std::string kReadHedgingModeFieldName = "readHedgingMode";
     static inline const std::string kMaxTimeMSForHedgedReadsFieldName = "maxTimeMSForHedgedReads";
     static inline const int kMaxTimeMSForHedgedReadsDefault = 10;
+    static inline const std::string kHedgedReadsDelayPercentileFieldName =
+        "hedgedReadsDelayPercentile";
 
     static inline const BSONObj kDefaultParameters =
         BSON(kReadHedgingModeFieldName << "on" << kMaxTimeMSForHedgedReadsFieldName
-                                       << kMaxTimeMSForHedgedReadsDefault);
+                                       << kMaxTimeMSForHedgedReadsDefault
+                                       << kHedgedReadsDelayPercentileFieldName << 0);
 
 private:
     ServiceContext::UniqueServiceContext _serviceCtx = ServiceContext::make();
@@ -191,5 +196,15 @@ TEST_F(HedgeOptionsUtilTestFixture, MaxTimeMSForHedgedReads) {
     checkHedgeOptions(parameters, cmdObj, rspObj, true, 100);
 }
 
+TEST_F(HedgeOptionsUtilTestFixture, HedgedReadsDelayPercentile) {
+    const auto parameters = BSON(kHedgedReadsDelayPercentileFieldName << 95);
+    const auto cmdObj = BSON("find" << kCollName);
+    const auto rspObj = BSON("mode"
+                             << "nearest"
+                             << "hedge" << BSONObj());
+
+    checkHedgeOptions(parameters, cmdObj, rspObj, true, kMaxTimeMSForHedgedReadsDefault, 95);
+}
+
 }  // namespace
 }  // namespace mongo
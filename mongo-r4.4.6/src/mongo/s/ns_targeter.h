@@ -37,6 +37,7 @@
 #include "mongo/s/chunk_version.h"
 #include "mongo/s/shard_id.h"
 #include "mongo/s/stale_exception.h"
+#include "mongo/util/assert_util.h"
 
 namespace mongo {
 
@@ -103,6 +104,28 @@ public:
     virtual StatusWith<ShardEndpoint> targetInsert(OperationContext* opCtx,
                                                    const BSONObj& doc) const = 0;
 
+    /**
+     * Returns a ShardEndpoint, or the reason it could not be targeted, for each document of a
+     * batch of inserts, in the same order as 'docs'.
+     *
+     * Implementations may target the documents together, which is cheaper than targeting them one
+     * at a time. Errors are never thrown; callers which need the exact failure behaviour of
+     * targetInsert for a document should retarget it individually.
+     */
+    virtual std::vector<StatusWith<ShardEndpoint>> targetInserts(
+        OperationContext* opCtx, const std::vector<BSONObj>& docs) const {
+        std::vector<StatusWith<ShardEndpoint>> endpoints;
+        endpoints.reserve(docs.size());
+        for (const auto& doc : docs) {
+            try {
+                endpoints.push_back(targetInsert(opCtx, doc));
+            } catch (const DBException& ex) {
+                endpoints.push_back(ex.toStatus());
+            }
+        }
+        return endpoints;
+    }
+
     /**
      * Returns a vector of ShardEndpoints for a potentially multi-shard update.
      *
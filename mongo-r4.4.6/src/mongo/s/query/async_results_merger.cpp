@@ -33,12 +33,15 @@
 
 #include "mongo/s/query/async_results_merger.h"
 
+#include "mongo/base/counter.h"
 #include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/client/remote_command_targeter.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/pipeline/change_stream_constants.h"
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/killcursors_request.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/executor/remote_command_request.h"
 #include "mongo/executor/remote_command_response.h"
 #include "mongo/s/catalog/type_shard.h"
@@ -54,6 +57,37 @@ namespace {
 // Maximum number of retries for network and replication NotPrimary errors (per host).
 const int kMaxNumFailedHostRetryAttempts = 3;
 
+// The total size of the results buffered by all AsyncResultsMergers in this process. Prefetching
+// getMores are not scheduled while this is at or above 'internalQueryPrefetchMaxBufferedBytes'.
+Counter64 bufferedBytesGauge;
+ServerStatusMetricField<Counter64> displayBufferedBytes("cursor.prefetch.bufferedBytes",
+                                                        &bufferedBytesGauge);
+
+// The number of prefetching getMores scheduled.
+Counter64 prefetchGetMoresCounter;
+ServerStatusMetricField<Counter64> displayPrefetchGetMores("cursor.prefetch.getMores",
+                                                           &prefetchGetMoresCounter);
+
+// The number of prefetched batches which arrived before the remote's buffer was drained, and the
+// number which arrived after the caller had already started waiting for them.
+Counter64 prefetchHitsCounter;
+ServerStatusMetricField<Counter64> displayPrefetchHits("cursor.prefetch.hits",
+                                                       &prefetchHitsCounter);
+Counter64 prefetchMissesCounter;
+ServerStatusMetricField<Counter64> displayPrefetchMisses("cursor.prefetch.misses",
+                                                         &prefetchMissesCounter);
+
+// The number of prefetching getMores which were not scheduled because of the buffered bytes limit.
+Counter64 prefetchSkippedCounter;
+ServerStatusMetricField<Counter64> displayPrefetchSkipped("cursor.prefetch.skippedBufferFull",
+                                                          &prefetchSkippedCounter);
+
+// The total size of prefetched results which were discarded without being returned, because the
+// cursor was killed or exhausted by the client before reaching them.
+Counter64 prefetchWastedBytesCounter;
+ServerStatusMetricField<Counter64> displayPrefetchWastedBytes("cursor.prefetch.wastedBytes",
+                                                              &prefetchWastedBytesCounter);
+
 /**
  * Returns the sort key out of the $sortKey metadata field in 'obj'. This object is of the form
  * {'': 'firstSortKey', '': 'secondSortKey', ...}.
@@ -83,6 +117,22 @@ int compareSortKeys(BSONObj leftSortKey, BSONObj rightSortKey, BSONObj sortKeyPa
     return leftSortKey.woCompare(rightSortKey, sortKeyPattern, rules);
 }
 
+/**
+ * Returns the Ordering with which sort keys should be encoded into KeyStrings for merging, or
+ * boost::none if the merge should compare BSON sort keys instead. The KeyString merge is used for
+ * every sorted merge unless it is disabled, or the sort pattern has more components than an
+ * Ordering can describe.
+ */
+boost::optional<Ordering> makeSortKeyOrdering(const AsyncResultsMergerParams& params) {
+    if (!params.getSort() || !internalQueryMergeSortKeysAsKeyStrings.load()) {
+        return boost::none;
+    }
+    if (static_cast<size_t>(params.getSort()->nFields()) > Ordering::kMaxCompoundIndexKeys) {
+        return boost::none;
+    }
+    return Ordering::make(*params.getSort());
+}
+
 }  // namespace
 
 AsyncResultsMerger::AsyncResultsMerger(OperationContext* opCtx,
@@ -95,8 +145,10 @@ AsyncResultsMerger::AsyncResultsMerger(OperationContext* opCtx,
       // since that is not supported we treat boost::none (unspecified) to mean 'kNormal'.
       _tailableMode(params.getTailableMode().value_or(TailableModeEnum::kNormal)),
       _params(std::move(params)),
+      _sortKeyOrdering(makeSortKeyOrdering(_params)),
       _mergeQueue(MergingComparator(
           _remotes, _params.getSort().value_or(BSONObj()), _params.getCompareWholeSortKey())),
+      _mergeTree(KeyStringMergingComparator(_remotes)),
       _promisedMinSortKeys(PromisedMinSortKeyComparator(_params.getSort().value_or(BSONObj()))) {
     if (params.getTxnNumber()) {
         invariant(params.getSessionId());
@@ -111,6 +163,7 @@ AsyncResultsMerger::AsyncResultsMerger(OperationContext* opCtx,
 
         // A remote cannot be flagged as 'partialResultsReturned' if 'allowPartialResults' is false.
         invariant(!(_remotes.back().partialResultsReturned && !_params.getAllowPartialResults()));
+        _mergeTree.resize(_remotes.size());
 
         // We don't check the return value of _addBatchToBuffer here; if there was an error,
         // it will be stored in the remote and the first call to ready() will return true.
@@ -141,6 +194,9 @@ void AsyncResultsMerger::_setInitialHighWaterMark() {
 AsyncResultsMerger::~AsyncResultsMerger() {
     stdx::lock_guard<Latch> lk(_mutex);
     invariant(_remotesExhausted(lk) || _lifecycleState == kKillComplete);
+    for (size_t i = 0; i < _remotes.size(); ++i) {
+        _clearBuffer(lk, i);
+    }
 }
 
 bool AsyncResultsMerger::remotesExhausted() const {
@@ -209,6 +265,7 @@ void AsyncResultsMerger::addNewShardCursors(std::vector<RemoteCursor>&& newCurso
                               remote.getCursorResponse().getNSS(),
                               remote.getCursorResponse().getCursorId(),
                               remote.getCursorResponse().getPartialResultsReturned());
+        _mergeTree.resize(_remotes.size());
         _addBatchToBuffer(lk, newIndex, remote.getCursorResponse());
     }
 }
@@ -297,12 +354,12 @@ bool AsyncResultsMerger::_readySorted(WithLock lk) {
 }
 
 bool AsyncResultsMerger::_readySortedTailable(WithLock lk) {
-    if (_mergeQueue.empty()) {
+    auto smallestRemote = _getSmallestRemote(lk);
+    if (!smallestRemote) {
         return false;
     }
 
-    auto smallestRemote = _mergeQueue.top();
-    auto smallestResult = _remotes[smallestRemote].docBuffer.front();
+    auto smallestResult = _remotes[*smallestRemote].docBuffer.front();
     auto keyWeWantToReturn =
         extractSortKey(*smallestResult.getResult(), _params.getCompareWholeSortKey());
     // We should always have a minPromisedSortKey from every shard in the sorted tailable case.
@@ -345,28 +402,32 @@ StatusWith<ClusterQueryResult> AsyncResultsMerger::nextReady() {
     return _params.getSort() ? _nextReadySorted(lk) : _nextReadyUnsorted(lk);
 }
 
-ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock) {
+ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock lk) {
     // Tailable non-awaitData cursors cannot have a sort.
     invariant(_tailableMode != TailableModeEnum::kTailable);
 
-    if (_mergeQueue.empty()) {
+    auto smallest = _getSmallestRemote(lk);
+    if (!smallest) {
         return {};
     }
 
-    size_t smallestRemote = _mergeQueue.top();
-    _mergeQueue.pop();
+    size_t smallestRemote = *smallest;
+    if (!_sortKeyOrdering) {
+        // The comparator reads the front of each remote's buffer, so the remote must be popped
+        // from the queue before its buffer is modified.
+        _mergeQueue.pop();
+        _remotes[smallestRemote].inMergeQueue = false;
+    }
 
     invariant(!_remotes[smallestRemote].docBuffer.empty());
     invariant(_remotes[smallestRemote].status.isOK());
 
-    ClusterQueryResult front = _remotes[smallestRemote].docBuffer.front();
-    _remotes[smallestRemote].docBuffer.pop();
+    ClusterQueryResult front = _popBufferedResult(lk, smallestRemote);
 
     // Re-populate the merging queue with the next result from 'smallestRemote', if it has a
     // next result.
-    if (!_remotes[smallestRemote].docBuffer.empty()) {
-        _mergeQueue.push(smallestRemote);
-    }
+    _updateMergeOrder(lk, smallestRemote);
+    _maybePrefetch(lk, smallestRemote);
 
     // For sorted tailable awaitData cursors, update the high water mark to the document's sort key.
     if (_tailableMode == TailableModeEnum::kTailableAndAwaitData) {
@@ -379,15 +440,15 @@ ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock) {
     return front;
 }
 
-ClusterQueryResult AsyncResultsMerger::_nextReadyUnsorted(WithLock) {
+ClusterQueryResult AsyncResultsMerger::_nextReadyUnsorted(WithLock lk) {
     size_t remotesAttempted = 0;
     while (remotesAttempted < _remotes.size()) {
         // It is illegal to call this method if there is an error received from any shard.
         invariant(_remotes[_gettingFromRemote].status.isOK());
 
         if (_remotes[_gettingFromRemote].hasNext()) {
-            ClusterQueryResult front = _remotes[_gettingFromRemote].docBuffer.front();
-            _remotes[_gettingFromRemote].docBuffer.pop();
+            ClusterQueryResult front = _popBufferedResult(lk, _gettingFromRemote);
+            _maybePrefetch(lk, _gettingFromRemote);
 
             if (_tailableMode == TailableModeEnum::kTailable &&
                 !_remotes[_gettingFromRemote].hasNext()) {
@@ -410,7 +471,67 @@ ClusterQueryResult AsyncResultsMerger::_nextReadyUnsorted(WithLock) {
     return {};
 }
 
-Status AsyncResultsMerger::_askForNextBatch(WithLock, size_t remoteIndex) {
+ClusterQueryResult AsyncResultsMerger::_popBufferedResult(WithLock, size_t remoteIndex) {
+    auto& remote = _remotes[remoteIndex];
+    ClusterQueryResult front = std::move(remote.docBuffer.front());
+    remote.docBuffer.pop();
+    if (_sortKeyOrdering) {
+        remote.sortKeyBuffer.pop();
+    }
+
+    const long long bytes = front.getResult() ? front.getResult()->objsize() : 0;
+    remote.bufferedBytes -= bytes;
+    bufferedBytesGauge.decrement(bytes);
+
+    // Prefetched results are always at the back of the buffer.
+    if (remote.prefetchedDocs > remote.docBuffer.size()) {
+        --remote.prefetchedDocs;
+        remote.prefetchedBytes -= bytes;
+    }
+    return front;
+}
+
+void AsyncResultsMerger::_clearBuffer(WithLock, size_t remoteIndex) {
+    auto& remote = _remotes[remoteIndex];
+    std::queue<ClusterQueryResult> emptyBuffer;
+    std::swap(remote.docBuffer, emptyBuffer);
+    std::queue<KeyString::Value> emptySortKeyBuffer;
+    std::swap(remote.sortKeyBuffer, emptySortKeyBuffer);
+
+    bufferedBytesGauge.decrement(remote.bufferedBytes);
+    prefetchWastedBytesCounter.increment(remote.prefetchedBytes);
+    remote.bufferedBytes = 0;
+    remote.prefetchedDocs = 0;
+    remote.prefetchedBytes = 0;
+}
+
+void AsyncResultsMerger::_maybePrefetch(WithLock lk, size_t remoteIndex) {
+    auto& remote = _remotes[remoteIndex];
+
+    // An empty buffer is refilled by the regular getMore path. Tailable cursors pass batches
+    // through as they arrive, and a getMore running concurrently with another statement in the
+    // same transaction would conflict with it on the shard.
+    if (!remote.hasNext() || remote.exhausted() || remote.cbHandle.isValid() ||
+        !remote.status.isOK() || !_opCtx || _lifecycleState != kAlive ||
+        _tailableMode != TailableModeEnum::kNormal || _params.getTxnNumber() ||
+        !internalQueryPrefetchRemoteGetMores.load()) {
+        return;
+    }
+
+    if (remote.docBuffer.size() >=
+        static_cast<size_t>(internalQueryPrefetchRemoteGetMoresLowWatermark.load())) {
+        return;
+    }
+
+    if (bufferedBytesGauge.get() >= internalQueryPrefetchMaxBufferedBytes.load()) {
+        prefetchSkippedCounter.increment();
+        return;
+    }
+
+    remote.status = _askForNextBatch(lk, remoteIndex, true /* isPrefetch */);
+}
+
+Status AsyncResultsMerger::_askForNextBatch(WithLock, size_t remoteIndex, bool isPrefetch) {
     invariant(_opCtx, "Cannot schedule a getMore without an OperationContext");
     auto& remote = _remotes[remoteIndex];
 
@@ -454,6 +575,11 @@ Status AsyncResultsMerger::_askForNextBatch(WithLock, size_t remoteIndex) {
 
     executor::RemoteCommandRequest request(
         remote.getTargetHost(), remote.cursorNss.db().toString(), cmdObj, _opCtx);
+    if (isPrefetch) {
+        // The prefetched batch is meant for a later operation on this cursor, so it should not
+        // inherit the deadline of the operation which happened to trigger it.
+        request.timeout = executor::RemoteCommandRequest::kNoTimeout;
+    }
 
     auto callbackStatus =
         _executor->scheduleRemoteCommand(request, [this, remoteIndex](auto const& cbData) {
@@ -466,6 +592,10 @@ Status AsyncResultsMerger::_askForNextBatch(WithLock, size_t remoteIndex) {
     }
 
     remote.cbHandle = callbackStatus.getValue();
+    remote.prefetchInFlight = isPrefetch;
+    if (isPrefetch) {
+        prefetchGetMoresCounter.increment();
+    }
     return Status::OK();
 }
 
@@ -653,6 +783,7 @@ void AsyncResultsMerger::_handleBatchResponse(WithLock lk,
                                               size_t remoteIndex) {
     // Got a response from remote, so indicate we are no longer waiting for one.
     _remotes[remoteIndex].cbHandle = executor::TaskExecutor::CallbackHandle();
+    const bool wasPrefetch = std::exchange(_remotes[remoteIndex].prefetchInFlight, false);
 
     //  On shutdown, there is no need to process the response.
     if (_lifecycleState != kAlive) {
@@ -661,7 +792,7 @@ void AsyncResultsMerger::_handleBatchResponse(WithLock lk,
         return;
     }
     try {
-        _processBatchResults(lk, cbData.response, remoteIndex);
+        _processBatchResults(lk, cbData.response, remoteIndex, wasPrefetch);
     } catch (DBException const& e) {
         _remotes[remoteIndex].status = e.toStatus();
     }
@@ -696,16 +827,22 @@ void AsyncResultsMerger::_cleanUpFailedBatch(WithLock lk, Status status, size_t
     if (_params.getAllowPartialResults() || remote.status == ErrorCodes::ExchangePassthrough) {
         // Clear the results buffer and cursor id, and set 'partialResultsReturned' if appropriate.
         remote.partialResultsReturned = (remote.status != ErrorCodes::ExchangePassthrough);
-        std::queue<ClusterQueryResult> emptyBuffer;
-        std::swap(remote.docBuffer, emptyBuffer);
+        // A prefetching getMore can fail while the remote still has buffered results, and so
+        // while it is still in the merge queue.
+        _removeFromMergeQueue(lk, remoteIndex);
+        _clearBuffer(lk, remoteIndex);
         remote.status = Status::OK();
         remote.cursorId = 0;
+        if (_sortKeyOrdering) {
+            _updateMergeOrder(lk, remoteIndex);
+        }
     }
 }
 
 void AsyncResultsMerger::_processBatchResults(WithLock lk,
                                               CbResponse const& response,
-                                              size_t remoteIndex) {
+                                              size_t remoteIndex,
+                                              bool isPrefetch) {
     auto& remote = _remotes[remoteIndex];
     if (!response.isOK()) {
         _cleanUpFailedBatch(lk, response.status, remoteIndex);
@@ -725,10 +862,22 @@ void AsyncResultsMerger::_processBatchResults(WithLock lk,
     // Update the cursorId; it is sent as '0' when the cursor has been exhausted on the shard.
     remote.cursorId = cursorResponse.getCursorId();
 
+    // A prefetch is only useful if its batch arrives before the caller has drained the results
+    // which were buffered when it was scheduled.
+    if (isPrefetch) {
+        (remote.hasNext() ? prefetchHitsCounter : prefetchMissesCounter).increment();
+    }
+
     // Save the batch in the remote's buffer.
+    const auto docsBeforeBatch = remote.docBuffer.size();
+    const auto bytesBeforeBatch = remote.bufferedBytes;
     if (!_addBatchToBuffer(lk, remoteIndex, cursorResponse)) {
         return;
     }
+    if (isPrefetch) {
+        remote.prefetchedDocs += remote.docBuffer.size() - docsBeforeBatch;
+        remote.prefetchedBytes += remote.bufferedBytes - bytesBeforeBatch;
+    }
 
     // If the cursor is tailable and we just received an empty batch, the next return value should
     // be boost::none in order to indicate the end of the batch. We do not ask for the next batch if
@@ -774,17 +923,74 @@ bool AsyncResultsMerger::_addBatchToBuffer(WithLock lk,
 
         ClusterQueryResult result(obj);
         remote.docBuffer.push(result);
+        if (_sortKeyOrdering) {
+            remote.sortKeyBuffer.push(_encodeSortKey(obj));
+        }
+        remote.bufferedBytes += obj.objsize();
+        bufferedBytesGauge.increment(obj.objsize());
         ++remote.fetchedCount;
     }
 
     // If we're doing a sorted merge, then we have to make sure to put this remote onto the merge
     // queue.
     if (_params.getSort() && !response.getBatch().empty()) {
-        _mergeQueue.push(remoteIndex);
+        _updateMergeOrder(lk, remoteIndex);
     }
     return true;
 }
 
+boost::optional<size_t> AsyncResultsMerger::_getSmallestRemote(WithLock) {
+    if (_sortKeyOrdering) {
+        auto smallestRemote = _mergeTree.top();
+        return smallestRemote == decltype(_mergeTree)::kNoWinner
+            ? boost::optional<size_t>{}
+            : smallestRemote;
+    }
+    return _mergeQueue.empty() ? boost::optional<size_t>{} : _mergeQueue.top();
+}
+
+void AsyncResultsMerger::_updateMergeOrder(WithLock, size_t remoteIndex) {
+    auto& remote = _remotes[remoteIndex];
+    if (_sortKeyOrdering) {
+        invariant(remote.docBuffer.size() == remote.sortKeyBuffer.size());
+        _mergeTree.update(remoteIndex, remote.hasNext());
+    } else if (remote.hasNext() && !remote.inMergeQueue) {
+        // A remote which is already queued, such as one whose prefetched batch arrived before its
+        // buffer was drained, keeps its place: appending to its buffer does not change its front.
+        _mergeQueue.push(remoteIndex);
+        remote.inMergeQueue = true;
+    }
+}
+
+void AsyncResultsMerger::_removeFromMergeQueue(WithLock, size_t remoteIndex) {
+    auto& remote = _remotes[remoteIndex];
+    if (!remote.inMergeQueue) {
+        return;
+    }
+
+    // A priority queue cannot remove an arbitrary element, so rebuild it without this remote.
+    std::vector<size_t> others;
+    while (!_mergeQueue.empty()) {
+        if (_mergeQueue.top() != remoteIndex) {
+            others.push_back(_mergeQueue.top());
+        }
+        _mergeQueue.pop();
+    }
+    for (auto other : others) {
+        _mergeQueue.push(other);
+    }
+    remote.inMergeQueue = false;
+}
+
+KeyString::Value AsyncResultsMerger::_encodeSortKey(const BSONObj& obj) const {
+    // The KeyString compares equivalently to 'compareSortKeys()': the sort key's field names are
+    // not encoded, and the sort direction of each component is taken from '_sortKeyOrdering'.
+    KeyString::HeapBuilder builder(KeyString::Version::kLatestVersion,
+                                   extractSortKey(obj, _params.getCompareWholeSortKey()),
+                                   *_sortKeyOrdering);
+    return builder.release();
+}
+
 void AsyncResultsMerger::_signalCurrentEventIfReady(WithLock lk) {
     if (_ready(lk) && _currentEvent.isValid()) {
         // To prevent ourselves from signalling the event twice, we set '_currentEvent' as
@@ -905,6 +1111,14 @@ bool AsyncResultsMerger::MergingComparator::operator()(const size_t& lhs, const
                            _sort) > 0;
 }
 
+//
+// AsyncResultsMerger::KeyStringMergingComparator
+//
+
+bool AsyncResultsMerger::KeyStringMergingComparator::operator()(size_t lhs, size_t rhs) const {
+    return _remotes[lhs].sortKeyBuffer.front().compare(_remotes[rhs].sortKeyBuffer.front()) < 0;
+}
+
 bool AsyncResultsMerger::PromisedMinSortKeyComparator::operator()(
     const MinSortKeyRemoteIdPair& lhs, const MinSortKeyRemoteIdPair& rhs) const {
     auto sortKeyComp = compareSortKeys(lhs.first, rhs.first, _sort);
@@ -35,11 +35,14 @@
 
 #include "mongo/base/status_with.h"
 #include "mongo/bson/bsonobj.h"
+#include "mongo/bson/ordering.h"
 #include "mongo/db/cursor_id.h"
+#include "mongo/db/storage/key_string.h"
 #include "mongo/executor/task_executor.h"
 #include "mongo/platform/mutex.h"
 #include "mongo/s/query/async_results_merger_params_gen.h"
 #include "mongo/s/query/cluster_query_result.h"
+#include "mongo/s/query/loser_tree.h"
 #include "mongo/util/concurrency/with_lock.h"
 #include "mongo/util/net/hostandport.h"
 #include "mongo/util/time_support.h"
@@ -67,6 +70,18 @@ class CursorResponse;
  * This requires waiting until we have a response from every remote before returning results.
  * Without a sort, we are ready to return results as soon as we have *any* response from a remote.
  *
+ * When merging sorted streams, the sort key of each result is by default encoded into a KeyString
+ * once, as the result is buffered. The remotes are then merged using a tournament tree whose
+ * comparisons are plain byte comparisons of those KeyStrings, rather than BSON comparisons which
+ * extract the sort key from each result again. The 'internalQueryMergeSortKeysAsKeyStrings' knob
+ * reverts to the BSON-comparing priority queue.
+ *
+ * By default a getMore is only scheduled on a remote once all of its buffered results have been
+ * returned, so the caller waits for a full round trip at every batch boundary. If the
+ * 'internalQueryPrefetchRemoteGetMores' knob is set, the next getMore is instead scheduled as soon
+ * as the remote's buffer drops below a low watermark, provided that the results buffered by all
+ * ARMs in the process do not exceed 'internalQueryPrefetchMaxBufferedBytes'.
+ *
  * On any error, the caller is responsible for shutting down the ARM using the kill() method.
  *
  * Does not throw exceptions.
@@ -308,6 +323,26 @@ private:
         // The buffer of results that have been retrieved but not yet returned to the caller.
         std::queue<ClusterQueryResult> docBuffer;
 
+        // The KeyString-encoded sort keys of the results in 'docBuffer', in the same order. Only
+        // populated if the ARM is merging sort keys as KeyStrings.
+        std::queue<KeyString::Value> sortKeyBuffer;
+
+        // The total size in bytes of the results in 'docBuffer'.
+        long long bufferedBytes = 0;
+
+        // The number and total size of the results at the back of 'docBuffer' which were received
+        // in response to a prefetching getMore and have not yet been returned.
+        size_t prefetchedDocs = 0;
+        long long prefetchedBytes = 0;
+
+        // True if the request outstanding on 'cbHandle' is a prefetching getMore, i.e. it was
+        // scheduled while 'docBuffer' still held results.
+        bool prefetchInFlight = false;
+
+        // True if this remote's index is in the merge queue. The queue's comparator reads the
+        // front of 'docBuffer', so the buffer must not be emptied while this is set.
+        bool inMergeQueue = false;
+
         // Is valid if there is currently a pending request to this remote.
         executor::TaskExecutor::CallbackHandle cbHandle;
 
@@ -340,6 +375,21 @@ private:
         const bool _compareWholeSortKey;
     };
 
+    /**
+     * Orders two remotes by the KeyString-encoded sort keys at the front of their buffers. Used by
+     * '_mergeTree', which only compares remotes that have buffered results.
+     */
+    class KeyStringMergingComparator {
+    public:
+        KeyStringMergingComparator(const std::vector<RemoteCursorData>& remotes)
+            : _remotes(remotes) {}
+
+        bool operator()(size_t lhs, size_t rhs) const;
+
+    private:
+        const std::vector<RemoteCursorData>& _remotes;
+    };
+
     using MinSortKeyRemoteIdPair = std::pair<BSONObj, size_t>;
 
     class PromisedMinSortKeyComparator {
@@ -370,7 +420,15 @@ private:
      *
      * Returns success if the command to retrieve the next batch was scheduled successfully.
      */
-    Status _askForNextBatch(WithLock, size_t remoteIndex);
+    Status _askForNextBatch(WithLock, size_t remoteIndex, bool isPrefetch = false);
+
+    /**
+     * Schedules a prefetching getMore on the given remote if prefetching is enabled and allowed for
+     * this cursor, the remote's buffer has dropped below the low watermark, and the process-wide
+     * limit on buffered bytes has not been reached. Errors scheduling the getMore are recorded in
+     * the remote's status, as for any other getMore.
+     */
+    void _maybePrefetch(WithLock, size_t remoteIndex);
 
     /**
      * Checks whether or not the remote cursors are all exhausted.
@@ -393,6 +451,45 @@ private:
     ClusterQueryResult _nextReadySorted(WithLock);
     ClusterQueryResult _nextReadyUnsorted(WithLock);
 
+    /**
+     * Removes and returns the result at the front of the given remote's buffer, keeping the
+     * buffer's accounting up to date.
+     */
+    ClusterQueryResult _popBufferedResult(WithLock, size_t remoteIndex);
+
+    /**
+     * Discards every result in the given remote's buffer. Prefetched results which are discarded
+     * are reported as wasted.
+     */
+    void _clearBuffer(WithLock, size_t remoteIndex);
+
+    //
+    // Helpers for the sorted merge.
+    //
+
+    /**
+     * Returns the index into '_remotes' of the remote whose next buffered result sorts first, or
+     * boost::none if no remote has a buffered result.
+     */
+    boost::optional<size_t> _getSmallestRemote(WithLock);
+
+    /**
+     * Informs the merge structure that the buffer of the given remote has changed, so that the
+     * remote is (re-)considered for merging if it has results, and is ignored otherwise.
+     */
+    void _updateMergeOrder(WithLock, size_t remoteIndex);
+
+    /**
+     * Removes the given remote from '_mergeQueue', if it is there. Must be called before the
+     * remote's buffer is cleared.
+     */
+    void _removeFromMergeQueue(WithLock, size_t remoteIndex);
+
+    /**
+     * Encodes the $sortKey of 'obj' into a KeyString ordered according to the sort pattern.
+     */
+    KeyString::Value _encodeSortKey(const BSONObj& obj) const;
+
     using CbData = executor::TaskExecutor::RemoteCommandCallbackArgs;
     using CbResponse = executor::TaskExecutor::ResponseStatus;
 
@@ -416,9 +513,10 @@ private:
     void _cleanUpFailedBatch(WithLock lk, Status status, size_t remoteIndex);
 
     /**
-     * Processes results from a remote query.
+     * Processes results from a remote query. 'isPrefetch' is true if the results are the response
+     * to a prefetching getMore.
      */
-    void _processBatchResults(WithLock, CbResponse const&, size_t remoteIndex);
+    void _processBatchResults(WithLock, CbResponse const&, size_t remoteIndex, bool isPrefetch);
 
     /**
      * Adds the batch of results to the RemoteCursorData. Returns false if there was an error
@@ -480,6 +578,10 @@ private:
     TailableModeEnum _tailableMode;
     AsyncResultsMergerParams _params;
 
+    // Set if the sorted merge compares KeyString-encoded sort keys using '_mergeTree' rather than
+    // BSON sort keys using '_mergeQueue'. Read-only after construction.
+    const boost::optional<Ordering> _sortKeyOrdering;
+
     // Must be acquired before accessing any data members (other than _params, which is read-only).
     mutable Mutex _mutex = MONGO_MAKE_LATCH("AsyncResultsMerger::_mutex");
 
@@ -490,6 +592,10 @@ private:
     // next document to return, according to the sort order. Used only if there is a sort.
     std::priority_queue<size_t, std::vector<size_t>, MergingComparator> _mergeQueue;
 
+    // Has one leaf per entry in '_remotes', whose winner is the index of the remote with the next
+    // document to return. Used instead of '_mergeQueue' if '_sortKeyOrdering' is set.
+    LoserTree<KeyStringMergingComparator> _mergeTree;
+
     // The index into '_remotes' for the remote from which we are currently retrieving results.
     // Used only if there is *not* a sort.
     size_t _gettingFromRemote = 0;
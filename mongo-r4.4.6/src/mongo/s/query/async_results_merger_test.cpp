@@ -38,6 +38,7 @@
 #include "mongo/db/pipeline/resume_token.h"
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/getmore_request.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_request.h"
 #include "mongo/executor/task_executor.h"
 #include "mongo/s/catalog/type_shard.h"
@@ -45,6 +46,7 @@
 #include "mongo/s/query/results_merger_test_fixture.h"
 #include "mongo/unittest/death_test.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -444,6 +446,84 @@ TEST_F(AsyncResultsMergerTest, CompoundSortKey) {
     ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
 }
 
+TEST_F(AsyncResultsMergerTest, CompoundSortKeyWithoutKeyStringMerge) {
+    internalQueryMergeSortKeysAsKeyStrings.store(false);
+    ON_BLOCK_EXIT([] { internalQueryMergeSortKeysAsKeyStrings.store(true); });
+
+    BSONObj findCmd = fromjson("{find: 'testcoll', sort: {a: -1, b: 1}}");
+    std::vector<RemoteCursor> cursors;
+    cursors.push_back(
+        makeRemoteCursor(kTestShardIds[0], kTestShardHosts[0], CursorResponse(kTestNss, 5, {})));
+    cursors.push_back(
+        makeRemoteCursor(kTestShardIds[1], kTestShardHosts[1], CursorResponse(kTestNss, 6, {})));
+    auto arm = makeARMFromExistingCursors(std::move(cursors), findCmd);
+
+    ASSERT_FALSE(arm->ready());
+    auto readyEvent = unittest::assertGet(arm->nextEvent());
+
+    std::vector<CursorResponse> responses;
+    std::vector<BSONObj> batch1 = {fromjson("{$sortKey: {'': 5, '': 9}}"),
+                                   fromjson("{$sortKey: {'': 4, '': 20}}")};
+    responses.emplace_back(kTestNss, CursorId(0), batch1);
+    std::vector<BSONObj> batch2 = {fromjson("{$sortKey: {'': 10, '': 11}}"),
+                                   fromjson("{$sortKey: {'': 4, '': 4}}")};
+    responses.emplace_back(kTestNss, CursorId(0), batch2);
+    scheduleNetworkResponses(std::move(responses));
+    executor()->waitForEvent(readyEvent);
+
+    // The BSON-comparing merge returns the results in the same order as the KeyString merge.
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{$sortKey: {'': 10, '': 11}}"),
+                      *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{$sortKey: {'': 5, '': 9}}"),
+                      *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{$sortKey: {'': 4, '': 4}}"),
+                      *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{$sortKey: {'': 4, '': 20}}"),
+                      *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_TRUE(arm->ready());
+    ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
+}
+
+TEST_F(AsyncResultsMergerTest, SortedMergeResumesRemoteAfterGetMore) {
+    BSONObj findCmd = fromjson("{find: 'testcoll', sort: {_id: 1}}");
+    std::vector<RemoteCursor> cursors;
+    std::vector<BSONObj> firstBatch1 = {fromjson("{$sortKey: {'': 1}}")};
+    cursors.push_back(makeRemoteCursor(
+        kTestShardIds[0], kTestShardHosts[0], CursorResponse(kTestNss, 5, firstBatch1)));
+    std::vector<BSONObj> firstBatch2 = {fromjson("{$sortKey: {'': 2}}"),
+                                        fromjson("{$sortKey: {'': 6}}")};
+    cursors.push_back(makeRemoteCursor(
+        kTestShardIds[1], kTestShardHosts[1], CursorResponse(kTestNss, 0, firstBatch2)));
+    auto arm = makeARMFromExistingCursors(std::move(cursors), findCmd);
+
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{$sortKey: {'': 1}}"),
+                      *unittest::assertGet(arm->nextReady()).getResult());
+
+    // The first remote has drained its buffer but is not exhausted, so the merge must wait for it.
+    ASSERT_FALSE(arm->ready());
+    auto readyEvent = unittest::assertGet(arm->nextEvent());
+    std::vector<CursorResponse> responses;
+    std::vector<BSONObj> batch = {fromjson("{$sortKey: {'': 3}}"),
+                                  fromjson("{$sortKey: {'': 7}}")};
+    responses.emplace_back(kTestNss, CursorId(0), batch);
+    scheduleNetworkResponses(std::move(responses));
+    executor()->waitForEvent(readyEvent);
+
+    // The refilled remote re-enters the merge in the correct position.
+    for (int expected : {2, 3, 6, 7}) {
+        ASSERT_TRUE(arm->ready());
+        ASSERT_BSONOBJ_EQ(BSON("$sortKey" << BSON("" << expected)),
+                          *unittest::assertGet(arm->nextReady()).getResult());
+    }
+    ASSERT_TRUE(arm->ready());
+    ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
+}
+
 TEST_F(AsyncResultsMergerTest, SortedButNoSortKey) {
     BSONObj findCmd = fromjson("{find: 'testcoll', sort: {a: -1, b: 1}}");
     std::vector<RemoteCursor> cursors;
@@ -529,6 +609,151 @@ TEST_F(AsyncResultsMergerTest, HasFirstBatch) {
     ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
 }
 
+TEST_F(AsyncResultsMergerTest, PrefetchesGetMoreBelowLowWatermark) {
+    internalQueryPrefetchRemoteGetMores.store(true);
+    internalQueryPrefetchRemoteGetMoresLowWatermark.store(2);
+    ON_BLOCK_EXIT([] {
+        internalQueryPrefetchRemoteGetMores.store(false);
+        internalQueryPrefetchRemoteGetMoresLowWatermark.store(
+            kInternalQueryPrefetchRemoteGetMoresLowWatermarkDefault);
+    });
+
+    std::vector<BSONObj> firstBatch = {
+        fromjson("{_id: 1}"), fromjson("{_id: 2}"), fromjson("{_id: 3}")};
+    std::vector<RemoteCursor> cursors;
+    cursors.push_back(makeRemoteCursor(
+        kTestShardIds[0], kTestShardHosts[0], CursorResponse(kTestNss, 5, std::move(firstBatch))));
+    auto arm = makeARMFromExistingCursors(std::move(cursors));
+
+    // Two results remain buffered, which is not below the watermark, so nothing is scheduled.
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 1}"), *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_FALSE(networkHasReadyRequests());
+
+    // Once the buffer drops below the watermark, the next getMore is scheduled even though there
+    // is still a buffered result to return.
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 2}"), *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_TRUE(networkHasReadyRequests());
+    ASSERT_EQ(5, getNthPendingRequest(0).cmdObj["getMore"].numberLong());
+    ASSERT_TRUE(arm->ready());
+
+    // The prefetched batch arrives before the buffer is drained.
+    std::vector<CursorResponse> responses;
+    std::vector<BSONObj> batch = {fromjson("{_id: 4}"), fromjson("{_id: 5}")};
+    responses.emplace_back(kTestNss, CursorId(0), batch);
+    scheduleNetworkResponses(std::move(responses));
+    ASSERT_TRUE(arm->remotesExhausted());
+
+    for (int expected = 3; expected <= 5; ++expected) {
+        ASSERT_TRUE(arm->ready());
+        ASSERT_BSONOBJ_EQ(BSON("_id" << expected),
+                          *unittest::assertGet(arm->nextReady()).getResult());
+    }
+    ASSERT_TRUE(arm->ready());
+    ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
+}
+
+TEST_F(AsyncResultsMergerTest, SortedMergeWithPrefetchedBatchForQueuedRemote) {
+    internalQueryPrefetchRemoteGetMores.store(true);
+    internalQueryPrefetchRemoteGetMoresLowWatermark.store(2);
+    ON_BLOCK_EXIT([] {
+        internalQueryPrefetchRemoteGetMores.store(false);
+        internalQueryPrefetchRemoteGetMoresLowWatermark.store(
+            kInternalQueryPrefetchRemoteGetMoresLowWatermarkDefault);
+        internalQueryMergeSortKeysAsKeyStrings.store(true);
+    });
+
+    auto makeBatch = [](std::vector<int> keys) {
+        std::vector<BSONObj> batch;
+        for (int key : keys) {
+            batch.push_back(BSON("$sortKey" << BSON("" << key)));
+        }
+        return batch;
+    };
+
+    for (bool mergeSortKeysAsKeyStrings : {true, false}) {
+        internalQueryMergeSortKeysAsKeyStrings.store(mergeSortKeysAsKeyStrings);
+
+        BSONObj findCmd = fromjson("{find: 'testcoll', sort: {_id: 1}}");
+        std::vector<RemoteCursor> cursors;
+        cursors.push_back(makeRemoteCursor(kTestShardIds[0],
+                                           kTestShardHosts[0],
+                                           CursorResponse(kTestNss, 5, makeBatch({1, 3, 5}))));
+        cursors.push_back(makeRemoteCursor(kTestShardIds[1],
+                                           kTestShardHosts[1],
+                                           CursorResponse(kTestNss, 0, makeBatch({2, 4, 6, 8}))));
+        auto arm = makeARMFromExistingCursors(std::move(cursors), findCmd);
+
+        for (int expected : {1, 2, 3}) {
+            ASSERT_TRUE(arm->ready());
+            ASSERT_BSONOBJ_EQ(BSON("$sortKey" << BSON("" << expected)),
+                              *unittest::assertGet(arm->nextReady()).getResult());
+        }
+
+        // The first remote is still in the merge with one buffered result when its prefetched
+        // batch arrives.
+        ASSERT_TRUE(networkHasReadyRequests());
+        std::vector<CursorResponse> responses;
+        responses.emplace_back(kTestNss, CursorId(0), makeBatch({7, 9}));
+        scheduleNetworkResponses(std::move(responses));
+
+        for (int expected : {4, 5, 6, 7, 8, 9}) {
+            ASSERT_TRUE(arm->ready());
+            ASSERT_BSONOBJ_EQ(BSON("$sortKey" << BSON("" << expected)),
+                              *unittest::assertGet(arm->nextReady()).getResult());
+        }
+        ASSERT_TRUE(arm->ready());
+        ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
+    }
+}
+
+TEST_F(AsyncResultsMergerTest, SortedMergeWithFailedPrefetchAndPartialResults) {
+    internalQueryPrefetchRemoteGetMores.store(true);
+    internalQueryPrefetchRemoteGetMoresLowWatermark.store(2);
+    ON_BLOCK_EXIT([] {
+        internalQueryPrefetchRemoteGetMores.store(false);
+        internalQueryPrefetchRemoteGetMoresLowWatermark.store(
+            kInternalQueryPrefetchRemoteGetMoresLowWatermarkDefault);
+        internalQueryMergeSortKeysAsKeyStrings.store(true);
+    });
+
+    for (bool mergeSortKeysAsKeyStrings : {true, false}) {
+        internalQueryMergeSortKeysAsKeyStrings.store(mergeSortKeysAsKeyStrings);
+
+        BSONObj findCmd = fromjson("{find: 'testcoll', sort: {_id: 1}, allowPartialResults: true}");
+        std::vector<RemoteCursor> cursors;
+        std::vector<BSONObj> firstBatch1 = {fromjson("{$sortKey: {'': 1}}"),
+                                            fromjson("{$sortKey: {'': 3}}"),
+                                            fromjson("{$sortKey: {'': 5}}")};
+        cursors.push_back(makeRemoteCursor(
+            kTestShardIds[0], kTestShardHosts[0], CursorResponse(kTestNss, 5, firstBatch1)));
+        std::vector<BSONObj> firstBatch2 = {fromjson("{$sortKey: {'': 2}}"),
+                                            fromjson("{$sortKey: {'': 4}}")};
+        cursors.push_back(makeRemoteCursor(
+            kTestShardIds[1], kTestShardHosts[1], CursorResponse(kTestNss, 0, firstBatch2)));
+        auto arm = makeARMFromExistingCursors(std::move(cursors), findCmd);
+
+        for (int expected : {1, 2, 3}) {
+            ASSERT_TRUE(arm->ready());
+            ASSERT_BSONOBJ_EQ(BSON("$sortKey" << BSON("" << expected)),
+                              *unittest::assertGet(arm->nextReady()).getResult());
+        }
+
+        // The prefetching getMore to the first remote fails while it still has a buffered result.
+        // Its results are dropped and the merge continues with the other remote.
+        ASSERT_TRUE(networkHasReadyRequests());
+        scheduleErrorResponse({ErrorCodes::HostUnreachable, "host unreachable"});
+
+        ASSERT_TRUE(arm->ready());
+        ASSERT_BSONOBJ_EQ(fromjson("{$sortKey: {'': 4}}"),
+                          *unittest::assertGet(arm->nextReady()).getResult());
+        ASSERT_TRUE(arm->ready());
+        ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
+        ASSERT_TRUE(arm->partialResultsReturned());
+    }
+}
+
 TEST_F(AsyncResultsMergerTest, OneShardHasInitialBatchOtherShardExhausted) {
     std::vector<BSONObj> firstBatch = {
         fromjson("{_id: 1}"), fromjson("{_id: 2}"), fromjson("{_id: 3}")};
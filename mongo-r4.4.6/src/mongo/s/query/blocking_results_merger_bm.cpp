@@ -0,0 +1,137 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/query/cursor_response.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/s/query/blocking_results_merger.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kTestNss("test.foo");
+
+// Sort on a coarse ascending component followed by a fine descending one, so that most merge
+// comparisons have to look at both components of the sort key.
+const BSONObj kSortPattern = BSON("a" << 1 << "b" << -1);
+
+/**
+ * Generates 'nRemotes' sorted streams of 'docsPerRemote' results each. The values are interleaved
+ * across the streams, so that the merge switches between remotes on almost every result.
+ */
+std::vector<std::vector<BSONObj>> makeSortedBatches(int nRemotes, int docsPerRemote) {
+    std::vector<std::vector<BSONObj>> batches(nRemotes);
+    for (int r = 0; r < nRemotes; ++r) {
+        batches[r].reserve(docsPerRemote);
+        for (int i = 0; i < docsPerRemote; ++i) {
+            const long long v = static_cast<long long>(i) * nRemotes + r;
+            batches[r].push_back(BSON("_id" << v << "payload" << "xxxxxxxxxxxxxxxx"
+                                            << AsyncResultsMerger::kSortKeyField
+                                            << BSON_ARRAY((v / 16) << -v)));
+        }
+    }
+    return batches;
+}
+
+/**
+ * Builds merger parameters for remotes whose entire result set is in the first batch, and whose
+ * cursors are already closed. The merger can therefore be drained without any network activity,
+ * so the benchmark measures only the cost of buffering and merging the results.
+ */
+AsyncResultsMergerParams makeParams(const std::vector<std::vector<BSONObj>>& batches) {
+    std::vector<RemoteCursor> remotes;
+    for (size_t r = 0; r < batches.size(); ++r) {
+        RemoteCursor remote;
+        remote.setShardId(str::stream() << "shard" << r);
+        remote.setHostAndPort(HostAndPort("localhost", 27017 + r));
+        remote.setCursorResponse(CursorResponse(kTestNss, CursorId(0), batches[r]));
+        remotes.push_back(std::move(remote));
+    }
+
+    AsyncResultsMergerParams params;
+    params.setNss(kTestNss);
+    params.setSort(kSortPattern);
+    params.setRemotes(std::move(remotes));
+    return params;
+}
+
+void BM_BlockingResultsMergerSorted(benchmark::State& state) {
+    const int nRemotes = state.range(0);
+    const int docsPerRemote = state.range(1);
+    const bool mergeKeyStrings = state.range(2);
+
+    const bool oldMergeKeyStrings = internalQueryMergeSortKeysAsKeyStrings.load();
+    internalQueryMergeSortKeysAsKeyStrings.store(mergeKeyStrings);
+
+    const auto batches = makeSortedBatches(nRemotes, docsPerRemote);
+
+    for (auto keepRunning : state) {
+        state.PauseTiming();
+        auto params = makeParams(batches);
+        state.ResumeTiming();
+
+        // Neither an OperationContext nor an executor is required, since every remote is
+        // exhausted and the merger never has to wait for results.
+        BlockingResultsMerger merger(nullptr, std::move(params), nullptr, nullptr);
+        size_t nReturned = 0;
+        while (true) {
+            auto next = merger.next(nullptr, RouterExecStage::ExecContext::kInitialFind);
+            invariant(next.isOK());
+            if (next.getValue().isEOF()) {
+                break;
+            }
+            benchmark::DoNotOptimize(next.getValue().getResult());
+            ++nReturned;
+        }
+        invariant(nReturned == static_cast<size_t>(nRemotes) * docsPerRemote);
+    }
+
+    state.SetItemsProcessed(state.iterations() * nRemotes * docsPerRemote);
+    internalQueryMergeSortKeysAsKeyStrings.store(oldMergeKeyStrings);
+}
+
+BENCHMARK(BM_BlockingResultsMergerSorted)
+    ->ArgNames({"remotes", "docsPerRemote", "keyString"})
+    ->Args({2, 10000, 0})
+    ->Args({2, 10000, 1})
+    ->Args({16, 1000, 0})
+    ->Args({16, 1000, 1})
+    ->Args({100, 200, 0})
+    ->Args({100, 200, 1})
+    ->Args({500, 40, 0})
+    ->Args({500, 40, 1});
+
+}  // namespace
+}  // namespace mongo
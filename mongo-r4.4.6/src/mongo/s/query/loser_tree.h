@@ -0,0 +1,192 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <limits>
+#include <vector>
+
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+/**
+ * A tournament tree which repeatedly selects the smallest of 'k' sorted input streams. Each
+ * internal node remembers the loser of the match played at that node, so that after the winning
+ * stream advances, only the log2(k) matches on the path from that stream's leaf to the root need
+ * to be replayed. Each replayed match is a single comparison against the stored loser, which
+ * avoids the sibling lookups and the additional comparisons performed by a binary heap.
+ *
+ * Leaves are identified by their index in [0, k). Every leaf is either active, meaning that its
+ * stream has a current value which can be compared using 'Less', or inactive, meaning that its
+ * stream currently has no value (it is exhausted, or is waiting for more data). Inactive leaves
+ * sort after all active leaves. Ties between active leaves are broken by leaf index, so the merge
+ * order is deterministic.
+ *
+ * 'Less' must be a callable of signature bool(size_t lhs, size_t rhs) which defines a strict weak
+ * ordering over the current values of two active leaves.
+ *
+ * Replaying a single path is only correct when the leaf being updated is the current winner. Any
+ * other update marks the tree as stale, and the next call to top() rebuilds it from scratch in
+ * O(k) comparisons. Callers are expected to update the winner on the hot path, and other leaves
+ * rarely (e.g. when a new batch arrives for a stream whose buffer had been drained).
+ *
+ * Not thread-safe.
+ */
+template <typename Less>
+class LoserTree {
+public:
+    static constexpr size_t kNoWinner = std::numeric_limits<size_t>::max();
+
+    explicit LoserTree(Less less) : _less(std::move(less)) {}
+
+    /**
+     * Returns the number of leaves in the tree.
+     */
+    size_t size() const {
+        return _active.size();
+    }
+
+    /**
+     * Resizes the tree to 'numLeaves' leaves. The activity of existing leaves is preserved, and any
+     * new leaves are inactive.
+     */
+    void resize(size_t numLeaves) {
+        _active.resize(numLeaves, false);
+        _stale = true;
+    }
+
+    /**
+     * Notifies the tree that the current value of 'leaf' has changed, and records whether the leaf
+     * is now active.
+     */
+    void update(size_t leaf, bool active) {
+        invariant(leaf < size());
+        _active[leaf] = active;
+        if (_stale || leaf != _nodes[0]) {
+            _stale = true;
+            return;
+        }
+        _replay(leaf);
+    }
+
+    /**
+     * Returns the index of the leaf with the smallest current value, or kNoWinner if no leaf is
+     * active.
+     */
+    size_t top() {
+        if (_stale) {
+            _rebuild();
+        }
+        return (_nodes.empty() || !_active[_nodes[0]]) ? kNoWinner : _nodes[0];
+    }
+
+    /**
+     * Returns true if no leaf is active.
+     */
+    bool empty() {
+        return top() == kNoWinner;
+    }
+
+private:
+    /**
+     * Returns true if 'lhs' should be returned before 'rhs'.
+     */
+    bool _beats(size_t lhs, size_t rhs) {
+        if (_active[lhs] != _active[rhs]) {
+            return _active[lhs];
+        }
+        if (_active[lhs]) {
+            if (_less(lhs, rhs)) {
+                return true;
+            }
+            if (_less(rhs, lhs)) {
+                return false;
+            }
+        }
+        return lhs < rhs;
+    }
+
+    /**
+     * Replays all of the matches on the path from 'leaf' to the root. Leaf 'i' occupies the
+     * implicit position 'k + i', and the parent of position 'p' is 'p / 2'. Position 0 holds the
+     * overall winner.
+     */
+    void _replay(size_t leaf) {
+        size_t winner = leaf;
+        for (size_t pos = (size() + leaf) / 2; pos > 0; pos /= 2) {
+            if (_beats(_nodes[pos], winner)) {
+                std::swap(_nodes[pos], winner);
+            }
+        }
+        _nodes[0] = winner;
+    }
+
+    void _rebuild() {
+        const size_t k = size();
+        _stale = false;
+        _nodes.assign(k, kNoWinner);
+        if (k == 0) {
+            return;
+        }
+
+        // Play the tournament bottom-up, recording the winner of each position in a scratch array
+        // and the loser in '_nodes'.
+        std::vector<size_t> winners(2 * k);
+        for (size_t i = 0; i < k; ++i) {
+            winners[k + i] = i;
+        }
+        for (size_t pos = k - 1; pos > 0; --pos) {
+            const size_t left = winners[2 * pos];
+            const size_t right = winners[2 * pos + 1];
+            if (_beats(left, right)) {
+                winners[pos] = left;
+                _nodes[pos] = right;
+            } else {
+                winners[pos] = right;
+                _nodes[pos] = left;
+            }
+        }
+        _nodes[0] = (k == 1 ? 0 : winners[1]);
+    }
+
+    Less _less;
+
+    // Whether each leaf currently has a value.
+    std::vector<bool> _active;
+
+    // Position 0 holds the index of the winning leaf, and positions [1, k) hold the index of the
+    // leaf which lost the match played at that position.
+    std::vector<size_t> _nodes;
+
+    // Set when the tree must be rebuilt before the winner can be read.
+    bool _stale = true;
+};
+
+}  // namespace mongo
@@ -0,0 +1,176 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/query/loser_tree.h"
+
+#include <algorithm>
+#include <deque>
+
+#include "mongo/platform/random.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using Streams = std::vector<std::deque<int>>;
+
+/**
+ * Orders two leaves by the value at the front of their streams.
+ */
+struct FrontLess {
+    const Streams* streams;
+
+    bool operator()(size_t lhs, size_t rhs) const {
+        return (*streams)[lhs].front() < (*streams)[rhs].front();
+    }
+};
+
+using Tree = LoserTree<FrontLess>;
+
+void activateAll(Tree& tree, const Streams& streams) {
+    for (size_t i = 0; i < streams.size(); ++i) {
+        tree.update(i, !streams[i].empty());
+    }
+}
+
+/**
+ * Pops the winner off 'tree' until it is empty, returning the values in merge order.
+ */
+std::vector<int> drain(Tree& tree, Streams& streams) {
+    std::vector<int> out;
+    for (auto winner = tree.top(); winner != Tree::kNoWinner; winner = tree.top()) {
+        out.push_back(streams[winner].front());
+        streams[winner].pop_front();
+        tree.update(winner, !streams[winner].empty());
+    }
+    return out;
+}
+
+TEST(LoserTreeTest, EmptyTreeHasNoWinner) {
+    Streams streams;
+    Tree tree(FrontLess{&streams});
+    ASSERT_TRUE(tree.empty());
+    ASSERT_EQ(Tree::kNoWinner, tree.top());
+}
+
+TEST(LoserTreeTest, AllLeavesInactiveHasNoWinner) {
+    Streams streams(3);
+    Tree tree(FrontLess{&streams});
+    tree.resize(streams.size());
+    activateAll(tree, streams);
+    ASSERT_TRUE(tree.empty());
+}
+
+TEST(LoserTreeTest, SingleLeaf) {
+    Streams streams{{1, 2, 3}};
+    Tree tree(FrontLess{&streams});
+    tree.resize(streams.size());
+    activateAll(tree, streams);
+    ASSERT_EQ(0U, tree.top());
+    ASSERT_TRUE(std::vector<int>({1, 2, 3}) == drain(tree, streams));
+}
+
+TEST(LoserTreeTest, MergesInSortedOrder) {
+    Streams streams{{1, 4, 9}, {2, 3, 10}, {}, {0, 5, 6, 7, 8}, {11}};
+    Tree tree(FrontLess{&streams});
+    tree.resize(streams.size());
+    activateAll(tree, streams);
+    ASSERT_TRUE(std::vector<int>({0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11}) == drain(tree, streams));
+}
+
+TEST(LoserTreeTest, TiesAreBrokenByLeafIndex) {
+    Streams streams{{5}, {5}, {5}};
+    Tree tree(FrontLess{&streams});
+    tree.resize(streams.size());
+    activateAll(tree, streams);
+    for (size_t expected = 0; expected < streams.size(); ++expected) {
+        ASSERT_EQ(expected, tree.top());
+        streams[expected].pop_front();
+        tree.update(expected, false);
+    }
+    ASSERT_TRUE(tree.empty());
+}
+
+TEST(LoserTreeTest, InactiveLeafRejoinsMerge) {
+    Streams streams{{1}, {2, 6}};
+    Tree tree(FrontLess{&streams});
+    tree.resize(streams.size());
+    activateAll(tree, streams);
+
+    ASSERT_EQ(0U, tree.top());
+    streams[0].pop_front();
+    tree.update(0, false);
+    ASSERT_EQ(1U, tree.top());
+
+    // Leaf 0 receives more values while it is not the winner.
+    streams[0] = {3, 4};
+    tree.update(0, true);
+    ASSERT_TRUE(std::vector<int>({2, 3, 4, 6}) == drain(tree, streams));
+}
+
+TEST(LoserTreeTest, ResizeAddsInactiveLeaves) {
+    Streams streams{{1, 5}};
+    Tree tree(FrontLess{&streams});
+    tree.resize(streams.size());
+    activateAll(tree, streams);
+    ASSERT_EQ(0U, tree.top());
+
+    streams.push_back({0, 2});
+    tree.resize(streams.size());
+    ASSERT_EQ(0U, tree.top());
+    tree.update(1, true);
+    ASSERT_TRUE(std::vector<int>({0, 1, 2, 5}) == drain(tree, streams));
+}
+
+TEST(LoserTreeTest, MatchesSortForRandomStreams) {
+    PseudoRandom rand(12345);
+    for (int trial = 0; trial < 500; ++trial) {
+        Streams streams(1 + rand.nextInt32(33));
+        std::vector<int> expected;
+        for (auto&& stream : streams) {
+            const auto numValues = rand.nextInt32(20);
+            for (int i = 0; i < numValues; ++i) {
+                stream.push_back(rand.nextInt32(100));
+                expected.push_back(stream.back());
+            }
+            std::sort(stream.begin(), stream.end());
+        }
+        std::sort(expected.begin(), expected.end());
+
+        Tree tree(FrontLess{&streams});
+        tree.resize(streams.size());
+        activateAll(tree, streams);
+        ASSERT_TRUE(expected == drain(tree, streams));
+    }
+}
+
+}  // namespace
+}  // namespace mongo
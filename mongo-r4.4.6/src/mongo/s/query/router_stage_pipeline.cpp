@@ -45,6 +45,11 @@ RouterStagePipeline::RouterStagePipeline(std::unique_ptr<Pipeline, PipelineDelet
     invariant(!_mergePipeline->getSources().empty());
     _mergeCursorsStage =
         dynamic_cast<DocumentSourceMergeCursors*>(_mergePipeline->getSources().front().get());
+    for (auto&& source : _mergePipeline->getSources()) {
+        if (auto lookupStage = dynamic_cast<DocumentSourceLookupChangePostImage*>(source.get())) {
+            _postImageLookupStage = lookupStage;
+        }
+    }
 }
 
 StatusWith<ClusterQueryResult> RouterStagePipeline::next(RouterExecStage::ExecContext execContext) {
@@ -52,9 +57,19 @@ StatusWith<ClusterQueryResult> RouterStagePipeline::next(RouterExecStage::ExecCo
         _mergeCursorsStage->setExecContext(execContext);
     }
 
+    // Record a resume token to report in case the post-image lookup holds back events before any
+    // is returned.
+    if (_postImageLookupStage && _postBatchResumeToken.isEmpty()) {
+        getPostBatchResumeToken();
+    }
+
     // Pipeline::getNext will return a boost::optional<Document> or boost::none if EOF.
     if (auto result = _mergePipeline->getNext()) {
-        return _validateAndConvertToBSON(*result);
+        auto resultBSON = _validateAndConvertToBSON(*result);
+        if (_postImageLookupStage) {
+            _postBatchResumeToken = result->metadata().getSortKey().getDocument().toBson();
+        }
+        return resultBSON;
     }
 
     // If we reach this point, we have hit EOF.
@@ -87,7 +102,17 @@ std::size_t RouterStagePipeline::getNumRemotes() const {
 }
 
 BSONObj RouterStagePipeline::getPostBatchResumeToken() const {
-    return _mergeCursorsStage ? _mergeCursorsStage->getHighWaterMark() : BSONObj();
+    if (!_mergeCursorsStage) {
+        return BSONObj();
+    }
+
+    // Events which the post-image lookup has read ahead have already advanced the high water mark
+    // of the merged cursors. Until they are returned, hold the token back at the last event
+    // returned, so that a stream resumed from it does not skip them.
+    if (!_postImageLookupStage || !_postImageLookupStage->hasBufferedEvents()) {
+        _postBatchResumeToken = _mergeCursorsStage->getHighWaterMark();
+    }
+    return _postBatchResumeToken;
 }
 
 BSONObj RouterStagePipeline::_validateAndConvertToBSON(const Document& event) {
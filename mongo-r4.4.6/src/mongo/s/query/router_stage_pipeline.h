@@ -32,6 +32,7 @@
 #include "mongo/s/query/router_exec_stage.h"
 
 #include "mongo/db/pipeline/document_source.h"
+#include "mongo/db/pipeline/document_source_lookup_change_post_image.h"
 #include "mongo/db/pipeline/pipeline.h"
 #include "mongo/s/query/document_source_merge_cursors.h"
 
@@ -69,5 +70,13 @@ private:
 
     // May be null if this pipeline runs exclusively on mongos without contacting the shards at all.
     boost::intrusive_ptr<DocumentSourceMergeCursors> _mergeCursorsStage;
+
+    // The post-image lookup stage of an updateLookup change stream, if any, which may read events
+    // from '_mergeCursorsStage' ahead of returning them.
+    boost::intrusive_ptr<DocumentSourceLookupChangePostImage> _postImageLookupStage;
+
+    // The latest resume token returned by getPostBatchResumeToken(), or of an event returned by
+    // next(), whichever is more recent.
+    mutable BSONObj _postBatchResumeToken;
 };
 }  // namespace mongo
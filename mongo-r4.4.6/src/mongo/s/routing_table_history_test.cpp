@@ -318,5 +318,149 @@ TEST_F(RoutingTableHistoryTestThreeInitialChunks,
                               expectedBytesInChunksNotSplit);
 }
 
+/**
+ * Builds a routing table with 'nChunks' chunks of the form [i * 10, (i + 1) * 10) distributed
+ * round-robin across 'shards', which spans several blocks of the chunk map.
+ */
+std::vector<ChunkType> makeRoundRobinChunks(const OID& epoch,
+                                            const std::vector<ShardId>& shards,
+                                            int nChunks) {
+    std::vector<ChunkType> chunks;
+    for (int i = 0; i < nChunks; ++i) {
+        const auto min = i == 0 ? BSON("a" << MINKEY) : BSON("a" << i * 10);
+        const auto max = i == nChunks - 1 ? BSON("a" << MAXKEY) : BSON("a" << (i + 1) * 10);
+        chunks.emplace_back(kNss,
+                            ChunkRange{min, max},
+                            ChunkVersion(1, uint32_t(i), epoch),
+                            shards[i % shards.size()]);
+    }
+    return chunks;
+}
+
+/**
+ * Asserts that 'rt' has the same chunks and shard versions as a routing table built from scratch
+ * out of the same chunks.
+ */
+void assertSameAsFullRebuild(const std::shared_ptr<RoutingTableHistory>& rt,
+                             const std::vector<ShardId>& shards) {
+    std::vector<ChunkType> chunks;
+    for (const auto& [key, chunk] : rt->getChunkMap()) {
+        chunks.emplace_back(
+            kNss, chunk->getRange(), chunk->getLastmod(), chunk->getShardIdAt(boost::none));
+    }
+    std::sort(chunks.begin(), chunks.end(), [](const ChunkType& lhs, const ChunkType& rhs) {
+        return lhs.getVersion() < rhs.getVersion();
+    });
+
+    auto rebuilt = RoutingTableHistory::makeNew(kNss,
+                                                rt->getUUID(),
+                                                rt->getShardKeyPattern().getKeyPattern(),
+                                                nullptr,
+                                                false,
+                                                rt->getVersion().epoch(),
+                                                chunks);
+
+    ASSERT_EQ(rebuilt->getChunkMap().size(), rt->getChunkMap().size());
+    ASSERT_EQ(rebuilt->getVersion(), rt->getVersion());
+    ASSERT_EQ(rebuilt->getNShardsOwningChunks(), rt->getNShardsOwningChunks());
+    for (const auto& shard : shards) {
+        ASSERT_EQ(rebuilt->getVersion(shard), rt->getVersion(shard));
+    }
+}
+
+TEST(RoutingTableHistoryIncrementalUpdateTest, MigrationMatchesFullRebuild) {
+    const OID epoch = OID::gen();
+    const std::vector<ShardId> shards{ShardId("shard0"), ShardId("shard1"), ShardId("shard2")};
+    const auto chunks = makeRoundRobinChunks(epoch, shards, 2000);
+    auto rt = RoutingTableHistory::makeNew(
+        kNss, UUID::gen(), KeyPattern(BSON("a" << 1)), nullptr, false, epoch, chunks);
+
+    // Move a chunk from shard0 to shard1 and bump the version of another chunk left on shard0,
+    // which is what a migration commit does.
+    auto version = rt->getVersion();
+    version.incMajor();
+    std::vector<ChunkType> changedChunks;
+    changedChunks.emplace_back(kNss, chunks[999].getRange(), version, shards[1]);
+    version.incMinor();
+    changedChunks.emplace_back(kNss, chunks[3].getRange(), version, shards[0]);
+
+    auto updated = rt->makeUpdated(changedChunks);
+    ASSERT_NE(updated.get(), rt.get());
+    ASSERT_EQ(updated->getVersion(shards[0]), version);
+    assertSameAsFullRebuild(updated, shards);
+
+    // The original routing table still reflects the chunk distribution before the migration.
+    const auto movedKey = BSON("a" << 9995);
+    ASSERT_EQ(ChunkManager(rt, boost::none)
+                  .findIntersectingChunkWithSimpleCollation(movedKey)
+                  .getShardId(),
+              shards[0]);
+    ASSERT_EQ(ChunkManager(updated, boost::none)
+                  .findIntersectingChunkWithSimpleCollation(movedKey)
+                  .getShardId(),
+              shards[1]);
+}
+
+TEST(RoutingTableHistoryIncrementalUpdateTest, MergeAcrossManyChunksMatchesFullRebuild) {
+    const OID epoch = OID::gen();
+    const std::vector<ShardId> shards{ShardId("shard0")};
+    const auto chunks = makeRoundRobinChunks(epoch, shards, 2000);
+    auto rt = RoutingTableHistory::makeNew(
+        kNss, UUID::gen(), KeyPattern(BSON("a" << 1)), nullptr, false, epoch, chunks);
+
+    auto version = rt->getVersion();
+    version.incMajor();
+    std::vector<ChunkType> changedChunks;
+    changedChunks.emplace_back(
+        kNss, ChunkRange{BSON("a" << 100), BSON("a" << 15000)}, version, shards[0]);
+
+    auto updated = rt->makeUpdated(changedChunks);
+    ASSERT_EQ(updated->getChunkMap().size(), 2000ull - 1490ull + 1ull);
+    assertSameAsFullRebuild(updated, shards);
+}
+
+TEST(RoutingTableHistoryIncrementalUpdateTest, MovingLastChunkOffShardRemovesShard) {
+    const OID epoch = OID::gen();
+    const std::vector<ShardId> shards{ShardId("shard0"), ShardId("shard1")};
+    std::vector<ChunkType> chunks;
+    chunks.emplace_back(kNss,
+                        ChunkRange{BSON("a" << MINKEY), BSON("a" << 0)},
+                        ChunkVersion(1, 0, epoch),
+                        shards[0]);
+    chunks.emplace_back(kNss,
+                        ChunkRange{BSON("a" << 0), BSON("a" << MAXKEY)},
+                        ChunkVersion(1, 1, epoch),
+                        shards[1]);
+    auto rt = RoutingTableHistory::makeNew(
+        kNss, UUID::gen(), KeyPattern(BSON("a" << 1)), nullptr, false, epoch, chunks);
+    ASSERT_EQ(rt->getNShardsOwningChunks(), 2);
+
+    std::vector<ChunkType> changedChunks;
+    changedChunks.emplace_back(
+        kNss, chunks[1].getRange(), ChunkVersion(2, 0, epoch), shards[0]);
+    auto updated = rt->makeUpdated(changedChunks);
+
+    ASSERT_EQ(updated->getNShardsOwningChunks(), 1);
+    ASSERT_EQ(updated->getVersion(shards[0]), ChunkVersion(2, 0, epoch));
+    ASSERT_EQ(updated->getVersion(shards[1]), ChunkVersion(0, 0, epoch));
+    assertSameAsFullRebuild(updated, shards);
+}
+
+TEST(RoutingTableHistoryIncrementalUpdateTest, GapIntroducedByUpdateIsDetected) {
+    const OID epoch = OID::gen();
+    const std::vector<ShardId> shards{ShardId("shard0")};
+    const auto chunks = makeRoundRobinChunks(epoch, shards, 10);
+    auto rt = RoutingTableHistory::makeNew(
+        kNss, UUID::gen(), KeyPattern(BSON("a" << 1)), nullptr, false, epoch, chunks);
+
+    std::vector<ChunkType> changedChunks;
+    changedChunks.emplace_back(kNss,
+                               ChunkRange{BSON("a" << 25), BSON("a" << 30)},
+                               ChunkVersion(2, 0, epoch),
+                               shards[0]);
+    ASSERT_THROWS_CODE(
+        rt->makeUpdated(changedChunks), DBException, ErrorCodes::ConflictingOperationInProgress);
+}
+
 }  // namespace
 }  // namespace mongo
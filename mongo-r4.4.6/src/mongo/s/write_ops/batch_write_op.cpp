@@ -53,6 +53,11 @@ using std::vector;
 
 namespace {
 
+// Inserts are targeted in bulk, over windows of the batch which start at this many write ops and
+// double each time a window is used up, so that an ordered batch which stops early at a shard
+// boundary does not pay for targeting the rest of the batch.
+const size_t kInitialInsertTargetingWindowSize = 64;
+
 struct WriteErrorDetailComp {
     bool operator()(const WriteErrorDetail* errorA, const WriteErrorDetail* errorB) const {
         return errorA->getIndex() < errorB->getIndex();
@@ -305,6 +310,40 @@ Status BatchWriteOp::targetBatch(const NSTargeter& targeter,
 
     const size_t numWriteOps = _clientRequest.sizeWriteOps();
 
+    const bool isInsertBatch =
+        _clientRequest.getBatchType() == BatchedCommandRequest::BatchType_Insert;
+    size_t insertWindowBegin = 0;
+    size_t insertWindowEnd = 0;
+    size_t insertWindowSize = kInitialInsertTargetingWindowSize;
+    std::vector<boost::optional<StatusWith<ShardEndpoint>>> insertEndpoints;
+
+    // Targets the ready inserts in the window of write ops starting at 'windowBegin' together.
+    const auto targetInsertWindow = [&](size_t windowBegin) {
+        const auto& insertDocs = _clientRequest.getInsertRequest().getDocuments();
+        insertWindowBegin = windowBegin;
+        insertWindowEnd = std::min(numWriteOps, windowBegin + insertWindowSize);
+        insertWindowSize *= 2;
+
+        std::vector<BSONObj> docs;
+        for (size_t i = insertWindowBegin; i < insertWindowEnd; ++i) {
+            if (_writeOps[i].getWriteState() == WriteOpState_Ready) {
+                docs.push_back(insertDocs[i]);
+            }
+        }
+
+        auto endpoints = targeter.targetInserts(_opCtx, docs);
+        invariant(endpoints.size() == docs.size());
+
+        insertEndpoints.clear();
+        insertEndpoints.resize(insertWindowEnd - insertWindowBegin);
+        auto endpointIt = endpoints.begin();
+        for (size_t i = insertWindowBegin; i < insertWindowEnd; ++i) {
+            if (_writeOps[i].getWriteState() == WriteOpState_Ready) {
+                insertEndpoints[i - insertWindowBegin] = std::move(*endpointIt++);
+            }
+        }
+    };
+
     for (size_t i = 0; i < numWriteOps; ++i) {
         WriteOp& writeOp = _writeOps[i];
 
@@ -320,7 +359,24 @@ Status BatchWriteOp::targetBatch(const NSTargeter& targeter,
         OwnedPointerVector<TargetedWrite> writesOwned;
         vector<TargetedWrite*>& writes = writesOwned.mutableVector();
 
-        Status targetStatus = writeOp.targetWrites(_opCtx, targeter, &writes);
+        Status targetStatus = Status::OK();
+        if (isInsertBatch) {
+            if (i >= insertWindowEnd) {
+                targetInsertWindow(i);
+            }
+
+            auto& swEndpoint = insertEndpoints[i - insertWindowBegin];
+            invariant(swEndpoint);
+            if (swEndpoint->isOK()) {
+                writeOp.targetInsert(std::move(swEndpoint->getValue()), &writes);
+            } else {
+                // Retarget the insert on its own, so that it fails exactly as it would have
+                // without bulk targeting.
+                targetStatus = writeOp.targetWrites(_opCtx, targeter, &writes);
+            }
+        } else {
+            targetStatus = writeOp.targetWrites(_opCtx, targeter, &writes);
+        }
 
         if (!targetStatus.isOK()) {
             WriteErrorDetail targetError;
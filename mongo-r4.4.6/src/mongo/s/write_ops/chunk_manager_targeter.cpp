@@ -417,6 +417,67 @@ StatusWith<ShardEndpoint> ChunkManagerTargeter::targetInsert(OperationContext* o
     return Status::OK();
 }
 
+std::vector<StatusWith<ShardEndpoint>> ChunkManagerTargeter::targetInserts(
+    OperationContext* opCtx, const std::vector<BSONObj>& docs) const {
+    // Inserts into an unsharded collection all go to the database primary.
+    if (!_routingInfo->cm()) {
+        return NSTargeter::targetInserts(opCtx, docs);
+    }
+
+    const auto& cm = *_routingInfo->cm();
+
+    std::vector<BSONObj> shardKeys;
+    shardKeys.reserve(docs.size());
+    for (const auto& doc : docs) {
+        shardKeys.push_back(cm.getShardKeyPattern().extractShardKeyFromDoc(doc));
+    }
+
+    auto shardIds = cm.getShardIdsForKeysWithSimpleCollation(shardKeys);
+
+    // A batch usually only spans a few shards, so only look up each shard's version once.
+    std::map<ShardId, StatusWith<ChunkVersion>> shardVersions;
+    const auto getShardVersion = [&](const ShardId& shardId) -> const StatusWith<ChunkVersion>& {
+        auto it = shardVersions.find(shardId);
+        if (it == shardVersions.end()) {
+            StatusWith<ChunkVersion> swShardVersion(ErrorCodes::InternalError, "");
+            try {
+                swShardVersion = cm.getVersion(shardId);
+            } catch (const DBException& ex) {
+                swShardVersion = ex.toStatus();
+            }
+            it = shardVersions.emplace(shardId, std::move(swShardVersion)).first;
+        }
+        return it->second;
+    };
+
+    std::vector<StatusWith<ShardEndpoint>> endpoints;
+    endpoints.reserve(docs.size());
+    for (size_t i = 0; i < docs.size(); ++i) {
+        // See targetInsert for why an empty extracted shard key is an error.
+        if (shardKeys[i].isEmpty()) {
+            endpoints.push_back(
+                Status(ErrorCodes::ShardKeyNotFound,
+                       "Shard key cannot contain array values or array descendants."));
+            continue;
+        }
+
+        if (!shardIds[i].isOK()) {
+            endpoints.push_back(shardIds[i].getStatus());
+            continue;
+        }
+
+        const auto& swShardVersion = getShardVersion(shardIds[i].getValue());
+        if (!swShardVersion.isOK()) {
+            endpoints.push_back(swShardVersion.getStatus());
+            continue;
+        }
+
+        endpoints.push_back(ShardEndpoint(shardIds[i].getValue(), swShardVersion.getValue()));
+    }
+
+    return endpoints;
+}
+
 StatusWith<std::vector<ShardEndpoint>> ChunkManagerTargeter::targetUpdate(
     OperationContext* opCtx, const write_ops::UpdateOpEntry& updateDoc) const {
     // If the update is replacement-style:
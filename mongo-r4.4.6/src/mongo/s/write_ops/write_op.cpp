@@ -85,8 +85,21 @@ Status WriteOp::targetWrites(OperationContext* opCtx,
     if (!swEndpoints.isOK())
         return swEndpoints.getStatus();
 
-    auto& endpoints = swEndpoints.getValue();
+    _createChildOps(std::move(swEndpoints.getValue()), inTransaction, targetedWrites);
+    return Status::OK();
+}
+
+void WriteOp::targetInsert(ShardEndpoint endpoint, std::vector<TargetedWrite*>* targetedWrites) {
+    invariant(_itemRef.getOpType() == BatchedCommandRequest::BatchType_Insert);
 
+    std::vector<ShardEndpoint> endpoints;
+    endpoints.push_back(std::move(endpoint));
+    _createChildOps(std::move(endpoints), _inTxn, targetedWrites);
+}
+
+void WriteOp::_createChildOps(std::vector<ShardEndpoint> endpoints,
+                              bool inTransaction,
+                              std::vector<TargetedWrite*>* targetedWrites) {
     for (auto&& endpoint : endpoints) {
         // if the operation was already successfull on that shard, there is no need to repeat the
         // write
@@ -112,7 +125,6 @@ Status WriteOp::targetWrites(OperationContext* opCtx,
     // If all operations currently targeted were successful on a previous round we might have 0
     // childOps, that would mean that the operation is finished.
     _state = _childOps.size() ? WriteOpState_Pending : WriteOpState_Completed;
-    return Status::OK();
 }
 
 size_t WriteOp::getNumTargeted() {
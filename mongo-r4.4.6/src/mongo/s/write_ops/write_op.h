@@ -123,6 +123,12 @@ public:
                         const NSTargeter& targeter,
                         std::vector<TargetedWrite*>* targetedWrites);
 
+    /**
+     * Same as targetWrites, for an insert whose endpoint has already been determined through
+     * NSTargeter::targetInserts.
+     */
+    void targetInsert(ShardEndpoint endpoint, std::vector<TargetedWrite*>* targetedWrites);
+
     /**
      * Returns the number of child writes that were last targeted.
      */
@@ -166,6 +172,14 @@ private:
      */
     void _updateOpState();
 
+    /**
+     * Creates a child op and a TargetedWrite for each of 'endpoints' on which this write has not
+     * already succeeded.
+     */
+    void _createChildOps(std::vector<ShardEndpoint> endpoints,
+                         bool inTransaction,
+                         std::vector<TargetedWrite*>* targetedWrites);
+
     // Owned elsewhere, reference to a batch with a write item
     const BatchItemRef _itemRef;
 
@@ -542,6 +542,42 @@ TEST_F(ChunkManagerTargeterTest, TargetInsertWithRangePrefixHashedShardKey) {
                        ErrorCodes::ShardKeyNotFound);
 }
 
+TEST_F(ChunkManagerTargeterTest, BulkTargetInsertsMatchesTargetInsert) {
+    std::vector<BSONObj> splitPoints = {
+        BSON("a.b" << BSONNULL), BSON("a.b" << -100), BSON("a.b" << 0), BSON("a.b" << 100)};
+    auto cmTargeter = prepare(BSON("a.b" << 1 << "c.d"
+                                         << "hashed"),
+                              splitPoints);
+
+    // Unsorted keys, repeated keys and keys which fall into the same chunk.
+    std::vector<BSONObj> docs;
+    for (int i = 0; i < 200; ++i) {
+        docs.push_back(BSON("a" << BSON("b" << ((i * 37) % 400) - 200) << "c" << BSON("d" << i)));
+    }
+    docs.push_back(BSONObj());
+    docs.push_back(fromjson("{a: {b: 1000}, c: null, d: {}}"));
+    docs.push_back(fromjson("{a: {b: -111}, c: {d: '1'}}"));
+
+    auto endpoints = cmTargeter.targetInserts(operationContext(), docs);
+    ASSERT_EQ(docs.size(), endpoints.size());
+    for (size_t i = 0; i < docs.size(); ++i) {
+        auto res = cmTargeter.targetInsert(operationContext(), docs[i]);
+        ASSERT_OK(res.getStatus());
+        ASSERT_OK(endpoints[i].getStatus());
+        ASSERT_EQUALS(res.getValue().shardName, endpoints[i].getValue().shardName);
+        ASSERT_EQUALS(res.getValue().shardVersion, endpoints[i].getValue().shardVersion);
+    }
+
+    // Documents which targetInsert rejects by throwing are reported as errors, without affecting
+    // the other documents of the batch.
+    endpoints = cmTargeter.targetInserts(
+        operationContext(), {fromjson("{a: {b: 5}}"), fromjson("{a: [1,2]}"), fromjson("{}")});
+    ASSERT_EQ(3U, endpoints.size());
+    ASSERT_EQUALS(endpoints[0].getValue().shardName, "3");
+    ASSERT_EQUALS(ErrorCodes::ShardKeyNotFound, endpoints[1].getStatus().code());
+    ASSERT_EQUALS(endpoints[2].getValue().shardName, "1");
+}
+
 TEST_F(ChunkManagerTargeterTest, TargetInsertsWithVaryingHashedPrefixAndConstantRangedSuffix) {
     // Create 4 chunks and 4 shards such that shardId '0' has chunk [MinKey, -2^62), '1' has chunk
     // [-2^62, 0), '2' has chunk ['0', 2^62) and '3' has chunk [2^62, MaxKey).
@@ -0,0 +1,133 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/platform/random.h"
+#include "mongo/s/chunk_manager.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kNss("test.foo");
+
+// Builds a routing table for {x: 1} with 'nChunks' chunks of width 100, spread round-robin across
+// 'nShards' shards.
+std::shared_ptr<ChunkManager> makeChunkManager(int nShards, int nChunks) {
+    const auto collEpoch = OID::gen();
+
+    std::vector<ChunkType> chunks;
+    chunks.reserve(nChunks);
+    for (int i = 0; i < nChunks; ++i) {
+        const auto min = i == 0 ? BSON("x" << MINKEY) : BSON("x" << (i - 1) * 100);
+        const auto max = i + 1 == nChunks ? BSON("x" << MAXKEY) : BSON("x" << i * 100);
+        chunks.emplace_back(kNss,
+                            ChunkRange{min, max},
+                            ChunkVersion{uint32_t(i + 1), 0, collEpoch},
+                            ShardId(str::stream() << "shard" << (i % nShards)));
+    }
+
+    auto rt = RoutingTableHistory::makeNew(
+        kNss, UUID::gen(), KeyPattern(BSON("x" << 1)), nullptr, false, collEpoch, chunks);
+    return std::make_shared<ChunkManager>(rt, boost::none);
+}
+
+// Builds an insert batch of 'nDocs' documents with either random or monotonically increasing shard
+// key values, the latter being the common case of inserts on a timestamp or ObjectId-like key.
+std::vector<BSONObj> makeDocs(int nDocs, int nChunks, bool monotonic) {
+    PseudoRandom rand(12345);
+    std::vector<BSONObj> docs;
+    docs.reserve(nDocs);
+    for (int i = 0; i < nDocs; ++i) {
+        const long long x = monotonic ? (nChunks - 2) * 100LL + i : rand.nextInt64(nChunks * 100LL);
+        docs.push_back(BSON("_id" << i << "x" << x << "payload"
+                                  << "abcdefghijklmnopqrstuvwxyz"));
+    }
+    return docs;
+}
+
+void BM_TargetInsertsOneAtATime(benchmark::State& state) {
+    const int nChunks = state.range(0);
+    const int nDocs = state.range(1);
+    const bool monotonic = state.range(2);
+    const auto cm = makeChunkManager(10, nChunks);
+    const auto docs = makeDocs(nDocs, nChunks, monotonic);
+
+    for (auto keepRunning : state) {
+        for (const auto& doc : docs) {
+            const auto shardKey = cm->getShardKeyPattern().extractShardKeyFromDoc(doc);
+            benchmark::DoNotOptimize(
+                cm->findIntersectingChunkWithSimpleCollation(shardKey).getShardId());
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * nDocs);
+}
+
+void BM_TargetInsertsInBulk(benchmark::State& state) {
+    const int nChunks = state.range(0);
+    const int nDocs = state.range(1);
+    const bool monotonic = state.range(2);
+    const auto cm = makeChunkManager(10, nChunks);
+    const auto docs = makeDocs(nDocs, nChunks, monotonic);
+
+    for (auto keepRunning : state) {
+        std::vector<BSONObj> shardKeys;
+        shardKeys.reserve(docs.size());
+        for (const auto& doc : docs) {
+            shardKeys.push_back(cm->getShardKeyPattern().extractShardKeyFromDoc(doc));
+        }
+        benchmark::DoNotOptimize(cm->getShardIdsForKeysWithSimpleCollation(shardKeys));
+    }
+
+    state.SetItemsProcessed(state.iterations() * nDocs);
+}
+
+BENCHMARK(BM_TargetInsertsOneAtATime)
+    ->ArgNames({"chunks", "docs", "monotonic"})
+    ->Args({1000, 100000, 0})
+    ->Args({1000, 100000, 1})
+    ->Args({500000, 100000, 0})
+    ->Args({500000, 100000, 1})
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_TargetInsertsInBulk)
+    ->ArgNames({"chunks", "docs", "monotonic"})
+    ->Args({1000, 100000, 0})
+    ->Args({1000, 100000, 1})
+    ->Args({500000, 100000, 0})
+    ->Args({500000, 100000, 1})
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace mongo